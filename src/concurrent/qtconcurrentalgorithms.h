@@ -0,0 +1,305 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QTCONCURRENT_ALGORITHMS_H
+#define QTCONCURRENT_ALGORITHMS_H
+
+#include <QtConcurrent/qtconcurrent_global.h>
+
+#if !defined(QT_NO_CONCURRENT) || defined(Q_QDOC)
+
+#include <QtConcurrent/qtconcurrentiteratekernel.h>
+#include <QtCore/qfuture.h>
+#include <QtCore/qspan.h>
+#include <QtCore/qthreadpool.h>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+namespace QtConcurrent {
+
+#ifndef Q_QDOC
+
+// A random access iterator over indexes, so that IterateKernel can hand out
+// blocks of an index range to the threads.
+class IndexIterator
+{
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = qsizetype;
+    using difference_type = qsizetype;
+    using pointer = const qsizetype *;
+    using reference = qsizetype;
+
+    constexpr IndexIterator() noexcept = default;
+    constexpr explicit IndexIterator(qsizetype index) noexcept : index(index) {}
+
+    constexpr qsizetype operator*() const noexcept { return index; }
+    constexpr IndexIterator &operator++() noexcept { ++index; return *this; }
+    constexpr IndexIterator &operator--() noexcept { --index; return *this; }
+    constexpr IndexIterator &operator+=(qsizetype n) noexcept { index += n; return *this; }
+    constexpr IndexIterator &operator-=(qsizetype n) noexcept { index -= n; return *this; }
+    friend constexpr qsizetype operator-(IndexIterator lhs, IndexIterator rhs) noexcept
+    { return lhs.index - rhs.index; }
+    friend constexpr bool operator==(IndexIterator lhs, IndexIterator rhs) noexcept
+    { return lhs.index == rhs.index; }
+    friend constexpr bool operator!=(IndexIterator lhs, IndexIterator rhs) noexcept
+    { return lhs.index != rhs.index; }
+
+private:
+    qsizetype index = 0;
+};
+
+// Calls a function for each index of a range. IterateKernel counts in int,
+// so larger ranges are iterated in steps of more than one index.
+template <typename Function>
+class ForEachIndexKernel : public IterateKernel<IndexIterator, void>
+{
+public:
+    template <typename F = Function>
+    ForEachIndexKernel(QThreadPool *pool, qsizetype first, qsizetype last, F &&function)
+        : IterateKernel<IndexIterator, void>(pool, IndexIterator(0),
+                                             IndexIterator(stepCount(first, last))),
+          first(first), last(last), step(stepSize(first, last)),
+          function(std::forward<F>(function))
+    { }
+
+    bool runIteration(IndexIterator, int index, void *) override
+    {
+        return runIterations(IndexIterator(), index, index + 1, nullptr);
+    }
+
+    bool runIterations(IndexIterator, int beginIndex, int endIndex, void *) override
+    {
+        const qsizetype begin = first + beginIndex * step;
+        const qsizetype end = qMin(first + endIndex * step, last);
+        for (qsizetype i = begin; i < end; ++i)
+            std::invoke(function, i);
+        return false;
+    }
+
+private:
+    static qsizetype stepSize(qsizetype first, qsizetype last)
+    {
+        constexpr qsizetype maxSteps = (std::numeric_limits<int>::max)();
+        return (last - first + maxSteps - 1) / maxSteps;
+    }
+    static qsizetype stepCount(qsizetype first, qsizetype last)
+    {
+        const qsizetype step = stepSize(first, last);
+        return (last - first + step - 1) / step;
+    }
+
+    const qsizetype first;
+    const qsizetype last;
+    const qsizetype step;
+    Function function;
+};
+
+namespace Algorithms {
+
+// Ranges shorter than this are not worth splitting.
+enum { MinimumChunkSize = 4096 };
+
+// The number of chunks the sorts and the scan split a range of count
+// elements into: a few per thread, so that a slow thread does not hold up
+// the others, but no chunk shorter than MinimumChunkSize.
+inline qsizetype chunkCount(QThreadPool *pool, qsizetype count)
+{
+    const qsizetype perThread = 2 * qsizetype(std::max(pool->maxThreadCount(), 1));
+    return std::clamp<qsizetype>(count / MinimumChunkSize, 1, perThread);
+}
+
+inline qsizetype chunkBegin(qsizetype chunk, qsizetype chunkCount, qsizetype count)
+{
+    return qsizetype(qint64(count) * chunk / chunkCount);
+}
+
+template <typename RandomAccessIterator, typename Compare, typename SortFunction>
+void mergeSort(QThreadPool *pool, RandomAccessIterator begin, RandomAccessIterator end,
+               Compare &comp, SortFunction sortChunk);
+
+} // namespace Algorithms
+
+#endif // Q_QDOC
+
+template <typename Function>
+void blockingForEach(QThreadPool *pool, qsizetype begin, qsizetype end, Function &&function)
+{
+    if (begin >= end)
+        return;
+    QFuture<void> future =
+            startThreadEngine(new ForEachIndexKernel<std::decay_t<Function>>(
+                    pool, begin, end, std::forward<Function>(function)))
+                    .startAsynchronously();
+    future.waitForFinished();
+}
+
+template <typename Function>
+void blockingForEach(qsizetype begin, qsizetype end, Function &&function)
+{
+    blockingForEach(QThreadPool::globalInstance(), begin, end, std::forward<Function>(function));
+}
+
+template <typename InputIterator, typename T, std::size_t E, typename Function>
+void blockingTransform(QThreadPool *pool, InputIterator begin, InputIterator end,
+                       QSpan<T, E> output, Function &&function)
+{
+    static_assert(std::is_base_of_v<std::random_access_iterator_tag,
+                                    typename std::iterator_traits<InputIterator>::iterator_category>,
+                  "QtConcurrent::blockingTransform() requires random access iterators");
+    const qsizetype count = std::distance(begin, end);
+    Q_ASSERT_X(output.size() >= count, "QtConcurrent::blockingTransform",
+               "the output span is shorter than the input range");
+    blockingForEach(pool, 0, count, [&](qsizetype i) {
+        output[i] = std::invoke(function, begin[i]);
+    });
+}
+
+template <typename InputIterator, typename T, std::size_t E, typename Function>
+void blockingTransform(InputIterator begin, InputIterator end, QSpan<T, E> output,
+                       Function &&function)
+{
+    blockingTransform(QThreadPool::globalInstance(), begin, end, output,
+                      std::forward<Function>(function));
+}
+
+template <typename RandomAccessIterator, typename Compare = std::less<>>
+void blockingSort(QThreadPool *pool, RandomAccessIterator begin, RandomAccessIterator end,
+                  Compare comp = {})
+{
+    Algorithms::mergeSort(pool, begin, end, comp,
+                          [](auto first, auto last, Compare &comp) {
+        std::sort(first, last, comp);
+    });
+}
+
+template <typename RandomAccessIterator, typename Compare = std::less<>>
+void blockingSort(RandomAccessIterator begin, RandomAccessIterator end, Compare comp = {})
+{
+    blockingSort(QThreadPool::globalInstance(), begin, end, std::move(comp));
+}
+
+template <typename RandomAccessIterator, typename Compare = std::less<>>
+void blockingStableSort(QThreadPool *pool, RandomAccessIterator begin, RandomAccessIterator end,
+                        Compare comp = {})
+{
+    Algorithms::mergeSort(pool, begin, end, comp,
+                          [](auto first, auto last, Compare &comp) {
+        std::stable_sort(first, last, comp);
+    });
+}
+
+template <typename RandomAccessIterator, typename Compare = std::less<>>
+void blockingStableSort(RandomAccessIterator begin, RandomAccessIterator end, Compare comp = {})
+{
+    blockingStableSort(QThreadPool::globalInstance(), begin, end, std::move(comp));
+}
+
+template <typename InputIterator, typename OutputIterator, typename BinaryOperation = std::plus<>>
+OutputIterator blockingInclusiveScan(QThreadPool *pool, InputIterator begin, InputIterator end,
+                                     OutputIterator output, BinaryOperation op = {})
+{
+    static_assert(std::is_base_of_v<std::random_access_iterator_tag,
+                                    typename std::iterator_traits<InputIterator>::iterator_category>,
+                  "QtConcurrent::blockingInclusiveScan() requires random access iterators");
+    using ValueType = typename std::iterator_traits<InputIterator>::value_type;
+
+    const qsizetype count = std::distance(begin, end);
+    const qsizetype chunks = Algorithms::chunkCount(pool, count);
+    if (chunks < 2)
+        return std::inclusive_scan(begin, end, output, op);
+
+    // Sum up each chunk but the last, add up those sums, then scan each
+    // chunk starting from the sum of the chunks before it. Each element is
+    // read before the same position of the output is written, so the output
+    // may be the input.
+    std::vector<std::optional<ValueType>> sums(chunks - 1);
+    blockingForEach(pool, 0, chunks - 1, [&](qsizetype chunk) {
+        const qsizetype first = Algorithms::chunkBegin(chunk, chunks, count);
+        const qsizetype last = Algorithms::chunkBegin(chunk + 1, chunks, count);
+        ValueType sum = begin[first];
+        for (qsizetype i = first + 1; i < last; ++i)
+            sum = std::invoke(op, std::move(sum), begin[i]);
+        sums[chunk].emplace(std::move(sum));
+    });
+    for (qsizetype chunk = 1; chunk < chunks - 1; ++chunk)
+        sums[chunk].emplace(std::invoke(op, *sums[chunk - 1], std::move(*sums[chunk])));
+
+    blockingForEach(pool, 0, chunks, [&](qsizetype chunk) {
+        const qsizetype first = Algorithms::chunkBegin(chunk, chunks, count);
+        const qsizetype last = Algorithms::chunkBegin(chunk + 1, chunks, count);
+        ValueType sum = chunk ? std::invoke(op, *sums[chunk - 1], begin[first])
+                              : ValueType(begin[first]);
+        OutputIterator out = std::next(output, first);
+        *out = sum;
+        for (qsizetype i = first + 1; i < last; ++i) {
+            sum = std::invoke(op, std::move(sum), begin[i]);
+            *++out = sum;
+        }
+    });
+    return std::next(output, count);
+}
+
+template <typename InputIterator, typename OutputIterator, typename BinaryOperation = std::plus<>>
+OutputIterator blockingInclusiveScan(InputIterator begin, InputIterator end,
+                                     OutputIterator output, BinaryOperation op = {})
+{
+    return blockingInclusiveScan(QThreadPool::globalInstance(), begin, end, output,
+                                 std::move(op));
+}
+
+#ifndef Q_QDOC
+
+namespace Algorithms {
+
+// Sorts the chunks of the range in parallel, then merges neighboring runs
+// in rounds, each round merging twice as long runs as the one before.
+template <typename RandomAccessIterator, typename Compare, typename SortFunction>
+void mergeSort(QThreadPool *pool, RandomAccessIterator begin, RandomAccessIterator end,
+               Compare &comp, SortFunction sortChunk)
+{
+    static_assert(std::is_base_of_v<std::random_access_iterator_tag,
+                                    typename std::iterator_traits<RandomAccessIterator>::iterator_category>,
+                  "QtConcurrent sorting requires random access iterators");
+    const qsizetype count = std::distance(begin, end);
+    const qsizetype chunks = chunkCount(pool, count);
+    if (chunks < 2) {
+        sortChunk(begin, end, comp);
+        return;
+    }
+
+    const auto at = [&](qsizetype chunk) {
+        return begin + chunkBegin(qMin(chunk, chunks), chunks, count);
+    };
+    blockingForEach(pool, 0, chunks, [&](qsizetype chunk) {
+        sortChunk(at(chunk), at(chunk + 1), comp);
+    });
+    for (qsizetype width = 1; width < chunks; width *= 2) {
+        const qsizetype merges = (chunks + 2 * width - 1) / (2 * width);
+        blockingForEach(pool, 0, merges, [&](qsizetype merge) {
+            const qsizetype first = merge * 2 * width;
+            if (first + width < chunks)
+                std::inplace_merge(at(first), at(first + width), at(first + 2 * width), comp);
+        });
+    }
+}
+
+} // namespace Algorithms
+
+#endif // Q_QDOC
+
+} // namespace QtConcurrent
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_CONCURRENT
+
+#endif
@@ -101,8 +101,17 @@
     \value OrderedReduce Reduction is done in the order of the
     original sequence.
     \value SequentialReduce Reduction is done sequentially: only one
-    thread will enter the reduce function at a time. (Parallel reduction
-    might be supported in a future version of Qt Concurrent.)
+    thread will enter the reduce function at a time.
+    \value [since 6.9] ParallelReduce Reduction is done in parallel: each
+    thread reduces into a partial result of its own, which starts out as a
+    copy of the first value it gets, and the partial results are combined
+    by calling the reduce function with a partial result as its second
+    argument. This requires the map or filter function to produce values of
+    the result type; the reduce function must be associative and
+    commutative, and may be called from several threads at the same time.
+    This option takes
+    precedence over SequentialReduce. If the types do not allow it, or if
+    OrderedReduce is also set, reduction is done as with UnorderedReduce.
 */
 
 /*!
@@ -194,7 +203,10 @@
     control the order in which the reduction is done. If
     QtConcurrent::UnorderedReduce is used (the default), the order is
     undefined, while QtConcurrent::OrderedReduce ensures that the reduction
-    is done in the order of the original sequence.
+    is done in the order of the original sequence. QtConcurrent::ParallelReduce
+    lifts the one-thread-at-a-time guarantee when the intermediate results
+    and the final result have the same type, such as when summing up
+    numbers, so that the reduction scales with the number of threads.
 
     \section1 Additional API Features
 
@@ -151,6 +151,15 @@ public:
         : IterateKernel<Iterator, T>(pool, begin, end), map(std::forward<F>(_map))
     { }
 
+    void start() override
+    {
+        // results are reported with their index, and nobody looks at the
+        // return value, so they can bypass the mutex of the future
+        if (this->futureInterface)
+            this->futureInterface->setResultStagingEnabled(true);
+        IterateKernel<Iterator, T>::start();
+    }
+
     bool runIteration(Iterator it, int,  T *result) override
     {
         *result = std::invoke(map, *it);
@@ -0,0 +1,258 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qtconcurrentpipeline.h"
+
+#if !defined(QT_NO_CONCURRENT) || defined(Q_QDOC)
+
+QT_BEGIN_NAMESPACE
+
+namespace QtConcurrent {
+
+/*!
+  \class QtConcurrent::PipelineItem
+  \inmodule QtConcurrent
+  \internal
+*/
+
+/*!
+  \class QtConcurrent::PipelineStage
+  \inmodule QtConcurrent
+  \internal
+
+  A stage keeps the items waiting for it and runs workers for them on the
+  thread pool: one for a serial stage, which takes the items in the order
+  the source produced them, and up to the pool's maximum thread count for
+  a parallel one. Workers never block: a worker that runs out of items
+  ends, and pushing an item starts one if there is room for another.
+*/
+
+/*!
+  \class QtConcurrent::PipelineEngine
+  \inmodule QtConcurrent
+  \internal
+
+  Runs the source of a pipeline and keeps track of the items in flight.
+  The source only produces an item while fewer than the capacity are in
+  the pipeline, and is restarted when an item leaves the pipeline, which
+  bounds the memory a pipeline uses independently of the length of its
+  source. The engine finishes its future once the source is done and the
+  last item has left.
+
+  The engine lives for as long as one of the tasks it started on the
+  thread pool, each of which holds a reference to it.
+*/
+
+PipelineItem::~PipelineItem()
+    = default;
+
+PipelineStage::~PipelineStage()
+    = default;
+
+void PipelineStage::push(std::unique_ptr<PipelineItem> item)
+{
+    {
+        QMutexLocker locker(&mutex);
+        if (mode == Serial)
+            pending.emplace(item->sequence, std::move(item));
+        else
+            queue.push_back(std::move(item));
+
+        const int maxWorkers = mode == Serial ? 1 : qMax(engine->threadPool->maxThreadCount(), 1);
+        if (workers >= maxWorkers)
+            return;
+        if (mode == Serial && pending.begin()->first != nextSequence)
+            return;
+        ++workers;
+    }
+    engine->schedule(this);
+}
+
+// Must be called with the mutex locked.
+std::unique_ptr<PipelineItem> PipelineStage::takeNext()
+{
+    std::unique_ptr<PipelineItem> item;
+    if (mode == Serial) {
+        auto it = pending.begin();
+        if (it == pending.end() || it->first != nextSequence)
+            return item;
+        item = std::move(it->second);
+        pending.erase(it);
+        ++nextSequence;
+    } else if (!queue.empty()) {
+        item = std::move(queue.front());
+        queue.pop_front();
+    }
+    return item;
+}
+
+void PipelineStage::drain()
+{
+    for (;;) {
+        std::unique_ptr<PipelineItem> item;
+        {
+            QMutexLocker locker(&mutex);
+            item = takeNext();
+            if (!item) {
+                --workers;
+                return;
+            }
+        }
+
+        if (item->skipped || engine->isCanceled()) {
+            item->skipped = true;
+            forward(std::move(item));
+            continue;
+        }
+
+#ifndef QT_NO_EXCEPTIONS
+        const qint64 sequence = item->sequence;
+        try {
+#endif
+            process(std::move(item));
+#ifndef QT_NO_EXCEPTIONS
+        } catch (...) {
+            engine->handleException();
+            // the item is gone with the exception, but serial stages after
+            // this one wait for its sequence number
+            auto skipped = std::make_unique<PipelineItem>();
+            skipped->sequence = sequence;
+            skipped->skipped = true;
+            forward(std::move(skipped));
+        }
+#endif
+    }
+}
+
+void PipelineStage::forward(std::unique_ptr<PipelineItem> item)
+{
+    if (next) {
+        next->push(std::move(item));
+    } else {
+        item.reset();
+        engine->retire();
+    }
+}
+
+PipelineEngine::PipelineEngine(std::vector<std::unique_ptr<PipelineStage>> stages,
+                               QThreadPool *pool, int priority, qsizetype capacity)
+    : stages(std::move(stages)),
+      threadPool(pool),
+      priority(priority),
+      capacity(capacity > 0 ? capacity : 4 * qMax(pool->maxThreadCount(), 1))
+{
+    Q_ASSERT(!this->stages.empty());
+    for (size_t i = 0; i < this->stages.size(); ++i) {
+        this->stages[i]->engine = this;
+        if (i + 1 < this->stages.size())
+            this->stages[i]->next = this->stages[i + 1].get();
+    }
+}
+
+PipelineEngine::~PipelineEngine()
+    = default;
+
+QFuture<void> PipelineEngine::start(std::shared_ptr<PipelineEngine> engine)
+{
+    engine->futureInterface.reportStarted();
+    QFuture<void> future = engine->futureInterface.future();
+    engine->scheduleSource();
+    return future;
+}
+
+void PipelineEngine::schedule(PipelineStage *stage)
+{
+    threadPool->start([self = shared_from_this(), stage] { stage->drain(); }, priority);
+}
+
+void PipelineEngine::scheduleSource()
+{
+    {
+        QMutexLocker locker(&mutex);
+        if (sourceRunning || sourceDone || inFlight >= capacity)
+            return;
+        sourceRunning = true;
+    }
+    threadPool->start([self = shared_from_this()] { self->runSource(); }, priority);
+}
+
+void PipelineEngine::runSource()
+{
+    for (;;) {
+        {
+            QMutexLocker locker(&mutex);
+            if (isCanceled())
+                sourceDone = true;
+            if (sourceDone || inFlight >= capacity) {
+                sourceRunning = false;
+                break;
+            }
+            ++inFlight;
+        }
+
+        std::unique_ptr<PipelineItem> item;
+#ifndef QT_NO_EXCEPTIONS
+        try {
+#endif
+            item = produce();
+#ifndef QT_NO_EXCEPTIONS
+        } catch (...) {
+            handleException();
+        }
+#endif
+        if (!item) {
+            QMutexLocker locker(&mutex);
+            --inFlight;
+            sourceDone = true;
+            sourceRunning = false;
+            break;
+        }
+
+        // only one thread runs the source at a time
+        item->sequence = nextSequence++;
+        stages.front()->push(std::move(item));
+    }
+
+    if (finishIfDone())
+        futureInterface.reportFinished();
+}
+
+// Called whenever an item leaves the pipeline.
+void PipelineEngine::retire()
+{
+    {
+        QMutexLocker locker(&mutex);
+        --inFlight;
+        if (isCanceled())
+            sourceDone = true;
+    }
+    if (finishIfDone())
+        futureInterface.reportFinished();
+    else
+        scheduleSource();
+}
+
+// Returns true if the pipeline has just become done, so that the caller
+// reports it; that happens once.
+bool PipelineEngine::finishIfDone()
+{
+    QMutexLocker locker(&mutex);
+    if (finished || !sourceDone || sourceRunning || inFlight > 0)
+        return false;
+    finished = true;
+    return true;
+}
+
+#ifndef QT_NO_EXCEPTIONS
+void PipelineEngine::handleException()
+{
+    // the first exception cancels the pipeline, so it is the one reported
+    futureInterface.reportException(std::current_exception());
+}
+#endif
+
+} // namespace QtConcurrent
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_CONCURRENT
@@ -0,0 +1,354 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QTCONCURRENT_PIPELINE_H
+#define QTCONCURRENT_PIPELINE_H
+
+#include <QtConcurrent/qtconcurrent_global.h>
+
+#if !defined(QT_NO_CONCURRENT) || defined(Q_QDOC)
+
+#include <QtCore/qfuture.h>
+#include <QtCore/qfutureinterface.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qthreadpool.h>
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+#ifdef Q_QDOC
+
+namespace QtConcurrent {
+
+template <typename Source, typename T>
+class QPipelineBuilder
+{
+public:
+    template <typename Function>
+    [[nodiscard]]
+    QPipelineBuilder<Source, ResultType> parallel(Function &&function);
+
+    template <typename Function>
+    [[nodiscard]]
+    QPipelineBuilder<Source, ResultType> serial(Function &&function);
+
+    [[nodiscard]]
+    QPipelineBuilder<Source, T> &onThreadPool(QThreadPool &newThreadPool);
+
+    [[nodiscard]]
+    QPipelineBuilder<Source, T> &withPriority(int newPriority);
+
+    [[nodiscard]]
+    QPipelineBuilder<Source, T> &withCapacity(qsizetype capacity);
+
+    QFuture<void> run();
+};
+
+template <typename Source>
+[[nodiscard]]
+QPipelineBuilder<Source, SourceType> pipeline(Source &&source);
+
+} // namespace QtConcurrent
+
+#else
+
+namespace QtConcurrent {
+
+class PipelineEngine;
+
+// One item on its way through a pipeline. Items are numbered in the order
+// the source produced them; serial stages process them in that order.
+// Skipped items, whose stage threw or that were dropped after a
+// cancellation, pass the remaining stages without being processed, so that
+// serial stages do not wait for their sequence numbers.
+struct Q_CONCURRENT_EXPORT PipelineItem
+{
+    virtual ~PipelineItem();
+    qint64 sequence = 0;
+    bool skipped = false;
+};
+
+template <typename T>
+struct PipelineValue : PipelineItem
+{
+    // empty once a stage filtered the item out
+    std::optional<T> value;
+};
+
+class Q_CONCURRENT_EXPORT PipelineStage
+{
+    Q_DISABLE_COPY_MOVE(PipelineStage)
+public:
+    enum Mode { Serial, Parallel };
+
+    explicit PipelineStage(Mode mode) : mode(mode) { }
+    virtual ~PipelineStage();
+
+    void push(std::unique_ptr<PipelineItem> item);
+
+protected:
+    // Runs the stage's function on the item and passes the result on with
+    // forward(). Items that a stage before filtered out pass as well.
+    virtual void process(std::unique_ptr<PipelineItem> item) = 0;
+    void forward(std::unique_ptr<PipelineItem> item);
+
+private:
+    friend class PipelineEngine;
+
+    std::unique_ptr<PipelineItem> takeNext();
+    void drain();
+
+    PipelineEngine *engine = nullptr;
+    PipelineStage *next = nullptr;
+    const Mode mode;
+
+    QBasicMutex mutex;
+    std::deque<std::unique_ptr<PipelineItem>> queue; // Parallel
+    std::map<qint64, std::unique_ptr<PipelineItem>> pending; // Serial, by sequence
+    qint64 nextSequence = 0;
+    int workers = 0;
+};
+
+class Q_CONCURRENT_EXPORT PipelineEngine : public std::enable_shared_from_this<PipelineEngine>
+{
+    Q_DISABLE_COPY_MOVE(PipelineEngine)
+public:
+    PipelineEngine(std::vector<std::unique_ptr<PipelineStage>> stages,
+                   QThreadPool *pool, int priority, qsizetype capacity);
+    virtual ~PipelineEngine();
+
+    static QFuture<void> start(std::shared_ptr<PipelineEngine> engine);
+
+protected:
+    // Returns the next item of the source, or nullptr at its end.
+    virtual std::unique_ptr<PipelineItem> produce() = 0;
+
+private:
+    friend class PipelineStage;
+
+    void schedule(PipelineStage *stage);
+    void scheduleSource();
+    void runSource();
+    void retire();
+    bool finishIfDone();
+    bool isCanceled() const { return futureInterface.isCanceled(); }
+#ifndef QT_NO_EXCEPTIONS
+    void handleException();
+#endif
+
+    QFutureInterface<void> futureInterface;
+    std::vector<std::unique_ptr<PipelineStage>> stages;
+    QThreadPool *const threadPool;
+    const int priority;
+    const qsizetype capacity;
+
+    QBasicMutex mutex;
+    qsizetype inFlight = 0;
+    qint64 nextSequence = 0;
+    bool sourceRunning = false;
+    bool sourceDone = false;
+    bool finished = false;
+};
+
+template <typename T>
+struct IsOptional : std::false_type
+{
+    using ValueType = T;
+};
+template <typename T>
+struct IsOptional<std::optional<T>> : std::true_type
+{
+    using ValueType = T;
+};
+
+// The type a stage passes on: stages may return std::optional to filter
+// items out.
+template <typename Function, typename T>
+struct PipelineStageResult
+{
+    using InvokeResult = std::invoke_result_t<std::decay_t<Function> &, T &&>;
+    using Type = typename IsOptional<InvokeResult>::ValueType;
+};
+
+template <typename T, typename U, typename Function>
+class PipelineFunctionStage : public PipelineStage
+{
+public:
+    template <typename F>
+    PipelineFunctionStage(Mode mode, F &&function)
+        : PipelineStage(mode), function(std::forward<F>(function))
+    { }
+
+protected:
+    void process(std::unique_ptr<PipelineItem> item) override
+    {
+        auto input = static_cast<PipelineValue<T> *>(item.get());
+
+        if constexpr (std::is_void_v<U>) {
+            if (input->value)
+                std::invoke(function, std::move(*input->value));
+            forward(std::move(item));
+        } else {
+            std::optional<U> result;
+            if (input->value)
+                result = std::invoke(function, std::move(*input->value));
+
+            if constexpr (std::is_same_v<T, U>) {
+                // reuse the item
+                input->value = std::move(result);
+                forward(std::move(item));
+            } else {
+                auto output = std::make_unique<PipelineValue<U>>();
+                output->sequence = input->sequence;
+                output->value = std::move(result);
+                item.reset();
+                forward(std::move(output));
+            }
+        }
+    }
+
+private:
+    Function function;
+};
+
+template <typename T, typename Source>
+class PipelineSourceEngine : public PipelineEngine
+{
+public:
+    template <typename S>
+    PipelineSourceEngine(S &&source, std::vector<std::unique_ptr<PipelineStage>> stages,
+                         QThreadPool *pool, int priority, qsizetype capacity)
+        : PipelineEngine(std::move(stages), pool, priority, capacity),
+          source(std::forward<S>(source))
+    { }
+
+protected:
+    std::unique_ptr<PipelineItem> produce() override
+    {
+        std::optional<T> value = std::invoke(source);
+        if (!value)
+            return nullptr;
+        auto item = std::make_unique<PipelineValue<T>>();
+        item->value = std::move(value);
+        return item;
+    }
+
+private:
+    Source source;
+};
+
+template <typename Source, typename T>
+class QPipelineBuilder
+{
+public:
+    template <typename Function>
+    [[nodiscard]]
+    auto parallel(Function &&function)
+    {
+        return addStage(PipelineStage::Parallel, std::forward<Function>(function));
+    }
+
+    template <typename Function>
+    [[nodiscard]]
+    auto serial(Function &&function)
+    {
+        return addStage(PipelineStage::Serial, std::forward<Function>(function));
+    }
+
+    [[nodiscard]]
+    auto &onThreadPool(QThreadPool &newThreadPool)
+    {
+        threadPool = &newThreadPool;
+        return *this;
+    }
+
+    [[nodiscard]]
+    auto &withPriority(int newPriority)
+    {
+        priority = newPriority;
+        return *this;
+    }
+
+    [[nodiscard]]
+    auto &withCapacity(qsizetype newCapacity)
+    {
+        Q_ASSERT(newCapacity > 0);
+        capacity = newCapacity;
+        return *this;
+    }
+
+    QFuture<void> run()
+    {
+        static_assert(std::is_void_v<T>,
+                      "The last stage of a pipeline must not return a value.");
+        using SourceType = typename std::invoke_result_t<Source &>::value_type;
+        return PipelineEngine::start(std::make_shared<PipelineSourceEngine<SourceType, Source>>(
+                std::move(source), std::move(stages),
+                threadPool ? threadPool : QThreadPool::globalInstance(), priority, capacity));
+    }
+
+private:
+    template <typename S>
+    explicit QPipelineBuilder(S &&source) : source(std::forward<S>(source)) { }
+
+    template <typename Function>
+    auto addStage(PipelineStage::Mode mode, Function &&function)
+    {
+        static_assert(!std::is_void_v<T>,
+                      "A pipeline cannot have stages after one that returns void.");
+        static_assert(std::is_invocable_v<std::decay_t<Function> &, T &&>,
+                      "The function of a stage must take the result of the stage before.");
+        using U = typename PipelineStageResult<Function, T>::Type;
+
+        QPipelineBuilder<Source, U> builder(std::move(*this));
+        builder.stages.push_back(
+                std::make_unique<PipelineFunctionStage<T, U, std::decay_t<Function>>>(
+                        mode, std::forward<Function>(function)));
+        return builder;
+    }
+
+    template <typename OtherT>
+    QPipelineBuilder(QPipelineBuilder<Source, OtherT> &&other)
+        : source(std::move(other.source)), stages(std::move(other.stages)),
+          threadPool(other.threadPool), priority(other.priority), capacity(other.capacity)
+    { }
+
+    template <typename S>
+    friend auto pipeline(S &&source);
+
+    template <typename S, typename OtherT>
+    friend class QPipelineBuilder;
+
+    Source source;
+    std::vector<std::unique_ptr<PipelineStage>> stages;
+    QThreadPool *threadPool = nullptr;
+    int priority = 0;
+    qsizetype capacity = 0; // the engine picks one
+};
+
+template <typename Source>
+[[nodiscard]]
+auto pipeline(Source &&source)
+{
+    using SourceResult = std::invoke_result_t<std::decay_t<Source> &>;
+    static_assert(IsOptional<SourceResult>::value,
+                  "The source of a pipeline must return std::optional.");
+    return QPipelineBuilder<std::decay_t<Source>, typename SourceResult::value_type>(
+            std::forward<Source>(source));
+}
+
+} // namespace QtConcurrent
+
+#endif // Q_QDOC
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_CONCURRENT
+
+#endif
@@ -15,7 +15,11 @@
 #include <QtCore/qthread.h>
 #include <QtCore/qthreadpool.h>
 
+#include <memory>
 #include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 QT_BEGIN_NAMESPACE
 
@@ -66,19 +70,36 @@ public:
 enum ReduceOption {
     UnorderedReduce = 0x1,
     OrderedReduce = 0x2,
-    SequentialReduce = 0x4
-    // ParallelReduce = 0x8
+    SequentialReduce = 0x4,
+    ParallelReduce = 0x8
 };
 Q_DECLARE_FLAGS(ReduceOptions, ReduceOption)
 #ifndef Q_QDOC
 Q_DECLARE_OPERATORS_FOR_FLAGS(ReduceOptions)
 #endif
-// supports both ordered and out-of-order reduction
+// supports both ordered and out-of-order reduction, and reduction into
+// per-thread partial results for ParallelReduce
 template <typename ReduceFunctor, typename ReduceResultType, typename T>
 class ReduceKernel
 {
     typedef QMap<int, IntermediateResults<T> > ResultsMap;
 
+    // ParallelReduce combines partial results with the reduce functor itself.
+    // Only do so when that is the call reduceResult() makes anyway: reduce
+    // functors are not necessarily SFINAE-friendly.
+    static constexpr bool canReduceInParallel =
+            std::is_same_v<ReduceResultType, T>
+            && std::is_copy_constructible_v<ReduceResultType>;
+
+    static ReduceOptions effectiveOptions(ReduceOptions options)
+    {
+        if (!(options & ParallelReduce))
+            return options;
+        if (!canReduceInParallel || (options & OrderedReduce))
+            return (options & ~ReduceOptions(ParallelReduce)) | UnorderedReduce;
+        return options;
+    }
+
     const ReduceOptions reduceOptions;
 
     QMutex mutex;
@@ -86,6 +107,9 @@ class ReduceKernel
     const int threadCount;
     ResultsMap resultsMap;
 
+    // ParallelReduce: the partial results not in use by a thread
+    std::vector<std::unique_ptr<ReduceResultType>> partialResults;
+
     bool canReduce(int begin) const
     {
         return (((reduceOptions & UnorderedReduce)
@@ -114,9 +138,53 @@ class ReduceKernel
         }
     }
 
+    void runParallelReduce(ReduceFunctor &reduce, const IntermediateResults<T> &result)
+    {
+        // only the partial result changes hands under the lock; the
+        // reduction itself runs concurrently with the other threads
+        std::unique_ptr<ReduceResultType> partial;
+        {
+            std::lock_guard<QMutex> locker(mutex);
+            if (!partialResults.empty()) {
+                partial = std::move(partialResults.back());
+                partialResults.pop_back();
+            }
+        }
+        if (partial) {
+            reduceResult(reduce, *partial, result);
+        } else if (!result.vector.isEmpty()) {
+            // a new partial result starts from the first value rather than
+            // from a default-constructed one, which need not be the
+            // identity of the reduction
+            partial = std::make_unique<ReduceResultType>(result.vector.at(0));
+            for (qsizetype i = 1; i < result.vector.size(); ++i)
+                std::invoke(reduce, *partial, result.vector.at(i));
+        } else {
+            return;
+        }
+
+        std::lock_guard<QMutex> locker(mutex);
+        partialResults.push_back(std::move(partial));
+    }
+
+    void finishParallelReduce(ReduceFunctor &reduce, ReduceResultType &r)
+    {
+        // combine the partial results pairwise, so that each of them takes
+        // part in about log2(n) reductions and partial results of similar
+        // size are reduced into each other
+        const size_t count = partialResults.size();
+        for (size_t step = 1; step < count; step *= 2) {
+            for (size_t i = 0; i + step < count; i += 2 * step)
+                std::invoke(reduce, *partialResults[i], std::as_const(*partialResults[i + step]));
+        }
+        if (count)
+            std::invoke(reduce, r, std::as_const(*partialResults.front()));
+        partialResults.clear();
+    }
+
 public:
     ReduceKernel(QThreadPool *pool, ReduceOptions _reduceOptions)
-        : reduceOptions(_reduceOptions), progress(0), resultsMapSize(0),
+        : reduceOptions(effectiveOptions(_reduceOptions)), progress(0), resultsMapSize(0),
           threadCount(std::max(pool->maxThreadCount(), 1))
     { }
 
@@ -124,6 +192,11 @@ public:
                    ReduceResultType &r,
                    const IntermediateResults<T> &result)
     {
+        if constexpr (canReduceInParallel) {
+            if (reduceOptions & ParallelReduce)
+                return runParallelReduce(reduce, result);
+        }
+
         std::unique_lock<QMutex> locker(mutex);
         if (!canReduce(result.begin)) {
             ++resultsMapSize;
@@ -182,6 +255,10 @@ public:
     // final reduction
     void finish(ReduceFunctor &reduce, ReduceResultType &r)
     {
+        if constexpr (canReduceInParallel) {
+            if (reduceOptions & ParallelReduce)
+                return finishParallelReduce(reduce, r);
+        }
         reduceResults(reduce, r, resultsMap);
     }
 
@@ -0,0 +1,453 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qtconcurrenttaskgraph.h"
+
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qfutureinterface.h>
+
+#include <atomic>
+#include <vector>
+
+#if !defined(QT_NO_CONCURRENT) || defined(Q_QDOC)
+
+QT_BEGIN_NAMESPACE
+
+namespace QtConcurrent {
+
+/*!
+    \class QtConcurrent::QTaskGraph
+    \inmodule QtConcurrent
+    \brief The QTaskGraph class runs tasks that depend on each other on a
+    thread pool.
+    \since 6.9
+    \ingroup thread
+
+    A task graph holds tasks, added with addTask(), and dependencies between
+    them, added with addDependency(). run() runs every task once, on the
+    global QThreadPool or the one set with onThreadPool(), and starts a task
+    as soon as all the tasks it depends on are done:
+
+    \code
+    QtConcurrent::QTaskGraph graph;
+    const auto load = graph.addTask([&] { data = loadData(); });
+    const auto index = graph.addTask([&] { buildIndex(data); });
+    const auto thumbnails = graph.addTask([&] { renderThumbnails(data); });
+    const auto save = graph.addTask([&] { saveAll(); });
+    graph.addDependency(index, load);
+    graph.addDependency(thumbnails, load);
+    graph.addDependency(save, index);
+    graph.addDependency(save, thumbnails);
+
+    QFuture<void> future = graph.run();
+    \endcode
+
+    The same can be done by chaining QFuture::then() and QtFuture::whenAll()
+    on futures from QtConcurrent::task(), but each of those creates a future
+    and a continuation. A task graph instead counts the dependencies that
+    are still running for each task, and needs no allocation per task or
+    dependency while it runs. When a task finishes, the thread that ran it
+    goes on with one of the tasks that became ready, the one with the
+    highest priority, and starts the others on the thread pool with
+    the priority given to addTask().
+
+    \section1 Cancellation and Exceptions
+
+    Canceling the future returned by run() lets the running tasks finish,
+    but no other task starts. If a task throws an exception, the run is
+    canceled in the same way, and the exception is rethrown by
+    QFuture::waitForFinished() and the other functions of QFuture that wait
+    for the run.
+
+    \section1 Timing
+
+    Once a run finished, timing() returns when each task started and
+    finished, relative to the start of the run, which helps finding the
+    tasks on the critical path of a graph.
+
+    \section1 Running a Graph More than Once
+
+    A graph can be run again once its previous run finished. Tasks and
+    dependencies added while the graph runs take effect in the next run.
+    Destroying a graph does not wait for its run to finish.
+
+    \sa QtConcurrent::task(), {Concurrent Task}
+*/
+
+/*!
+    \typedef QtConcurrent::QTaskGraph::Node
+
+    Identifies a task of the graph. The tasks are numbered in the order in
+    which they are added, starting from 0.
+*/
+
+/*!
+    \class QtConcurrent::QTaskGraph::NodeTiming
+    \inmodule QtConcurrent
+    \brief The NodeTiming struct holds the time a task of a QTaskGraph ran.
+
+    \sa QTaskGraph::timing()
+*/
+
+/*!
+    \variable QtConcurrent::QTaskGraph::NodeTiming::started
+
+    The time the task started, relative to the start of the run.
+*/
+
+/*!
+    \variable QtConcurrent::QTaskGraph::NodeTiming::finished
+
+    The time the task finished, relative to the start of the run.
+*/
+
+/*!
+    \variable QtConcurrent::QTaskGraph::NodeTiming::executed
+
+    Whether the task ran. It does not if the run was canceled before it
+    could start.
+*/
+
+/*!
+    \fn std::chrono::nanoseconds QtConcurrent::QTaskGraph::NodeTiming::duration() const
+
+    Returns the time the task took.
+*/
+
+namespace {
+
+struct TaskGraphTask
+{
+    std::shared_ptr<QRunnable> runnable;
+    int priority;
+};
+
+class TaskGraphRun
+{
+    Q_DISABLE_COPY_MOVE(TaskGraphRun)
+public:
+    using Node = QTaskGraph::Node;
+
+    explicit TaskGraphRun(const std::vector<TaskGraphTask> &tasks)
+        : nodes(new NodeState[tasks.size()]),
+          size(qsizetype(tasks.size())),
+          remaining(qsizetype(tasks.size()))
+    {
+        for (Node node = 0; node < size; ++node) {
+            nodes[node].task = tasks[node];
+            nodes[node].runner.graphRun = this;
+            nodes[node].runner.node = node;
+        }
+    }
+
+    void start(const std::vector<Node> &roots);
+    void execute(Node node);
+    void schedule(Node node) { pool->start(&nodes[node].runner, nodes[node].task.priority); }
+    void finish();
+
+    class Runner : public QRunnable
+    {
+    public:
+        Runner() { setAutoDelete(false); }
+        void run() override { graphRun->execute(node); }
+
+        TaskGraphRun *graphRun = nullptr;
+        Node node = 0;
+    };
+
+    struct NodeState
+    {
+        TaskGraphTask task;
+        std::atomic<qsizetype> pendingDependencies = 0;
+        QTaskGraph::NodeTiming timing;
+        Runner runner;
+    };
+
+    std::unique_ptr<NodeState[]> nodes;
+    const qsizetype size;
+    // the successors of node i are successors[successorOffsets[i]] up to
+    // successors[successorOffsets[i + 1]]
+    std::vector<qsizetype> successorOffsets;
+    std::vector<Node> successors;
+
+    QFutureInterface<void> futureInterface;
+    QThreadPool *pool = nullptr;
+    QElapsedTimer clock;
+    std::atomic<qsizetype> remaining;
+    // the run lives until its last task is done
+    std::shared_ptr<TaskGraphRun> keepAlive;
+};
+
+void TaskGraphRun::start(const std::vector<Node> &roots)
+{
+    futureInterface.reportStarted();
+    clock.start();
+    if (size == 0) {
+        finish();
+        return;
+    }
+    for (Node root : roots)
+        schedule(root);
+}
+
+void TaskGraphRun::execute(Node node)
+{
+    for (;;) {
+        NodeState &state = nodes[node];
+        if (!futureInterface.isCanceled()) {
+            state.timing.started = clock.durationElapsed();
+#ifndef QT_NO_EXCEPTIONS
+            try {
+#endif
+                if (state.task.runnable)
+                    state.task.runnable->run();
+#ifndef QT_NO_EXCEPTIONS
+            } catch (...) {
+                futureInterface.reportException(std::current_exception());
+            }
+#endif
+            state.timing.finished = clock.durationElapsed();
+            state.timing.executed = true;
+        }
+
+        // Go on with the ready successor with the highest priority in this
+        // thread, which saves a round trip through the pool's queue.
+        Node next = -1;
+        for (qsizetype i = successorOffsets[node]; i < successorOffsets[node + 1]; ++i) {
+            const Node successor = successors[i];
+            if (nodes[successor].pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                continue;
+            if (next < 0) {
+                next = successor;
+            } else if (nodes[successor].task.priority > nodes[next].task.priority) {
+                schedule(next);
+                next = successor;
+            } else {
+                schedule(successor);
+            }
+        }
+
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            Q_ASSERT(next < 0);
+            finish();
+            return;
+        }
+        if (next < 0)
+            return;
+        node = next;
+    }
+}
+
+void TaskGraphRun::finish()
+{
+    // may destroy the run once this function returns
+    const auto self = std::move(keepAlive);
+    futureInterface.reportFinished();
+}
+
+} // unnamed namespace
+
+class QTaskGraphPrivate
+{
+public:
+    std::vector<TaskGraphTask> tasks;
+    std::vector<std::pair<QTaskGraph::Node, QTaskGraph::Node>> dependencies; // (node, dependency)
+    QThreadPool *threadPool = nullptr;
+    std::shared_ptr<TaskGraphRun> lastRun;
+};
+
+/*!
+    Constructs an empty task graph.
+*/
+QTaskGraph::QTaskGraph()
+    : d(new QTaskGraphPrivate)
+{
+}
+
+/*!
+    Move-constructs a task graph from \a other. \a other can only be
+    assigned to or destroyed afterwards.
+*/
+QTaskGraph::QTaskGraph(QTaskGraph &&other) noexcept
+    : d(std::move(other.d))
+{
+}
+
+/*!
+    \fn QtConcurrent::QTaskGraph &QtConcurrent::QTaskGraph::operator=(QTaskGraph &&other)
+
+    Move-assigns \a other to this task graph. \a other can only be
+    assigned to or destroyed afterwards.
+*/
+
+/*!
+    \fn void QtConcurrent::QTaskGraph::swap(QTaskGraph &other)
+
+    Swaps this task graph with \a other.
+*/
+
+/*!
+    Destroys the task graph. A run of the graph that did not finish yet goes
+    on.
+*/
+QTaskGraph::~QTaskGraph()
+    = default;
+
+/*!
+    \fn template <typename Function> QtConcurrent::QTaskGraph::Node QtConcurrent::QTaskGraph::addTask(Function &&function, int priority)
+
+    Adds a task that calls \a function, which takes no arguments, and
+    returns its node. The task is started on the thread pool with
+    \a priority once the tasks it depends on are done.
+
+    \sa addDependency(), QThreadPool::start()
+*/
+
+QTaskGraph::Node QTaskGraph::addTaskImpl(QRunnable *task, int priority)
+{
+    Q_ASSERT(d);
+    d->tasks.push_back({ std::shared_ptr<QRunnable>(task), priority });
+    return Node(d->tasks.size() - 1);
+}
+
+/*!
+    Makes the task \a node wait for the task \a dependency to be done
+    before it starts.
+
+    The dependencies must not form a cycle; run() refuses to run a graph
+    whose dependencies do.
+*/
+void QTaskGraph::addDependency(Node node, Node dependency)
+{
+    Q_ASSERT(d);
+    Q_ASSERT_X(node >= 0 && node < size(), "QTaskGraph::addDependency", "node out of range");
+    Q_ASSERT_X(dependency >= 0 && dependency < size(), "QTaskGraph::addDependency",
+               "dependency out of range");
+    d->dependencies.emplace_back(node, dependency);
+}
+
+/*!
+    Returns the number of tasks in the graph.
+*/
+qsizetype QTaskGraph::size() const
+{
+    Q_ASSERT(d);
+    return qsizetype(d->tasks.size());
+}
+
+/*!
+    Sets the thread pool \a newThreadPool that the graph runs on. The
+    global thread pool is used by default.
+*/
+QTaskGraph &QTaskGraph::onThreadPool(QThreadPool &newThreadPool)
+{
+    Q_ASSERT(d);
+    d->threadPool = &newThreadPool;
+    return *this;
+}
+
+static QFuture<void> canceledFuture()
+{
+    QFutureInterface<void> futureInterface;
+    futureInterface.reportStarted();
+    futureInterface.reportCanceled();
+    futureInterface.reportFinished();
+    return futureInterface.future();
+}
+
+/*!
+    Runs the tasks of the graph and returns a future that finishes when
+    they are all done.
+
+    If the graph is still running, or if its dependencies form a cycle, a
+    warning is printed and a canceled future is returned.
+*/
+QFuture<void> QTaskGraph::run()
+{
+    Q_ASSERT(d);
+    if (isRunning()) {
+        qWarning("QTaskGraph::run: The graph is already running");
+        return canceledFuture();
+    }
+
+    auto graphRun = std::make_shared<TaskGraphRun>(d->tasks);
+    const qsizetype count = graphRun->size;
+
+    // store the successors of all nodes in one array
+    auto &offsets = graphRun->successorOffsets;
+    offsets.assign(count + 1, 0);
+    for (const auto &[node, dependency] : d->dependencies)
+        ++offsets[dependency + 1];
+    for (qsizetype i = 0; i < count; ++i)
+        offsets[i + 1] += offsets[i];
+    graphRun->successors.resize(d->dependencies.size());
+    std::vector<qsizetype> fill(offsets.cbegin(), offsets.cend() - 1);
+    std::vector<qsizetype> pending(count, 0);
+    for (const auto &[node, dependency] : d->dependencies) {
+        graphRun->successors[fill[dependency]++] = node;
+        ++pending[node];
+    }
+
+    std::vector<Node> roots;
+    for (Node node = 0; node < count; ++node) {
+        graphRun->nodes[node].pendingDependencies.store(pending[node], std::memory_order_relaxed);
+        if (pending[node] == 0)
+            roots.push_back(node);
+    }
+
+    // a graph without a cycle can be walked from its roots completely
+    std::vector<Node> ready = roots;
+    qsizetype visited = 0;
+    while (!ready.empty()) {
+        const Node node = ready.back();
+        ready.pop_back();
+        ++visited;
+        for (qsizetype i = offsets[node]; i < offsets[node + 1]; ++i) {
+            const Node successor = graphRun->successors[i];
+            if (--pending[successor] == 0)
+                ready.push_back(successor);
+        }
+    }
+    if (visited != count) {
+        qWarning("QTaskGraph::run: The dependencies of the graph form a cycle");
+        return canceledFuture();
+    }
+
+    graphRun->pool = d->threadPool ? d->threadPool : QThreadPool::globalInstance();
+    graphRun->keepAlive = graphRun;
+    d->lastRun = graphRun;
+
+    QFuture<void> future = graphRun->futureInterface.future();
+    graphRun->start(roots);
+    return future;
+}
+
+/*!
+    Returns \c true if the graph runs, that is if the future returned by the
+    last call to run() did not finish yet.
+*/
+bool QTaskGraph::isRunning() const
+{
+    Q_ASSERT(d);
+    return d->lastRun && !d->lastRun->futureInterface.isFinished();
+}
+
+/*!
+    Returns when the task \a node started and finished in the last run of
+    the graph. The result is only valid once the future returned by run()
+    finished; it is empty for tasks added after that call.
+*/
+QTaskGraph::NodeTiming QTaskGraph::timing(Node node) const
+{
+    Q_ASSERT(d);
+    Q_ASSERT_X(node >= 0 && node < size(), "QTaskGraph::timing", "node out of range");
+    if (!d->lastRun || node >= d->lastRun->size)
+        return {};
+    return d->lastRun->nodes[node].timing;
+}
+
+} // namespace QtConcurrent
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_CONCURRENT
@@ -0,0 +1,82 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QTCONCURRENT_TASKGRAPH_H
+#define QTCONCURRENT_TASKGRAPH_H
+
+#include <QtConcurrent/qtconcurrent_global.h>
+
+#if !defined(QT_NO_CONCURRENT) || defined(Q_QDOC)
+
+#include <QtCore/qfuture.h>
+#include <QtCore/qrunnable.h>
+#include <QtCore/qthreadpool.h>
+
+#include <chrono>
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+namespace QtConcurrent {
+
+class QTaskGraphPrivate;
+
+class Q_CONCURRENT_EXPORT QTaskGraph
+{
+public:
+    using Node = qsizetype;
+
+    struct NodeTiming
+    {
+        std::chrono::nanoseconds started{0};
+        std::chrono::nanoseconds finished{0};
+        bool executed = false;
+
+        std::chrono::nanoseconds duration() const noexcept { return finished - started; }
+    };
+
+    QTaskGraph();
+    QTaskGraph(QTaskGraph &&other) noexcept;
+    QT_MOVE_ASSIGNMENT_OPERATOR_IMPL_VIA_MOVE_AND_SWAP(QTaskGraph)
+    ~QTaskGraph();
+
+    void swap(QTaskGraph &other) noexcept { d.swap(other.d); }
+
+#ifdef Q_QDOC
+    template <typename Function>
+    Node addTask(Function &&function, int priority = 0);
+#else
+    template <typename Function,
+              std::enable_if_t<std::is_invocable_r_v<void, std::decay_t<Function> &>, bool> = true>
+    Node addTask(Function &&function, int priority = 0)
+    {
+        return addTaskImpl(QRunnable::create(std::forward<Function>(function)), priority);
+    }
+#endif
+    void addDependency(Node node, Node dependency);
+
+    qsizetype size() const;
+
+    QTaskGraph &onThreadPool(QThreadPool &newThreadPool);
+
+    [[nodiscard]]
+    QFuture<void> run();
+    bool isRunning() const;
+
+    NodeTiming timing(Node node) const;
+
+private:
+    Q_DISABLE_COPY(QTaskGraph)
+
+    Node addTaskImpl(QRunnable *task, int priority);
+
+    std::unique_ptr<QTaskGraphPrivate> d;
+};
+
+} // namespace QtConcurrent
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_CONCURRENT
+
+#endif
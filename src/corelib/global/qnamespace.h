@@ -1288,6 +1288,7 @@ namespace Qt {
         BlockingQueuedConnection,
         UniqueConnection =  0x80,
         SingleShotConnection = 0x100,
+        BatchedConnection = 0x200,
     };
 
     enum ShortcutContext {
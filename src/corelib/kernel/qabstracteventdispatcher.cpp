@@ -4,6 +4,7 @@
 #include "qabstracteventdispatcher.h"
 #include "qabstracteventdispatcher_p.h"
 #include "qabstractnativeeventfilter.h"
+#include "qeventdispatcherstatistics_p.h"
 
 #include "qthread.h"
 #include <private/qthread_p.h>
@@ -85,10 +86,22 @@ QAbstractEventDispatcherPrivate::QAbstractEventDispatcherPrivate()
     // See also QTBUG-58732.
     if (!timerIdFreeList.isDestroyed())
         (void)timerIdFreeList();
+
+    // dispatchers may get created in several threads at once; the
+    // initialization of a function-local static is thread-safe
+    static const bool statisticsFromEnvironment = [] {
+        const bool enabled = qEnvironmentVariableIntValue("QT_EVENT_DISPATCHER_STATISTICS") > 0;
+        if (enabled)
+            QEventDispatcherStatistics::setEnabled(true);
+        return enabled;
+    }();
+    Q_UNUSED(statisticsFromEnvironment);
 }
 
 QAbstractEventDispatcherPrivate::~QAbstractEventDispatcherPrivate()
-    = default;
+{
+    delete statistics.loadRelaxed();
+}
 
 int QAbstractEventDispatcherPrivate::allocateTimerId()
 {
@@ -24,6 +24,8 @@ QT_BEGIN_NAMESPACE
 
 Q_AUTOTEST_EXPORT qsizetype qGlobalPostedEventsCount();
 
+class QEventDispatcherStatistics;
+
 class Q_CORE_EXPORT QAbstractEventDispatcherPrivate : public QObjectPrivate
 {
     Q_DECLARE_PUBLIC(QAbstractEventDispatcher)
@@ -35,6 +37,9 @@ public:
 
     bool isV2 = false;
 
+    // created by QEventDispatcherStatistics::forDispatcher()
+    QAtomicPointer<QEventDispatcherStatistics> statistics;
+
     static int allocateTimerId();
     static void releaseTimerId(int id);
     static void releaseTimerId(Qt::TimerId id)
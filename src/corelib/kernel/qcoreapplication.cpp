@@ -9,6 +9,7 @@
 #include "qabstracteventdispatcher.h"
 #include "qcoreevent.h"
 #include "qcoreevent_p.h"
+#include "qeventdispatcherstatistics_p.h"
 #include "qeventloop.h"
 #endif
 #include "qmetaobject.h"
@@ -497,6 +498,7 @@ void QCoreApplicationPrivate::cleanupThreadData()
 
         // need to clear the state of the mainData, just in case a new QCoreApplication comes along.
         const auto locker = qt_scoped_lock(thisThreadData->postEventList.mutex);
+        thisThreadData->postEventList.takeInbox();
         for (const QPostEvent &pe : std::as_const(thisThreadData->postEventList)) {
             if (pe.event) {
                 --pe.receiver->d_func()->postedEvents;
@@ -1619,6 +1621,7 @@ QCoreApplicationPrivate::QPostEventListLocker QCoreApplicationPrivate::lockThrea
     if (!object) {
         locker.threadData = QThreadData::current();
         locker.locker = qt_unique_lock(locker.threadData->postEventList.mutex);
+        locker.threadData->postEventList.takeInbox();
         return locker;
     }
 
@@ -1641,9 +1644,46 @@ QCoreApplicationPrivate::QPostEventListLocker QCoreApplicationPrivate::lockThrea
     }
 
     Q_ASSERT(locker.threadData);
+    // events posted to the inbox come before any that the caller adds
+    locker.threadData->postEventList.takeInbox();
     return locker;
 }
 
+/*!
+    \internal
+    Like lockThreadPostEventList(), but instead of locking the post event list
+    of the thread \a object lives in, registers the caller as an inbox poster
+    of that list. The caller must then try QPostEventList::pushToInbox() and
+    call leave(). QObject::moveToThread() waits for the posters that
+    registered before it changed the object's thread, after it closed the
+    inbox. Returns a null threadData if the object is being destroyed.
+*/
+QCoreApplicationPrivate::QPostEventInboxPoster
+QCoreApplicationPrivate::enterThreadPostEventInbox(QObject *object)
+{
+    auto &threadData = QObjectPrivate::get(object)->threadData;
+
+    // if object has moved to another thread, follow it
+    for (;;) {
+        QPostEventInboxPoster poster;
+        poster.threadData = threadData.loadAcquire();
+        if (!poster.threadData) {
+            // destruction in progress
+            return { nullptr, nullptr };
+        }
+
+        QPostEventList &list = poster.threadData->postEventList;
+        const int epoch = list.inboxEpoch.loadAcquire();
+        poster.posters = &list.inboxPosters[epoch];
+        poster.posters->ref();
+        // pairs with the fence in QPostEventList::reopenInbox()
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (poster.threadData == threadData.loadAcquire() && epoch == list.inboxEpoch.loadAcquire())
+            return poster;
+        poster.leave();
+    }
+}
+
 /*!
     \since 4.3
 
@@ -1682,6 +1722,46 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
         return;
     }
 
+    // Queued signal emissions are never compressed and, with the default
+    // priority, always go to the end of the list. Push them onto the
+    // receiving thread's lock-free inbox instead of contending on the list's
+    // mutex with all other threads posting to the same thread.
+    if (event->type() == QEvent::MetaCall && priority == Qt::NormalEventPriority) {
+        // delete the event on exceptions to protect against memory leaks till the event is
+        // properly owned in the inbox
+        std::unique_ptr<QEvent> eventDeleter(event);
+        auto node = new QPostEventList::InboxNode{ QPostEvent(receiver, event, priority), nullptr };
+        Q_UNUSED(eventDeleter.release());
+
+        auto poster = QCoreApplicationPrivate::enterThreadPostEventInbox(receiver);
+        QThreadData *data = poster.threadData;
+        if (!data) {
+            // posting during destruction? just delete the event to prevent a leak
+            delete node;
+            delete event;
+            return;
+        }
+
+        event->m_posted = true;
+        ++receiver->d_func()->postedEvents;
+        const bool pushed = data->postEventList.pushToInbox(node);
+        QAbstractEventDispatcher *dispatcher = data->eventDispatcher.loadAcquire();
+        poster.leave();
+
+        if (pushed) {
+            // the event may have been delivered and deleted already
+            Q_TRACE(QCoreApplication_postEvent_event_posted, receiver, event, QEvent::MetaCall);
+            if (dispatcher)
+                dispatcher->wakeUp();
+            return;
+        }
+
+        // the inbox is closed while an object moves out of the thread
+        --receiver->d_func()->postedEvents;
+        event->m_posted = false;
+        delete node;
+    }
+
     auto locker = QCoreApplicationPrivate::lockThreadPostEventList(receiver);
     if (!locker.threadData) {
         // posting during destruction? just delete the event to prevent a leak
@@ -1801,6 +1881,7 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
     ++data->postEventList.recursion;
 
     auto locker = qt_unique_lock(data->postEventList.mutex);
+    data->postEventList.takeInbox();
 
     // by default, we assume that the event dispatcher can go to sleep after
     // processing all events. if any new events are posted while we send
@@ -1814,6 +1895,12 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
 
     data->canWait = true;
 
+    if (Q_UNLIKELY(QEventDispatcherStatistics::isEnabled()) && !receiver && !event_type
+        && data->hasEventDispatcher()) {
+        QEventDispatcherStatistics::forDispatcher(data->eventDispatcher.loadRelaxed())
+                ->recordQueueDepth(data->postEventList.size() - data->postEventList.startOffset);
+    }
+
     // okay. here is the tricky loop. be careful about optimizing
     // this, it looks the way it does for good reasons.
     qsizetype startOffset = data->postEventList.startOffset;
@@ -1949,7 +2036,18 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
         QScopedPointer<QEvent> event_deleter(e); // will delete the event (with the mutex unlocked)
 
         // after all that work, it's time to deliver the event.
-        QCoreApplication::sendEvent(r, e);
+        if (Q_UNLIKELY(QEventDispatcherStatistics::isEnabled()) && data->hasEventDispatcher()) {
+            auto statistics = QEventDispatcherStatistics::forDispatcher(data->eventDispatcher.loadRelaxed());
+            // r may be gone after the delivery
+            const QMetaObject *metaObject = r->metaObject();
+            const int type = e->type();
+            const auto start = std::chrono::steady_clock::now();
+            QCoreApplication::sendEvent(r, e);
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            statistics->recordDelivery(metaObject, type, std::chrono::nanoseconds(elapsed).count());
+        } else {
+            QCoreApplication::sendEvent(r, e);
+        }
 
         // careful when adding anything below this point - the
         // sendEvent() call might invalidate any invariants this
@@ -2045,6 +2143,7 @@ void QCoreApplicationPrivate::removePostedEvent(QEvent * event)
     QThreadData *data = QThreadData::current();
 
     const auto locker = qt_scoped_lock(data->postEventList.mutex);
+    data->postEventList.takeInbox();
 
     if (data->postEventList.size() == 0) {
 #if defined(QT_DEBUG)
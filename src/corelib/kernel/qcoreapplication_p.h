@@ -125,6 +125,14 @@ public:
         void unlock() { locker.unlock(); }
     };
     static QPostEventListLocker lockThreadPostEventList(QObject *object);
+    struct QPostEventInboxPoster
+    {
+        QThreadData *threadData;
+        QAtomicInt *posters;
+
+        void leave() { posters->deref(); }
+    };
+    static QPostEventInboxPoster enterThreadPostEventInbox(QObject *object);
 #endif // QT_NO_QOBJECT
 
     int &argc;
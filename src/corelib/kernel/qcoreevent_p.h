@@ -16,6 +16,7 @@
 //
 
 #include "QtCore/qcoreevent.h"
+#include "QtCore/private/qeventpool_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -26,6 +27,8 @@ class QDeferredDeleteEvent : public QEvent
     Q_DECL_EVENT_COMMON(QDeferredDeleteEvent)
 public:
     explicit QDeferredDeleteEvent(int loopLevel, int scopeLevel);
+    static void *operator new(size_t size) { return QEventPool::allocate(size); }
+    static void operator delete(void *ptr, size_t size) noexcept { QEventPool::release(ptr, size); }
     int loopLevel() const { return m_loopLevel; }
     int scopeLevel() const { return m_scopeLevel; }
 
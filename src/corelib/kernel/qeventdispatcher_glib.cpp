@@ -4,6 +4,7 @@
 #include "qeventdispatcher_glib_p.h"
 #include "qeventdispatcher_unix_p.h"
 
+#include <private/qeventdispatcherstatistics_p.h>
 #include <private/qnumeric_p.h>
 #include <private/qthread_p.h>
 
@@ -65,6 +66,7 @@ static gboolean socketNotifierSourceCheck(GSource *source)
 
 static gboolean socketNotifierSourceDispatch(GSource *source, GSourceFunc, gpointer)
 {
+    QEventDispatcherStatistics::PhaseTimer timer(QEventDispatcherStatistics::SocketNotifiers);
     QEvent event(QEvent::SockAct);
 
     GSocketNotifierSource *src = reinterpret_cast<GSocketNotifierSource *>(source);
@@ -148,6 +150,7 @@ static gboolean timerSourceDispatch(GSource *source, GSourceFunc, gpointer)
     if (timerSource->processEventsFlags & QEventLoop::X11ExcludeTimers)
         return true;
     timerSource->runWithIdlePriority = true;
+    QEventDispatcherStatistics::PhaseTimer timer(QEventDispatcherStatistics::Timers);
     (void) timerSource->timerList.activateTimers();
     return true; // ??? don't remove, right again?
 }
@@ -242,7 +245,10 @@ static gboolean postEventSourceDispatch(GSource *s, GSourceFunc, gpointer)
 {
     GPostEventSource *source = reinterpret_cast<GPostEventSource *>(s);
     source->lastSerialNumber = source->serialNumber.loadRelaxed();
-    QCoreApplication::sendPostedEvents();
+    {
+        QEventDispatcherStatistics::PhaseTimer timer(QEventDispatcherStatistics::PostedEvents);
+        QCoreApplication::sendPostedEvents();
+    }
     source->d->runTimersOnceWithNormalPriority();
     return true; // i dunno, george...
 }
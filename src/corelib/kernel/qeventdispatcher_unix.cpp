@@ -13,6 +13,7 @@
 #include <private/qthread_p.h>
 #include <private/qcoreapplication_p.h>
 #include <private/qcore_unix_p.h>
+#include <private/qeventdispatcherstatistics_p.h>
 
 #include <cstdio>
 
@@ -31,6 +32,10 @@ static constexpr bool UsingEventfd = false;
 #  include <pipeDrv.h>
 #endif
 
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+#  include <sys/epoll.h>
+#endif
+
 using namespace std::chrono;
 using namespace std::chrono_literals;
 
@@ -176,14 +181,146 @@ QEventDispatcherUNIXPrivate::QEventDispatcherUNIXPrivate()
 {
     if (Q_UNLIKELY(threadPipe.init() == false))
         qFatal("QEventDispatcherUNIXPrivate(): Cannot continue without a thread pipe");
+
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+    if (qEnvironmentVariableIntValue("QT_EVENT_DISPATCHER_EPOLL") > 0)
+        initEpoll();
+#endif
 }
 
 QEventDispatcherUNIXPrivate::~QEventDispatcherUNIXPrivate()
 {
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+    if (epollFd >= 0)
+        qt_safe_close(epollFd);
+#endif
+
     // cleanup timers
     timerList.clearTimers();
 }
 
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+/*
+    With the epoll backend, socket notifiers are registered once with a
+    persistent epoll(7) set when they are enabled and removed when they are
+    disabled, instead of being copied into pollfds on every iteration. The
+    epoll descriptor itself is then polled together with the thread pipe, so
+    the cost of a wakeup depends on the number of ready sockets only, while
+    timeouts keep the nanosecond precision of qt_safe_poll().
+*/
+static uint32_t toEpollEvents(short events)
+{
+    uint32_t result = 0;
+    if (events & POLLIN)
+        result |= EPOLLIN;
+    if (events & POLLOUT)
+        result |= EPOLLOUT;
+    if (events & POLLPRI)
+        result |= EPOLLPRI;
+    return result;
+}
+
+static short toPollEvents(uint32_t events)
+{
+    short result = 0;
+    if (events & EPOLLIN)
+        result |= POLLIN;
+    if (events & EPOLLOUT)
+        result |= POLLOUT;
+    if (events & EPOLLPRI)
+        result |= POLLPRI;
+    if (events & EPOLLERR)
+        result |= POLLERR;
+    if (events & EPOLLHUP)
+        result |= POLLHUP;
+    return result;
+}
+
+void QEventDispatcherUNIXPrivate::initEpoll()
+{
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd == -1)
+        qErrnoWarning("QEventDispatcherUNIXPrivate: Unable to create epoll set, using poll()");
+}
+
+void QEventDispatcherUNIXPrivate::disableEpoll()
+{
+    // Fall back to rebuilding pollfds from socketNotifiers, which always
+    // reflects the full set of registered notifiers.
+    qt_safe_close(epollFd);
+    epollFd = -1;
+}
+
+void QEventDispatcherUNIXPrivate::updateEpoll(int fd, short oldEvents, short newEvents)
+{
+    Q_ASSERT(epollFd >= 0);
+
+    if (oldEvents == newEvents)
+        return;
+
+    if (!newEvents) {
+        // ENOENT and EBADF are expected if the descriptor was closed before
+        // its notifiers were disabled: close() already removed it from the set
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        return;
+    }
+
+    epoll_event ev = {};
+    ev.events = toEpollEvents(newEvents);
+    ev.data.fd = fd;
+
+    int op = oldEvents ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    int ret = epoll_ctl(epollFd, op, fd, &ev);
+    if (ret == -1 && (errno == ENOENT || errno == EEXIST)) {
+        // the descriptor number was closed and reused behind our back
+        op = (op == EPOLL_CTL_ADD) ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+        ret = epoll_ctl(epollFd, op, fd, &ev);
+    }
+
+    if (ret == -1) {
+        // EBADF: an invalid descriptor can never become ready
+        if (errno == EBADF)
+            return;
+        // EPERM: regular files and directories do not support epoll, but
+        // poll() reports them as always ready
+        if (errno != EPERM)
+            qErrnoWarning("QEventDispatcherUNIX: epoll_ctl failed for socket %d, using poll()", fd);
+        disableEpoll();
+    }
+}
+
+void QEventDispatcherUNIXPrivate::readEpollEvents()
+{
+    Q_ASSERT(epollFd >= 0);
+
+    // pollfds only holds the entry for the epoll set itself at this point;
+    // replace it with one entry per ready socket
+    Q_ASSERT(pollfds.size() == 1 && pollfds.first().fd == epollFd);
+    const bool ready = pollfds.first().revents & POLLIN;
+    pollfds.clear();
+    if (!ready)
+        return;
+
+    // Read the events once: the epoll set is level-triggered, so asking
+    // again would report the same descriptors again. Any that did not fit
+    // stay ready and are picked up by the next iteration of the event loop,
+    // as epoll moves the reported ones to the back of its ready list.
+    constexpr int MaxEvents = 64;
+    epoll_event events[MaxEvents];
+    int n;
+    QT_EINTR_LOOP(n, epoll_wait(epollFd, events, MaxEvents, 0));
+    for (int i = 0; i < n; ++i) {
+        // skip stale registrations of descriptors that were closed
+        // while a dup() kept them alive in the epoll set
+        if (!socketNotifiers.contains(events[i].data.fd))
+            continue;
+        pollfd pfd = qt_make_pollfd(events[i].data.fd, 0);
+        pfd.revents = toPollEvents(events[i].events);
+        pollfds.append(pfd);
+    }
+}
+#endif // QT_EVENTDISPATCHER_UNIX_EPOLL
+
 void QEventDispatcherUNIXPrivate::setSocketNotifierPending(QSocketNotifier *notifier)
 {
     Q_ASSERT(notifier);
@@ -201,6 +338,11 @@ int QEventDispatcherUNIXPrivate::activateTimers()
 
 void QEventDispatcherUNIXPrivate::markPendingSocketNotifiers()
 {
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+    if (epollFd >= 0)
+        readEpollEvents();
+#endif
+
     for (const pollfd &pfd : std::as_const(pollfds)) {
         if (pfd.fd < 0 || pfd.revents == 0)
             continue;
@@ -361,7 +503,16 @@ void QEventDispatcherUNIX::registerSocketNotifier(QSocketNotifier *notifier)
         qWarning("%s: Multiple socket notifiers for same socket %d and type %s",
                  Q_FUNC_INFO, sockfd, socketType(type));
 
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+    const short oldEvents = sn_set.events();
+#endif
+
     sn_set.notifiers[type] = notifier;
+
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+    if (d->epollFd >= 0)
+        d->updateEpoll(sockfd, oldEvents, sn_set.events());
+#endif
 }
 
 void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
@@ -400,8 +551,17 @@ void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
         return;
     }
 
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+    const short oldEvents = sn_set.events();
+#endif
+
     sn_set.notifiers[type] = nullptr;
 
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+    if (d->epollFd >= 0)
+        d->updateEpoll(sockfd, oldEvents, sn_set.events());
+#endif
+
     if (sn_set.isEmpty())
         d->socketNotifiers.erase(i);
 }
@@ -415,7 +575,10 @@ bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
     emit awake();
 
     auto threadData = d->threadData.loadRelaxed();
-    QCoreApplicationPrivate::sendPostedEvents(nullptr, 0, threadData);
+    {
+        QEventDispatcherStatistics::PhaseTimer timer(QEventDispatcherStatistics::PostedEvents, this);
+        QCoreApplicationPrivate::sendPostedEvents(nullptr, 0, threadData);
+    }
 
     const bool include_timers = (flags & QEventLoop::X11ExcludeTimers) == 0;
     const bool include_notifiers = (flags & QEventLoop::ExcludeSocketNotifiers) == 0;
@@ -446,17 +609,30 @@ bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
     }
 
     d->pollfds.clear();
-    d->pollfds.reserve(1 + (include_notifiers ? d->socketNotifiers.size() : 0));
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+    if (include_notifiers && d->epollFd >= 0) {
+        d->pollfds.append(qt_make_pollfd(d->epollFd, POLLIN));
+    } else
+#endif
+    {
+        d->pollfds.reserve(1 + (include_notifiers ? d->socketNotifiers.size() : 0));
 
-    if (include_notifiers)
-        for (auto it = d->socketNotifiers.cbegin(); it != d->socketNotifiers.cend(); ++it)
-            d->pollfds.append(qt_make_pollfd(it.key(), it.value().events()));
+        if (include_notifiers)
+            for (auto it = d->socketNotifiers.cbegin(); it != d->socketNotifiers.cend(); ++it)
+                d->pollfds.append(qt_make_pollfd(it.key(), it.value().events()));
+    }
 
     // This must be last, as it's popped off the end below
     d->pollfds.append(d->threadPipe.prepare());
 
+    int pollResult;
+    {
+        QEventDispatcherStatistics::PhaseTimer timer(QEventDispatcherStatistics::Poll, this);
+        pollResult = qt_safe_poll(d->pollfds.data(), d->pollfds.size(), deadline);
+    }
+
     int nevents = 0;
-    switch (qt_safe_poll(d->pollfds.data(), d->pollfds.size(), deadline)) {
+    switch (pollResult) {
     case -1:
         qErrnoWarning("qt_safe_poll");
         if (QT_CONFIG(poll_exit_on_error))
@@ -466,13 +642,17 @@ bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
         break;
     default:
         nevents += d->threadPipe.check(d->pollfds.takeLast());
-        if (include_notifiers)
+        if (include_notifiers) {
+            QEventDispatcherStatistics::PhaseTimer timer(QEventDispatcherStatistics::SocketNotifiers, this);
             nevents += d->activateSocketNotifiers();
+        }
         break;
     }
 
-    if (include_timers)
+    if (include_timers) {
+        QEventDispatcherStatistics::PhaseTimer timer(QEventDispatcherStatistics::Timers, this);
         nevents += d->activateTimers();
+    }
 
     // return true if we handled events, false otherwise
     return (nevents > 0);
@@ -23,6 +23,10 @@
 #include "QtCore/qhash.h"
 #include "private/qtimerinfo_unix_p.h"
 
+#if defined(Q_OS_LINUX) && __has_include(<sys/epoll.h>)
+#  define QT_EVENTDISPATCHER_UNIX_EPOLL
+#endif
+
 QT_BEGIN_NAMESPACE
 
 class QEventDispatcherUNIXPrivate;
@@ -103,6 +107,17 @@ public:
     int activateSocketNotifiers();
     void setSocketNotifierPending(QSocketNotifier *notifier);
 
+#ifdef QT_EVENTDISPATCHER_UNIX_EPOLL
+    void initEpoll();
+    void updateEpoll(int fd, short oldEvents, short newEvents);
+    void readEpollEvents();
+    void disableEpoll();
+
+    // persistent epoll(7) set holding all registered socket notifiers,
+    // or -1 if notifiers are polled by rebuilding pollfds every iteration
+    int epollFd = -1;
+#endif
+
     QThreadPipe threadPipe;
     QList<pollfd> pollfds;
 
@@ -0,0 +1,176 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qeventdispatcherstatistics_p.h"
+
+#include "qabstracteventdispatcher.h"
+#include "qabstracteventdispatcher_p.h"
+#include "qalgorithms.h"
+#include "qmetaobject.h"
+#include <private/qthread_p.h>
+
+#include <qtcore_tracepoints_p.h>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+Q_TRACE_POINT(qtcore, QEventDispatcher_phase, int phase, qint64 nsecs);
+Q_TRACE_POINT(qtcore, QEventDispatcher_postedEvents, qint64 queueDepth);
+Q_TRACE_POINT(qtcore, QEventDispatcher_eventDelivered, const char *className, int eventType, qint64 nsecs);
+
+/*!
+    \internal
+    \class QEventDispatcherStatistics
+    \inmodule QtCore
+
+    Collects per-thread measurements of an event loop: how long each
+    iteration spends polling, activating timers, delivering posted events
+    and activating socket notifiers; how many posted events are pending
+    when a delivery pass starts; and which receiver classes take the most
+    time to handle their posted events.
+
+    Each event dispatcher owns one instance, created on first use; see
+    forDispatcher(). The event dispatchers and
+    QCoreApplicationPrivate::sendPostedEvents() feed it, but only while
+    recording is enabled with setEnabled() or by setting the
+    \c QT_EVENT_DISPATCHER_STATISTICS environment variable to 1. Every
+    measurement is also emitted as a tracepoint, so that a tracing backend
+    such as the CTF plugin can record them over time.
+
+    Durations are in nanoseconds, and are collected in histograms with
+    power-of-two buckets.
+*/
+
+Q_CONSTINIT QBasicAtomicInteger<bool> QEventDispatcherStatistics::enabled = Q_BASIC_ATOMIC_INITIALIZER(false);
+
+void QEventDispatcherStatistics::Histogram::add(quint64 value) noexcept
+{
+    const int bucket = std::min(64 - int(qCountLeadingZeroBits(value)), BucketCount - 1);
+    ++buckets[bucket];
+    ++count;
+    sum += value;
+    max = std::max(max, value);
+}
+
+/*!
+    \internal
+    Returns an upper bound for the value below which \a fraction of the
+    samples fall, within the resolution of the buckets.
+*/
+quint64 QEventDispatcherStatistics::Histogram::percentile(double fraction) const noexcept
+{
+    if (!count)
+        return 0;
+    const quint64 rank = std::max<quint64>(1, quint64(fraction * count + 0.5));
+    quint64 seen = 0;
+    for (int i = 0; i < BucketCount; ++i) {
+        seen += buckets[i];
+        if (seen >= rank)
+            return i ? std::min(max, (quint64(1) << i) - 1) : 0;
+    }
+    return max;
+}
+
+void QEventDispatcherStatistics::setEnabled(bool enable) noexcept
+{
+    enabled.storeRelaxed(enable);
+}
+
+/*!
+    \internal
+    Returns the statistics of \a dispatcher, creating them if necessary.
+*/
+QEventDispatcherStatistics *QEventDispatcherStatistics::forDispatcher(QAbstractEventDispatcher *dispatcher)
+{
+    auto d = QAbstractEventDispatcherPrivate::get(dispatcher);
+    QEventDispatcherStatistics *statistics = d->statistics.loadAcquire();
+    if (statistics)
+        return statistics;
+    auto created = new QEventDispatcherStatistics;
+    if (d->statistics.testAndSetOrdered(nullptr, created, statistics))
+        return created;
+    delete created;
+    return statistics;
+}
+
+void QEventDispatcherStatistics::recordPhase(Phase phase, qint64 nsecs)
+{
+    Q_TRACE(QEventDispatcher_phase, int(phase), nsecs);
+    QMutexLocker locker(&mutex);
+    data.phases[phase].add(quint64(nsecs));
+}
+
+void QEventDispatcherStatistics::recordQueueDepth(qsizetype depth)
+{
+    Q_TRACE(QEventDispatcher_postedEvents, qint64(depth));
+    QMutexLocker locker(&mutex);
+    data.queueDepth.add(quint64(depth));
+}
+
+void QEventDispatcherStatistics::recordDelivery(const QMetaObject *metaObject, int eventType,
+                                                qint64 nsecs)
+{
+    Q_TRACE(QEventDispatcher_eventDelivered, metaObject->className(), eventType, nsecs);
+    Q_UNUSED(eventType);
+    QMutexLocker locker(&mutex);
+    data.delivery.add(quint64(nsecs));
+    ReceiverStatistics &r = receivers[metaObject];
+    r.metaObject = metaObject;
+    ++r.count;
+    r.totalNSecs += quint64(nsecs);
+    r.maxNSecs = std::max(r.maxNSecs, quint64(nsecs));
+}
+
+/*!
+    \internal
+    Returns a copy of the data collected so far, with the \a maxReceivers
+    receiver classes that spent the most time handling posted events.
+*/
+QEventDispatcherStatistics::Snapshot QEventDispatcherStatistics::snapshot(qsizetype maxReceivers) const
+{
+    QMutexLocker locker(&mutex);
+    Snapshot result = data;
+    result.slowestReceivers.reserve(receivers.size());
+    for (const ReceiverStatistics &r : receivers)
+        result.slowestReceivers.append(r);
+    locker.unlock();
+
+    auto slower = [](const ReceiverStatistics &lhs, const ReceiverStatistics &rhs) {
+        return lhs.totalNSecs > rhs.totalNSecs;
+    };
+    const qsizetype n = std::min(maxReceivers, result.slowestReceivers.size());
+    std::partial_sort(result.slowestReceivers.begin(), result.slowestReceivers.begin() + n,
+                      result.slowestReceivers.end(), slower);
+    result.slowestReceivers.resize(n);
+    return result;
+}
+
+void QEventDispatcherStatistics::reset()
+{
+    QMutexLocker locker(&mutex);
+    data = Snapshot();
+    receivers.clear();
+}
+
+void QEventDispatcherStatistics::PhaseTimer::start(QAbstractEventDispatcher *dispatcher)
+{
+    if (!dispatcher) {
+        QThreadData *threadData = QThreadData::current(false);
+        if (!threadData)
+            return;
+        dispatcher = threadData->eventDispatcher.loadRelaxed();
+        if (!dispatcher)
+            return;
+    }
+    statistics = forDispatcher(dispatcher);
+    startTime = std::chrono::steady_clock::now();
+}
+
+void QEventDispatcherStatistics::PhaseTimer::finish()
+{
+    const auto elapsed = std::chrono::steady_clock::now() - startTime;
+    statistics->recordPhase(phase, std::chrono::nanoseconds(elapsed).count());
+}
+
+QT_END_NAMESPACE
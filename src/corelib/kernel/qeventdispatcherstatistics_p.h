@@ -0,0 +1,125 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QEVENTDISPATCHERSTATISTICS_P_H
+#define QEVENTDISPATCHERSTATISTICS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qatomic.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qmutex.h>
+
+#include <array>
+#include <chrono>
+
+QT_BEGIN_NAMESPACE
+
+class QAbstractEventDispatcher;
+struct QMetaObject;
+
+// Measures where the event loop of a thread spends its time. Recording is
+// off by default; see setEnabled().
+class Q_CORE_EXPORT QEventDispatcherStatistics
+{
+    Q_DISABLE_COPY_MOVE(QEventDispatcherStatistics)
+public:
+    enum Phase {
+        Poll,               // blocked waiting for events
+        Timers,             // activating timers
+        PostedEvents,       // delivering posted events
+        SocketNotifiers,    // activating socket notifiers
+        PhaseCount
+    };
+
+    struct Histogram
+    {
+        // bucket 0 counts zeros, bucket i > 0 the values in [2^(i-1), 2^i)
+        static constexpr int BucketCount = 48;
+        std::array<quint64, BucketCount> buckets = {};
+        quint64 count = 0;
+        quint64 sum = 0;
+        quint64 max = 0;
+
+        void add(quint64 value) noexcept;
+        quint64 percentile(double fraction) const noexcept;
+    };
+
+    struct ReceiverStatistics
+    {
+        const QMetaObject *metaObject = nullptr;
+        quint64 count = 0;
+        quint64 totalNSecs = 0;
+        quint64 maxNSecs = 0;
+    };
+
+    struct Snapshot
+    {
+        std::array<Histogram, PhaseCount> phases;   // nanoseconds per phase
+        Histogram delivery;                         // nanoseconds per posted event
+        Histogram queueDepth;                       // pending posted events per pass
+        QList<ReceiverStatistics> slowestReceivers; // by total time, descending
+    };
+
+    QEventDispatcherStatistics() = default;
+
+    static bool isEnabled() noexcept { return enabled.loadRelaxed(); }
+    static void setEnabled(bool enable) noexcept;
+    static QEventDispatcherStatistics *forDispatcher(QAbstractEventDispatcher *dispatcher);
+
+    void recordPhase(Phase phase, qint64 nsecs);
+    void recordQueueDepth(qsizetype depth);
+    void recordDelivery(const QMetaObject *metaObject, int eventType, qint64 nsecs);
+
+    Snapshot snapshot(qsizetype maxReceivers = 10) const;
+    void reset();
+
+    // Records the time from construction to destruction as \a phase of the
+    // given dispatcher, or the current thread's if that is null.
+    class PhaseTimer
+    {
+        Q_DISABLE_COPY_MOVE(PhaseTimer)
+    public:
+        explicit PhaseTimer(Phase phase, QAbstractEventDispatcher *dispatcher = nullptr)
+            : phase(phase)
+        {
+            if (Q_UNLIKELY(isEnabled()))
+                start(dispatcher);
+        }
+        ~PhaseTimer()
+        {
+            if (Q_UNLIKELY(statistics))
+                finish();
+        }
+
+    private:
+        void start(QAbstractEventDispatcher *dispatcher);
+        void finish();
+
+        QEventDispatcherStatistics *statistics = nullptr;
+        std::chrono::steady_clock::time_point startTime;
+        Phase phase;
+    };
+
+private:
+    mutable QMutex mutex;
+    Snapshot data;
+    QHash<const QMetaObject *, ReceiverStatistics> receivers;
+
+    Q_CONSTINIT static QBasicAtomicInteger<bool> enabled;
+};
+
+QT_END_NAMESPACE
+
+#endif // QEVENTDISPATCHERSTATISTICS_P_H
@@ -0,0 +1,259 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qeventpool_p.h"
+
+#include <QtCore/qatomic.h>
+#include <QtCore/private/qfreelist_p.h>
+
+#include <new>
+#include <utility>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+    \class QEventPool
+    \inmodule QtCore
+
+    A slab allocator for internal event types that are allocated and deleted
+    at a high rate, typically in different threads.
+
+    Memory comes in slots of a few fixed sizes, kept in one QFreeList per
+    size. Each thread caches a number of released slots, so that allocating
+    and releasing usually do not touch any shared state. A thread whose
+    cache is full returns slots to the free list, where other threads pick
+    them up; this balances producer threads, which only allocate, with
+    consumer threads, which only release.
+
+    Requests larger than the largest slot, and requests made while all slots
+    are in use, are passed on to operator new. When building with
+    AddressSanitizer, everything is.
+*/
+
+namespace {
+
+// the object lives at the start of the slot, followed by the free list id,
+// or -1 if the slot was allocated with operator new
+template <size_t Size>
+struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) EventSlot
+{
+    char storage[Size];
+    int id;
+};
+
+struct EventPoolConstants : QFreeListDefaultConstants
+{
+    enum { BlockCount = 4, MaxIndex = 256 + 2048 + 16384 + 131072 };
+    static const int Sizes[BlockCount];
+};
+
+Q_CONSTINIT const int EventPoolConstants::Sizes[EventPoolConstants::BlockCount] = {
+    256,
+    2048,
+    16384,
+    131072
+};
+
+template <size_t Size>
+class EventSlotPool
+{
+public:
+    using Slot = EventSlot<Size>;
+
+    // Returns a slot from the free list, or nullptr if all are in use. The
+    // free list cannot tell when it is exhausted, hence the counter.
+    Slot *take()
+    {
+        if (inUse.fetchAndAddRelaxed(1) >= EventPoolConstants::MaxIndex) {
+            inUse.deref();
+            return nullptr;
+        }
+        const int id = freeList.next();
+        Slot *slot = &freeList[id];
+        slot->id = id;
+        return slot;
+    }
+
+    Slot *at(int id) { return &freeList[id]; }
+
+    void release(int id)
+    {
+        freeList.release(id);
+        inUse.deref();
+    }
+
+private:
+    QFreeList<Slot, EventPoolConstants> freeList;
+    QAtomicInt inUse;
+};
+
+enum { SmallSlotSize = 64, LargeSlotSize = 192 };
+Q_CONSTINIT static EventSlotPool<SmallSlotSize> smallPool;
+Q_CONSTINIT static EventSlotPool<LargeSlotSize> largePool;
+
+Q_CONSTINIT static QBasicAtomicInteger<quint64> totalHits = Q_BASIC_ATOMIC_INITIALIZER(0);
+Q_CONSTINIT static QBasicAtomicInteger<quint64> totalMisses = Q_BASIC_ATOMIC_INITIALIZER(0);
+Q_CONSTINIT static QBasicAtomicInteger<quint64> totalUnpooled = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+struct ThreadCache
+{
+    enum { Capacity = 64, FlushInterval = 1024 };
+
+    struct Ids
+    {
+        int count = 0;
+        int ids[Capacity];
+    };
+
+    Ids small;
+    Ids large;
+
+    // not yet added to the totals
+    quint64 hits = 0;
+    quint64 misses = 0;
+    quint64 unpooled = 0;
+    uint operations = 0;
+
+    void countOperation()
+    {
+        if (++operations == FlushInterval)
+            flushStatistics();
+    }
+
+    void flushStatistics()
+    {
+        totalHits.fetchAndAddRelaxed(std::exchange(hits, 0));
+        totalMisses.fetchAndAddRelaxed(std::exchange(misses, 0));
+        totalUnpooled.fetchAndAddRelaxed(std::exchange(unpooled, 0));
+        operations = 0;
+    }
+
+    ~ThreadCache();
+};
+
+// the cache must not be used once its destructor has run, which can happen
+// when other thread_local objects release events while being destroyed
+Q_CONSTINIT static thread_local bool threadCacheDestroyed = false;
+static thread_local ThreadCache threadCache;
+
+ThreadCache::~ThreadCache()
+{
+    while (small.count)
+        smallPool.release(small.ids[--small.count]);
+    while (large.count)
+        largePool.release(large.ids[--large.count]);
+    flushStatistics();
+    threadCacheDestroyed = true;
+}
+
+template <size_t Size>
+void *allocateSlot(EventSlotPool<Size> &pool, ThreadCache::Ids ThreadCache::*ids)
+{
+    if (!threadCacheDestroyed) {
+        ThreadCache &cache = threadCache;
+        ThreadCache::Ids &cached = cache.*ids;
+        cache.countOperation();
+        if (cached.count) {
+            ++cache.hits;
+            return pool.at(cached.ids[--cached.count]);
+        }
+        if (auto slot = pool.take()) {
+            ++cache.misses;
+            return slot;
+        }
+        ++cache.unpooled;
+    } else if (auto slot = pool.take()) {
+        totalMisses.fetchAndAddRelaxed(1);
+        return slot;
+    } else {
+        totalUnpooled.fetchAndAddRelaxed(1);
+    }
+
+    auto slot = new EventSlot<Size>;
+    slot->id = -1;
+    return slot;
+}
+
+template <size_t Size>
+void releaseSlot(EventSlotPool<Size> &pool, ThreadCache::Ids ThreadCache::*ids, void *ptr)
+{
+    auto slot = static_cast<EventSlot<Size> *>(ptr);
+    if (slot->id < 0) {
+        delete slot;
+        return;
+    }
+
+    if (!threadCacheDestroyed) {
+        ThreadCache::Ids &cached = threadCache.*ids;
+        if (cached.count < ThreadCache::Capacity) {
+            cached.ids[cached.count++] = slot->id;
+            return;
+        }
+    }
+    pool.release(slot->id);
+}
+
+} // unnamed namespace
+
+/*!
+    \internal
+
+    Returns memory for an object of \a size bytes.
+*/
+void *QEventPool::allocate(size_t size)
+{
+#ifndef QT_ASAN_ENABLED
+    if (size <= SmallSlotSize)
+        return allocateSlot(smallPool, &ThreadCache::small);
+    if (size <= LargeSlotSize)
+        return allocateSlot(largePool, &ThreadCache::large);
+    if (!threadCacheDestroyed) {
+        ++threadCache.unpooled;
+        threadCache.countOperation();
+    }
+#endif
+    return ::operator new(size);
+}
+
+/*!
+    \internal
+
+    Releases \a ptr, which must have been returned by allocate() with the
+    same \a size. The thread calling this function does not need to be the
+    one that allocated it.
+*/
+void QEventPool::release(void *ptr, size_t size) noexcept
+{
+    if (!ptr)
+        return;
+#ifndef QT_ASAN_ENABLED
+    if (size <= SmallSlotSize)
+        return releaseSlot(smallPool, &ThreadCache::small, ptr);
+    if (size <= LargeSlotSize)
+        return releaseSlot(largePool, &ThreadCache::large, ptr);
+#endif
+    ::operator delete(ptr, size);
+}
+
+/*!
+    \internal
+
+    Returns the number of allocations so far that were served from a
+    thread's cache, from the shared free lists, or by operator new. The
+    counts of other threads are updated periodically, so they may lag
+    behind by a few hundred allocations each.
+*/
+QEventPool::Statistics QEventPool::statistics()
+{
+    if (!threadCacheDestroyed)
+        threadCache.flushStatistics();
+
+    Statistics result;
+    result.hits = totalHits.loadRelaxed();
+    result.misses = totalMisses.loadRelaxed();
+    result.unpooled = totalUnpooled.loadRelaxed();
+    return result;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,42 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QEVENTPOOL_P_H
+#define QEVENTPOOL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+
+QT_BEGIN_NAMESPACE
+
+// Recycles the memory of short-lived internal objects such as posted events.
+// Classes opt in by forwarding their operator new and operator delete here.
+class Q_CORE_EXPORT QEventPool
+{
+public:
+    struct Statistics
+    {
+        quint64 hits = 0;       // served from the calling thread's cache
+        quint64 misses = 0;     // taken from the shared free list
+        quint64 unpooled = 0;   // too large, or the pool was exhausted
+    };
+
+    static void *allocate(size_t size);
+    static void release(void *ptr, size_t size) noexcept;
+
+    static Statistics statistics();
+};
+
+QT_END_NAMESPACE
+
+#endif // QEVENTPOOL_P_H
@@ -23,6 +23,7 @@
 #include <private/qthread_p.h>
 #include <qdebug.h>
 #include <qvarlengtharray.h>
+#include <qpointer.h>
 #include <qscopeguard.h>
 #include <qset.h>
 #if QT_CONFIG(thread)
@@ -287,6 +288,7 @@ inline void QObjectPrivate::addConnection(int signal, Connection *c)
     c->id = ++cd->currentConnectionId;
     c->prevConnectionList = connectionList.last.loadRelaxed();
     connectionList.last.storeRelaxed(c);
+    cd->invalidateConnectionArray(connectionList);
 
     QObjectPrivate *rd = QObjectPrivate::get(c->receiver.loadRelaxed());
     rd->ensureConnectionData();
@@ -339,6 +341,7 @@ void QObjectPrivate::ConnectionData::removeConnection(QObjectPrivate::Connection
     if (c->prevConnectionList)
         c->prevConnectionList->nextConnectionList.storeRelaxed(n);
     c->prevConnectionList = nullptr;
+    invalidateConnectionArray(connections);
 
     Q_ASSERT(c != static_cast<Connection *>(orphaned.load(std::memory_order_relaxed)));
     // add c to orphanedConnections
@@ -392,10 +395,31 @@ void QObjectPrivate::ConnectionData::cleanOrphanedConnectionsImpl(QObject *sende
     }
 }
 
+/*!
+  \internal
+  Returns the connection array for \a signal, creating it if needed.
+
+  Must be called while the connection data is referenced, as the array is only
+  guaranteed to stay alive until the orphaned objects are cleaned up.
+*/
+const QObjectPrivate::ConnectionArray *
+QObjectPrivate::ConnectionData::connectionArray(QObject *sender, int signal)
+{
+    QMutexLocker locker(signalSlotLock(sender));
+    ConnectionList &list = connectionsForSignal(signal);
+    ConnectionArray *array = list.array.loadRelaxed();
+    if (!array) {
+        array = ConnectionArray::create(list);
+        list.array.storeRelease(array);
+    }
+    return array;
+}
+
 inline void QObjectPrivate::ConnectionData::deleteOrphaned(TaggedSignalVector o)
 {
     while (o) {
         TaggedSignalVector next = nullptr;
+        // signal vectors and connection arrays are both plain malloc()ed blocks
         if (SignalVector *v = static_cast<SignalVector *>(o)) {
             next = v->nextInOrphanList;
             free(v);
@@ -1146,8 +1170,118 @@ QObject::~QObject()
         d->setParent_helper(nullptr);
 }
 
+/*!
+    \internal
+
+    The calls collected for a connection made with Qt::BatchedConnection.
+    Until its event is delivered, the connection's pendingBatch points to it
+    and further emissions append their arguments instead of posting an
+    event each; pendingBatch is guarded by the signalSlotLock() of the
+    receiver. The arguments of each call are copied into one block of
+    memory laid out by the argument types.
+
+    Copying the arguments runs their copy constructors, which must not run
+    under the lock, so an emission copies them into a batch of its own
+    first, and then moves the call over to the pending batch with splice().
+
+    The batch is shared by the connection and the event; a reference count
+    of 1 while it is pending means that the event was discarded.
+*/
+class QMetaCallBatch
+{
+    Q_DISABLE_COPY_MOVE(QMetaCallBatch)
+public:
+    // followed by the arguments, at offsets
+    struct Call
+    {
+        Call *next;
+    };
+
+    QMetaCallBatch(const int *argumentTypes, int nargs);
+    ~QMetaCallBatch();
+    void deref()
+    {
+        if (!ref.deref())
+            delete this;
+    }
+
+    void append(void **argv);
+    void splice(QMetaCallBatch &other) noexcept;
+
+    // nullptr for signals without arguments
+    const Call *firstCall() const noexcept { return first; }
+    void *argument(const Call *call, int n) const
+    {
+        return const_cast<char *>(reinterpret_cast<const char *>(call)) + offsets[n];
+    }
+
+    QAtomicInt ref = 1;
+    int nargs;
+    qsizetype count = 0;
+
+private:
+    QVarLengthArray<QMetaType, 4> types;    // types[0] is the return type
+    QVarLengthArray<size_t, 4> offsets;     // of each argument within a call
+    size_t size = sizeof(Call);
+    size_t alignment = alignof(Call);
+    Call *first = nullptr;
+    Call **last = &first;
+};
+
+QMetaCallBatch::QMetaCallBatch(const int *argumentTypes, int nargs)
+    : nargs(nargs), types(nargs), offsets(nargs)
+{
+    offsets[0] = 0;
+    for (int n = 1; n < nargs; ++n) {
+        types[n] = QMetaType(argumentTypes[n - 1]);
+        const size_t align = types[n].alignOf();
+        alignment = qMax(alignment, align);
+        size = (size + align - 1) & ~(align - 1);
+        offsets[n] = size;
+        size += types[n].sizeOf();
+    }
+    size = (size + alignment - 1) & ~(alignment - 1);
+}
+
+QMetaCallBatch::~QMetaCallBatch()
+{
+    while (Call *call = first) {
+        first = call->next;
+        for (int n = 1; n < nargs; ++n)
+            types[n].destruct(argument(call, n));
+        ::operator delete(call, std::align_val_t(alignment));
+    }
+}
+
+void QMetaCallBatch::append(void **argv)
+{
+    if (nargs > 1) {
+        void *memory = ::operator new(size, std::align_val_t(alignment));
+        Call *call = new (memory) Call{ nullptr };
+        for (int n = 1; n < nargs; ++n)
+            types[n].construct(argument(call, n), argv[n]);
+        *last = call;
+        last = &call->next;
+    }
+    ++count;
+}
+
+// Moves the calls of other, which has the same argument types, to the end
+// of this batch.
+void QMetaCallBatch::splice(QMetaCallBatch &other) noexcept
+{
+    Q_ASSERT(other.nargs == nargs);
+    if (other.first) {
+        *last = std::exchange(other.first, nullptr);
+        last = std::exchange(other.last, &other.first);
+    }
+    count += std::exchange(other.count, 0);
+}
+
 inline QObjectPrivate::Connection::~Connection()
 {
+    if (pendingBatch)
+        pendingBatch->deref();
     if (ownArgumentTypes) {
         const int *v = argumentTypes.loadRelaxed();
         if (v != &DIRECT_CONNECTION_ONLY)
@@ -1693,6 +1827,11 @@ bool QObject::moveToThread(QThread *targetThread QT6_IMPL_NEW_OVERLOAD_TAIL)
 
     QOrderedMutexLocker locker(&currentData->postEventList.mutex,
                                &targetData->postEventList.mutex);
+    // QCoreApplication::postEvent() may have picked currentData's inbox for
+    // events to the moved objects before they switch threads. Until those
+    // posters are gone, events to currentData are posted with the lock held.
+    currentData->postEventList.closeInbox();
+    targetData->postEventList.takeInbox();
 
     // keep currentData alive (since we've got it locked)
     currentData->ref();
@@ -1709,7 +1848,13 @@ bool QObject::moveToThread(QThread *targetThread QT6_IMPL_NEW_OVERLOAD_TAIL)
     }
     d_func()->setThreadData_helper(currentData, targetData, bindingStatus);
 
+    const int previousInboxEpoch = currentData->postEventList.startInboxEpoch();
+
     locker.unlock();
+    l.unlock();
+
+    // not with a mutex locked, see QPostEventList::reopenInbox()
+    currentData->postEventList.reopenInbox(previousInboxEpoch);
 
     // now currentData can commit suicide if it wants to
     currentData->deref();
@@ -3613,6 +3758,8 @@ QObjectPrivate::Connection *QMetaObjectPrivate::connect(const QObject *sender,
 
     const bool isSingleShot = type & Qt::SingleShotConnection;
     type &= ~Qt::SingleShotConnection;
+    const bool isBatched = (type & Qt::BatchedConnection) && !isSingleShot;
+    type &= ~Qt::BatchedConnection;
 
     Q_ASSERT(type >= 0);
     Q_ASSERT(type <= 3);
@@ -3631,6 +3778,7 @@ QObjectPrivate::Connection *QMetaObjectPrivate::connect(const QObject *sender,
     c->argumentTypes.storeRelaxed(types);
     c->callFunction = callFunction;
     c->isSingleShot = isSingleShot;
+    c->isBatched = isBatched;
 
     QObjectPrivate::get(s)->addConnection(signal_index, c.get());
 
@@ -3925,6 +4073,87 @@ private:
     QtPrivate::SlotObjUniquePtr m_slotObject;
 };
 
+/*!
+    \internal
+
+    The event posted for a connection made with Qt::BatchedConnection. It
+    delivers all calls collected in its QMetaCallBatch.
+*/
+class QBatchedMetaCallEvent : public QAbstractMetaCallEvent
+{
+public:
+    QBatchedMetaCallEvent(QObjectPrivate::Connection *c, QMetaCallBatch *batch,
+                          const QObject *sender, int signalId, QBasicMutex *lock);
+    ~QBatchedMetaCallEvent() override;
+
+    void placeMetaCall(QObject *object) override;
+
+private:
+    QObjectPrivate::Connection *connection;
+    QMetaCallBatch *batch;
+    QBasicMutex *lock;
+    QtPrivate::SlotObjUniquePtr slotObj;
+    QObjectPrivate::StaticMetaCallFunction callFunction = nullptr;
+    ushort method_offset = 0;
+    ushort method_relative = 0;
+};
+
+QBatchedMetaCallEvent::QBatchedMetaCallEvent(QObjectPrivate::Connection *c, QMetaCallBatch *batch,
+                                             const QObject *sender, int signalId,
+                                             QBasicMutex *lock)
+    : QAbstractMetaCallEvent(sender, signalId), connection(c), batch(batch), lock(lock)
+{
+    c->ref();
+    batch->ref.ref();
+    if (c->isSlotObject) {
+        c->slotObj->ref();
+        slotObj.reset(c->slotObj);
+    } else {
+        callFunction = c->callFunction;
+        method_offset = c->method_offset;
+        method_relative = c->method_relative;
+    }
+}
+
+QBatchedMetaCallEvent::~QBatchedMetaCallEvent()
+{
+    batch->deref();
+    connection->deref();
+}
+
+void QBatchedMetaCallEvent::placeMetaCall(QObject *object)
+{
+    {
+        // stop further emissions from being appended
+        QMutexLocker locker(lock);
+        if (connection->pendingBatch == batch) {
+            connection->pendingBatch = nullptr;
+            batch->deref();
+        }
+    }
+
+    QPointer<QObject> guard(object);
+    QVarLengthArray<void *, 8> args(batch->nargs);
+    args[0] = nullptr;
+    const QMetaCallBatch::Call *call = batch->firstCall();
+    for (qsizetype i = 0; i < batch->count && guard; ++i) {
+        if (call) {
+            for (int n = 1; n < batch->nargs; ++n)
+                args[n] = batch->argument(call, n);
+            call = call->next;
+        }
+
+        if (slotObj) {
+            slotObj->call(object, args.data());
+        } else if (callFunction && method_offset <= object->metaObject()->methodOffset()) {
+            callFunction(object, QMetaObject::InvokeMetaMethod, method_relative, args.data());
+        } else {
+            QMetaObject::metacall(object, QMetaObject::InvokeMetaMethod,
+                                  method_offset + method_relative, args.data());
+        }
+    }
+}
+
 /*!
     \internal
 
@@ -3957,6 +4186,39 @@ static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connect
         return;
     }
 
+    if (c->isBatched) {
+        // copy the arguments without holding the lock, since their copy
+        // constructors may connect, disconnect or emit
+        QMetaCallBatch call(argumentTypes, nargs);
+        locker.unlock();
+        call.append(argv);
+        locker.relock();
+        receiver = c->receiver.loadRelaxed();
+        if (!receiver) {
+            // the connection has been disconnected in the meantime
+            locker.unlock();
+            return;
+        }
+
+        if (QMetaCallBatch *batch = c->pendingBatch) {
+            // an earlier emission is still waiting for delivery, join it,
+            // unless its event has been discarded
+            if (batch->ref.loadRelaxed() > 1) {
+                batch->splice(call);
+                return;
+            }
+            c->pendingBatch = nullptr;
+            batch->deref();
+        }
+
+        auto batch = new QMetaCallBatch(argumentTypes, nargs);
+        batch->splice(call);
+        c->pendingBatch = batch;
+        QCoreApplication::postEvent(receiver, new QBatchedMetaCallEvent(c, batch, sender, signal,
+                                                                        signalSlotLock(receiver)));
+        return;
+    }
+
     SlotObjectGuard slotObjectGuard { c->isSlotObject ? c->slotObj : nullptr };
     locker.unlock();
 
@@ -4047,12 +4309,31 @@ void doActivate(QObject *sender, int signal_index, void **argv)
     // We need to check against the highest connection id to ensure that signals added
     // during the signal emission are not emitted in this emission.
     uint highestConnectionId = connections->currentConnectionId.loadRelaxed();
+    int listIndex = signal_index < signalVector->count() ? signal_index : -1;
     do {
-        QObjectPrivate::Connection *c = list->first.loadRelaxed();
-        if (!c)
+        QObjectPrivate::Connection *first = list->first.loadRelaxed();
+        if (!first)
             continue;
 
-        do {
+        // Walk a contiguous snapshot of the list if there is more than one
+        // connection. Connections removed meanwhile are still in it, but have
+        // no receiver anymore, and connections added meanwhile are skipped by
+        // their id, just as when walking the list itself.
+        QObjectPrivate::Connection * const *begin = &first;
+        QObjectPrivate::Connection * const *end = &first + 1;
+        if (first != list->last.loadRelaxed()) {
+            const QObjectPrivate::ConnectionArray *array = list->array.loadAcquire();
+            if (!array)
+                array = connections->connectionArray(sender, listIndex);
+            begin = array->begin();
+            end = array->end();
+        }
+
+        for (auto it = begin; it != end; ++it) {
+            QObjectPrivate::Connection *c = *it;
+            if (it != begin && c->id > highestConnectionId)
+                break;
+
             QObject * const receiver = c->receiver.loadRelaxed();
             if (!receiver)
                 continue;
@@ -4149,11 +4430,11 @@ void doActivate(QObject *sender, int signal_index, void **argv)
                 if (callbacks_enabled && signal_spy_set->slot_end_callback != nullptr)
                     signal_spy_set->slot_end_callback(receiver, method);
             }
-        } while ((c = c->nextConnectionList.loadRelaxed()) != nullptr && c->id <= highestConnectionId);
+        }
 
     } while (list != &signalVector->at(-1) &&
         //start over for all signals;
-        ((list = &signalVector->at(-1)), true));
+        ((list = &signalVector->at(-1)), (listIndex = -1), true));
 
         if (connections->currentConnectionId.loadRelaxed() == 0)
             senderDeleted = true;
@@ -5285,6 +5566,8 @@ QMetaObject::Connection QObjectPrivate::connectImpl(const QObject *sender, int s
 
     const bool isSingleShot = type & Qt::SingleShotConnection;
     type &= ~Qt::SingleShotConnection;
+    const bool isBatched = (type & Qt::BatchedConnection) && !isSingleShot;
+    type &= ~Qt::BatchedConnection;
 
     Q_ASSERT(type >= 0);
     Q_ASSERT(type <= 3);
@@ -5304,6 +5587,7 @@ QMetaObject::Connection QObjectPrivate::connectImpl(const QObject *sender, int s
         c->ownArgumentTypes = false;
     }
     c->isSingleShot = isSingleShot;
+    c->isBatched = isBatched;
 
     QObjectPrivate::get(s)->addConnection(signal_index, c.get());
     QMetaObject::Connection ret(c.release());
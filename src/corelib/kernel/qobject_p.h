@@ -26,6 +26,7 @@
 #include "QtCore/qproperty.h"
 #include <QtCore/qshareddata.h>
 #include "QtCore/private/qproperty_p.h"
+#include "QtCore/private/qeventpool_p.h"
 
 #include <string>
 
@@ -107,6 +108,7 @@ public:
 
     typedef void (*StaticMetaCallFunction)(QObject *, QMetaObject::Call, int, void **);
     struct Connection;
+    struct ConnectionArray;
     struct ConnectionData;
     struct ConnectionList;
     struct ConnectionOrSignalVector;
@@ -352,6 +354,9 @@ public:
     { Q_UNUSED(semaphore); }
     ~QAbstractMetaCallEvent();
 
+    static void *operator new(size_t size) { return QEventPool::allocate(size); }
+    static void operator delete(void *ptr, size_t size) noexcept { QEventPool::release(ptr, size); }
+
     virtual void placeMetaCall(QObject *object) = 0;
 
     inline const QObject *sender() const { return sender_; }
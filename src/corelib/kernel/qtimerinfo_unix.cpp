@@ -25,7 +25,206 @@ Q_CORE_EXPORT bool qt_disable_lowpriority_timers=false;
  * timerBitVec array is used for keeping track of timer identifiers.
  */
 
-QTimerInfoList::QTimerInfoList() = default;
+/*
+ * QTimerWheel
+ */
+
+void QTimerWheel::insert(QTimerInfo *t)
+{
+    const Tick tick = tickFor(t->timeout);
+    Q_ASSERT(tick > currentTick);
+
+    // the lowest level above which tick and currentTick agree
+    int level = 0;
+    while (level < LevelCount - 1 && digit(tick, level + 1) != digit(currentTick, level + 1))
+        ++level;
+
+    Tick d = digit(tick, level);
+    if (level == LevelCount - 1 && d - digit(currentTick, level) >= SlotCount) {
+        // beyond the wheel's range: park it in the last slot, it gets
+        // re-inserted once the wheel has advanced far enough
+        d = digit(currentTick, level) + SlotCount - 1;
+    }
+
+    const int slot = int(d & (SlotCount - 1));
+    t->wheelLevel = qint8(level);
+    t->wheelSlot = quint8(slot);
+    t->wheelPrev = nullptr;
+    t->wheelNext = buckets[level][slot];
+    if (t->wheelNext)
+        t->wheelNext->wheelPrev = t;
+    buckets[level][slot] = t;
+    occupied[level] |= Q_UINT64_C(1) << slot;
+
+    if (earliestValid && (!cachedEarliest || t->timeout < cachedEarliest->timeout))
+        cachedEarliest = t;
+}
+
+void QTimerWheel::remove(QTimerInfo *t)
+{
+    Q_ASSERT(t->wheelLevel >= 0);
+    const int level = t->wheelLevel;
+    const int slot = t->wheelSlot;
+
+    if (t->wheelPrev)
+        t->wheelPrev->wheelNext = t->wheelNext;
+    else
+        buckets[level][slot] = t->wheelNext;
+    if (t->wheelNext)
+        t->wheelNext->wheelPrev = t->wheelPrev;
+    if (!buckets[level][slot])
+        occupied[level] &= ~(Q_UINT64_C(1) << slot);
+
+    t->wheelNext = t->wheelPrev = nullptr;
+    t->wheelLevel = -1;
+
+    if (t == cachedEarliest)
+        earliestValid = false;
+}
+
+QTimerInfo *QTimerWheel::takeSlot(int level, int slot)
+{
+    QTimerInfo *head = buckets[level][slot];
+    buckets[level][slot] = nullptr;
+    occupied[level] &= ~(Q_UINT64_C(1) << slot);
+    return head;
+}
+
+/*
+    Moves the current tick to \a newTick. Timers due at or before the new
+    tick are passed to \a expire, the others in the slots the current tick
+    moved across are re-inserted at a lower level.
+*/
+template <typename Expire>
+void QTimerWheel::advance(Tick newTick, Expire expire)
+{
+    if (newTick <= currentTick)
+        return;
+
+    const Tick oldTick = currentTick;
+    currentTick = newTick;
+    earliestValid = false;
+
+    // the highest level whose digit changed
+    int top = LevelCount - 1;
+    while (top > 0 && digit(oldTick, top) == digit(newTick, top))
+        --top;
+
+    // collect all timers that must be cascaded into a singly-linked list
+    QTimerInfo *pending = nullptr;
+    auto collect = [&](int level, int slot) {
+        QTimerInfo *t = takeSlot(level, slot);
+        while (t) {
+            QTimerInfo *next = t->wheelNext;
+            t->wheelNext = pending;
+            pending = t;
+            t = next;
+        }
+    };
+
+    // every timer below the top level belonged to the old tick's range
+    for (int level = 0; level < top; ++level) {
+        for (quint64 bits = occupied[level]; bits; bits &= bits - 1)
+            collect(level, qCountTrailingZeroBits(bits));
+    }
+
+    const Tick from = digit(oldTick, top);
+    const Tick to = digit(newTick, top);
+    if (to - from >= Tick(SlotCount)) {
+        for (quint64 bits = occupied[top]; bits; bits &= bits - 1)
+            collect(top, qCountTrailingZeroBits(bits));
+    } else {
+        for (Tick d = from + 1; d <= to; ++d)
+            collect(top, int(d & (SlotCount - 1)));
+    }
+
+    while (pending) {
+        QTimerInfo *t = pending;
+        pending = t->wheelNext;
+        t->wheelNext = t->wheelPrev = nullptr;
+        t->wheelLevel = -1;
+        if (tickFor(t->timeout) <= currentTick)
+            expire(t);
+        else
+            insert(t);
+    }
+}
+
+/*
+    Returns the timer with the earliest timeout in the wheel. Timers on a
+    lower level always expire before those on a higher one, and within a
+    level the slots are ordered starting after the current tick's digit,
+    so only one slot needs to be searched.
+*/
+QTimerInfo *QTimerWheel::earliest() const
+{
+    if (earliestValid)
+        return cachedEarliest;
+
+    cachedEarliest = nullptr;
+    for (int level = 0; level < LevelCount; ++level) {
+        const quint64 bits = occupied[level];
+        if (!bits)
+            continue;
+
+        const int start = int((digit(currentTick, level) + 1) & (SlotCount - 1));
+        const quint64 rotated = (bits >> start) | (bits << ((SlotCount - start) & (SlotCount - 1)));
+        const int slot = (start + qCountTrailingZeroBits(rotated)) & (SlotCount - 1);
+        for (QTimerInfo *t = buckets[level][slot]; t; t = t->wheelNext) {
+            if (!cachedEarliest || t->timeout < cachedEarliest->timeout)
+                cachedEarliest = t;
+        }
+        break;
+    }
+    earliestValid = true;
+    return cachedEarliest;
+}
+
+void QTimerWheel::clear()
+{
+    for (int level = 0; level < LevelCount; ++level) {
+        for (quint64 bits = occupied[level]; bits; bits &= bits - 1)
+            takeSlot(level, qCountTrailingZeroBits(bits));
+    }
+    cachedEarliest = nullptr;
+    earliestValid = true;
+}
+
+/*
+ * QTimerInfoList
+ */
+
+static QTimerInfoList::Backend defaultBackend()
+{
+    return qEnvironmentVariableIntValue("QT_EVENT_DISPATCHER_TIMER_WHEEL") > 0
+            ? QTimerInfoList::Backend::Wheel
+            : QTimerInfoList::Backend::SortedList;
+}
+
+QTimerInfoList::QTimerInfoList()
+    : QTimerInfoList(defaultBackend())
+{
+}
+
+QTimerInfoList::QTimerInfoList(Backend backend)
+{
+    if (backend == Backend::Wheel)
+        wheel = std::make_unique<QTimerWheel>(QTimerWheel::tickFor(updateCurrentTime()));
+}
+
+QTimerInfoList::~QTimerInfoList() = default;
+
+void QTimerInfoList::clearTimers()
+{
+    if (wheel) {
+        wheel->clear();
+        qDeleteAll(timersById);
+        timersById.clear();
+    } else {
+        qDeleteAll(timers);
+    }
+    timers.clear();
+}
 
 steady_clock::time_point QTimerInfoList::updateCurrentTime() const
 {
@@ -41,9 +240,10 @@ steady_clock::time_point QTimerInfoList::updateCurrentTime() const
 */
 bool QTimerInfoList::hasPendingTimers()
 {
-    if (timers.isEmpty())
+    if (isEmpty())
         return false;
-    return updateCurrentTime() < timers.at(0)->timeout;
+    const QTimerInfo *first = timers.isEmpty() ? wheel->earliest() : timers.at(0);
+    return updateCurrentTime() < first->timeout;
 }
 
 static bool byTimeout(const QTimerInfo *a, const QTimerInfo *b)
@@ -54,6 +254,10 @@ static bool byTimeout(const QTimerInfo *a, const QTimerInfo *b)
 */
 void QTimerInfoList::timerInsert(QTimerInfo *ti)
 {
+    if (wheel && QTimerWheel::tickFor(ti->timeout) > wheel->currentTick) {
+        wheel->insert(ti);
+        return;
+    }
     timers.insert(std::upper_bound(timers.cbegin(), timers.cend(), ti, byTimeout),
                   ti);
 }
@@ -242,10 +446,15 @@ std::optional<QTimerInfoList::Duration> QTimerInfoList::timerWait()
     auto isWaiting = [](QTimerInfo *tinfo) { return !tinfo->activateRef; };
     // Find first waiting timer not already active
     auto it = std::find_if(timers.cbegin(), timers.cend(), isWaiting);
-    if (it == timers.cend())
+    const QTimerInfo *first = nullptr;
+    if (it != timers.cend())
+        first = *it;
+    else if (wheel)
+        first = wheel->earliest();
+    if (!first)
         return std::nullopt;
 
-    Duration timeToWait = (*it)->timeout - now;
+    Duration timeToWait = first->timeout - now;
     if (timeToWait > 0ns)
         return roundToMillisecond(timeToWait);
     return 0ms;
@@ -260,15 +469,14 @@ QTimerInfoList::Duration QTimerInfoList::remainingDuration(Qt::TimerId timerId)
 {
     const steady_clock::time_point now = updateCurrentTime();
 
-    auto it = findTimerById(timerId);
-    if (it == timers.cend()) {
+    const QTimerInfo *t = findTimer(timerId);
+    if (!t) {
 #ifndef QT_NO_DEBUG
         qWarning("QTimerInfoList::timerRemainingTime: timer id %i not found", int(timerId));
 #endif
         return Duration::min();
     }
 
-    const QTimerInfo *t = *it;
     if (now < t->timeout) // time to wait
         return t->timeout - now;
     return 0ms;
@@ -314,11 +522,45 @@ void QTimerInfoList::registerTimer(Qt::TimerId timerId, QTimerInfoList::Duration
             t->timeout += 1s;
     }
 
+    if (wheel)
+        timersById.insert(timerId, t);
     timerInsert(t);
 }
 
+QTimerInfo *QTimerInfoList::findTimer(Qt::TimerId timerId) const
+{
+    if (wheel)
+        return timersById.value(timerId);
+    auto it = findTimerById(timerId);
+    return it == timers.cend() ? nullptr : *it;
+}
+
+// removes t from timers or the wheel and deletes it
+void QTimerInfoList::removeTimer(QTimerInfo *t)
+{
+    if (t->wheelLevel >= 0)
+        wheel->remove(t);
+    else
+        timers.removeOne(t);
+
+    // set timer inactive
+    if (t == firstTimerInfo)
+        firstTimerInfo = nullptr;
+    if (t->activateRef)
+        *(t->activateRef) = nullptr;
+    delete t;
+}
+
 bool QTimerInfoList::unregisterTimer(Qt::TimerId timerId)
 {
+    if (wheel) {
+        QTimerInfo *t = timersById.take(timerId);
+        if (!t)
+            return false; // id not found
+        removeTimer(t);
+        return true;
+    }
+
     auto it = findTimerById(timerId);
     if (it == timers.cend())
         return false; // id not found
@@ -336,9 +578,23 @@ bool QTimerInfoList::unregisterTimer(Qt::TimerId timerId)
 
 bool QTimerInfoList::unregisterTimers(QObject *object)
 {
-    if (timers.isEmpty())
+    if (isEmpty())
         return false;
 
+    if (wheel) {
+        bool found = false;
+        for (auto it = timersById.begin(); it != timersById.end(); ) {
+            if (it.value()->obj == object) {
+                removeTimer(it.value());
+                it = timersById.erase(it);
+                found = true;
+            } else {
+                ++it;
+            }
+        }
+        return found;
+    }
+
     auto associatedWith = [this](QObject *o) {
         return [this, o](auto &t) {
             if (t->obj == o) {
@@ -360,6 +616,19 @@ bool QTimerInfoList::unregisterTimers(QObject *object)
 auto QTimerInfoList::registeredTimers(QObject *object) const -> QList<TimerInfo>
 {
     QList<TimerInfo> list;
+    if (wheel) {
+        // report them in timeout order, like the sorted list does
+        QList<const QTimerInfo *> found;
+        for (const QTimerInfo *t : timersById) {
+            if (t->obj == object)
+                found.append(t);
+        }
+        std::sort(found.begin(), found.end(), byTimeout);
+        for (const QTimerInfo *t : std::as_const(found))
+            list.emplaceBack(TimerInfo{t->interval, t->id, t->timerType});
+        return list;
+    }
+
     for (const auto &t : timers) {
         if (t->obj == object)
             list.emplaceBack(TimerInfo{t->interval, t->id, t->timerType});
@@ -372,12 +641,16 @@ auto QTimerInfoList::registeredTimers(QObject *object) const -> QList<TimerInfo>
 */
 int QTimerInfoList::activateTimers()
 {
-    if (qt_disable_lowpriority_timers || timers.isEmpty())
+    if (qt_disable_lowpriority_timers || isEmpty())
         return 0; // nothing to do
 
     firstTimerInfo = nullptr;
 
     const steady_clock::time_point now = updateCurrentTime();
+    if (wheel) {
+        // move the timers that are due now from the wheel into the list
+        wheel->advance(QTimerWheel::tickFor(now), [this](QTimerInfo *t) { timerInsert(t); });
+    }
     // qDebug() << "Thread" << QThread::currentThreadId() << "woken up at" << now;
     // Find out how many timer have expired
     auto stillActive = [&now](const QTimerInfo *t) { return now < t->timeout; };
@@ -407,7 +680,10 @@ int QTimerInfoList::activateTimers()
 
         // determine next timeout time
         calculateNextTimeout(currentTimerInfo, now);
-        if (timers.size() > 1) {
+        if (wheel && QTimerWheel::tickFor(currentTimerInfo->timeout) > wheel->currentTick) {
+            timers.removeFirst();
+            wheel->insert(currentTimerInfo);
+        } else if (timers.size() > 1) {
             // Find where "currentTimerInfo" should be in the list so as
             // to keep the list ordered by timeout
             auto afterCurrentIt = timers.begin() + 1;
@@ -18,9 +18,11 @@
 #include <QtCore/private/qglobal_p.h>
 
 #include "qabstracteventdispatcher.h"
+#include "qhash.h"
 
 #include <sys/time.h> // struct timespec
 #include <chrono>
+#include <memory>
 
 QT_BEGIN_NAMESPACE
 
@@ -40,6 +42,51 @@ struct QTimerInfo
     Qt::TimerType timerType; // - timer type
     QObject *obj = nullptr; // - object to receive event
     QTimerInfo **activateRef = nullptr; // - ref from activateTimers
+
+    // links into a QTimerWheel slot; wheelLevel is -1 while the timer is
+    // in QTimerInfoList::timers instead
+    QTimerInfo *wheelNext = nullptr;
+    QTimerInfo *wheelPrev = nullptr;
+    qint8 wheelLevel = -1;
+    quint8 wheelSlot = 0;
+};
+
+// Hierarchical timing wheel with millisecond ticks. A timer is kept at the
+// lowest level at which its tick differs from the current tick, so inserting
+// and removing are O(1) and each timer is cascaded at most LevelCount times
+// as the current tick advances.
+class QTimerWheel
+{
+public:
+    using Tick = quint64;
+    static constexpr int LevelBits = 6;
+    static constexpr int SlotCount = 1 << LevelBits;
+    static constexpr int LevelCount = 6;
+
+    static Tick tickFor(QTimerInfo::TimePoint timeout)
+    {
+        using namespace std::chrono;
+        return Tick(floor<milliseconds>(timeout.time_since_epoch()).count());
+    }
+
+    explicit QTimerWheel(Tick tick) : currentTick(tick) { }
+
+    void insert(QTimerInfo *t);
+    void remove(QTimerInfo *t);
+    template <typename Expire> void advance(Tick newTick, Expire expire);
+    QTimerInfo *earliest() const;
+    void clear();
+
+    Tick currentTick;
+
+private:
+    static Tick digit(Tick tick, int level) { return tick >> (level * LevelBits); }
+    QTimerInfo *takeSlot(int level, int slot);
+
+    QTimerInfo *buckets[LevelCount][SlotCount] = {};
+    quint64 occupied[LevelCount] = {};
+    mutable QTimerInfo *cachedEarliest = nullptr;
+    mutable bool earliestValid = true;
 };
 
 class Q_CORE_EXPORT QTimerInfoList
@@ -47,7 +94,11 @@ class Q_CORE_EXPORT QTimerInfoList
 public:
     using Duration = QAbstractEventDispatcher::Duration;
     using TimerInfo = QAbstractEventDispatcher::TimerInfoV2;
+    enum class Backend { SortedList, Wheel };
+
     QTimerInfoList();
+    explicit QTimerInfoList(Backend backend);
+    ~QTimerInfoList();
 
     mutable std::chrono::steady_clock::time_point currentTime;
 
@@ -65,15 +116,11 @@ public:
     int activateTimers();
     bool hasPendingTimers();
 
-    void clearTimers()
-    {
-        qDeleteAll(timers);
-        timers.clear();
-    }
+    void clearTimers();
 
-    bool isEmpty() const { return timers.empty(); }
+    bool isEmpty() const { return wheel ? timersById.isEmpty() : timers.empty(); }
 
-    qsizetype size() const { return timers.size(); }
+    qsizetype size() const { return wheel ? timersById.size() : timers.size(); }
 
     auto findTimerById(Qt::TimerId timerId) const
     {
@@ -83,10 +130,19 @@ public:
 
 private:
     std::chrono::steady_clock::time_point updateCurrentTime() const;
+    QTimerInfo *findTimer(Qt::TimerId timerId) const;
+    void removeTimer(QTimerInfo *t);
 
     // state variables used by activateTimers()
     QTimerInfo *firstTimerInfo = nullptr;
+
+    // sorted by timeout; with the wheel backend, only the timers that are
+    // due within the wheel's current tick
     QList<QTimerInfo *> timers;
+
+    // only used by the wheel backend
+    std::unique_ptr<QTimerWheel> wheel;
+    QHash<Qt::TimerId, QTimerInfo *> timersById;
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,745 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qcborview.h"
+
+#include "qviewindex_p.h"
+
+#include <qendian.h>
+#include <qfloat16.h>
+#include <qvarlengtharray.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QCborView
+    \inmodule QtCore
+    \ingroup cbor
+    \ingroup qtserialization
+    \reentrant
+    \since 6.9
+
+    \brief The QCborView class is a read-only view of a value in CBOR data
+    that is not copied.
+
+    QCborValue::fromCbor() decodes all of the data it is given, and copies
+    every string and byte array into the value it returns. That is
+    wasteful for large files of which only a few values are read, and
+    unnecessary when the data outlives the values anyway, for instance
+    because it is a file mapped into memory with QFile::map().
+
+    QCborView instead reads the values directly from the data. Creating a
+    view with fromCbor() costs nothing, whatever the size of the data;
+    the elements of an array or a map are found the first time one of them
+    is accessed, and the offsets of the elements found are kept for the
+    later accesses. Strings and byte arrays are returned as views of the
+    data, with toStringView() and toByteArrayView(), without being copied.
+
+    \code
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+    const uchar *data = file.map(0, file.size());
+    const QCborView root = QCborView::fromCbor(QByteArrayView(data, file.size()));
+    const QCborView entries = root["entries"];
+    for (qsizetype i = 0; i < entries.size(); ++i)
+        names << entries[i]["name"].toString();
+    \endcode
+
+    The data is not copied, so it must stay valid and unmodified for as long
+    as views of it exist. All the views obtained from the same fromCbor()
+    call share the offsets found, including across threads.
+
+    Unlike QCborValue, QCborView does not interpret the tags of the data:
+    a tagged value, such as a date and time, has the type QCborValue::Tag,
+    and tag() and taggedValue() return its tag and its content.
+
+    QCborView does not check the data as a whole. The data is only checked
+    as it is read: a malformed value has the type QCborValue::Invalid, and
+    an array or map only contains the elements that precede malformed data.
+    Use QCborStreamReader or QCborValue::fromCbor() to check data that
+    cannot be trusted before reading it with QCborView.
+
+    \sa QCborValue, QJsonView
+*/
+
+class QCborViewPrivate : public QtPrivate::ViewIndex
+{
+public:
+    enum {
+        // same as QCborStreamReader
+        NestingLimit = 1024,
+        IndefiniteLength = 31,
+        Break = 0xff,
+    };
+
+    enum MajorType : quint8 {
+        UnsignedInteger = 0x00,
+        NegativeInteger = 0x20,
+        ByteString = 0x40,
+        TextString = 0x60,
+        Array = 0x80,
+        Map = 0xa0,
+        Tag = 0xc0,
+        SimpleTypes = 0xe0,
+    };
+
+    // The initial byte of a data item and the argument that follows it.
+    struct Head
+    {
+        qsizetype next = -1;    // the offset after the head, -1 if malformed
+        quint64 argument = 0;
+        quint8 major = 0;
+        quint8 info = 0;
+
+        bool isValid() const { return next >= 0; }
+        bool isIndefinite() const { return info == IndefiniteLength; }
+        bool isIntegerOutOfRange() const { return qint64(argument) < 0; }
+    };
+
+    using ViewIndex::ViewIndex;
+
+    const uchar *bytes() const { return reinterpret_cast<const uchar *>(data.data()); }
+
+    Head head(qsizetype pos) const;
+    qsizetype skipBytes(qsizetype pos, quint64 size) const;
+    qsizetype skipChunks(qsizetype pos, quint8 major) const;
+    qsizetype skip(qsizetype pos) const;
+    bool readString(qsizetype pos, quint8 major, QByteArray *result) const;
+    void build(qsizetype pos, Container *container) const;
+    const Container &container(qsizetype pos)
+    {
+        return ViewIndex::container(pos, [this](qsizetype pos, Container *container) {
+            build(pos, container);
+        });
+    }
+};
+
+QCborViewPrivate::Head QCborViewPrivate::head(qsizetype pos) const
+{
+    Head h;
+    if (pos < 0 || pos >= data.size())
+        return h;
+
+    const uchar *ptr = bytes() + pos;
+    h.major = *ptr & 0xe0;
+    h.info = *ptr & 0x1f;
+    ++ptr;
+    if (h.info < 24) {
+        h.argument = h.info;
+    } else if (h.info < 28) {
+        const qsizetype size = qsizetype(1) << (h.info - 24);
+        if (data.size() - pos - 1 < size)
+            return h;
+        switch (size) {
+        case 1: h.argument = *ptr; break;
+        case 2: h.argument = qFromBigEndian<quint16>(ptr); break;
+        case 4: h.argument = qFromBigEndian<quint32>(ptr); break;
+        case 8: h.argument = qFromBigEndian<quint64>(ptr); break;
+        }
+        ptr += size;
+    } else if (h.info != IndefiniteLength) {
+        return h;       // reserved
+    } else if (h.major == UnsignedInteger || h.major == NegativeInteger || h.major == Tag) {
+        return h;
+    }
+    h.next = ptr - bytes();
+    return h;
+}
+
+// Returns the offset after size bytes from pos, or -1 if there are not as
+// many.
+qsizetype QCborViewPrivate::skipBytes(qsizetype pos, quint64 size) const
+{
+    if (size > quint64(data.size() - pos))
+        return -1;
+    return pos + qsizetype(size);
+}
+
+// Returns the offset after the chunks of a string of indefinite length
+// that start at pos, or -1 if they are malformed.
+qsizetype QCborViewPrivate::skipChunks(qsizetype pos, quint8 major) const
+{
+    while (true) {
+        const Head h = head(pos);
+        if (!h.isValid())
+            return -1;
+        if (h.major == SimpleTypes && h.isIndefinite())
+            return h.next;
+        if (h.major != major || h.isIndefinite())
+            return -1;
+        pos = skipBytes(h.next, h.argument);
+        if (pos < 0)
+            return -1;
+    }
+}
+
+// Returns the offset after the data item that starts at pos, or -1 if it
+// is malformed.
+qsizetype QCborViewPrivate::skip(qsizetype pos) const
+{
+    // the number of items left in each of the enclosing containers, or -1
+    // for containers of indefinite length
+    QVarLengthArray<qint64, 16> remaining;
+    while (true) {
+        const Head h = head(pos);
+        if (!h.isValid())
+            return -1;
+        pos = h.next;
+        switch (h.major) {
+        case ByteString:
+        case TextString:
+            pos = h.isIndefinite() ? skipChunks(pos, h.major) : skipBytes(pos, h.argument);
+            if (pos < 0)
+                return -1;
+            break;
+        case Array:
+        case Map:
+            if (remaining.size() == NestingLimit)
+                return -1;
+            if (h.isIndefinite()) {
+                remaining.append(-1);
+                continue;
+            }
+            // each item takes at least one byte
+            if (h.argument > quint64(data.size() - pos))
+                return -1;
+            if (h.argument) {
+                remaining.append(qint64(h.argument) * (h.major == Map ? 2 : 1));
+                continue;
+            }
+            break;
+        case Tag:
+            continue;       // the tagged item is part of this one
+        case SimpleTypes:
+            if (h.isIndefinite()) {
+                if (remaining.isEmpty() || remaining.back() != -1)
+                    return -1;
+                remaining.removeLast();
+            }
+            break;
+        }
+
+        // an item ended, and with it the containers it was the last item of
+        while (!remaining.isEmpty() && remaining.back() > 0 && --remaining.back() == 0)
+            remaining.removeLast();
+        if (remaining.isEmpty())
+            return pos;
+    }
+}
+
+// Reads the string or byte array at pos, joining its chunks if it has an
+// indefinite length.
+bool QCborViewPrivate::readString(qsizetype pos, quint8 major, QByteArray *result) const
+{
+    Head h = head(pos);
+    if (!h.isValid() || h.major != major)
+        return false;
+    if (!h.isIndefinite()) {
+        if (skipBytes(h.next, h.argument) < 0)
+            return false;
+        *result = QByteArray(data.data() + h.next, qsizetype(h.argument));
+        return true;
+    }
+
+    const qsizetype end = skipChunks(h.next, major);
+    if (end < 0)
+        return false;
+    result->clear();
+    for (h = head(h.next); !h.isIndefinite(); h = head(h.next + qsizetype(h.argument)))
+        result->append(data.data() + h.next, qsizetype(h.argument));
+    return true;
+}
+
+void QCborViewPrivate::build(qsizetype pos, Container *container) const
+{
+    const Head h = head(pos);
+    Q_ASSERT(h.major == Array || h.major == Map);
+    const qsizetype itemsPerElement = h.major == Map ? 2 : 1;
+    pos = h.next;
+
+    // an item of a definite length container takes at least one byte
+    qint64 remaining = -1;
+    if (!h.isIndefinite()) {
+        if (h.argument > quint64(data.size() - pos))
+            return;
+        remaining = qint64(h.argument) * itemsPerElement;
+        container->offsets.reserve(remaining);
+    }
+
+    while (remaining != 0) {
+        if (remaining < 0 && pos < data.size() && bytes()[pos] == Break)
+            break;
+        for (qsizetype i = 0; i < itemsPerElement; ++i) {
+            const qsizetype next = skip(pos);
+            if (next < 0) {
+                // keep the elements that precede the malformed data
+                container->offsets.resize(container->offsets.size() - i);
+                return;
+            }
+            container->offsets.append(pos);
+            pos = next;
+        }
+        if (remaining > 0)
+            remaining -= itemsPerElement;
+    }
+
+    container->end = remaining < 0 ? pos + 1 : pos;
+}
+
+// Same as QCborStreamReader.
+template <typename FP> static FP toFloatingPoint(quint64 bits) noexcept
+{
+    using UIntFP = typename QIntegerForSizeof<FP>::Unsigned;
+    const UIntFP u = UIntFP(bits);
+    FP f;
+    memcpy(static_cast<void *>(&f), &u, sizeof(f));
+    return f;
+}
+
+QT_DEFINE_QESDP_SPECIALIZATION_DTOR(QCborViewPrivate)
+
+/*!
+    Constructs an invalid view, of type QCborValue::Invalid.
+*/
+QCborView::QCborView() noexcept = default;
+
+/*!
+    Constructs a copy of \a other, which views the same value.
+*/
+QCborView::QCborView(const QCborView &other) noexcept = default;
+
+/*!
+    \fn QCborView::QCborView(QCborView &&other)
+
+    Move-constructs a QCborView instance, making it view the same value as
+    \a other.
+*/
+
+/*!
+    Makes this view view the same value as \a other, and returns a
+    reference to it.
+*/
+QCborView &QCborView::operator=(const QCborView &other) noexcept = default;
+
+/*!
+    \fn QCborView &QCborView::operator=(QCborView &&other)
+
+    Move-assigns \a other to this view, and returns a reference to it.
+*/
+
+/*!
+    \fn void QCborView::swap(QCborView &other)
+    \memberswap{view}
+*/
+
+/*!
+    Destroys the view. The data it views is not affected.
+*/
+QCborView::~QCborView() = default;
+
+QCborView::QCborView(QCborViewPrivate *d, qsizetype pos) noexcept
+    : d(d), pos(pos)
+{
+}
+
+/*!
+    Returns a view of the first data item in \a data, which contains CBOR.
+
+    Nothing is decoded yet, and \a data is not copied: it must stay valid
+    and unmodified for as long as views of it exist.
+
+    The view is invalid if \a data is empty.
+*/
+QCborView QCborView::fromCbor(QByteArrayView data)
+{
+    if (data.isEmpty())
+        return QCborView();
+    return QCborView(new QCborViewPrivate(data), 0);
+}
+
+/*!
+    Returns the type of the value this view views.
+
+    As QCborView does not interpret tags, this is never one of the extended
+    types of QCborValue, like QCborValue::DateTime. Integers that do not fit
+    in a qint64 are QCborValue::Double, as in QCborValue.
+
+    \sa isInteger(), isString(), isArray(), isMap(), isTag()
+*/
+QCborValue::Type QCborView::type() const
+{
+    if (!d)
+        return QCborValue::Invalid;
+    const QCborViewPrivate::Head h = d->head(pos);
+    if (!h.isValid())
+        return QCborValue::Invalid;
+
+    switch (h.major) {
+    case QCborViewPrivate::UnsignedInteger:
+    case QCborViewPrivate::NegativeInteger:
+        return h.isIntegerOutOfRange() ? QCborValue::Double : QCborValue::Integer;
+    case QCborViewPrivate::ByteString:
+        return QCborValue::ByteArray;
+    case QCborViewPrivate::TextString:
+        return QCborValue::String;
+    case QCborViewPrivate::Array:
+        return QCborValue::Array;
+    case QCborViewPrivate::Map:
+        return QCborValue::Map;
+    case QCborViewPrivate::Tag:
+        return QCborValue::Tag;
+    }
+
+    if (h.info < 24)
+        return QCborValue::Type(QCborValue::SimpleType + h.info);
+    if (h.info == 24)
+        return QCborValue::Type(QCborValue::SimpleType + int(h.argument));
+    if (h.info == QCborViewPrivate::IndefiniteLength)
+        return QCborValue::Invalid;         // a break where no item may end
+    return QCborValue::Double;
+}
+
+/*!
+    \fn bool QCborView::isInteger() const
+    \fn bool QCborView::isByteArray() const
+    \fn bool QCborView::isString() const
+    \fn bool QCborView::isArray() const
+    \fn bool QCborView::isMap() const
+    \fn bool QCborView::isTag() const
+    \fn bool QCborView::isFalse() const
+    \fn bool QCborView::isTrue() const
+    \fn bool QCborView::isBool() const
+    \fn bool QCborView::isNull() const
+    \fn bool QCborView::isUndefined() const
+    \fn bool QCborView::isDouble() const
+    \fn bool QCborView::isInvalid() const
+    \fn bool QCborView::isContainer() const
+    \fn bool QCborView::isSimpleType() const
+
+    These functions return \c true if the value viewed has the type tested,
+    as returned by type(). See QCborValue for the meaning of each type.
+*/
+
+/*!
+    \fn bool QCborView::toBool(bool defaultValue) const
+
+    Returns the boolean value viewed, or \a defaultValue if the value is
+    neither QCborValue::True nor QCborValue::False.
+*/
+
+/*!
+    \fn QCborSimpleType QCborView::toSimpleType(QCborSimpleType defaultValue) const
+
+    Returns the simple type viewed, or \a defaultValue if the value is not
+    a simple type.
+*/
+
+/*!
+    Returns the integer viewed, or \a defaultValue if the value is not an
+    integer. A QCborValue::Double is truncated to an integer, as in
+    QCborValue::toInteger().
+*/
+qint64 QCborView::toInteger(qint64 defaultValue) const
+{
+    if (!d)
+        return defaultValue;
+    const QCborViewPrivate::Head h = d->head(pos);
+    if (h.isValid() && !h.isIntegerOutOfRange()) {
+        if (h.major == QCborViewPrivate::UnsignedInteger)
+            return qint64(h.argument);
+        if (h.major == QCborViewPrivate::NegativeInteger)
+            return -1 - qint64(h.argument);
+    }
+    return isDouble() ? qint64(toDouble()) : defaultValue;
+}
+
+/*!
+    Returns the floating-point number viewed, or \a defaultValue if the value
+    is neither a number nor an integer.
+*/
+double QCborView::toDouble(double defaultValue) const
+{
+    if (!d)
+        return defaultValue;
+    const QCborViewPrivate::Head h = d->head(pos);
+    if (!h.isValid())
+        return defaultValue;
+
+    switch (h.major) {
+    case QCborViewPrivate::UnsignedInteger:
+        return double(h.argument);
+    case QCborViewPrivate::NegativeInteger:
+        return h.isIntegerOutOfRange() ? -1 - double(h.argument) : double(-1 - qint64(h.argument));
+    case QCborViewPrivate::SimpleTypes:
+        switch (h.info) {
+        case 25:
+            return double(toFloatingPoint<qfloat16>(h.argument));
+        case 26:
+            return double(toFloatingPoint<float>(h.argument));
+        case 27:
+            return toFloatingPoint<double>(h.argument);
+        }
+        break;
+    }
+    return defaultValue;
+}
+
+/*!
+    Returns the tag of the tagged value viewed, or \a defaultValue if the
+    value is not tagged.
+
+    \sa taggedValue()
+*/
+QCborTag QCborView::tag(QCborTag defaultValue) const
+{
+    if (!d)
+        return defaultValue;
+    const QCborViewPrivate::Head h = d->head(pos);
+    return h.isValid() && h.major == QCborViewPrivate::Tag ? QCborTag(h.argument) : defaultValue;
+}
+
+/*!
+    Returns a view of the content of the tagged value viewed, or an invalid
+    view if the value is not tagged.
+
+    \sa tag()
+*/
+QCborView QCborView::taggedValue() const
+{
+    if (!d)
+        return QCborView();
+    const QCborViewPrivate::Head h = d->head(pos);
+    if (!h.isValid() || h.major != QCborViewPrivate::Tag)
+        return QCborView();
+    return QCborView(d.data(), h.next);
+}
+
+/*!
+    Returns the byte array viewed, as a view of the data, without copying
+    it.
+
+    Returns a null view if the value is not a byte array, or if it is split
+    into chunks in the data, which happens when it was written with
+    QCborStreamWriter::appendByteString() in several parts. Use
+    toByteArray() to read such byte arrays.
+
+    \sa toByteArray(), toStringView()
+*/
+QByteArrayView QCborView::toByteArrayView() const
+{
+    if (!d)
+        return {};
+    const QCborViewPrivate::Head h = d->head(pos);
+    if (!h.isValid() || h.major != QCborViewPrivate::ByteString || h.isIndefinite()
+            || d->skipBytes(h.next, h.argument) < 0) {
+        return {};
+    }
+    return d->data.sliced(h.next, qsizetype(h.argument));
+}
+
+/*!
+    Returns the string viewed, as a view of the UTF-8 data, without copying
+    it.
+
+    Returns a null view if the value is not a string, or if it is split into
+    chunks in the data. Use toString() to read such strings.
+
+    \sa toString(), toByteArrayView()
+*/
+QUtf8StringView QCborView::toStringView() const
+{
+    if (!d)
+        return {};
+    const QCborViewPrivate::Head h = d->head(pos);
+    if (!h.isValid() || h.major != QCborViewPrivate::TextString || h.isIndefinite()
+            || d->skipBytes(h.next, h.argument) < 0) {
+        return {};
+    }
+    return QUtf8StringView(d->data.data() + h.next, qsizetype(h.argument));
+}
+
+/*!
+    Returns a copy of the byte array viewed, or \a defaultValue if the value
+    is not a byte array.
+
+    \sa toByteArrayView()
+*/
+QByteArray QCborView::toByteArray(const QByteArray &defaultValue) const
+{
+    QByteArray result;
+    if (!d || !d->readString(pos, QCborViewPrivate::ByteString, &result))
+        return defaultValue;
+    return result;
+}
+
+/*!
+    Returns a copy of the string viewed, or \a defaultValue if the value is
+    not a string.
+
+    \sa toStringView()
+*/
+QString QCborView::toString(const QString &defaultValue) const
+{
+    if (const QUtf8StringView view = toStringView(); !view.isNull())
+        return view.toString();
+    QByteArray utf8;
+    if (!d || !d->readString(pos, QCborViewPrivate::TextString, &utf8))
+        return defaultValue;
+    return QString::fromUtf8(utf8);
+}
+
+/*!
+    Returns the number of elements of the array viewed, the number of
+    members of the map viewed, or 0 if the value is neither.
+
+    The first call for an array or a map, or for any other view of it,
+    finds its elements in the data.
+*/
+qsizetype QCborView::size() const
+{
+    const QCborValue::Type t = type();
+    if (t != QCborValue::Array && t != QCborValue::Map)
+        return 0;
+    const qsizetype n = d->container(pos).offsets.size();
+    return t == QCborValue::Map ? n / 2 : n;
+}
+
+/*!
+    Returns a view of the element at index \a i of the array viewed, or an
+    invalid view if the value is not an array or has no such element.
+
+    \sa size(), operator[]()
+*/
+QCborView QCborView::at(qsizetype i) const
+{
+    if (!isArray())
+        return QCborView();
+    const qsizetype offset = d->container(pos).offsets.value(i, -1);
+    return offset < 0 ? QCborView() : QCborView(d.data(), offset);
+}
+
+/*!
+    Returns a view of the key of the member at index \a i of the map viewed,
+    in the order of the data, or an invalid view if the value is not a map
+    or has no such member.
+
+    \sa valueAt(), size()
+*/
+QCborView QCborView::keyAt(qsizetype i) const
+{
+    if (!isMap() || i < 0)
+        return QCborView();
+    const qsizetype offset = d->container(pos).offsets.value(2 * i, -1);
+    return offset < 0 ? QCborView() : QCborView(d.data(), offset);
+}
+
+/*!
+    Returns a view of the value of the member at index \a i of the map
+    viewed, in the order of the data, or an invalid view if the value is not
+    a map or has no such member.
+
+    \sa keyAt(), size()
+*/
+QCborView QCborView::valueAt(qsizetype i) const
+{
+    if (!isMap() || i < 0)
+        return QCborView();
+    const qsizetype offset = d->container(pos).offsets.value(2 * i + 1, -1);
+    return offset < 0 ? QCborView() : QCborView(d.data(), offset);
+}
+
+/*!
+    Returns a view of the value of the first member of the map viewed whose
+    key is the integer \a key, or an invalid view if the value is not a map
+    or has no such member.
+
+    Members are searched in the order of the data, as in QCborMap.
+
+    \sa operator[]()
+*/
+QCborView QCborView::value(qint64 key) const
+{
+    if (!isMap())
+        return QCborView();
+    const QList<qsizetype> &offsets = d->container(pos).offsets;
+    for (qsizetype i = 0; i < offsets.size(); i += 2) {
+        const QCborView k(d.data(), offsets.at(i));
+        if (k.isInteger() && k.toInteger() == key)
+            return QCborView(d.data(), offsets.at(i + 1));
+    }
+    return QCborView();
+}
+
+/*!
+    \overload
+
+    Returns a view of the value of the first member of the map viewed whose
+    key is the string \a key, or an invalid view if the value is not a map
+    or has no such member.
+*/
+QCborView QCborView::value(QAnyStringView key) const
+{
+    if (!isMap())
+        return QCborView();
+    const QList<qsizetype> &offsets = d->container(pos).offsets;
+    for (qsizetype i = 0; i < offsets.size(); i += 2) {
+        const QCborView k(d.data(), offsets.at(i));
+        if (!k.isString())
+            continue;
+        const QUtf8StringView view = k.toStringView();
+        if (view.isNull() ? QAnyStringView::equal(k.toString(), key)
+                          : QAnyStringView::equal(view, key)) {
+            return QCborView(d.data(), offsets.at(i + 1));
+        }
+    }
+    return QCborView();
+}
+
+/*!
+    Returns a view of the element at index \a key of the array viewed, or
+    of the value of the first member with the integer key \a key of the map
+    viewed, like QCborValue::operator[](). Returns an invalid view if there
+    is no such element or member.
+
+    \sa at(), value()
+*/
+QCborView QCborView::operator[](qint64 key) const
+{
+    return isMap() ? value(key) : at(key);
+}
+
+/*!
+    \fn QCborView QCborView::operator[](QAnyStringView key) const
+    \overload
+
+    Same as value(\a key).
+*/
+
+#if QT_CONFIG(cborstreamreader)
+/*!
+    Decodes the value viewed, with all of its content if it is an array or
+    a map, into a QCborValue. Unlike the views, the QCborValue does not
+    depend on the data staying valid.
+
+    Returns an invalid QCborValue if the value is malformed.
+*/
+QCborValue QCborView::toCborValue() const
+{
+    if (!d)
+        return QCborValue(QCborValue::Invalid);
+    const qsizetype end = d->skip(pos);
+    if (end < 0)
+        return QCborValue(QCborValue::Invalid);
+    return QCborValue::fromCbor(QByteArray::fromRawData(d->data.data() + pos, end - pos));
+}
+#endif
+
+/*!
+    \fn qsizetype QCborView::offset() const
+
+    Returns the offset in the data of the value viewed, or -1 if the view is
+    invalid.
+*/
+
+QT_END_NAMESPACE
@@ -0,0 +1,96 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QCBORVIEW_H
+#define QCBORVIEW_H
+
+#include <QtCore/qanystringview.h>
+#include <QtCore/qbytearrayview.h>
+#include <QtCore/qcborvalue.h>
+#include <QtCore/qshareddata.h>
+#include <QtCore/qutf8stringview.h>
+
+QT_BEGIN_NAMESPACE
+
+class QCborViewPrivate;
+QT_DECLARE_QESDP_SPECIALIZATION_DTOR_WITH_EXPORT(QCborViewPrivate, Q_CORE_EXPORT)
+
+class Q_CORE_EXPORT QCborView
+{
+public:
+    QCborView() noexcept;
+    QCborView(const QCborView &other) noexcept;
+    QCborView(QCborView &&other) noexcept = default;
+    QCborView &operator=(const QCborView &other) noexcept;
+    QT_MOVE_ASSIGNMENT_OPERATOR_IMPL_VIA_PURE_SWAP(QCborView)
+    ~QCborView();
+
+    void swap(QCborView &other) noexcept
+    {
+        d.swap(other.d);
+        std::swap(pos, other.pos);
+    }
+
+    static QCborView fromCbor(QByteArrayView data);
+
+    QCborValue::Type type() const;
+    bool isInteger() const      { return type() == QCborValue::Integer; }
+    bool isByteArray() const    { return type() == QCborValue::ByteArray; }
+    bool isString() const       { return type() == QCborValue::String; }
+    bool isArray() const        { return type() == QCborValue::Array; }
+    bool isMap() const          { return type() == QCborValue::Map; }
+    bool isTag() const          { return type() == QCborValue::Tag; }
+    bool isFalse() const        { return type() == QCborValue::False; }
+    bool isTrue() const         { return type() == QCborValue::True; }
+    bool isBool() const         { return isFalse() || isTrue(); }
+    bool isNull() const         { return type() == QCborValue::Null; }
+    bool isUndefined() const    { return type() == QCborValue::Undefined; }
+    bool isDouble() const       { return type() == QCborValue::Double; }
+    bool isInvalid() const      { return type() == QCborValue::Invalid; }
+    bool isContainer() const    { return isMap() || isArray(); }
+    bool isSimpleType() const
+    {
+        return int(type()) >> 8 == int(QCborValue::SimpleType) >> 8;
+    }
+
+    qint64 toInteger(qint64 defaultValue = 0) const;
+    double toDouble(double defaultValue = 0) const;
+    bool toBool(bool defaultValue = false) const
+    { return isBool() ? isTrue() : defaultValue; }
+    QCborSimpleType toSimpleType(QCborSimpleType defaultValue = QCborSimpleType::Undefined) const
+    { return isSimpleType() ? QCborSimpleType(type() & 0xff) : defaultValue; }
+
+    QCborTag tag(QCborTag defaultValue = QCborTag(-1)) const;
+    QCborView taggedValue() const;
+
+    QByteArrayView toByteArrayView() const;
+    QUtf8StringView toStringView() const;
+    QByteArray toByteArray(const QByteArray &defaultValue = {}) const;
+    QString toString(const QString &defaultValue = {}) const;
+
+    qsizetype size() const;
+    QCborView at(qsizetype i) const;
+    QCborView keyAt(qsizetype i) const;
+    QCborView valueAt(qsizetype i) const;
+    QCborView value(qint64 key) const;
+    QCborView value(QAnyStringView key) const;
+    QCborView operator[](qint64 key) const;
+    QCborView operator[](QAnyStringView key) const { return value(key); }
+
+#if QT_CONFIG(cborstreamreader)
+    QCborValue toCborValue() const;
+#endif
+    qsizetype offset() const { return pos; }
+
+private:
+    QCborView(QCborViewPrivate *d, qsizetype pos) noexcept;
+
+    QExplicitlySharedDataPointer<QCborViewPrivate> d;
+    qsizetype pos = -1;
+};
+
+Q_DECLARE_SHARED(QCborView)
+
+QT_END_NAMESPACE
+
+#endif // QCBORVIEW_H
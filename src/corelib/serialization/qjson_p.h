@@ -197,6 +197,8 @@ public:
         return container(r)->elements.at(indexHelper(r));
     }
 
+    static const QCborValue &toCbor(const QJsonValue &v) noexcept { return v.value; }
+
     static QJsonValue fromTrustedCbor(const QCborValue &v)
     {
         QJsonValue result;
@@ -11,6 +11,7 @@
 #include "private/qstringconverter_p.h"
 #include "private/qcborvalue_p.h"
 #include "private/qnumeric_p.h"
+#include "private/qsimd_p.h"
 #include <private/qtools_p.h>
 
 //#define PARSER_DEBUG
@@ -244,6 +245,125 @@ enum {
     Quote = 0x22
 };
 
+/*
+    The scanners below find the end of a run of whitespace or of plain
+    string characters a vector at a time. They only load whole vectors
+    inside [ptr, end) and finish the remaining bytes one at a time.
+*/
+
+#ifdef __SSE2__
+static constexpr bool UseAvx2 =
+        (qCompilerCpuFeatures & CpuFeatureArchHaswell) == CpuFeatureArchHaswell;
+
+// bit i is set if byte i is JSON whitespace
+template <typename Vector, typename Set1, typename CmpEq, typename Or>
+static Q_ALWAYS_INLINE Vector whitespaceBytes(Vector data, Set1 set1, CmpEq cmpeq, Or vor)
+{
+    return vor(vor(cmpeq(data, set1(Space)), cmpeq(data, set1(Tab))),
+               vor(cmpeq(data, set1(LineFeed)), cmpeq(data, set1(Return))));
+}
+
+// bit i is set if byte i ends a run of characters that need no decoding:
+// a quote, a backslash or a byte that is not US-ASCII
+template <typename Vector, typename Set1, typename CmpEq, typename Or>
+static Q_ALWAYS_INLINE Vector stringStopBytes(Vector data, Set1 set1, CmpEq cmpeq, Or vor)
+{
+    return vor(vor(cmpeq(data, set1(Quote)), cmpeq(data, set1('\\'))), data);
+}
+
+template <bool Whitespace>
+static const char *simdScan(const char *ptr, const char *end)
+{
+    if constexpr (UseAvx2) {
+        const auto set1 = [](char c) { return _mm256_set1_epi8(c); };
+        const auto cmpeq = [](__m256i a, __m256i b) { return _mm256_cmpeq_epi8(a, b); };
+        const auto vor = [](__m256i a, __m256i b) { return _mm256_or_si256(a, b); };
+        for ( ; end - ptr >= 32; ptr += 32) {
+            const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr));
+            uint mask;
+            if constexpr (Whitespace)
+                mask = ~uint(_mm256_movemask_epi8(whitespaceBytes(data, set1, cmpeq, vor)));
+            else
+                mask = uint(_mm256_movemask_epi8(stringStopBytes(data, set1, cmpeq, vor)));
+            if (mask)
+                return ptr + qCountTrailingZeroBits(mask);
+        }
+    }
+
+    const auto set1 = [](char c) { return _mm_set1_epi8(c); };
+    const auto cmpeq = [](__m128i a, __m128i b) { return _mm_cmpeq_epi8(a, b); };
+    const auto vor = [](__m128i a, __m128i b) { return _mm_or_si128(a, b); };
+    for ( ; end - ptr >= 16; ptr += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+        uint mask;
+        if constexpr (Whitespace)
+            mask = ~uint(_mm_movemask_epi8(whitespaceBytes(data, set1, cmpeq, vor))) & 0xffff;
+        else
+            mask = uint(_mm_movemask_epi8(stringStopBytes(data, set1, cmpeq, vor)));
+        if (mask)
+            return ptr + qCountTrailingZeroBits(mask);
+    }
+    return ptr;
+}
+#elif defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64)
+template <bool Whitespace>
+static const char *simdScan(const char *ptr, const char *end)
+{
+    for ( ; end - ptr >= 16; ptr += 16) {
+        const uint8x16_t data = vld1q_u8(reinterpret_cast<const uint8_t *>(ptr));
+        uint8x16_t found;
+        if constexpr (Whitespace) {
+            const uint8x16_t ws = vorrq_u8(vorrq_u8(vceqq_u8(data, vdupq_n_u8(Space)),
+                                                    vceqq_u8(data, vdupq_n_u8(Tab))),
+                                           vorrq_u8(vceqq_u8(data, vdupq_n_u8(LineFeed)),
+                                                    vceqq_u8(data, vdupq_n_u8(Return))));
+            found = vmvnq_u8(ws);
+        } else {
+            found = vorrq_u8(vorrq_u8(vceqq_u8(data, vdupq_n_u8(Quote)),
+                                      vceqq_u8(data, vdupq_n_u8('\\'))),
+                             vcgeq_u8(data, vdupq_n_u8(0x80)));
+        }
+        // narrow each byte of the comparison to a nibble of a 64-bit mask
+        const uint64_t mask =
+                vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(found), 4)), 0);
+        if (mask)
+            return ptr + qCountTrailingZeroBits(mask) / 4;
+    }
+    return ptr;
+}
+#else
+template <bool Whitespace>
+static const char *simdScan(const char *ptr, const char *)
+{
+    return ptr;
+}
+#endif
+
+static inline bool isJsonWhitespace(char c)
+{
+    return c == Space || c == Tab || c == LineFeed || c == Return;
+}
+
+// Returns a pointer to the first character in [ptr, end) that is not
+// whitespace, or end.
+const char *QJsonPrivate::skipWhitespace(const char *ptr, const char *end)
+{
+    ptr = simdScan<true>(ptr, end);
+    while (ptr < end && isJsonWhitespace(*ptr))
+        ++ptr;
+    return ptr;
+}
+
+// Returns a pointer to the first quote, backslash or non-US-ASCII
+// character in [ptr, end), or end.
+const char *QJsonPrivate::skipPlainStringCharacters(const char *ptr, const char *end)
+{
+    ptr = simdScan<false>(ptr, end);
+    while (ptr < end && *ptr != Quote && *ptr != '\\' && uchar(*ptr) < 0x80)
+        ++ptr;
+    return ptr;
+}
+
 void Parser::eatBOM()
 {
     // eat UTF-8 byte order mark
@@ -257,16 +377,10 @@ void Parser::eatBOM()
 
 bool Parser::eatSpace()
 {
-    while (json < end) {
-        if (*json > Space)
-            break;
-        if (*json != Space &&
-            *json != Tab &&
-            *json != LineFeed &&
-            *json != Return)
-            break;
-        ++json;
-    }
+    // most tokens are not preceded by whitespace
+    if (json < end && !isJsonWhitespace(*json))
+        return true;
+    json = skipWhitespace(json, end);
     return (json < end);
 }
 
@@ -685,12 +799,12 @@ bool Parser::parseValue()
 
 */
 
-bool Parser::parseNumber()
+// Returns a pointer to the end of the number starting at json, and
+// whether it is an integer in *isInt. Whether the number is valid is left
+// to the conversion.
+const char *QJsonPrivate::scanNumber(const char *json, const char *end, bool *isInt)
 {
-    QT_PARSER_TRACING_BEGIN << "parseNumber" << json;
-
-    const char *start = json;
-    bool isInt = true;
+    *isInt = true;
 
     // minus
     if (json < end && *json == '-')
@@ -708,20 +822,30 @@ bool Parser::parseNumber()
     if (json < end && *json == '.') {
         ++json;
         while (json < end && isAsciiDigit(*json)) {
-            isInt = isInt && *json == '0';
+            *isInt = *isInt && *json == '0';
             ++json;
         }
     }
 
     // exp = e [ minus / plus ] 1*DIGIT
     if (json < end && (*json == 'e' || *json == 'E')) {
-        isInt = false;
+        *isInt = false;
         ++json;
         if (json < end && (*json == '-' || *json == '+'))
             ++json;
         while (json < end && isAsciiDigit(*json))
             ++json;
     }
+    return json;
+}
+
+bool Parser::parseNumber()
+{
+    QT_PARSER_TRACING_BEGIN << "parseNumber" << json;
+
+    const char *start = json;
+    bool isInt;
+    json = scanNumber(json, end, &isInt);
 
     if (json >= end) {
         lastError = QJsonParseError::TerminationByNumber;
@@ -793,7 +917,7 @@ static inline bool addHexDigit(char digit, char32_t *result)
     return false;
 }
 
-static inline bool scanEscapeSequence(const char *&json, const char *end, char32_t *ch)
+bool QJsonPrivate::scanEscapeSequence(const char *&json, const char *end, char32_t *ch)
 {
     ++json;
     if (json >= end)
@@ -838,7 +962,7 @@ static inline bool scanEscapeSequence(const char *&json, const char *end, char32
     return true;
 }
 
-static inline bool scanUtf8Char(const char *&json, const char *end, char32_t *result)
+bool QJsonPrivate::scanUtf8Char(const char *&json, const char *end, char32_t *result)
 {
     const auto *usrc = reinterpret_cast<const uchar *>(json);
     const auto *uend = reinterpret_cast<const uchar *>(end);
@@ -861,6 +985,9 @@ bool Parser::parseString()
     bool isUtf8 = true;
     bool isAscii = true;
     while (json < end) {
+        json = skipPlainStringCharacters(json, end);
+        if (json >= end)
+            break;
         char32_t ch = 0;
         if (*json == '"')
             break;
@@ -899,10 +1026,17 @@ bool Parser::parseString()
 
     QT_PARSER_TRACING_DEBUG << "has escape sequences";
 
-    json = start;
-
-    QString ucs4;
+    // resume at the first escape sequence; the part before it was
+    // validated above
+    --json;
+    QString ucs4 = QString::fromUtf8(start, json - start);
     while (json < end) {
+        const char *run = json;
+        json = skipPlainStringCharacters(json, end);
+        if (json != run)
+            ucs4.append(QLatin1StringView(run, json - run));
+        if (json >= end)
+            break;
         char32_t ch = 0;
         if (*json == '"')
             break;
@@ -23,6 +23,13 @@ QT_BEGIN_NAMESPACE
 
 namespace QJsonPrivate {
 
+// Scanners shared with QJsonStreamReader; see qjsonparser.cpp
+const char *skipWhitespace(const char *ptr, const char *end);
+const char *skipPlainStringCharacters(const char *ptr, const char *end);
+const char *scanNumber(const char *json, const char *end, bool *isInt);
+bool scanEscapeSequence(const char *&json, const char *end, char32_t *ch);
+bool scanUtf8Char(const char *&json, const char *end, char32_t *result);
+
 class Parser
 {
 public:
@@ -0,0 +1,897 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qjsonstreamreader.h"
+
+#include "qjson_p.h"
+#include "qjsonparser_p.h"
+
+#include <private/qnumeric_p.h>
+#include <qiodevice.h>
+#include <qvarlengtharray.h>
+
+#include <climits>
+
+QT_BEGIN_NAMESPACE
+
+using namespace QJsonPrivate;
+
+/*!
+    \class QJsonStreamReader
+    \inmodule QtCore
+    \ingroup json
+    \ingroup qtserialization
+    \reentrant
+    \since 6.9
+
+    \brief The QJsonStreamReader class is a fast parser for reading JSON
+    token by token from a QByteArray or a QIODevice.
+
+    QJsonDocument::fromJson() parses a whole document into memory before
+    any of it can be used. QJsonStreamReader instead reports the document
+    one token at a time, and only keeps the token being read in memory,
+    so that it can process documents far larger than the available memory,
+    or data that arrives in parts, like the body of a network reply.
+
+    The reader reads a sequence of JSON values separated by whitespace,
+    such as a single document or a file in the JSON Lines format. Unlike
+    QJsonDocument, it accepts any value at the top level, not only objects
+    and arrays.
+
+    The basic concept is readNext(), which reads the next token and returns
+    its type. The value of the token is then available with text(),
+    toInteger(), toDouble() and toBool(). A typical loop over the members of
+    an object looks like this:
+
+    \code
+    QJsonStreamReader reader(&file);
+    if (reader.readNext() == QJsonStreamReader::StartObject) {
+        while (reader.readNext() == QJsonStreamReader::Name) {
+            const QString name = reader.text().toString();
+            reader.readNext();
+            if (name == u"id")
+                id = reader.toInteger();
+            else
+                reader.skipCurrentValue();
+        }
+    }
+    if (reader.hasError())
+        qWarning() << reader.errorString() << "at offset" << reader.offset();
+    \endcode
+
+    readValue() reads the value starting at the current token into a
+    QJsonValue, which is a convenient way to read the records of a file in
+    the JSON Lines format one at a time:
+
+    \code
+    QJsonStreamReader reader(&file);
+    while (reader.readNext() == QJsonStreamReader::StartObject)
+        process(reader.readValue().toObject());
+    \endcode
+
+    \section1 Incremental parsing
+
+    When the reader reaches the end of the data that is available before a
+    token is complete, readNext() returns NoToken and atEnd() returns
+    \c true. Once more data is available, either because it was passed to
+    addData() or because the device() received it, the next call to
+    readNext() continues where the previous one stopped. Similarly,
+    readValue() returns an undefined QJsonValue and leaves the reader on
+    the current token when the value is not complete yet.
+
+    The reader cannot tell that a sequential device or the data passed
+    to addData() is complete. A document that ends prematurely is only
+    reported as an error when reading from a random-access device such as
+    a QFile; otherwise readNext() keeps returning NoToken. For the same
+    reason, a number at the top level is only reported once the character
+    following it has been read.
+
+    \section1 Memory use
+
+    The reader keeps the token being read, and reads the device in chunks
+    of a few kilobytes, so the memory it uses does not depend on the size
+    of the document, but on the size of its largest string. readValue()
+    additionally keeps the text of the value being read.
+
+    \sa QJsonStreamWriter, QJsonDocument, QCborStreamReader
+*/
+
+/*!
+    \enum QJsonStreamReader::TokenType
+
+    This enum specifies the type of token that the reader has read.
+
+    \value NoToken      No token was read yet, or the reader reached the
+                        end of the data available.
+    \value Invalid      An error occurred, see error() and errorString().
+    \value StartArray   The start of an array.
+    \value EndArray     The end of an array.
+    \value StartObject  The start of an object.
+    \value EndObject    The end of an object.
+    \value Name         The name of a member of an object, available with
+                        text(). The value of the member follows.
+    \value String       A string, available with text().
+    \value Integer      A number without a fractional part that fits in a
+                        qint64, available with toInteger().
+    \value Double       Any other number, available with toDouble().
+    \value Bool         \c true or \c false, available with toBool().
+    \value Null         \c null.
+*/
+
+class QJsonStreamReaderPrivate
+{
+public:
+    enum {
+        // read at least this many bytes from the device at a time
+        ChunkSize = 16 * 1024,
+        NestingLimit = 1024
+    };
+
+    enum State : quint8 {
+        ExpectValue,
+        ExpectFirstValueOrEnd,
+        ExpectName,
+        ExpectFirstNameOrEnd,
+        ExpectNameSeparator,
+        ExpectValueSeparator
+    };
+
+    enum Result {
+        TokenRead,
+        NeedData,
+        Failed
+    };
+
+    // what readValue() restores when the value is not complete yet
+    struct SavedState
+    {
+        qint64 offset;
+        qint64 tokenOffset;
+        QVarLengthArray<char, 16> containers;
+        State state;
+        QJsonStreamReader::TokenType type;
+    };
+
+    QJsonStreamReader::TokenType readNext();
+    Result readToken(bool atEndOfInput);
+    Result readValueToken(const char *ptr, const char *end, bool atEndOfInput);
+    Result readString(const char *ptr, const char *end, bool atEndOfInput);
+    Result readLiteral(const char *ptr, const char *end, bool atEndOfInput,
+                       QByteArrayView literal);
+    Result readNumber(const char *ptr, const char *end, bool atEndOfInput);
+    Result startContainer(const char *ptr);
+    Result endContainer(const char *ptr);
+    Result endOfInput(const char *end);
+    Result fail(const char *ptr, QJsonParseError::ParseError error);
+
+    bool fetchMore();
+    void compact();
+    bool isAtEndOfInput() const
+    { return device && !device->isSequential() && device->atEnd(); }
+
+    SavedState saveState() const
+    { return { bufferOffset + pos, tokenOffset, containers, state, type }; }
+    void restoreState(const SavedState &saved);
+
+    void reset(QIODevice *newDevice, const QByteArray &data);
+
+    QIODevice *device = nullptr;
+    QByteArray buffer;
+    qint64 bufferOffset = 0;    // offset in the stream of the start of the buffer
+    qsizetype pos = 0;          // index in the buffer of the first byte not read
+    qint64 keepOffset = -1;     // offset of the first byte compact() must keep
+    qint64 tokenOffset = 0;     // offset of the current token
+    qsizetype skipToDepth = -1; // depth that skipCurrentValue() returns to
+
+    QVarLengthArray<char, 16> containers;  // '[' or '{' for each open container
+    State state = ExpectValue;
+    QJsonStreamReader::TokenType type = QJsonStreamReader::NoToken;
+    QJsonParseError::ParseError lastError = QJsonParseError::NoError;
+    bool checkedBom = false;
+    bool needData = false;
+    bool decodeStrings = true;
+
+    QString text;
+    qint64 integer = 0;
+    double number = 0;
+    bool boolean = false;
+};
+
+void QJsonStreamReaderPrivate::reset(QIODevice *newDevice, const QByteArray &data)
+{
+    device = newDevice;
+    buffer = data;
+    bufferOffset = 0;
+    pos = 0;
+    keepOffset = -1;
+    tokenOffset = 0;
+    skipToDepth = -1;
+    containers.clear();
+    state = ExpectValue;
+    type = QJsonStreamReader::NoToken;
+    lastError = QJsonParseError::NoError;
+    checkedBom = false;
+    needData = false;
+    decodeStrings = true;
+    text.clear();
+}
+
+void QJsonStreamReaderPrivate::restoreState(const SavedState &saved)
+{
+    Q_ASSERT(saved.offset >= bufferOffset);
+    pos = qsizetype(saved.offset - bufferOffset);
+    tokenOffset = saved.tokenOffset;
+    containers = saved.containers;
+    state = saved.state;
+    type = saved.type;
+}
+
+// Drops the bytes that were read from the start of the buffer.
+void QJsonStreamReaderPrivate::compact()
+{
+    qsizetype drop = pos;
+    if (keepOffset >= 0)
+        drop = qMin(drop, qsizetype(keepOffset - bufferOffset));
+    if (type == QJsonStreamReader::StartArray || type == QJsonStreamReader::StartObject)
+        drop = qMin(drop, qsizetype(tokenOffset - bufferOffset));   // for readValue()
+    if (drop <= 0)
+        return;
+    buffer.remove(0, drop);
+    bufferOffset += drop;
+    pos -= drop;
+}
+
+bool QJsonStreamReaderPrivate::fetchMore()
+{
+    if (!device)
+        return false;
+    compact();
+
+    // read more than the part of a token that is buffered already, so that
+    // a long token does not get rescanned for each chunk
+    qint64 wanted = qMax<qint64>(ChunkSize, buffer.size() - pos);
+    if (device->isSequential())
+        wanted = qMax(wanted, device->bytesAvailable());
+
+    const qsizetype oldSize = buffer.size();
+    buffer.resize(oldSize + wanted);
+    const qint64 n = device->read(buffer.data() + oldSize, wanted);
+    buffer.resize(oldSize + qMax<qint64>(n, 0));
+    return n > 0;
+}
+
+QJsonStreamReaderPrivate::Result
+QJsonStreamReaderPrivate::fail(const char *ptr, QJsonParseError::ParseError error)
+{
+    pos = ptr - buffer.constData();
+    lastError = error;
+    type = QJsonStreamReader::Invalid;
+    return Failed;
+}
+
+QJsonStreamReaderPrivate::Result QJsonStreamReaderPrivate::startContainer(const char *ptr)
+{
+    if (containers.size() >= NestingLimit)
+        return fail(ptr, QJsonParseError::DeepNesting);
+    containers.append(*ptr);
+    if (*ptr == '[') {
+        type = QJsonStreamReader::StartArray;
+        state = ExpectFirstValueOrEnd;
+    } else {
+        type = QJsonStreamReader::StartObject;
+        state = ExpectFirstNameOrEnd;
+    }
+    pos = ptr + 1 - buffer.constData();
+    return TokenRead;
+}
+
+QJsonStreamReaderPrivate::Result QJsonStreamReaderPrivate::endContainer(const char *ptr)
+{
+    type = containers.back() == '[' ? QJsonStreamReader::EndArray : QJsonStreamReader::EndObject;
+    containers.removeLast();
+    state = ExpectValueSeparator;
+    pos = ptr + 1 - buffer.constData();
+    return TokenRead;
+}
+
+// Called when only whitespace is left at the end of the input.
+QJsonStreamReaderPrivate::Result QJsonStreamReaderPrivate::endOfInput(const char *end)
+{
+    if (containers.isEmpty())
+        return NeedData;
+    return fail(end, containers.back() == '[' ? QJsonParseError::UnterminatedArray
+                                              : QJsonParseError::UnterminatedObject);
+}
+
+QJsonStreamReaderPrivate::Result
+QJsonStreamReaderPrivate::readLiteral(const char *ptr, const char *end, bool atEndOfInput,
+                                      QByteArrayView literal)
+{
+    const QByteArrayView available(ptr, qMin(end - ptr, literal.size()));
+    if (available != literal.first(available.size()))
+        return fail(ptr, QJsonParseError::IllegalValue);
+    if (available.size() < literal.size())
+        return atEndOfInput ? fail(ptr, QJsonParseError::IllegalValue) : NeedData;
+
+    if (literal.front() == 'n') {
+        type = QJsonStreamReader::Null;
+    } else {
+        type = QJsonStreamReader::Bool;
+        boolean = literal.front() == 't';
+    }
+    state = ExpectValueSeparator;
+    pos = ptr + literal.size() - buffer.constData();
+    return TokenRead;
+}
+
+QJsonStreamReaderPrivate::Result
+QJsonStreamReaderPrivate::readNumber(const char *ptr, const char *end, bool atEndOfInput)
+{
+    bool isInt;
+    const char *numberEnd = scanNumber(ptr, end, &isInt);
+    if (numberEnd == end && !atEndOfInput)
+        return NeedData;    // more digits may follow
+    if (numberEnd == ptr)
+        return fail(ptr, QJsonParseError::IllegalValue);
+
+    const QByteArrayView digits(ptr, numberEnd - ptr);
+    bool ok = false;
+    if (isInt)
+        integer = digits.toLongLong(&ok);
+    if (ok) {
+        type = QJsonStreamReader::Integer;
+    } else {
+        // same as QJsonDocument::fromJson()
+        const double d = digits.toDouble(&ok);
+        if (!ok)
+            return fail(ptr, QJsonParseError::IllegalNumber);
+        if (convertDoubleTo(d, &integer)) {
+            type = QJsonStreamReader::Integer;
+        } else {
+            type = QJsonStreamReader::Double;
+            number = d;
+        }
+    }
+    state = ExpectValueSeparator;
+    pos = numberEnd - buffer.constData();
+    return TokenRead;
+}
+
+static qsizetype utf8SequenceLength(uchar lead)
+{
+    if ((lead & 0xe0) == 0xc0)
+        return 2;
+    if ((lead & 0xf0) == 0xe0)
+        return 3;
+    if ((lead & 0xf8) == 0xf0)
+        return 4;
+    return 1;
+}
+
+// Reads the string whose opening quote precedes ptr into text.
+QJsonStreamReaderPrivate::Result
+QJsonStreamReaderPrivate::readString(const char *ptr, const char *end, bool atEndOfInput)
+{
+    text.resize(0);
+    while (true) {
+        // a run of characters that need no unescaping
+        const char *run = ptr;
+        bool isAscii = true;
+        while (true) {
+            ptr = skipPlainStringCharacters(ptr, end);
+            if (ptr == end || *ptr == '"' || *ptr == '\\')
+                break;
+            const char *next = ptr;
+            char32_t ch;
+            if (!scanUtf8Char(next, end, &ch)) {
+                if (!atEndOfInput && end - ptr < utf8SequenceLength(uchar(*ptr)))
+                    return NeedData;
+                return fail(ptr, QJsonParseError::IllegalUTF8String);
+            }
+            isAscii = false;
+            ptr = next;
+        }
+        if (decodeStrings && ptr != run) {
+            if (isAscii)
+                text.append(QLatin1StringView(run, ptr - run));
+            else
+                text.append(QUtf8StringView(run, ptr - run));
+        }
+
+        if (ptr == end)
+            return atEndOfInput ? fail(ptr, QJsonParseError::UnterminatedString) : NeedData;
+        if (*ptr == '"')
+            break;
+
+        // an escape sequence
+        if (!atEndOfInput && (end - ptr < 2 || (ptr[1] == 'u' && end - ptr < 6)))
+            return NeedData;
+        char32_t ch = 0;
+        if (!scanEscapeSequence(ptr, end, &ch))
+            return fail(ptr, QJsonParseError::IllegalEscapeSequence);
+        if (decodeStrings)
+            text.append(QChar::fromUcs4(ch));
+    }
+
+    pos = ptr + 1 - buffer.constData();
+    return TokenRead;
+}
+
+QJsonStreamReaderPrivate::Result
+QJsonStreamReaderPrivate::readValueToken(const char *ptr, const char *end, bool atEndOfInput)
+{
+    switch (*ptr) {
+    case '[':
+    case '{':
+        return startContainer(ptr);
+    case '"': {
+        const Result result = readString(ptr + 1, end, atEndOfInput);
+        if (result == TokenRead) {
+            type = QJsonStreamReader::String;
+            state = ExpectValueSeparator;
+        }
+        return result;
+    }
+    case 't':
+        return readLiteral(ptr, end, atEndOfInput, "true");
+    case 'f':
+        return readLiteral(ptr, end, atEndOfInput, "false");
+    case 'n':
+        return readLiteral(ptr, end, atEndOfInput, "null");
+    case ',':
+        return fail(ptr, QJsonParseError::IllegalValue);
+    case ']':
+    case '}':
+        return fail(ptr, QJsonParseError::MissingObject);
+    default:
+        return readNumber(ptr, end, atEndOfInput);
+    }
+}
+
+QJsonStreamReaderPrivate::Result QJsonStreamReaderPrivate::readToken(bool atEndOfInput)
+{
+    const char *const begin = buffer.constData();
+    const char *const end = begin + buffer.size();
+    const char *ptr = begin + pos;
+
+    if (!checkedBom) {
+        // skip a UTF-8 byte order mark at the start of the stream
+        const QByteArrayView bom("\xef\xbb\xbf");
+        const QByteArrayView available(ptr, qMin(end - ptr, bom.size()));
+        if (available == bom.first(available.size())) {
+            if (available.size() < bom.size() && !atEndOfInput)
+                return NeedData;
+            ptr += available.size();
+        }
+        checkedBom = true;
+    }
+
+    while (true) {
+        ptr = skipWhitespace(ptr, end);
+        pos = ptr - begin;
+        if (ptr == end)
+            return atEndOfInput ? endOfInput(end) : NeedData;
+        tokenOffset = bufferOffset + pos;
+
+        switch (state) {
+        case ExpectNameSeparator:
+            if (*ptr != ':')
+                return fail(ptr, QJsonParseError::MissingNameSeparator);
+            ++ptr;
+            state = ExpectValue;
+            continue;
+
+        case ExpectValueSeparator:
+            if (containers.isEmpty()) {
+                // another value at the top level
+                state = ExpectValue;
+                continue;
+            }
+            if (*ptr == ',') {
+                ++ptr;
+                state = containers.back() == '[' ? ExpectValue : ExpectName;
+                continue;
+            }
+            if (*ptr == (containers.back() == '[' ? ']' : '}'))
+                return endContainer(ptr);
+            return fail(ptr, containers.back() == '[' ? QJsonParseError::MissingValueSeparator
+                                                      : QJsonParseError::UnterminatedObject);
+
+        case ExpectFirstNameOrEnd:
+            if (*ptr == '}')
+                return endContainer(ptr);
+            Q_FALLTHROUGH();
+        case ExpectName: {
+            if (*ptr != '"') {
+                return fail(ptr, state == ExpectName && *ptr == '}'
+                                         ? QJsonParseError::MissingObject
+                                         : QJsonParseError::UnterminatedObject);
+            }
+            const Result result = readString(ptr + 1, end, atEndOfInput);
+            if (result == TokenRead) {
+                type = QJsonStreamReader::Name;
+                state = ExpectNameSeparator;
+            }
+            return result;
+        }
+
+        case ExpectFirstValueOrEnd:
+            if (*ptr == ']')
+                return endContainer(ptr);
+            Q_FALLTHROUGH();
+        case ExpectValue:
+            return readValueToken(ptr, end, atEndOfInput);
+        }
+        Q_UNREACHABLE_RETURN(Failed);
+    }
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::readNext()
+{
+    if (lastError != QJsonParseError::NoError)
+        return QJsonStreamReader::Invalid;
+
+    Result result;
+    while ((result = readToken(false)) == NeedData) {
+        if (fetchMore())
+            continue;
+        if (isAtEndOfInput())
+            result = readToken(true);
+        break;
+    }
+
+    needData = result == NeedData;
+    if (needData)
+        type = QJsonStreamReader::NoToken;
+    return type;
+}
+
+/*!
+    Constructs a QJsonStreamReader with no data. Use addData() or
+    setDevice() to give it data to read.
+*/
+QJsonStreamReader::QJsonStreamReader()
+    : d(new QJsonStreamReaderPrivate)
+{
+}
+
+/*!
+    Constructs a QJsonStreamReader that reads the JSON text in \a data.
+
+    The reader shares \a data rather than copying it. More data can be
+    added with addData().
+*/
+QJsonStreamReader::QJsonStreamReader(const QByteArray &data)
+    : QJsonStreamReader()
+{
+    d->buffer = data;
+}
+
+/*!
+    Constructs a QJsonStreamReader that reads the JSON text from \a device,
+    which must be open for reading.
+*/
+QJsonStreamReader::QJsonStreamReader(QIODevice *device)
+    : QJsonStreamReader()
+{
+    d->device = device;
+}
+
+/*!
+    Destroys the reader. The device() is not closed or deleted.
+*/
+QJsonStreamReader::~QJsonStreamReader()
+    = default;
+
+/*!
+    Sets the device the reader reads from to \a device, and resets the
+    reader to read a new stream.
+
+    \sa device(), clear()
+*/
+void QJsonStreamReader::setDevice(QIODevice *device)
+{
+    d->reset(device, QByteArray());
+}
+
+/*!
+    Returns the device the reader reads from, or \nullptr if it reads data
+    passed to the constructor or addData().
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamReader::device() const
+{
+    return d->device;
+}
+
+/*!
+    Adds \a data to the data the reader reads. This is only allowed when
+    the reader has no device().
+
+    \sa readNext(), atEnd()
+*/
+void QJsonStreamReader::addData(QByteArrayView data)
+{
+    if (d->device) {
+        qWarning("QJsonStreamReader: addData() with a device()");
+        return;
+    }
+    d->compact();
+    d->buffer.append(data);
+    d->needData = false;
+}
+
+/*!
+    Resets the reader to read a new stream, and removes the data and the
+    device() it had.
+
+    \sa setDevice(), addData()
+*/
+void QJsonStreamReader::clear()
+{
+    d->reset(nullptr, QByteArray());
+}
+
+/*!
+    Returns \c true if the reader has read all the data that is available,
+    or if an error occurred; otherwise returns \c false.
+
+    When the data read so far is not the complete stream, more data can be
+    added with addData() or be read from the device(), and reading can
+    continue.
+
+    \sa readNext(), hasError()
+*/
+bool QJsonStreamReader::atEnd() const
+{
+    if (d->lastError != QJsonParseError::NoError)
+        return true;
+    return d->needData && !(d->device && d->device->bytesAvailable() > 0);
+}
+
+/*!
+    Reads the next token and returns its type.
+
+    Returns NoToken if the data available ends before the next token, and
+    Invalid if an error occurred. Once an error occurred, readNext() keeps
+    returning Invalid.
+
+    \sa tokenType(), atEnd()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::readNext()
+{
+    d->skipToDepth = -1;
+    return d->readNext();
+}
+
+/*!
+    Returns the type of the current token, which is the one readNext()
+    returned last.
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::tokenType() const
+{
+    return d->type;
+}
+
+/*!
+    Returns the number of arrays and objects that contain the current
+    token. For StartArray and StartObject tokens, this includes the
+    container that starts; for EndArray and EndObject tokens, it does not
+    include the container that ends.
+*/
+qsizetype QJsonStreamReader::depth() const
+{
+    return d->containers.size();
+}
+
+/*!
+    Returns the number of bytes the reader has read from the start of the
+    stream, or, if an error occurred, the offset where it was found.
+*/
+qint64 QJsonStreamReader::offset() const
+{
+    return d->bufferOffset + d->pos;
+}
+
+/*!
+    Returns the text of the current token if it is a Name or a String;
+    otherwise returns an empty string view.
+
+    The view is only valid until the next call to readNext().
+*/
+QStringView QJsonStreamReader::text() const
+{
+    if (d->type == Name || d->type == String)
+        return d->text;
+    return {};
+}
+
+/*!
+    Returns the value of the current token if it is an Integer; otherwise
+    returns 0.
+
+    \sa toDouble()
+*/
+qint64 QJsonStreamReader::toInteger() const
+{
+    return d->type == Integer ? d->integer : 0;
+}
+
+/*!
+    Returns the value of the current token if it is an Integer or a Double;
+    otherwise returns 0.
+
+    \sa toInteger()
+*/
+double QJsonStreamReader::toDouble() const
+{
+    if (d->type == Integer)
+        return double(d->integer);
+    return d->type == Double ? d->number : 0;
+}
+
+/*!
+    Returns the value of the current token if it is a Bool; otherwise
+    returns \c false.
+*/
+bool QJsonStreamReader::toBool() const
+{
+    return d->type == Bool && d->boolean;
+}
+
+/*!
+    Returns the value that starts at the current token as a QJsonValue.
+
+    If the current token is StartArray or StartObject, the whole array or
+    object is read, and the current token becomes the EndArray or
+    EndObject that ends it. If the current token is a value, it is returned.
+    Otherwise, an undefined QJsonValue is returned.
+
+    When the array or object is not complete in the data available, the
+    reader stays on its start and an undefined QJsonValue is returned, so
+    that readValue() can be called again once more data is available.
+    atEnd() then returns \c true. An undefined QJsonValue is also returned
+    if an error occurred.
+
+    \sa skipCurrentValue()
+*/
+QJsonValue QJsonStreamReader::readValue()
+{
+    switch (d->type) {
+    case String:
+        return d->text;
+    case Integer:
+        return d->integer;
+    case Double:
+        return d->number;
+    case Bool:
+        return d->boolean;
+    case Null:
+        return QJsonValue::Null;
+    case StartArray:
+    case StartObject:
+        break;
+    default:
+        return QJsonValue::Undefined;
+    }
+
+    // scan for the end of the container, then parse its text in one go
+    const QJsonStreamReaderPrivate::SavedState saved = d->saveState();
+    const qsizetype targetDepth = depth() - 1;
+    d->skipToDepth = -1;
+    d->keepOffset = d->tokenOffset;
+    d->decodeStrings = false;
+    TokenType type;
+    do {
+        type = d->readNext();
+    } while (depth() > targetDepth && type != NoToken && type != Invalid);
+    d->decodeStrings = true;
+    d->keepOffset = -1;
+
+    if (type == Invalid)
+        return QJsonValue::Undefined;
+    if (type == NoToken) {
+        d->restoreState(saved);
+        d->needData = true;
+        return QJsonValue::Undefined;
+    }
+
+    const qint64 size = offset() - saved.tokenOffset;
+    const char *json = d->buffer.constData() + (saved.tokenOffset - d->bufferOffset);
+    if (size > INT_MAX) {
+        d->fail(json, QJsonParseError::DocumentTooLarge);
+        return QJsonValue::Undefined;
+    }
+
+    Parser parser(json, int(size));
+    QJsonParseError error;
+    const QCborValue value = parser.parse(&error);
+    if (error.error != QJsonParseError::NoError) {
+        // cannot happen for text that was scanned, but be safe
+        d->fail(json + error.offset, error.error);
+        return QJsonValue::Undefined;
+    }
+    return Value::fromTrustedCbor(value);
+}
+
+/*!
+    Skips the value that starts at the current token, and returns \c true
+    if it succeeded.
+
+    If the current token is StartArray or StartObject, the reader reads up
+    to the EndArray or EndObject that ends it. If the current token is a
+    value, there is nothing to skip.
+
+    Returns \c false if the current token is not the start of a value, if an
+    error occurred, or if the data available ends before the value does. In
+    the last case, call skipCurrentValue() again once more data is
+    available to continue skipping; the skipped data is not kept in memory.
+
+    \sa readValue()
+*/
+bool QJsonStreamReader::skipCurrentValue()
+{
+    if (d->skipToDepth < 0) {
+        switch (d->type) {
+        case String:
+        case Integer:
+        case Double:
+        case Bool:
+        case Null:
+            return true;
+        case StartArray:
+        case StartObject:
+            d->skipToDepth = depth() - 1;
+            break;
+        default:
+            return false;
+        }
+    }
+
+    d->decodeStrings = false;
+    while (depth() > d->skipToDepth) {
+        const TokenType type = d->readNext();
+        if (type == NoToken || type == Invalid)
+            break;
+    }
+    d->decodeStrings = true;
+    if (depth() > d->skipToDepth && d->lastError == QJsonParseError::NoError)
+        return false;
+    d->skipToDepth = -1;
+    return d->lastError == QJsonParseError::NoError;
+}
+
+/*!
+    \fn bool QJsonStreamReader::hasError() const
+
+    Returns \c true if an error occurred; otherwise returns \c false.
+
+    \sa error(), errorString()
+*/
+
+/*!
+    Returns the error that occurred, or QJsonParseError::NoError.
+
+    \sa errorString(), offset()
+*/
+QJsonParseError::ParseError QJsonStreamReader::error() const
+{
+    return d->lastError;
+}
+
+/*!
+    Returns a human-readable description of the error that occurred.
+
+    \sa error()
+*/
+QString QJsonStreamReader::errorString() const
+{
+    QJsonParseError error;
+    error.error = d->lastError;
+    return error.errorString();
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qjsonstreamreader.cpp"
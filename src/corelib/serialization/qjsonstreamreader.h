@@ -0,0 +1,74 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QJSONSTREAMREADER_H
+#define QJSONSTREAMREADER_H
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonvalue.h>
+#include <QtCore/qobjectdefs.h>
+#include <QtCore/qscopedpointer.h>
+#include <QtCore/qstringview.h>
+
+QT_BEGIN_NAMESPACE
+
+class QIODevice;
+
+class QJsonStreamReaderPrivate;
+class Q_CORE_EXPORT QJsonStreamReader
+{
+    Q_GADGET
+public:
+    enum TokenType {
+        NoToken = 0,
+        Invalid,
+        StartArray,
+        EndArray,
+        StartObject,
+        EndObject,
+        Name,
+        String,
+        Integer,
+        Double,
+        Bool,
+        Null
+    };
+    Q_ENUM(TokenType)
+
+    QJsonStreamReader();
+    explicit QJsonStreamReader(const QByteArray &data);
+    explicit QJsonStreamReader(QIODevice *device);
+    ~QJsonStreamReader();
+    Q_DISABLE_COPY(QJsonStreamReader)
+
+    void setDevice(QIODevice *device);
+    QIODevice *device() const;
+    void addData(QByteArrayView data);
+    void clear();
+
+    bool atEnd() const;
+    TokenType readNext();
+    TokenType tokenType() const;
+    qsizetype depth() const;
+    qint64 offset() const;
+
+    QStringView text() const;
+    qint64 toInteger() const;
+    double toDouble() const;
+    bool toBool() const;
+
+    QJsonValue readValue();
+    bool skipCurrentValue();
+
+    bool hasError() const { return error() != QJsonParseError::NoError; }
+    QJsonParseError::ParseError error() const;
+    QString errorString() const;
+
+private:
+    QScopedPointer<QJsonStreamReaderPrivate> d;
+};
+
+QT_END_NAMESPACE
+
+#endif // QJSONSTREAMREADER_H
@@ -0,0 +1,435 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qjsonstreamwriter.h"
+
+#include "qjson_p.h"
+#include "qjsonwriter_p.h"
+
+#include <private/qnumeric_p.h>
+#include <qiodevice.h>
+#include <qjsonvalue.h>
+#include <qlocale.h>
+#include <qvarlengtharray.h>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+using namespace QJsonPrivate;
+
+/*!
+    \class QJsonStreamWriter
+    \inmodule QtCore
+    \ingroup json
+    \ingroup qtserialization
+    \reentrant
+    \since 6.9
+
+    \brief The QJsonStreamWriter class writes JSON token by token to a
+    QByteArray or a QIODevice.
+
+    QJsonDocument::toJson() needs the whole document in memory, and creates
+    all of its text before any of it can be written. QJsonStreamWriter
+    instead writes the document as it is produced, and only buffers a few
+    kilobytes of text before passing them to the device(), so that it can
+    write documents of any size with little memory.
+
+    Arrays and objects are started with startArray() and startObject(), and
+    ended with endArray() and endObject(). Values are written with
+    append(). Inside an object, the calls to append() alternate between the
+    name of a member, which must be a string, and its value:
+
+    \code
+    QJsonStreamWriter writer(&file);
+    writer.startObject();
+    writer.append("id");
+    writer.append(42);
+    writer.append("tags");
+    writer.startArray();
+    for (const QString &tag : tags)
+        writer.append(tag);
+    writer.endArray();
+    writer.endObject();
+    \endcode
+
+    The text written is the same as the one of QJsonDocument::toJson() for
+    the same document and format(), except that each value at the top
+    level is followed by a newline. Several values can be written at the
+    top level; in the QJsonDocument::Compact format, this produces a file
+    in the JSON Lines format, with one value per line.
+
+    As with QJsonDocument, numbers that are not finite are written as
+    \c null.
+
+    \sa QJsonStreamReader, QJsonDocument, QCborStreamWriter
+*/
+
+class QJsonStreamWriterPrivate
+{
+public:
+    enum {
+        // pass the text to the device once there is this much of it
+        FlushSize = 16 * 1024
+    };
+
+    struct Container
+    {
+        char type;      // '[' or '{'
+        bool isEmpty;
+    };
+
+    QJsonStreamWriterPrivate(QIODevice *device, QByteArray *data)
+        : device(device), data(data)
+    {
+    }
+
+    QByteArray &output() { return device ? buffer : *data; }
+    bool expectsName() const
+    { return !containers.isEmpty() && containers.back().type == '{' && !hasName; }
+
+    void writeSeparator();
+    void writeIndent(qsizetype level);
+    void writeString(QAnyStringView str);
+    bool startValue();
+    void endValue();
+    void startContainer(char type);
+    bool endContainer(char type);
+    void flush();
+
+    QIODevice *device;
+    QByteArray *data;
+    QByteArray buffer;
+    QVarLengthArray<Container, 16> containers;
+    bool compact = false;
+    bool hasName = false;
+};
+
+void QJsonStreamWriterPrivate::writeIndent(qsizetype level)
+{
+    if (!compact)
+        output().append(4 * level, ' ');
+}
+
+// Writes what precedes an element of an array or a member of an object.
+void QJsonStreamWriterPrivate::writeSeparator()
+{
+    Container &container = containers.back();
+    if (!container.isEmpty)
+        output() += compact ? "," : ",\n";
+    container.isEmpty = false;
+    writeIndent(containers.size());
+}
+
+void QJsonStreamWriterPrivate::writeString(QAnyStringView str)
+{
+    QByteArray &json = output();
+    str.visit([&json](auto str) {
+        if constexpr (std::is_same_v<decltype(str), QStringView>) {
+            Writer::stringToJson(str, json);
+        } else {
+            // most names and many values need no escaping
+            const auto isPlain = [](char c) {
+                return uchar(c) >= 0x20 && uchar(c) < 0x80 && c != '"' && c != '\\';
+            };
+            if (std::all_of(str.begin(), str.end(), isPlain)) {
+                json += '"';
+                json.append(str.data(), str.size());
+                json += '"';
+            } else {
+                Writer::stringToJson(str.toString(), json);
+            }
+        }
+    });
+}
+
+// Writes what precedes a value, and returns false if a value is not
+// allowed here.
+bool QJsonStreamWriterPrivate::startValue()
+{
+    if (containers.isEmpty())
+        return true;
+    if (containers.back().type == '[') {
+        writeSeparator();
+        return true;
+    }
+    if (!hasName) {
+        qWarning("QJsonStreamWriter: the name of an object member must be a string");
+        return false;
+    }
+    hasName = false;
+    return true;
+}
+
+void QJsonStreamWriterPrivate::endValue()
+{
+    if (containers.isEmpty()) {
+        // end each value at the top level with a newline, like JSON Lines
+        output() += '\n';
+        flush();
+    } else if (device && buffer.size() >= FlushSize) {
+        flush();
+    }
+}
+
+void QJsonStreamWriterPrivate::startContainer(char type)
+{
+    if (!startValue())
+        return;
+    output() += type;
+    if (!compact)
+        output() += '\n';
+    containers.append({ type, true });
+}
+
+bool QJsonStreamWriterPrivate::endContainer(char type)
+{
+    if (containers.isEmpty() || containers.back().type != type || hasName)
+        return false;
+    const Container container = containers.back();
+    containers.removeLast();
+    if (!compact && !container.isEmpty)
+        output() += '\n';
+    writeIndent(containers.size());
+    output() += type == '[' ? ']' : '}';
+    endValue();
+    return true;
+}
+
+void QJsonStreamWriterPrivate::flush()
+{
+    if (!device || buffer.isEmpty())
+        return;
+    device->write(buffer);
+    buffer.truncate(0);
+}
+
+/*!
+    Constructs a QJsonStreamWriter that writes to \a device, which must be
+    open for writing.
+*/
+QJsonStreamWriter::QJsonStreamWriter(QIODevice *device)
+    : d(new QJsonStreamWriterPrivate(device, nullptr))
+{
+}
+
+/*!
+    Constructs a QJsonStreamWriter that appends the text it writes to
+    \a data. The byte array must outlive the writer.
+*/
+QJsonStreamWriter::QJsonStreamWriter(QByteArray *data)
+    : d(new QJsonStreamWriterPrivate(nullptr, data))
+{
+}
+
+/*!
+    Destroys the writer, after passing the text that is still buffered to
+    the device(). The device is not closed or deleted.
+*/
+QJsonStreamWriter::~QJsonStreamWriter()
+{
+    d->flush();
+}
+
+/*!
+    Makes the writer write to \a device, after passing the text that is
+    still buffered to the previous device.
+
+    \sa device()
+*/
+void QJsonStreamWriter::setDevice(QIODevice *device)
+{
+    d->flush();
+    d->device = device;
+    d->data = nullptr;
+}
+
+/*!
+    Returns the device the writer writes to, or \nullptr if it writes to a
+    QByteArray.
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamWriter::device() const
+{
+    return d->device;
+}
+
+/*!
+    Sets the format of the text the writer writes to \a format. The default
+    is QJsonDocument::Indented.
+
+    \sa format()
+*/
+void QJsonStreamWriter::setFormat(QJsonDocument::JsonFormat format)
+{
+    d->compact = format == QJsonDocument::Compact;
+}
+
+/*!
+    Returns the format of the text the writer writes.
+
+    \sa setFormat()
+*/
+QJsonDocument::JsonFormat QJsonStreamWriter::format() const
+{
+    return d->compact ? QJsonDocument::Compact : QJsonDocument::Indented;
+}
+
+/*!
+    Writes the string \a str, which can be the name of an object member.
+*/
+void QJsonStreamWriter::append(QAnyStringView str)
+{
+    if (d->expectsName()) {
+        d->writeSeparator();
+        d->writeString(str);
+        d->output() += d->compact ? ":" : ": ";
+        d->hasName = true;
+        return;
+    }
+    if (!d->startValue())
+        return;
+    d->writeString(str);
+    d->endValue();
+}
+
+/*!
+    \overload
+
+    Writes the integer \a i.
+*/
+void QJsonStreamWriter::append(qint64 i)
+{
+    if (!d->startValue())
+        return;
+    d->output() += QByteArray::number(i);
+    d->endValue();
+}
+
+/*!
+    \overload
+
+    Writes the number \a d, or \c null if it is not finite.
+*/
+void QJsonStreamWriter::append(double d)
+{
+    if (!this->d->startValue())
+        return;
+    if (qt_is_finite(d))
+        this->d->output() += QByteArray::number(d, 'g', QLocale::FloatingPointShortest);
+    else
+        this->d->output() += "null";
+    this->d->endValue();
+}
+
+/*!
+    \overload
+
+    Writes \c true or \c false, depending on \a b.
+*/
+void QJsonStreamWriter::append(bool b)
+{
+    if (!d->startValue())
+        return;
+    d->output() += b ? "true" : "false";
+    d->endValue();
+}
+
+/*!
+    \fn void QJsonStreamWriter::append(std::nullptr_t)
+    \overload
+
+    Writes \c null.
+
+    \sa appendNull()
+*/
+
+/*!
+    Writes \c null.
+*/
+void QJsonStreamWriter::appendNull()
+{
+    if (!d->startValue())
+        return;
+    d->output() += "null";
+    d->endValue();
+}
+
+/*!
+    \overload
+
+    Writes \a value, which can be an array or an object. An undefined value
+    is written as \c null.
+*/
+void QJsonStreamWriter::append(const QJsonValue &value)
+{
+    if (d->expectsName() && value.isString())
+        return append(value.toString());
+    if (!d->startValue())
+        return;
+    const int indent = d->compact ? 0 : int(d->containers.size());
+    Writer::valueToJson(Value::toCbor(value), d->output(), indent, d->compact);
+    d->endValue();
+}
+
+/*!
+    Starts an array. The values appended until the matching endArray() are
+    its elements.
+
+    \sa endArray(), startObject()
+*/
+void QJsonStreamWriter::startArray()
+{
+    d->startContainer('[');
+}
+
+/*!
+    Ends the array started last, and returns \c true. Returns \c false
+    without writing anything if the container started last is not an
+    array.
+
+    \sa startArray()
+*/
+bool QJsonStreamWriter::endArray()
+{
+    return d->endContainer('[');
+}
+
+/*!
+    Starts an object. The values appended until the matching endObject()
+    are alternately the names and the values of its members.
+
+    \sa endObject(), startArray()
+*/
+void QJsonStreamWriter::startObject()
+{
+    d->startContainer('{');
+}
+
+/*!
+    Ends the object started last, and returns \c true. Returns \c false
+    without writing anything if the container started last is not an
+    object, or if the value of its last member is missing.
+
+    \sa startObject()
+*/
+bool QJsonStreamWriter::endObject()
+{
+    return d->endContainer('{');
+}
+
+/*!
+    Passes the text that is buffered to the device(). The writer does this
+    by itself at the end of each value at the top level, when it has
+    buffered a few kilobytes, and when it is destroyed.
+
+    Nothing happens if the writer writes to a QByteArray, which always
+    contains all the text written.
+*/
+void QJsonStreamWriter::flush()
+{
+    d->flush();
+}
+
+QT_END_NAMESPACE
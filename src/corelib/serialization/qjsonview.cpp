@@ -0,0 +1,683 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qjsonview.h"
+
+#include "qjson_p.h"
+#include "qjsonparser_p.h"
+#include "qviewindex_p.h"
+
+#include <private/qnumeric_p.h>
+#include <private/qtools_p.h>
+#include <qvarlengtharray.h>
+
+#include <climits>
+
+QT_BEGIN_NAMESPACE
+
+using namespace QJsonPrivate;
+using namespace QtMiscUtils;
+using namespace Qt::StringLiterals;
+
+/*!
+    \class QJsonView
+    \inmodule QtCore
+    \ingroup json
+    \ingroup qtserialization
+    \reentrant
+    \since 6.9
+
+    \brief The QJsonView class is a read-only view of a value in JSON text
+    that is not copied.
+
+    QJsonDocument::fromJson() parses all of the text it is given, and
+    copies every string into the document it returns. That is wasteful for
+    large files of which only a few values are read, such as configuration
+    files and caches, and unnecessary when the text outlives the values
+    anyway, for instance because it is a file mapped into memory with
+    QFile::map().
+
+    QJsonView instead reads the values directly from the text. Creating a
+    view with fromJson() costs nothing, whatever the size of the text; the
+    elements of an array or an object are found the first time one of them
+    is accessed, and the offsets of the elements found are kept for the
+    later accesses. Strings that contain no escape sequences are returned as
+    views of the text by toStringView(), without being copied.
+
+    \code
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+    const uchar *data = file.map(0, file.size());
+    const QJsonView root = QJsonView::fromJson(QByteArrayView(data, file.size()));
+    const QJsonView entries = root["entries"];
+    for (qsizetype i = 0; i < entries.size(); ++i)
+        names << entries[i]["name"].toString();
+    \endcode
+
+    The text is not copied, so it must stay valid and unmodified for as long
+    as views of it exist. All the views obtained from the same fromJson()
+    call share the offsets found, including across threads.
+
+    The members of an object are in the order of the text, not sorted by
+    key as in QJsonObject. As in QJsonObject, value() returns the value of
+    the last member with the key looked up if there are several.
+
+    QJsonView does not check the text as a whole. The text is only checked
+    as it is read: a malformed value is QJsonValue::Undefined, and an array
+    or an object only contains the elements that precede malformed text.
+    Use QJsonDocument::fromJson() or QJsonStreamReader to check text that
+    cannot be trusted before reading it with QJsonView.
+
+    \sa QJsonValue, QJsonDocument, QCborView
+*/
+
+class QJsonViewPrivate : public QtPrivate::ViewIndex
+{
+public:
+    enum {
+        // same as QJsonDocument
+        NestingLimit = 1024
+    };
+
+    enum NumberType { NotANumber, Integer, Double };
+
+    using ViewIndex::ViewIndex;
+
+    const char *begin() const { return data.data(); }
+    const char *end() const { return data.data() + data.size(); }
+    qsizetype offsetOf(const char *json) const { return json - begin(); }
+
+    static const char *scanLiteral(const char *json, const char *end, QLatin1StringView literal);
+    static const char *scanString(const char *json, const char *end, bool *hasEscapes);
+    static const char *scanValue(const char *json, const char *end);
+
+    NumberType readNumber(qsizetype pos, qint64 *integer, double *number) const;
+    void build(qsizetype pos, Container *container) const;
+    const Container &container(qsizetype pos)
+    {
+        return ViewIndex::container(pos, [this](qsizetype pos, Container *container) {
+            build(pos, container);
+        });
+    }
+};
+
+// Returns the end of literal if json starts with it, or nullptr.
+const char *QJsonViewPrivate::scanLiteral(const char *json, const char *end,
+                                          QLatin1StringView literal)
+{
+    if (end - json < literal.size() || memcmp(json, literal.data(), literal.size()) != 0)
+        return nullptr;
+    return json + literal.size();
+}
+
+// Returns the end of the string that starts at json, which points to its
+// opening quote, or nullptr if the string is malformed. Escape sequences
+// are only checked when the string is decoded.
+const char *QJsonViewPrivate::scanString(const char *json, const char *end, bool *hasEscapes)
+{
+    ++json;
+    while (true) {
+        json = skipPlainStringCharacters(json, end);
+        if (json >= end)
+            return nullptr;
+        if (*json == '"')
+            return json + 1;
+        if (*json == '\\') {
+            if (end - json < 2)
+                return nullptr;
+            if (hasEscapes)
+                *hasEscapes = true;
+            json += 2;
+        } else {
+            ++json;     // part of a UTF-8 sequence
+        }
+    }
+}
+
+// Returns the end of the value that starts at json, or nullptr if it is
+// malformed. The separators inside arrays and objects are only checked
+// when they are built.
+const char *QJsonViewPrivate::scanValue(const char *json, const char *end)
+{
+    // the closing brackets of the enclosing arrays and objects
+    QVarLengthArray<char, 16> closers;
+    do {
+        json = skipWhitespace(json, end);
+        if (json >= end)
+            return nullptr;
+        switch (*json) {
+        case '"':
+            json = scanString(json, end, nullptr);
+            break;
+        case '[':
+        case '{':
+            if (closers.size() == NestingLimit)
+                return nullptr;
+            closers.append(*json == '[' ? ']' : '}');
+            ++json;
+            break;
+        case ']':
+        case '}':
+            if (closers.isEmpty() || closers.back() != *json)
+                return nullptr;
+            closers.removeLast();
+            ++json;
+            break;
+        case ',':
+        case ':':
+            if (closers.isEmpty())
+                return nullptr;
+            ++json;
+            break;
+        case 't':
+            json = scanLiteral(json, end, "true"_L1);
+            break;
+        case 'f':
+            json = scanLiteral(json, end, "false"_L1);
+            break;
+        case 'n':
+            json = scanLiteral(json, end, "null"_L1);
+            break;
+        default: {
+            const char *digit = json + (*json == '-');
+            if (digit >= end || !isAsciiDigit(*digit))
+                return nullptr;
+            bool isInt;
+            json = scanNumber(json, end, &isInt);
+            break;
+        }
+        }
+        if (!json)
+            return nullptr;
+    } while (!closers.isEmpty());
+    return json;
+}
+
+QJsonViewPrivate::NumberType QJsonViewPrivate::readNumber(qsizetype pos, qint64 *integer,
+                                                          double *number) const
+{
+    if (pos < 0 || pos >= data.size())
+        return NotANumber;
+    const char *start = begin() + pos;
+    const char *digit = start + (*start == '-');
+    if (digit >= end() || !isAsciiDigit(*digit))
+        return NotANumber;
+
+    // the same conversions as QJsonDocument
+    bool isInt;
+    const QByteArrayView text(start, scanNumber(start, end(), &isInt));
+    bool ok;
+    if (isInt) {
+        *integer = text.toLongLong(&ok);
+        if (ok)
+            return Integer;
+    }
+    *number = text.toDouble(&ok);
+    return ok ? Double : NotANumber;
+}
+
+void QJsonViewPrivate::build(qsizetype pos, Container *container) const
+{
+    const char *json = begin() + pos;
+    const bool isObject = *json == '{';
+    const char closer = isObject ? '}' : ']';
+    json = skipWhitespace(json + 1, end());
+    if (json < end() && *json == closer) {
+        container->end = offsetOf(json + 1);
+        return;
+    }
+
+    while (true) {
+        const char *key = json;
+        if (isObject) {
+            if (json >= end() || *json != '"')
+                return;
+            json = scanString(json, end(), nullptr);
+            if (!json)
+                return;
+            json = skipWhitespace(json, end());
+            if (json >= end() || *json != ':')
+                return;
+            json = skipWhitespace(json + 1, end());
+        }
+        const char *value = json;
+        json = scanValue(json, end());
+        if (!json)
+            return;
+
+        if (isObject)
+            container->offsets.append(offsetOf(key));
+        container->offsets.append(offsetOf(value));
+
+        json = skipWhitespace(json, end());
+        if (json >= end())
+            return;
+        if (*json == closer) {
+            container->end = offsetOf(json + 1);
+            return;
+        }
+        if (*json != ',')
+            return;
+        json = skipWhitespace(json + 1, end());
+    }
+}
+
+// Decodes the string that starts at json, which points to its opening
+// quote, like QJsonDocument does.
+static QString decodeString(const char *json, const char *end)
+{
+    QString result;
+    ++json;
+    while (json < end) {
+        const char *run = json;
+        while (json < end && *json != '"' && *json != '\\')
+            ++json;
+        if (json != run)
+            result.append(QUtf8StringView(run, json - run));
+        if (json >= end || *json == '"')
+            break;
+        char32_t ch;
+        if (!scanEscapeSequence(json, end, &ch))
+            break;
+        result.append(QChar::fromUcs4(ch));
+    }
+    return result;
+}
+
+QT_DEFINE_QESDP_SPECIALIZATION_DTOR(QJsonViewPrivate)
+
+/*!
+    Constructs an undefined view, of type QJsonValue::Undefined.
+*/
+QJsonView::QJsonView() noexcept = default;
+
+/*!
+    Constructs a copy of \a other, which views the same value.
+*/
+QJsonView::QJsonView(const QJsonView &other) noexcept = default;
+
+/*!
+    \fn QJsonView::QJsonView(QJsonView &&other)
+
+    Move-constructs a QJsonView instance, making it view the same value as
+    \a other.
+*/
+
+/*!
+    Makes this view view the same value as \a other, and returns a
+    reference to it.
+*/
+QJsonView &QJsonView::operator=(const QJsonView &other) noexcept = default;
+
+/*!
+    \fn QJsonView &QJsonView::operator=(QJsonView &&other)
+
+    Move-assigns \a other to this view, and returns a reference to it.
+*/
+
+/*!
+    \fn void QJsonView::swap(QJsonView &other)
+    \memberswap{view}
+*/
+
+/*!
+    Destroys the view. The text it views is not affected.
+*/
+QJsonView::~QJsonView() = default;
+
+QJsonView::QJsonView(QJsonViewPrivate *d, qsizetype pos) noexcept
+    : d(d), pos(pos)
+{
+}
+
+/*!
+    Returns a view of the value in \a json, which is UTF-8 text. Like
+    QJsonStreamReader, and unlike QJsonDocument, any value is accepted, not
+    only arrays and objects. A byte order mark and whitespace preceding the
+    value are skipped; anything following it is ignored.
+
+    Nothing is parsed yet, and \a json is not copied: it must stay valid and
+    unmodified for as long as views of it exist.
+
+    The view is undefined if \a json contains no value.
+*/
+QJsonView QJsonView::fromJson(QByteArrayView json)
+{
+    const char *begin = json.data();
+    const char *end = begin + json.size();
+    if (json.startsWith("\xef\xbb\xbf"))
+        begin += 3;
+    begin = skipWhitespace(begin, end);
+    if (begin >= end)
+        return QJsonView();
+    return QJsonView(new QJsonViewPrivate(json), begin - json.data());
+}
+
+/*!
+    Returns the type of the value this view views, or QJsonValue::Undefined
+    if the view is undefined or the value is malformed.
+
+    \sa isNull(), isBool(), isDouble(), isString(), isArray(), isObject()
+*/
+QJsonValue::Type QJsonView::type() const
+{
+    if (!d)
+        return QJsonValue::Undefined;
+    const char *json = d->begin() + pos;
+    const char *end = d->end();
+    switch (*json) {
+    case '{':
+        return QJsonValue::Object;
+    case '[':
+        return QJsonValue::Array;
+    case '"':
+        return QJsonValue::String;
+    case 't':
+        return QJsonViewPrivate::scanLiteral(json, end, "true"_L1) ? QJsonValue::Bool
+                                                                   : QJsonValue::Undefined;
+    case 'f':
+        return QJsonViewPrivate::scanLiteral(json, end, "false"_L1) ? QJsonValue::Bool
+                                                                    : QJsonValue::Undefined;
+    case 'n':
+        return QJsonViewPrivate::scanLiteral(json, end, "null"_L1) ? QJsonValue::Null
+                                                                   : QJsonValue::Undefined;
+    }
+    const char *digit = json + (*json == '-');
+    return digit < end && isAsciiDigit(*digit) ? QJsonValue::Double : QJsonValue::Undefined;
+}
+
+/*!
+    \fn bool QJsonView::isNull() const
+    \fn bool QJsonView::isBool() const
+    \fn bool QJsonView::isDouble() const
+    \fn bool QJsonView::isString() const
+    \fn bool QJsonView::isArray() const
+    \fn bool QJsonView::isObject() const
+    \fn bool QJsonView::isUndefined() const
+
+    These functions return \c true if the value viewed has the type tested,
+    as returned by type().
+*/
+
+/*!
+    Returns the boolean value viewed, or \a defaultValue if the value is not
+    a boolean.
+*/
+bool QJsonView::toBool(bool defaultValue) const
+{
+    return isBool() ? d->data.at(pos) == 't' : defaultValue;
+}
+
+/*!
+    Returns the number viewed, converted to \c int, or \a defaultValue if
+    the value is not a number, or if it is not an integer that fits in an
+    \c int. Same as QJsonValue::toInt().
+
+    \sa toInteger(), toDouble()
+*/
+int QJsonView::toInt(int defaultValue) const
+{
+    if (!d)
+        return defaultValue;
+    qint64 integer;
+    double number;
+    switch (d->readNumber(pos, &integer, &number)) {
+    case QJsonViewPrivate::Integer:
+        return qint64(int(integer)) == integer ? int(integer) : defaultValue;
+    case QJsonViewPrivate::Double: {
+        int n;
+        return convertDoubleTo(number, &n) ? n : defaultValue;
+    }
+    case QJsonViewPrivate::NotANumber:
+        break;
+    }
+    return defaultValue;
+}
+
+/*!
+    Returns the number viewed, converted to \c qint64, or \a defaultValue if
+    the value is not a number, or if it is not an integer that fits in a
+    \c qint64. Same as QJsonValue::toInteger().
+
+    \sa toInt(), toDouble()
+*/
+qint64 QJsonView::toInteger(qint64 defaultValue) const
+{
+    if (!d)
+        return defaultValue;
+    qint64 integer;
+    double number;
+    switch (d->readNumber(pos, &integer, &number)) {
+    case QJsonViewPrivate::Integer:
+        return integer;
+    case QJsonViewPrivate::Double:
+        return convertDoubleTo(number, &integer) ? integer : defaultValue;
+    case QJsonViewPrivate::NotANumber:
+        break;
+    }
+    return defaultValue;
+}
+
+/*!
+    Returns the number viewed, or \a defaultValue if the value is not a
+    number.
+
+    \sa toInteger()
+*/
+double QJsonView::toDouble(double defaultValue) const
+{
+    if (!d)
+        return defaultValue;
+    qint64 integer;
+    double number;
+    switch (d->readNumber(pos, &integer, &number)) {
+    case QJsonViewPrivate::Integer:
+        return double(integer);
+    case QJsonViewPrivate::Double:
+        return number;
+    case QJsonViewPrivate::NotANumber:
+        break;
+    }
+    return defaultValue;
+}
+
+/*!
+    Returns the string viewed, as a view of the text, without copying it.
+
+    Returns a null view if the value is not a string, or if it contains
+    escape sequences, which must be decoded. Use toString() to read such
+    strings.
+
+    \sa toString()
+*/
+QUtf8StringView QJsonView::toStringView() const
+{
+    if (!isString())
+        return {};
+    const char *json = d->begin() + pos;
+    bool hasEscapes = false;
+    const char *end = QJsonViewPrivate::scanString(json, d->end(), &hasEscapes);
+    if (!end || hasEscapes)
+        return {};
+    return QUtf8StringView(json + 1, end - json - 2);
+}
+
+/*!
+    Returns a copy of the string viewed, with its escape sequences decoded,
+    or \a defaultValue if the value is not a string.
+
+    \sa toStringView()
+*/
+QString QJsonView::toString(const QString &defaultValue) const
+{
+    if (!isString())
+        return defaultValue;
+    const char *json = d->begin() + pos;
+    bool hasEscapes = false;
+    const char *end = QJsonViewPrivate::scanString(json, d->end(), &hasEscapes);
+    if (!end)
+        return defaultValue;
+    if (!hasEscapes)
+        return QString::fromUtf8(json + 1, end - json - 2);
+    return decodeString(json, end);
+}
+
+/*!
+    Returns the number of elements of the array viewed, the number of
+    members of the object viewed, or 0 if the value is neither.
+
+    The first call for an array or an object, or for any other view of it,
+    finds its elements in the text.
+*/
+qsizetype QJsonView::size() const
+{
+    const QJsonValue::Type t = type();
+    if (t != QJsonValue::Array && t != QJsonValue::Object)
+        return 0;
+    const qsizetype n = d->container(pos).offsets.size();
+    return t == QJsonValue::Object ? n / 2 : n;
+}
+
+/*!
+    Returns a view of the element at index \a i of the array viewed, or an
+    undefined view if the value is not an array or has no such element.
+
+    \sa size(), operator[]()
+*/
+QJsonView QJsonView::at(qsizetype i) const
+{
+    if (!isArray())
+        return QJsonView();
+    const qsizetype offset = d->container(pos).offsets.value(i, -1);
+    return offset < 0 ? QJsonView() : QJsonView(d.data(), offset);
+}
+
+/*!
+    Returns a view of the key of the member at index \a i of the object
+    viewed, in the order of the text, or an undefined view if the value is
+    not an object or has no such member.
+
+    \sa valueAt(), size()
+*/
+QJsonView QJsonView::keyAt(qsizetype i) const
+{
+    if (!isObject() || i < 0)
+        return QJsonView();
+    const qsizetype offset = d->container(pos).offsets.value(2 * i, -1);
+    return offset < 0 ? QJsonView() : QJsonView(d.data(), offset);
+}
+
+/*!
+    Returns a view of the value of the member at index \a i of the object
+    viewed, in the order of the text, or an undefined view if the value is
+    not an object or has no such member.
+
+    \sa keyAt(), size()
+*/
+QJsonView QJsonView::valueAt(qsizetype i) const
+{
+    if (!isObject() || i < 0)
+        return QJsonView();
+    const qsizetype offset = d->container(pos).offsets.value(2 * i + 1, -1);
+    return offset < 0 ? QJsonView() : QJsonView(d.data(), offset);
+}
+
+/*!
+    Returns a view of the value of the member of the object viewed whose
+    key is \a key, or an undefined view if the value is not an object or has
+    no such member. If several members have the key, the last one is used,
+    as in QJsonObject.
+
+    \sa operator[]()
+*/
+QJsonView QJsonView::value(QAnyStringView key) const
+{
+    if (!isObject())
+        return QJsonView();
+    const QList<qsizetype> &offsets = d->container(pos).offsets;
+    for (qsizetype i = offsets.size() - 2; i >= 0; i -= 2) {
+        const QJsonView k(d.data(), offsets.at(i));
+        const QUtf8StringView view = k.toStringView();
+        if (view.isNull() ? QAnyStringView::equal(k.toString(), key)
+                          : QAnyStringView::equal(view, key)) {
+            return QJsonView(d.data(), offsets.at(i + 1));
+        }
+    }
+    return QJsonView();
+}
+
+/*!
+    \fn QJsonView QJsonView::operator[](qsizetype i) const
+
+    Same as at(\a i).
+*/
+
+/*!
+    \fn QJsonView QJsonView::operator[](QAnyStringView key) const
+    \overload
+
+    Same as value(\a key).
+*/
+
+/*!
+    Parses the value viewed, with all of its content if it is an array or an
+    object, into a QJsonValue. Unlike the views, the QJsonValue does not
+    depend on the text staying valid.
+
+    Returns an undefined QJsonValue if the value is malformed.
+*/
+QJsonValue QJsonView::toJsonValue() const
+{
+    switch (type()) {
+    case QJsonValue::Null:
+        return QJsonValue::Null;
+    case QJsonValue::Bool:
+        return toBool();
+    case QJsonValue::Double: {
+        qint64 integer;
+        double number;
+        switch (d->readNumber(pos, &integer, &number)) {
+        case QJsonViewPrivate::Integer:
+            return integer;
+        case QJsonViewPrivate::Double:
+            return number;
+        case QJsonViewPrivate::NotANumber:
+            break;
+        }
+        return QJsonValue::Undefined;
+    }
+    case QJsonValue::String: {
+        const char *json = d->begin() + pos;
+        if (!QJsonViewPrivate::scanString(json, d->end(), nullptr))
+            return QJsonValue::Undefined;
+        return toString();
+    }
+    case QJsonValue::Array:
+    case QJsonValue::Object:
+        break;
+    case QJsonValue::Undefined:
+        return QJsonValue::Undefined;
+    }
+
+    // parse the text of the container in one go
+    const char *json = d->begin() + pos;
+    const char *end = QJsonViewPrivate::scanValue(json, d->end());
+    if (!end || end - json > INT_MAX)
+        return QJsonValue::Undefined;
+    Parser parser(json, int(end - json));
+    QJsonParseError error;
+    const QCborValue value = parser.parse(&error);
+    if (error.error != QJsonParseError::NoError)
+        return QJsonValue::Undefined;
+    return Value::fromTrustedCbor(value);
+}
+
+/*!
+    \fn qsizetype QJsonView::offset() const
+
+    Returns the offset in the text of the value viewed, or -1 if the view is
+    undefined.
+*/
+
+QT_END_NAMESPACE
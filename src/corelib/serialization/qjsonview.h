@@ -0,0 +1,74 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QJSONVIEW_H
+#define QJSONVIEW_H
+
+#include <QtCore/qanystringview.h>
+#include <QtCore/qbytearrayview.h>
+#include <QtCore/qjsonvalue.h>
+#include <QtCore/qshareddata.h>
+#include <QtCore/qutf8stringview.h>
+
+QT_BEGIN_NAMESPACE
+
+class QJsonViewPrivate;
+QT_DECLARE_QESDP_SPECIALIZATION_DTOR_WITH_EXPORT(QJsonViewPrivate, Q_CORE_EXPORT)
+
+class Q_CORE_EXPORT QJsonView
+{
+public:
+    QJsonView() noexcept;
+    QJsonView(const QJsonView &other) noexcept;
+    QJsonView(QJsonView &&other) noexcept = default;
+    QJsonView &operator=(const QJsonView &other) noexcept;
+    QT_MOVE_ASSIGNMENT_OPERATOR_IMPL_VIA_PURE_SWAP(QJsonView)
+    ~QJsonView();
+
+    void swap(QJsonView &other) noexcept
+    {
+        d.swap(other.d);
+        std::swap(pos, other.pos);
+    }
+
+    static QJsonView fromJson(QByteArrayView json);
+
+    QJsonValue::Type type() const;
+    bool isNull() const      { return type() == QJsonValue::Null; }
+    bool isBool() const      { return type() == QJsonValue::Bool; }
+    bool isDouble() const    { return type() == QJsonValue::Double; }
+    bool isString() const    { return type() == QJsonValue::String; }
+    bool isArray() const     { return type() == QJsonValue::Array; }
+    bool isObject() const    { return type() == QJsonValue::Object; }
+    bool isUndefined() const { return type() == QJsonValue::Undefined; }
+
+    bool toBool(bool defaultValue = false) const;
+    int toInt(int defaultValue = 0) const;
+    qint64 toInteger(qint64 defaultValue = 0) const;
+    double toDouble(double defaultValue = 0) const;
+    QUtf8StringView toStringView() const;
+    QString toString(const QString &defaultValue = {}) const;
+
+    qsizetype size() const;
+    QJsonView at(qsizetype i) const;
+    QJsonView keyAt(qsizetype i) const;
+    QJsonView valueAt(qsizetype i) const;
+    QJsonView value(QAnyStringView key) const;
+    QJsonView operator[](qsizetype i) const { return at(i); }
+    QJsonView operator[](QAnyStringView key) const { return value(key); }
+
+    QJsonValue toJsonValue() const;
+    qsizetype offset() const { return pos; }
+
+private:
+    QJsonView(QJsonViewPrivate *d, qsizetype pos) noexcept;
+
+    QExplicitlySharedDataPointer<QJsonViewPrivate> d;
+    qsizetype pos = -1;
+};
+
+Q_DECLARE_SHARED(QJsonView)
+
+QT_END_NAMESPACE
+
+#endif // QJSONVIEW_H
@@ -197,6 +197,18 @@ void Writer::objectToJson(const QCborContainerPrivate *o, QByteArray &json, int
     json += compact ? "}" : "}\n";
 }
 
+void Writer::valueToJson(const QCborValue &v, QByteArray &json, int indent, bool compact)
+{
+    QT_PREPEND_NAMESPACE(valueToJson)(v, json, indent, compact);
+}
+
+void Writer::stringToJson(QStringView s, QByteArray &json)
+{
+    json += '"';
+    json += escapedString(s);
+    json += '"';
+}
+
 void Writer::arrayToJson(const QCborContainerPrivate *a, QByteArray &json, int indent, bool compact)
 {
     json.reserve(json.size() + (a ? (int)a->elements.size() : 16));
@@ -0,0 +1,79 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QVIEWINDEX_P_H
+#define QVIEWINDEX_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qbytearrayview.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qshareddata.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QtPrivate {
+
+// The data shared by all the views into one document (see QCborView and
+// QJsonView): the encoded document, which the views do not own, and the
+// offsets of the elements of the containers that were navigated into. A
+// container is only scanned the first time one of its elements is
+// accessed, so that opening a document costs nothing, and reading a few
+// values from it only costs the scanning of the containers on their path.
+class ViewIndex : public QSharedData
+{
+public:
+    struct Container
+    {
+        // the offsets of the elements of an array, or of the keys and the
+        // values of the members of a map in turn; elements that follow
+        // malformed data are missing
+        QList<qsizetype> offsets;
+        // the offset just past the container, or -1 if it is malformed
+        qsizetype end = -1;
+    };
+
+    explicit ViewIndex(QByteArrayView data) : data(data) {}
+    ~ViewIndex() { qDeleteAll(containers); }
+    Q_DISABLE_COPY_MOVE(ViewIndex)
+
+    // Returns the index of the container that starts at offset, calling
+    // build(offset, container) to scan it if this is the first time. The
+    // containers are never modified once built, so the reference stays
+    // valid for as long as the views that share this index exist.
+    template <typename Builder>
+    const Container &container(qsizetype offset, Builder build)
+    {
+        QMutexLocker locker(&mutex);
+        Container *&container = containers[offset];
+        if (!container) {
+            container = new Container;
+            build(offset, container);
+        }
+        return *container;
+    }
+
+    const QByteArrayView data;
+
+private:
+    QMutex mutex;
+    QHash<qsizetype, Container *> containers;
+};
+
+} // namespace QtPrivate
+
+QT_END_NAMESPACE
+
+#endif // QVIEWINDEX_P_H
@@ -16,6 +16,7 @@
 #include <qcoreapplication.h>
 
 #include <private/qoffsetstringarray_p.h>
+#include <private/qsimd_p.h>
 #include <private/qtools_p.h>
 
 #include <iterator>
@@ -880,6 +881,7 @@ void QXmlStreamReaderPrivate::init()
     lineNumber = lastLineStart = characterOffset = 0;
     readBufferPos = 0;
     nbytesread = 0;
+    dataBufferPos = 0;
     decoder = QStringDecoder();
     attributeStack.clear();
     attributeStack.reserve(16);
@@ -1176,6 +1178,141 @@ bool QXmlStreamReaderPrivate::scanAttType()
     return false;
 }
 
+/*
+    The scanners below find the end of a run of characters that the fast
+    scan functions copy to textBuffer unchanged, a vector at a time. They
+    only load whole vectors inside [ptr, end) and leave the remaining
+    characters, and the one that ends the run, to the caller.
+*/
+
+#ifdef __SSE2__
+static constexpr bool UseAvx2 =
+        (qCompilerCpuFeatures & CpuFeatureArchHaswell) == CpuFeatureArchHaswell;
+
+// lane i is set if character i is a space or a tab
+template <typename Vector, typename Set1, typename CmpEq, typename Or>
+static Q_ALWAYS_INLINE Vector spaceChars(Vector data, Set1 set1, CmpEq cmpeq, Or vor)
+{
+    return vor(cmpeq(data, set1(' ')), cmpeq(data, set1('\t')));
+}
+
+// lane i is set if character i ends a run of content or literal
+// characters: markup, a control character (including line breaks and
+// tabs), U+FFFE or U+FFFF
+template <QXmlStreamReaderPrivate::PlainRun Run, typename Vector, typename Set1, typename CmpEq,
+          typename Or, typename Control>
+static Q_ALWAYS_INLINE Vector runStopChars(Vector data, Set1 set1, CmpEq cmpeq, Or vor,
+                                           Control control)
+{
+    const Vector stops = vor(vor(control(data), cmpeq(data, set1('<'))), cmpeq(data, set1('&')));
+    if constexpr (Run == QXmlStreamReaderPrivate::PlainRun::Content)
+        return vor(stops, cmpeq(data, set1(']')));
+    else
+        return vor(stops, vor(cmpeq(data, set1('"')), cmpeq(data, set1('\''))));
+}
+
+template <QXmlStreamReaderPrivate::PlainRun Run>
+static const char16_t *scanPlainRun(const char16_t *ptr, const char16_t *end)
+{
+    constexpr bool Space = Run == QXmlStreamReaderPrivate::PlainRun::Space;
+
+    // adding 2 maps U+FFFE and U+FFFF to 0 and 1, and characters below
+    // 0x20 to [2, 0x21], so one unsigned comparison catches all of them
+    if constexpr (UseAvx2) {
+        const auto set1 = [](char16_t c) { return _mm256_set1_epi16(short(c)); };
+        const auto cmpeq = [](__m256i a, __m256i b) { return _mm256_cmpeq_epi16(a, b); };
+        const auto vor = [](__m256i a, __m256i b) { return _mm256_or_si256(a, b); };
+        const auto control = [](__m256i a) {
+            const __m256i shifted = _mm256_add_epi16(a, _mm256_set1_epi16(2));
+            return _mm256_cmpeq_epi16(_mm256_subs_epu16(shifted, _mm256_set1_epi16(0x21)),
+                                      _mm256_setzero_si256());
+        };
+        for ( ; end - ptr >= 16; ptr += 16) {
+            const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr));
+            uint mask;
+            if constexpr (Space)
+                mask = ~uint(_mm256_movemask_epi8(spaceChars(data, set1, cmpeq, vor)));
+            else
+                mask = uint(_mm256_movemask_epi8(runStopChars<Run>(data, set1, cmpeq, vor, control)));
+            if (mask)
+                return ptr + qCountTrailingZeroBits(mask) / 2;
+        }
+    }
+
+    const auto set1 = [](char16_t c) { return _mm_set1_epi16(short(c)); };
+    const auto cmpeq = [](__m128i a, __m128i b) { return _mm_cmpeq_epi16(a, b); };
+    const auto vor = [](__m128i a, __m128i b) { return _mm_or_si128(a, b); };
+    const auto control = [](__m128i a) {
+        const __m128i shifted = _mm_add_epi16(a, _mm_set1_epi16(2));
+        return _mm_cmpeq_epi16(_mm_subs_epu16(shifted, _mm_set1_epi16(0x21)), _mm_setzero_si128());
+    };
+    for ( ; end - ptr >= 8; ptr += 8) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+        uint mask;
+        if constexpr (Space)
+            mask = ~uint(_mm_movemask_epi8(spaceChars(data, set1, cmpeq, vor))) & 0xffff;
+        else
+            mask = uint(_mm_movemask_epi8(runStopChars<Run>(data, set1, cmpeq, vor, control)));
+        if (mask)
+            return ptr + qCountTrailingZeroBits(mask) / 2;
+    }
+    return ptr;
+}
+#elif defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64)
+template <QXmlStreamReaderPrivate::PlainRun Run>
+static const char16_t *scanPlainRun(const char16_t *ptr, const char16_t *end)
+{
+    for ( ; end - ptr >= 8; ptr += 8) {
+        const uint16x8_t data = vld1q_u16(reinterpret_cast<const uint16_t *>(ptr));
+        const auto is = [data](char16_t c) { return vceqq_u16(data, vdupq_n_u16(c)); };
+        uint16x8_t found;
+        if constexpr (Run == QXmlStreamReaderPrivate::PlainRun::Space) {
+            found = vmvnq_u16(vorrq_u16(is(' '), is('\t')));
+        } else {
+            // see the SSE2 version for the control character test
+            found = vcleq_u16(vaddq_u16(data, vdupq_n_u16(2)), vdupq_n_u16(0x21));
+            found = vorrq_u16(found, vorrq_u16(is('<'), is('&')));
+            if constexpr (Run == QXmlStreamReaderPrivate::PlainRun::Content)
+                found = vorrq_u16(found, is(']'));
+            else
+                found = vorrq_u16(found, vorrq_u16(is('"'), is('\'')));
+        }
+        // narrow each lane of the comparison to a byte of a 64-bit mask
+        const uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vmovn_u16(found)), 0);
+        if (mask)
+            return ptr + qCountTrailingZeroBits(mask) / 8;
+    }
+    return ptr;
+}
+#else
+template <QXmlStreamReaderPrivate::PlainRun Run>
+static const char16_t *scanPlainRun(const char16_t *ptr, const char16_t *)
+{
+    return ptr;
+}
+#endif
+
+/*!
+ \internal
+
+ Appends the run of characters at the read position that need no
+ treatment besides being copied to textBuffer, and returns its length.
+ The character that ends the run is left to the caller, which handles it
+ and any characters past the last whole vector one at a time.
+ */
+template <QXmlStreamReaderPrivate::PlainRun Run>
+inline qsizetype QXmlStreamReaderPrivate::fastScanPlainRun()
+{
+    if (putStack.size() || readBufferPos >= readBuffer.size())
+        return 0;
+    const QStringView available = QStringView(readBuffer).sliced(readBufferPos);
+    const char16_t *begin = available.utf16();
+    const qsizetype n = scanPlainRun<Run>(begin, begin + available.size()) - begin;
+    textBuffer += available.first(n);
+    readBufferPos += n;
+    return n;
+}
+
 /*!
  \internal
 
@@ -1233,6 +1370,7 @@ inline qsizetype QXmlStreamReaderPrivate::fastScanLiteralContent()
             }
             textBuffer += QChar(ushort(c));
             ++n;
+            n += fastScanPlainRun<PlainRun::Literal>();
         }
     }
     return n;
@@ -1256,6 +1394,7 @@ inline qsizetype QXmlStreamReaderPrivate::fastScanSpace()
         case '\t':
             textBuffer += QChar(c);
             ++n;
+            n += fastScanPlainRun<PlainRun::Space>();
             break;
         default:
             putChar(c);
@@ -1330,6 +1469,7 @@ inline qsizetype QXmlStreamReaderPrivate::fastScanContentCharList()
             isWhitespace = false;
             textBuffer += QChar(ushort(c));
             ++n;
+            n += fastScanPlainRun<PlainRun::Content>();
         }
     }
     return n;
@@ -1536,12 +1676,18 @@ uint QXmlStreamReaderPrivate::getChar_helper()
         qint64 nbytesreadOrMinus1 = device->read(rawReadBuffer.data() + nbytesread, BUFFER_SIZE - nbytesread);
         nbytesread += qMax(nbytesreadOrMinus1, qint64{0});
     } else {
-        if (nbytesread)
-            rawReadBuffer += dataBuffer;
-        else
-            rawReadBuffer = dataBuffer;
+        // Hand the decoder one slice of the data at a time, like a device
+        // read, instead of converting all of it to UTF-16 up front.
+        const qsizetype n = qMin(dataBuffer.size() - dataBufferPos,
+                                 BUFFER_SIZE - qsizetype(nbytesread));
+        rawReadBuffer.resize(nbytesread);
+        rawReadBuffer += QByteArrayView(dataBuffer).sliced(dataBufferPos, n);
         nbytesread = rawReadBuffer.size();
-        dataBuffer.clear();
+        dataBufferPos += n;
+        if (dataBufferPos == dataBuffer.size()) {
+            dataBuffer.clear();
+            dataBufferPos = 0;
+        }
     }
     if (!nbytesread) {
         atEnd = true;
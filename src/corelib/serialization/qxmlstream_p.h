@@ -238,6 +238,7 @@ public:
 
     QByteArray rawReadBuffer;
     QByteArray dataBuffer;
+    qsizetype dataBufferPos;
     uchar firstByte;
     qint64 nbytesread;
     QString readBuffer;
@@ -510,6 +511,8 @@ public:
     qsizetype fastScanLiteralContent();
     qsizetype fastScanSpace();
     qsizetype fastScanContentCharList();
+    enum class PlainRun { Content, Literal, Space };
+    template <PlainRun Run> qsizetype fastScanPlainRun();
     std::optional<qsizetype> fastScanName(Value *val = nullptr);
     inline qsizetype fastScanNMTOKEN();
 
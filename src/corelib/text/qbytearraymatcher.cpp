@@ -8,6 +8,8 @@
 #  include <private/qtcore-config_p.h>
 #endif
 
+#include <private/qstringsearch_p.h>
+
 #include <limits.h>
 
 QT_BEGIN_NAMESPACE
@@ -56,6 +58,27 @@ static inline qsizetype bm_find(const uchar *cc, qsizetype l, qsizetype index, c
     return -1; // not found
 }
 
+/*!
+    \internal
+
+    Searches for \a needle, which has at least two bytes, by filtering
+    the positions in \a haystack by the first and the last byte of the
+    needle, a vector at a time.
+*/
+static qsizetype qFindByteArrayFirstLast(const char *haystack, qsizetype l, qsizetype from,
+                                         const char *needle, qsizetype sl) noexcept
+{
+    Q_ASSERT(sl >= 2);
+    if (from > l - sl)
+        return -1;
+    const QtPrivate::SubstringSearchChar<char> first = { needle[0], 0, needle[0] };
+    const QtPrivate::SubstringSearchChar<char> last = { needle[sl - 1], 0, needle[sl - 1] };
+    return QtPrivate::findFirstLast<false>(haystack, l, from, sl, first, last,
+                                           [needle, sl](const char *p) {
+        return memcmp(p + 1, needle + 1, sl - 2) == 0;
+    });
+}
+
 /*! \class QByteArrayMatcher
     \inmodule QtCore
     \brief The QByteArrayMatcher class holds a sequence of bytes that
@@ -185,6 +208,8 @@ qsizetype QByteArrayMatcher::indexIn(const char *str, qsizetype len, qsizetype f
 {
     if (from < 0)
         from = 0;
+    if (QtPrivate::HasSimdSubstringSearch && p.l >= 2)
+        return qFindByteArrayFirstLast(str, len, from, reinterpret_cast<const char *>(p.p), p.l);
     return bm_find(reinterpret_cast<const uchar *>(str), len, from,
                    p.p, p.l, p.q_skiptable);
 }
@@ -204,6 +229,10 @@ qsizetype QByteArrayMatcher::indexIn(QByteArrayView data, qsizetype from) const
 {
     if (from < 0)
         from = 0;
+    if (QtPrivate::HasSimdSubstringSearch && p.l >= 2) {
+        return qFindByteArrayFirstLast(data.data(), data.size(), from,
+                                       reinterpret_cast<const char *>(p.p), p.l);
+    }
     return bm_find(reinterpret_cast<const uchar *>(data.data()), data.size(), from,
                    p.p, p.l, p.q_skiptable);
 }
@@ -257,6 +286,15 @@ qsizetype QtPrivate::findByteArray(QByteArrayView haystack, qsizetype from, QByt
     if (!l)
         return -1;
 
+#if QT_CONFIG(memmem)
+    // memmem()'s two-way search skips ahead by up to the needle's length,
+    // which beats filtering on the first and last byte for long needles
+    const bool preferFirstLast = sl < 32;
+#else
+    const bool preferFirstLast = true;
+#endif
+    if (QtPrivate::HasSimdSubstringSearch && preferFirstLast && sl >= 2)
+        return qFindByteArrayFirstLast(haystack0, l, from, needle.data(), sl);
 #if QT_CONFIG(memmem)
     auto where = memmem(haystack0 + from, l - from, needle.data(), sl);
     return where ? static_cast<const char *>(where) - haystack0 : -1;
@@ -0,0 +1,278 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QSMALLSTRING_H
+#define QSMALLSTRING_H
+
+#if 0
+#pragma qt_class(QSmallString)
+#pragma qt_class(QSmallByteArray)
+#endif
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qcompare.h>
+#include <QtCore/qhashfunctions.h>
+#include <QtCore/qstring.h>
+
+#include <cstring>
+#include <new>
+#include <utility>
+
+QT_BEGIN_NAMESPACE
+
+namespace QtPrivate {
+template <typename Char> struct SmallStringTraits;
+
+template <> struct SmallStringTraits<char>
+{
+    using View = QByteArrayView;
+    using Container = QByteArray;
+    static const char *data(View view) noexcept { return view.data(); }
+    static Container toContainer(View view) { return view.toByteArray(); }
+};
+
+template <> struct SmallStringTraits<char16_t>
+{
+    using View = QStringView;
+    using Container = QString;
+    static const char16_t *data(View view) noexcept { return view.utf16(); }
+    static Container toContainer(View view) { return view.toString(); }
+};
+} // namespace QtPrivate
+
+template <typename Char>
+class QBasicSmallString
+{
+    using Traits = QtPrivate::SmallStringTraits<Char>;
+    using View = typename Traits::View;
+    using Container = typename Traits::Container;
+
+    static_assert(sizeof(Container) == sizeof(QArrayDataPointer<Char>));
+    static_assert(sizeof(Container) == 2 * sizeof(void *) + sizeof(qsizetype));
+
+    // The size is the last member of the QArrayDataPointer of a Container.
+    // Its most significant byte never has the high bit set, so that bit
+    // marks the inline representation: the tag byte then holds the size and
+    // the characters are stored in the bytes before it.
+    static constexpr size_t TagOffset = sizeof(Container) - sizeof(qsizetype)
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+            + sizeof(qsizetype) - 1
+#endif
+            ;
+    static constexpr uchar InlineTag = 0x80;
+
+    template <typename C>
+    using if_char = std::enable_if_t<std::is_same_v<C, char>, bool>;
+    template <typename C>
+    using if_char16 = std::enable_if_t<std::is_same_v<C, char16_t>, bool>;
+
+public:
+    typedef Char value_type;
+    typedef qsizetype size_type;
+    typedef const Char *const_iterator;
+    typedef const_iterator iterator;
+
+    static constexpr qsizetype inlineCapacity() noexcept
+    { return qsizetype(TagOffset / sizeof(Char)) - 1; }
+
+    QBasicSmallString() noexcept { setInlineSize(0); }
+    explicit QBasicSmallString(View view)
+    {
+        if (view.size() <= inlineCapacity())
+            initInline(Traits::data(view), view.size());
+        else
+            new (storage) Container(Traits::toContainer(view));
+    }
+    explicit QBasicSmallString(const Container &other)
+    {
+        if (other.size() <= inlineCapacity())
+            initInline(Traits::data(View(other)), other.size());
+        else
+            new (storage) Container(other);
+    }
+    explicit QBasicSmallString(Container &&other)
+    {
+        if (other.size() <= inlineCapacity())
+            initInline(Traits::data(View(other)), other.size());
+        else
+            new (storage) Container(std::move(other));
+    }
+    QBasicSmallString(const QBasicSmallString &other)
+    {
+        if (other.isInline())
+            memcpy(storage, other.storage, sizeof(storage));
+        else
+            new (storage) Container(other.heap());
+    }
+    QBasicSmallString(QBasicSmallString &&other) noexcept
+    {
+        // Container is relocatable, so both representations move as bytes
+        memcpy(storage, other.storage, sizeof(storage));
+        other.setInlineSize(0);
+    }
+    QBasicSmallString &operator=(const QBasicSmallString &other)
+    {
+        QBasicSmallString copy(other);
+        swap(copy);
+        return *this;
+    }
+    QT_MOVE_ASSIGNMENT_OPERATOR_IMPL_VIA_PURE_SWAP(QBasicSmallString)
+    ~QBasicSmallString()
+    {
+        if (!isInline())
+            heap().~Container();
+    }
+
+    void swap(QBasicSmallString &other) noexcept
+    {
+        uchar tmp[sizeof(storage)];
+        memcpy(tmp, storage, sizeof(storage));
+        memcpy(storage, other.storage, sizeof(storage));
+        memcpy(other.storage, tmp, sizeof(storage));
+    }
+
+    bool isInline() const noexcept { return storage[TagOffset] & InlineTag; }
+
+    qsizetype size() const noexcept
+    {
+        if (isInline())
+            return qsizetype(storage[TagOffset] & ~InlineTag);
+        return heap().size();
+    }
+    qsizetype length() const noexcept { return size(); }
+    bool isEmpty() const noexcept { return size() == 0; }
+
+    const Char *data() const noexcept
+    {
+        if (isInline())
+            return inlineData();
+        return Traits::data(View(heap()));
+    }
+    const Char *constData() const noexcept { return data(); }
+
+    Char at(qsizetype i) const
+    {
+        Q_ASSERT(size_t(i) < size_t(size()));
+        return data()[i];
+    }
+    Char operator[](qsizetype i) const { return at(i); }
+
+    const_iterator begin() const noexcept { return data(); }
+    const_iterator cbegin() const noexcept { return data(); }
+    const_iterator end() const noexcept { return data() + size(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    View view() const noexcept { return View(data(), size()); }
+
+    template <typename C = Char, if_char<C> = true>
+    QByteArray toByteArray() const { return toContainer(); }
+    template <typename C = Char, if_char16<C> = true>
+    QString toString() const { return toContainer(); }
+
+    QBasicSmallString &assign(View view)
+    {
+        QBasicSmallString copy(view);
+        swap(copy);
+        return *this;
+    }
+
+    QBasicSmallString &append(View view)
+    {
+        const qsizetype oldSize = size();
+        const qsizetype newSize = oldSize + view.size();
+        if (!isInline()) {
+            heap().append(view);
+        } else if (newSize <= inlineCapacity()) {
+            // view may be a part of this string
+            if (!view.isEmpty())
+                memmove(inlineData() + oldSize, Traits::data(view), view.size() * sizeof(Char));
+            setInlineSize(newSize);
+        } else {
+            Container grown;
+            grown.reserve(newSize);
+            grown.append(this->view());
+            grown.append(view);
+            new (storage) Container(std::move(grown));
+        }
+        return *this;
+    }
+    QBasicSmallString &operator+=(View view) { return append(view); }
+
+    void clear()
+    {
+        if (!isInline())
+            heap().~Container();
+        setInlineSize(0);
+    }
+
+    friend size_t qHash(const QBasicSmallString &key, size_t seed = 0) noexcept
+    { return qHash(key.view(), seed); }
+
+private:
+    friend bool comparesEqual(const QBasicSmallString &lhs, const QBasicSmallString &rhs) noexcept
+    { return lhs.view() == rhs.view(); }
+    friend Qt::strong_ordering
+    compareThreeWay(const QBasicSmallString &lhs, const QBasicSmallString &rhs) noexcept
+    { return compareThreeWay(lhs.view(), rhs.view()); }
+    Q_DECLARE_STRONGLY_ORDERED(QBasicSmallString)
+
+    friend bool comparesEqual(const QBasicSmallString &lhs, const View &rhs) noexcept
+    { return lhs.view() == rhs; }
+    friend Qt::strong_ordering
+    compareThreeWay(const QBasicSmallString &lhs, const View &rhs) noexcept
+    { return compareThreeWay(lhs.view(), rhs); }
+    Q_DECLARE_STRONGLY_ORDERED(QBasicSmallString, View)
+
+    friend bool comparesEqual(const QBasicSmallString &lhs, const Container &rhs) noexcept
+    { return lhs.view() == View(rhs); }
+    friend Qt::strong_ordering
+    compareThreeWay(const QBasicSmallString &lhs, const Container &rhs) noexcept
+    { return compareThreeWay(lhs.view(), View(rhs)); }
+    Q_DECLARE_STRONGLY_ORDERED(QBasicSmallString, Container)
+
+    friend bool comparesEqual(const QBasicSmallString &lhs, const Char *rhs) noexcept
+    { return lhs.view() == View(rhs); }
+    friend Qt::strong_ordering
+    compareThreeWay(const QBasicSmallString &lhs, const Char *rhs) noexcept
+    { return compareThreeWay(lhs.view(), View(rhs)); }
+    Q_DECLARE_STRONGLY_ORDERED(QBasicSmallString, const Char *)
+
+    Char *inlineData() noexcept { return reinterpret_cast<Char *>(storage); }
+    const Char *inlineData() const noexcept { return reinterpret_cast<const Char *>(storage); }
+    Container &heap() noexcept { return *reinterpret_cast<Container *>(storage); }
+    const Container &heap() const noexcept { return *reinterpret_cast<const Container *>(storage); }
+
+    void setInlineSize(qsizetype size) noexcept
+    {
+        Q_ASSERT(size <= inlineCapacity());
+        inlineData()[size] = Char(0);
+        storage[TagOffset] = uchar(InlineTag | size);
+    }
+    void initInline(const Char *data, qsizetype size) noexcept
+    {
+        if (size)
+            memcpy(storage, data, size * sizeof(Char));
+        setInlineSize(size);
+    }
+    Container toContainer() const
+    {
+        if (isInline())
+            return Traits::toContainer(view());
+        return heap();
+    }
+
+    alignas(Container) uchar storage[sizeof(Container)];
+};
+
+template <typename Char>
+Q_DECLARE_TYPEINFO_BODY(QBasicSmallString<Char>, Q_RELOCATABLE_TYPE);
+
+using QSmallByteArray = QBasicSmallString<char>;
+using QSmallString = QBasicSmallString<char16_t>;
+
+template <> struct QHashHeterogeneousSearch<QSmallByteArray, QByteArrayView> : std::true_type {};
+template <> struct QHashHeterogeneousSearch<QSmallString, QStringView> : std::true_type {};
+
+QT_END_NAMESPACE
+
+#endif // QSMALLSTRING_H
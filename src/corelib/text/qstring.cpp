@@ -9913,10 +9913,14 @@ qsizetype QtPrivate::findString(QStringView haystack0, qsizetype from, QStringVi
         return -1;
 
     /*
-        We use the Boyer-Moore algorithm in cases where the overhead
-        for the skip table should pay off, otherwise we use a simple
-        hash function.
+        Where the CPU has SIMD instructions and the needle's first and last
+        characters allow it, we filter the positions by those two
+        characters. Otherwise, we use the Boyer-Moore algorithm in cases
+        where the overhead for the skip table should pay off, and a
+        simple hash function for the rest.
     */
+    if (qCanFindStringFirstLast(needle0, cs))
+        return qFindStringFirstLast(haystack0, from, needle0, cs);
     if (l > 500 && sl > 5)
         return qFindStringBoyerMoore(haystack0, from, needle0, cs);
 
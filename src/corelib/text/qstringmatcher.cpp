@@ -4,6 +4,8 @@
 
 #include "qstringmatcher.h"
 
+#include <private/qstringsearch_p.h>
+
 QT_BEGIN_NAMESPACE
 
 static constexpr qsizetype FoldBufferCapacity = 256;
@@ -113,6 +115,54 @@ static inline qsizetype bm_find(QStringView haystack, qsizetype index, QStringVi
     return -1; // not found
 }
 
+/*
+    The first/last character search needs filters that catch every
+    character that may match the first and the last character of the
+    needle. Case-insensitively, that is only easy for US-ASCII: a letter
+    matches both of its cases, plus KELVIN SIGN for 'k' and LATIN SMALL
+    LETTER LONG S for 's', the only other characters that fold to
+    US-ASCII.
+*/
+static QtPrivate::SubstringSearchChar<char16_t> firstLastFilter(char16_t c, Qt::CaseSensitivity cs)
+{
+    const char16_t lower = c | 0x20;
+    if (cs == Qt::CaseSensitive || lower < u'a' || lower > u'z')
+        return { c, 0, c };
+    return { lower, 0x20, lower == u'k' ? u'\x212a' : lower == u's' ? u'\x17f' : lower };
+}
+
+static bool qCanFindStringFirstLast(QStringView needle, Qt::CaseSensitivity cs) noexcept
+{
+    if (!QtPrivate::HasSimdSubstringSearch || needle.size() < 2)
+        return false;
+    return cs == Qt::CaseSensitive || (needle.front().unicode() < 0x80
+                                       && needle.back().unicode() < 0x80);
+}
+
+static qsizetype qFindStringFirstLast(QStringView haystack, qsizetype from, QStringView needle,
+                                      Qt::CaseSensitivity cs) noexcept
+{
+    Q_ASSERT(qCanFindStringFirstLast(needle, cs));
+    const qsizetype sl = needle.size();
+    if (from > haystack.size() - sl)
+        return -1;
+
+    const auto first = firstLastFilter(needle.front().unicode(), cs);
+    const auto last = firstLastFilter(needle.back().unicode(), cs);
+    if (cs == Qt::CaseSensitive) {
+        const char16_t *n = needle.utf16();
+        return QtPrivate::findFirstLast<false>(haystack.utf16(), haystack.size(), from, sl,
+                                               first, last, [n, sl](const char16_t *p) {
+            return memcmp(p + 1, n + 1, (sl - 2) * sizeof(char16_t)) == 0;
+        });
+    }
+    return QtPrivate::findFirstLast<true>(haystack.utf16(), haystack.size(), from, sl,
+                                          first, last, [needle](const char16_t *p) {
+        return QtPrivate::compareStrings(QStringView(p, needle.size()), needle,
+                                         Qt::CaseInsensitive) == 0;
+    });
+}
+
 void QStringMatcher::updateSkipTable()
 {
     bm_init_skiptable(q_sv, q_skiptable, q_cs);
@@ -304,6 +354,8 @@ qsizetype QStringMatcher::indexIn(QStringView str, qsizetype from) const
 {
     if (from < 0)
         from = 0;
+    if (qCanFindStringFirstLast(q_sv, q_cs))
+        return qFindStringFirstLast(str, from, q_sv, q_cs);
     return bm_find(str, from, q_sv, q_skiptable, q_cs);
 }
 
@@ -0,0 +1,202 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QSTRINGSEARCH_P_H
+#define QSTRINGSEARCH_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of internal files.  This header file may change from version to version
+// without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qalgorithms.h>
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/private/qsimd_p.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QtPrivate {
+
+/*
+    findFirstLast() looks for a needle of at least two characters by
+    comparing its first and its last character against a whole vector of
+    haystack positions at once, and only calls \c verify for the positions
+    where both of them match. That makes it fast for the short needles and
+    long haystacks for which setting up a Boyer-Moore skip table does not
+    pay off, and it needs no state besides the two characters.
+
+    A haystack character \c c matches a SubstringSearchChar if
+    \c{(c | orMask) == value} or \c{c == other}. With \c Folded set to
+    false, only \c value is used. A case-insensitive search for a US-ASCII
+    letter sets orMask to 0x20 to match both cases, and \c other to the
+    one non-US-ASCII character that folds to that letter, if any.
+*/
+template <typename Char>
+struct SubstringSearchChar
+{
+    Char value;
+    Char orMask;
+    Char other;
+
+    constexpr bool matches(Char c) const noexcept
+    { return Char(c | orMask) == value || c == other; }
+};
+
+#if defined(__SSE2__) || (defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64))
+inline constexpr bool HasSimdSubstringSearch = true;
+#else
+inline constexpr bool HasSimdSubstringSearch = false;
+#endif
+
+// Calls verify for the positions set in mask, which has BitsPerChar bits
+// set for each candidate, and returns the first one it accepts.
+template <int BitsPerChar, typename Mask, typename Char, typename Verify>
+Q_ALWAYS_INLINE const Char *findFirstLastCandidate(Mask mask, const Char *ptr, Verify &verify)
+{
+    constexpr Mask LaneBits = (Mask(1) << BitsPerChar) - 1;
+    while (mask) {
+        const uint bit = qCountTrailingZeroBits(mask);
+        if (verify(ptr + bit / BitsPerChar))
+            return ptr + bit / BitsPerChar;
+        mask &= ~(LaneBits << bit);
+    }
+    return nullptr;
+}
+
+template <bool Folded, typename Char, typename Verify>
+qsizetype findFirstLast(const Char *haystack, qsizetype l, qsizetype from, qsizetype sl,
+                        SubstringSearchChar<Char> first, SubstringSearchChar<Char> last,
+                        Verify verify) noexcept
+{
+    static_assert(sizeof(Char) == 1 || sizeof(Char) == 2);
+    Q_ASSERT(sl >= 2);
+    Q_ASSERT(from >= 0 && from <= l - sl);
+
+    // candidates are [ptr, end); the last character of the candidate at
+    // end - 1 is the last character of the haystack
+    const Char *ptr = haystack + from;
+    const Char *end = haystack + (l - sl + 1);
+    const qsizetype lastOffset = sl - 1;
+
+#ifdef __SSE2__
+    constexpr bool UseAvx2 =
+            (qCompilerCpuFeatures & CpuFeatureArchHaswell) == CpuFeatureArchHaswell;
+
+    if constexpr (UseAvx2) {
+        const auto set1 = [](Char c) {
+            if constexpr (sizeof(Char) == 1)
+                return _mm256_set1_epi8(char(c));
+            else
+                return _mm256_set1_epi16(short(c));
+        };
+        const auto cmpeq = [](__m256i a, __m256i b) {
+            if constexpr (sizeof(Char) == 1)
+                return _mm256_cmpeq_epi8(a, b);
+            else
+                return _mm256_cmpeq_epi16(a, b);
+        };
+        const auto matches = [&](__m256i data, SubstringSearchChar<Char> c) {
+            if constexpr (!Folded)
+                return cmpeq(data, set1(c.value));
+            return _mm256_or_si256(cmpeq(_mm256_or_si256(data, set1(c.orMask)), set1(c.value)),
+                                   cmpeq(data, set1(c.other)));
+        };
+        constexpr qsizetype Lanes = 32 / sizeof(Char);
+        for ( ; end - ptr >= Lanes; ptr += Lanes) {
+            const __m256i f = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr));
+            const __m256i b =
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr + lastOffset));
+            const uint mask = uint(_mm256_movemask_epi8(_mm256_and_si256(matches(f, first),
+                                                                         matches(b, last))));
+            if (const Char *found = findFirstLastCandidate<sizeof(Char)>(mask, ptr, verify))
+                return found - haystack;
+        }
+    }
+
+    const auto set1 = [](Char c) {
+        if constexpr (sizeof(Char) == 1)
+            return _mm_set1_epi8(char(c));
+        else
+            return _mm_set1_epi16(short(c));
+    };
+    const auto cmpeq = [](__m128i a, __m128i b) {
+        if constexpr (sizeof(Char) == 1)
+            return _mm_cmpeq_epi8(a, b);
+        else
+            return _mm_cmpeq_epi16(a, b);
+    };
+    const auto matches = [&](__m128i data, SubstringSearchChar<Char> c) {
+        if constexpr (!Folded)
+            return cmpeq(data, set1(c.value));
+        return _mm_or_si128(cmpeq(_mm_or_si128(data, set1(c.orMask)), set1(c.value)),
+                            cmpeq(data, set1(c.other)));
+    };
+    constexpr qsizetype Lanes = 16 / sizeof(Char);
+    for ( ; end - ptr >= Lanes; ptr += Lanes) {
+        const __m128i f = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr + lastOffset));
+        const uint mask = uint(_mm_movemask_epi8(_mm_and_si128(matches(f, first),
+                                                               matches(b, last))));
+        if (const Char *found = findFirstLastCandidate<sizeof(Char)>(mask, ptr, verify))
+            return found - haystack;
+    }
+#elif defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64)
+    constexpr qsizetype Lanes = 16 / sizeof(Char);
+    for ( ; end - ptr >= Lanes; ptr += Lanes) {
+        if constexpr (sizeof(Char) == 1) {
+            const auto matches = [](uint8x16_t data, SubstringSearchChar<Char> c) {
+                if constexpr (!Folded)
+                    return vceqq_u8(data, vdupq_n_u8(c.value));
+                return vorrq_u8(vceqq_u8(vorrq_u8(data, vdupq_n_u8(c.orMask)), vdupq_n_u8(c.value)),
+                                vceqq_u8(data, vdupq_n_u8(c.other)));
+            };
+            const uint8x16_t f = vld1q_u8(reinterpret_cast<const uint8_t *>(ptr));
+            const uint8x16_t b = vld1q_u8(reinterpret_cast<const uint8_t *>(ptr + lastOffset));
+            const uint8x16_t both = vandq_u8(matches(f, first), matches(b, last));
+            // narrow each byte of the comparison to a nibble of a 64-bit mask
+            const uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(both), 4);
+            const uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(nibbles), 0);
+            if (const Char *found = findFirstLastCandidate<4>(mask, ptr, verify))
+                return found - haystack;
+        } else {
+            const auto matches = [](uint16x8_t data, SubstringSearchChar<Char> c) {
+                if constexpr (!Folded)
+                    return vceqq_u16(data, vdupq_n_u16(c.value));
+                const uint16x8_t folded = vorrq_u16(data, vdupq_n_u16(c.orMask));
+                return vorrq_u16(vceqq_u16(folded, vdupq_n_u16(c.value)),
+                                 vceqq_u16(data, vdupq_n_u16(c.other)));
+            };
+            const uint16x8_t f = vld1q_u16(reinterpret_cast<const uint16_t *>(ptr));
+            const uint16x8_t b = vld1q_u16(reinterpret_cast<const uint16_t *>(ptr + lastOffset));
+            const uint16x8_t both = vandq_u16(matches(f, first), matches(b, last));
+            // narrow each lane of the comparison to a byte of a 64-bit mask
+            const uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vmovn_u16(both)), 0);
+            if (const Char *found = findFirstLastCandidate<8>(mask, ptr, verify))
+                return found - haystack;
+        }
+    }
+#endif
+
+    const auto charMatches = [](Char c, SubstringSearchChar<Char> filter) {
+        if constexpr (!Folded)
+            return c == filter.value;
+        return filter.matches(c);
+    };
+    for ( ; ptr < end; ++ptr) {
+        if (charMatches(*ptr, first) && charMatches(ptr[lastOffset], last) && verify(ptr))
+            return ptr - haystack;
+    }
+    return -1;
+}
+
+} // namespace QtPrivate
+
+QT_END_NAMESPACE
+
+#endif // QSTRINGSEARCH_P_H
@@ -0,0 +1,578 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QCOROUTINE_H
+#define QCOROUTINE_H
+
+#include <QtCore/qglobal.h>
+
+QT_REQUIRE_CONFIG(future);
+
+// Coroutines need C++20; the header is empty for older standards.
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#endif
+
+#if (defined(__cpp_lib_coroutine) && __cpp_lib_coroutine >= 201902L) || defined(Q_QDOC)
+
+#include <QtCore/qexception.h>
+#include <QtCore/qfuture.h>
+#include <QtCore/qiodevice.h>
+#include <QtCore/qobject.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qtimer.h>
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+QT_BEGIN_NAMESPACE
+
+template <typename T = void>
+class QCoroTask;
+
+namespace QtPrivate {
+
+class CoroPromiseBase
+{
+public:
+    std::suspend_never initial_suspend() const noexcept { return {}; }
+
+    template <typename Promise>
+    struct FinalAwaiter
+    {
+        bool await_ready() const noexcept { return false; }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            Promise &promise = handle.promise();
+            void *awaiting = promise.continuation.exchange(finishedMarker(),
+                                                           std::memory_order_acq_rel);
+            // a coroutine awaiting the task keeps the task, and so the frame, alive
+            if (promise.release()) {
+                handle.destroy();
+                return std::noop_coroutine();
+            }
+            if (awaiting)
+                return std::coroutine_handle<>::from_address(awaiting);
+            return std::noop_coroutine();
+        }
+        void await_resume() const noexcept { }
+    };
+
+    void unhandled_exception() noexcept { exception = std::current_exception(); }
+
+    bool isFinished() const noexcept
+    {
+        return continuation.load(std::memory_order_acquire) == finishedMarker();
+    }
+
+    // Returns false if the coroutine finished already, so that the caller
+    // goes on without suspending.
+    bool setContinuation(std::coroutine_handle<> awaiting) noexcept
+    {
+        void *expected = nullptr;
+        return continuation.compare_exchange_strong(expected, awaiting.address(),
+                                                    std::memory_order_acq_rel);
+    }
+
+    // Drops the reference of the task or of the running coroutine, and
+    // returns true if it was the last one.
+    bool release() noexcept { return refs.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+
+    void rethrowException() const
+    {
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+
+private:
+    static void *finishedMarker() noexcept { return reinterpret_cast<void *>(quintptr(1)); }
+
+    std::atomic<void *> continuation = nullptr;
+    std::atomic<int> refs = 2;
+    std::exception_ptr exception;
+};
+
+template <typename T>
+class CoroPromise : public CoroPromiseBase
+{
+public:
+    QCoroTask<T> get_return_object() noexcept;
+    auto final_suspend() noexcept { return FinalAwaiter<CoroPromise>{}; }
+
+    template <typename U = T, std::enable_if_t<std::is_convertible_v<U, T>, bool> = true>
+    void return_value(U &&value) { result.emplace(std::forward<U>(value)); }
+
+    T takeResult()
+    {
+        rethrowException();
+        Q_ASSERT(result);
+        return std::move(*result);
+    }
+
+private:
+    std::optional<T> result;
+};
+
+template <>
+class CoroPromise<void> : public CoroPromiseBase
+{
+public:
+    QCoroTask<void> get_return_object() noexcept;
+    auto final_suspend() noexcept { return FinalAwaiter<CoroPromise>{}; }
+
+    void return_void() noexcept { }
+    void takeResult() const { rethrowException(); }
+};
+
+// Called by an awaiter that cannot produce a result: the future was
+// canceled without one, or the object the coroutine waited for is gone.
+[[noreturn]] inline void throwCoroutineLost(const char *reason)
+{
+#ifndef QT_NO_EXCEPTIONS
+    Q_UNUSED(reason);
+    throw QUnhandledException();
+#else
+    qFatal("co_await: %s", reason);
+#endif
+}
+
+// Resumes a coroutine, in the thread of the context object if there is one.
+// If the context object is destroyed first, the coroutine resumes from its
+// destroyed() signal, and the awaiter throws; see throwIfContextDestroyed().
+class CoroResumer
+{
+    // Shared with the callbacks, which can be called after the coroutine
+    // went on, and from other threads.
+    struct State
+    {
+        QPointer<QObject> context;
+        std::coroutine_handle<> handle;
+        QMetaObject::Connection destroyedConnection;
+        bool resumed = false;
+        bool contextDestroyed = false;
+
+        // Called in the thread of the context object.
+        static void resume(std::shared_ptr<State> state, bool contextDestroyed)
+        {
+            if (std::exchange(state->resumed, true))
+                return;
+            state->contextDestroyed = contextDestroyed;
+            QObject::disconnect(std::exchange(state->destroyedConnection, {}));
+            state->handle.resume();
+        }
+
+        static void post(const std::shared_ptr<State> &state)
+        {
+            if (QObject *object = state ? state->context.data() : nullptr) {
+                QMetaObject::invokeMethod(object, [state] { resume(state, false); },
+                                          Qt::QueuedConnection);
+            }
+        }
+    };
+
+public:
+    explicit CoroResumer(QObject *context) : context(context), hasContext(context != nullptr) { }
+
+    void suspend(std::coroutine_handle<> awaiting)
+    {
+        handle = awaiting;
+        if (QObject *object = context.data()) {
+            state = std::make_shared<State>();
+            state->context = object;
+            state->handle = awaiting;
+            state->destroyedConnection = QObject::connect(object, &QObject::destroyed,
+                                                          [state = state] {
+                State::resume(state, true);
+            });
+        }
+    }
+
+    bool hasContextObject() const noexcept { return hasContext; }
+
+    // Returns a function that resumes the coroutine in the thread of the
+    // context object, and can be called from any thread, even once the
+    // awaiter is gone.
+    auto poster() const
+    {
+        return [state = state] { State::post(state); };
+    }
+
+    void resume() const
+    {
+        if (hasContext)
+            State::post(state);
+        else
+            handle.resume();
+    }
+
+    // Called in the thread of the context object, if there is one.
+    void resumeInContextThread() const
+    {
+        if (state)
+            State::resume(state, false);
+        else
+            handle.resume();
+    }
+
+    bool isInContextThread() const
+    {
+        return !hasContext || (context && context->thread() == QThread::currentThread());
+    }
+
+    void throwIfContextDestroyed() const
+    {
+        if (state && state->contextDestroyed)
+            throwCoroutineLost("The context object was destroyed");
+    }
+
+private:
+    QPointer<QObject> context;
+    std::shared_ptr<State> state;
+    std::coroutine_handle<> handle;
+    bool hasContext;
+};
+
+template <typename T>
+class FutureAwaiter
+{
+public:
+    explicit FutureAwaiter(QFuture<T> &&future, QObject *context = nullptr)
+        : future(std::move(future)), resumer(context)
+    { }
+
+    bool await_ready() const { return future.isFinished() && resumer.isInContextThread(); }
+
+    void await_suspend(std::coroutine_handle<> awaiting)
+    {
+        resumer.suspend(awaiting);
+        // The coroutine may resume before setContinuation() returns, and
+        // take the future with it, so the call goes to a copy. The
+        // continuation outlives the coroutine if the context object is
+        // destroyed first, so it must not refer to this awaiter.
+        QFutureInterfaceBase futureInterface = future.d;
+        if (resumer.hasContextObject()) {
+            futureInterface.setContinuation([post = resumer.poster()](const QFutureInterfaceBase &) {
+                post();
+            });
+        } else {
+            // no allocation for the std::function
+            futureInterface.setContinuation([awaiting](const QFutureInterfaceBase &) {
+                awaiting.resume();
+            });
+        }
+    }
+
+    T await_resume()
+    {
+        resumer.throwIfContextDestroyed();
+        if constexpr (std::is_void_v<T>) {
+            future.waitForFinished(); // rethrows the exception of the future, if any
+        } else {
+            if (future.resultCount() == 0) {
+                future.waitForFinished(); // rethrows the exception of the future, if any
+                throwCoroutineLost("Awaited a QFuture that finished without a result");
+            }
+            if constexpr (std::is_copy_constructible_v<T>)
+                return future.result();
+            else
+                return future.takeResult();
+        }
+    }
+
+private:
+    QFuture<T> future;
+    CoroResumer resumer;
+};
+
+template <typename List>
+struct SignalResult;
+
+template <>
+struct SignalResult<QtPrivate::List<>>
+{
+    using Storage = bool;
+    using Type = void;
+};
+
+template <typename Arg>
+struct SignalResult<QtPrivate::List<Arg>>
+{
+    using Type = std::decay_t<Arg>;
+    using Storage = std::optional<Type>;
+};
+
+template <typename... Args>
+struct SignalResult<QtPrivate::List<Args...>>
+{
+    using Type = std::tuple<std::decay_t<Args>...>;
+    using Storage = std::optional<Type>;
+};
+
+template <typename Sender, typename Signal>
+class SignalAwaiter
+{
+    using Result = SignalResult<typename QtPrivate::FunctionPointer<Signal>::Arguments>;
+
+    // Shared with the connections: if the sender lives in another thread,
+    // the notice of its destruction can arrive after the signal.
+    struct State
+    {
+        std::coroutine_handle<> handle;
+        typename Result::Storage result = {};
+        QMetaObject::Connection connections[3];
+        bool resumed = false;
+        bool lost = false;
+
+        static void resume(std::shared_ptr<State> state, bool lost)
+        {
+            if (std::exchange(state->resumed, true))
+                return;
+            state->lost = lost;
+            state->disconnect();
+            state->handle.resume();
+        }
+
+        void disconnect()
+        {
+            for (QMetaObject::Connection &connection : connections)
+                QObject::disconnect(std::exchange(connection, {}));
+        }
+    };
+
+public:
+    SignalAwaiter(Sender *sender, Signal signal, QObject *context)
+        : sender(sender), signal(signal), context(context ? context : sender)
+    { }
+    ~SignalAwaiter()
+    {
+        if (state && !std::exchange(state->resumed, true))
+            state->disconnect();
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        state = std::make_shared<State>();
+        state->handle = handle;
+        state->connections[0] = QObject::connect(sender, signal, context,
+                                                 [state = state](const auto &...args) {
+            if (state->resumed)
+                return;
+            if constexpr (sizeof...(args) == 0)
+                state->result = true;
+            else
+                state->result.emplace(args...);
+            State::resume(state, false);
+        }, Qt::SingleShotConnection);
+
+        const auto lose = [state = state] { State::resume(state, true); };
+        state->connections[1] = QObject::connect(context, &QObject::destroyed, lose);
+        if (context != sender)
+            state->connections[2] = QObject::connect(sender, &QObject::destroyed, context, lose);
+    }
+
+    typename Result::Type await_resume()
+    {
+        if (state->lost)
+            throwCoroutineLost("The sender or the context object was destroyed");
+        if constexpr (!std::is_void_v<typename Result::Type>)
+            return std::move(*state->result);
+    }
+
+private:
+    Sender *sender;
+    Signal signal;
+    QObject *context;
+    std::shared_ptr<State> state;
+};
+
+class ReadyReadAwaiter
+{
+public:
+    explicit ReadyReadAwaiter(QIODevice *device) : device(device), resumer(device) { }
+
+    bool await_ready() const { return device->bytesAvailable() > 0 || !device->isReadable(); }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        resumer.suspend(handle);
+        const auto resume = [this] {
+            QObject::disconnect(readyReadConnection);
+            QObject::disconnect(finishedConnection);
+            resumer.resumeInContextThread();
+        };
+        readyReadConnection = QObject::connect(device, &QIODevice::readyRead, device, resume);
+        finishedConnection = QObject::connect(device, &QIODevice::readChannelFinished, device,
+                                              resume);
+    }
+
+    qint64 await_resume() const
+    {
+        resumer.throwIfContextDestroyed();
+        return device->bytesAvailable();
+    }
+
+private:
+    QIODevice *device;
+    CoroResumer resumer;
+    QMetaObject::Connection readyReadConnection;
+    QMetaObject::Connection finishedConnection;
+};
+
+class DelayAwaiter
+{
+public:
+    DelayAwaiter(std::chrono::milliseconds duration, QObject *context)
+        : duration(duration), context(context), resumer(context)
+    { }
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        resumer.suspend(handle);
+        if (context)
+            QTimer::singleShot(duration, context, [this] { resumer.resumeInContextThread(); });
+        else
+            QTimer::singleShot(duration, [handle] { handle.resume(); });
+    }
+
+    void await_resume() const { resumer.throwIfContextDestroyed(); }
+
+private:
+    std::chrono::milliseconds duration;
+    QObject *context;
+    CoroResumer resumer;
+};
+
+class ResumeOnAwaiter
+{
+public:
+    explicit ResumeOnAwaiter(QObject *context) : resumer(context) { }
+
+    bool await_ready() const { return resumer.isInContextThread(); }
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        resumer.suspend(handle);
+        resumer.resume();
+    }
+    void await_resume() const { resumer.throwIfContextDestroyed(); }
+
+private:
+    CoroResumer resumer;
+};
+
+} // namespace QtPrivate
+
+template <typename T>
+class QCoroTask
+{
+public:
+    using promise_type = QtPrivate::CoroPromise<T>;
+
+    QCoroTask(QCoroTask &&other) noexcept : handle(std::exchange(other.handle, {})) { }
+    QT_MOVE_ASSIGNMENT_OPERATOR_IMPL_VIA_MOVE_AND_SWAP(QCoroTask)
+    Q_DISABLE_COPY(QCoroTask)
+
+    ~QCoroTask()
+    {
+        if (handle && handle.promise().release())
+            handle.destroy();
+    }
+
+    void swap(QCoroTask &other) noexcept { std::swap(handle, other.handle); }
+
+    bool isFinished() const noexcept { return handle && handle.promise().isFinished(); }
+
+    auto operator co_await() noexcept
+    {
+        struct Awaiter
+        {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() const noexcept { return handle.promise().isFinished(); }
+            bool await_suspend(std::coroutine_handle<> awaiting) noexcept
+            {
+                return handle.promise().setContinuation(awaiting);
+            }
+            T await_resume() { return handle.promise().takeResult(); }
+        };
+        Q_ASSERT_X(handle, "QCoroTask", "Awaited a moved-from task");
+        return Awaiter{ handle };
+    }
+
+private:
+    friend class QtPrivate::CoroPromise<T>;
+
+    explicit QCoroTask(std::coroutine_handle<promise_type> handle) noexcept : handle(handle) { }
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+namespace QtPrivate {
+
+template <typename T>
+QCoroTask<T> CoroPromise<T>::get_return_object() noexcept
+{
+    return QCoroTask<T>(std::coroutine_handle<CoroPromise<T>>::from_promise(*this));
+}
+
+inline QCoroTask<void> CoroPromise<void>::get_return_object() noexcept
+{
+    return QCoroTask<void>(std::coroutine_handle<CoroPromise<void>>::from_promise(*this));
+}
+
+} // namespace QtPrivate
+
+template <typename T>
+auto operator co_await(QFuture<T> future)
+{
+    return QtPrivate::FutureAwaiter<T>(std::move(future));
+}
+
+namespace QtCoro {
+
+template <typename T>
+auto await(QFuture<T> future, QObject *context)
+{
+    return QtPrivate::FutureAwaiter<T>(std::move(future), context);
+}
+
+template <typename Sender, typename Signal>
+auto signal(Sender *sender, Signal signal, QObject *context = nullptr)
+{
+    static_assert(QtPrivate::FunctionPointer<Signal>::IsPointerToMemberFunction,
+                  "The signal must be a pointer to a member function.");
+    return QtPrivate::SignalAwaiter<Sender, Signal>(sender, signal, context);
+}
+
+inline auto readyRead(QIODevice *device)
+{
+    return QtPrivate::ReadyReadAwaiter(device);
+}
+
+inline auto delay(std::chrono::milliseconds duration, QObject *context = nullptr)
+{
+    return QtPrivate::DelayAwaiter(duration, context);
+}
+
+inline auto resumeOn(QObject *context)
+{
+    return QtPrivate::ResumeOnAwaiter(context);
+}
+
+} // namespace QtCoro
+
+QT_END_NAMESPACE
+
+#endif // __cpp_lib_coroutine
+
+#endif // QCOROUTINE_H
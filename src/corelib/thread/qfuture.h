@@ -295,6 +295,9 @@ private:
 
     friend struct QtPrivate::UnwrapHandler;
 
+    template<typename ResultType>
+    friend class QtPrivate::FutureAwaiter;
+
     using QFuturePrivate =
             std::conditional_t<std::is_same_v<T, void>, QFutureInterfaceBase, QFutureInterface<T>>;
 
@@ -12,6 +12,8 @@
 #include <private/qthreadpool_p.h>
 #include <private/qobject_p.h>
 
+#include <algorithm>
+
 // GCC 12 gets confused about QFutureInterfaceBase::state, for some non-obvious
 // reason
 //  warning: ‘unsigned int __atomic_or_fetch_4(volatile void*, unsigned int, int)’ writing 4 bytes into a region of size 0 overflows the destination [-Wstringop-overflow=]
@@ -146,6 +148,7 @@ void QFutureInterfaceBase::cancel(QFutureInterfaceBase::CancelMode mode)
 {
     QMutexLocker locker(&d->m_mutex);
 
+    d->internal_collectStagedResults();
     const auto oldState = d->state.loadRelaxed();
 
     switch (mode) {
@@ -277,6 +280,7 @@ bool QFutureInterfaceBase::isThrottled() const
 bool QFutureInterfaceBase::isResultReadyAt(int index) const
 {
     QMutexLocker lock(&d->m_mutex);
+    d->internal_collectStagedResults();
     return d->internal_isResultReadyAt(index);
 }
 
@@ -351,6 +355,7 @@ void QFutureInterfaceBase::suspendIfRequested()
 int QFutureInterfaceBase::progressValue() const
 {
     const QMutexLocker lock(&d->m_mutex);
+    d->internal_collectStagedResults();
     return d->m_progressValue;
 }
 
@@ -369,6 +374,7 @@ int QFutureInterfaceBase::progressMaximum() const
 int QFutureInterfaceBase::resultCount() const
 {
     QMutexLocker lock(&d->m_mutex);
+    d->internal_collectStagedResults();
     return d->internal_resultCount();
 }
 
@@ -421,6 +427,7 @@ void QFutureInterfaceBase::reportException(const std::exception_ptr &exception)
 
     d->hasException = true;
     d->data.setException(exception);
+    d->internal_collectStagedResults(); // deletes them
     switch_on(d->state, Canceled);
     d->waitCondition.wakeAll();
     d->pausedWaitCondition.wakeAll();
@@ -432,6 +439,7 @@ void QFutureInterfaceBase::reportFinished()
 {
     QMutexLocker locker(&d->m_mutex);
     if (!isFinished()) {
+        d->internal_collectStagedResults();
         switch_from_to(d->state, Running, Finished);
         d->waitCondition.wakeAll();
         d->sendCallOut(QFutureCallOutEvent(QFutureCallOutEvent::Finished));
@@ -463,6 +471,26 @@ int QFutureInterfaceBase::loadState() const
     return d->state.loadRelaxed();
 }
 
+namespace {
+// While it exists, reporting threads deliver results right away instead of
+// staging them, so that waiting for them works.
+class ResultObserver
+{
+    Q_DISABLE_COPY_MOVE(ResultObserver)
+public:
+    explicit ResultObserver(QFutureInterfaceBasePrivate *d) : d(d)
+    {
+        d->observers.ref();
+        // pairs with the fence in QFutureInterfaceBase::stageResults()
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+    ~ResultObserver() { d->observers.deref(); }
+
+private:
+    QFutureInterfaceBasePrivate *d;
+};
+} // unnamed namespace
+
 void QFutureInterfaceBase::waitForResult(int resultIndex)
 {
     if (d->hasException)
@@ -479,6 +507,8 @@ void QFutureInterfaceBase::waitForResult(int resultIndex)
 
     lock.relock();
 
+    const ResultObserver observer(d);
+    d->internal_collectStagedResults();
     const int waitIndex = (resultIndex == -1) ? INT_MAX : resultIndex;
     while (isRunningOrPending() && !d->internal_isResultReadyAt(waitIndex))
         d->waitCondition.wait(&d->m_mutex);
@@ -508,28 +538,67 @@ void QFutureInterfaceBase::waitForFinished()
 
 void QFutureInterfaceBase::reportResultsReady(int beginIndex, int endIndex)
 {
-    if (beginIndex == endIndex || (d->state.loadRelaxed() & (Canceled|Finished)))
-        return;
+    d->internal_reportResultsReady(beginIndex, endIndex);
+}
 
-    d->waitCondition.wakeAll();
+/*!
+    \internal
+    Reports \a count results at \a index without locking mutex() in the
+    common case. The results are created by calling \a factory with \a
+    context: a single result if \a vectorSize is 0, and a QList of \a
+    vectorSize results otherwise. They are deleted with \a deleter.
+
+    The results are published in an array indexed by the result index, from
+    where whoever next locks the mutex to look at the results, or to wait
+    for them, moves them into the result store. Only if the entry for \a
+    index is still occupied does this function lock the mutex and add the
+    results directly.
+
+    Returns ResultStaging::Unavailable, without calling \a factory, unless
+    staging was enabled with setResultStagingEnabled(), the future is
+    running and nobody waits for results or watches them. The caller then
+    has to add the results to the store itself.
+
+    Otherwise returns ResultStaging::Rejected if the results were rejected
+    right away, because there already are results at \a index, or the
+    future was canceled or has finished. Staged results are rejected in the
+    same cases, but only when they are moved into the store.
+*/
+QFutureInterfaceBase::ResultStaging
+QFutureInterfaceBase::stageResults(int index, ResultFactory factory, void *context,
+                                   int vectorSize, int count, ResultDeleter deleter)
+{
+    if (index < 0 || !d->stagingEnabled.loadRelaxed() || d->observers.loadRelaxed() != 0
+            || (d->state.loadRelaxed() & (Canceled | Finished))) {
+        return ResultStaging::Unavailable;
+    }
 
-    if (!d->m_progress) {
-        if (d->internal_updateProgressValue(d->m_progressValue + endIndex - beginIndex) == false) {
-            d->sendCallOut(QFutureCallOutEvent(QFutureCallOutEvent::ResultsReady,
-                                               beginIndex,
-                                               endIndex));
-            return;
-        }
+    using StagedResults = QFutureInterfaceBasePrivate::StagedResults;
+    StagedResults *staged = d->stagedResults.loadAcquire();
+    if (!staged) {
+        auto created = new StagedResults;
+        if (d->stagedResults.testAndSetOrdered(nullptr, created, staged))
+            staged = created;
+        else
+            delete created;
+    }
 
-        d->sendCallOuts(QFutureCallOutEvent(QFutureCallOutEvent::Progress,
-                                            d->m_progressValue,
-                                            QString()),
-                        QFutureCallOutEvent(QFutureCallOutEvent::ResultsReady,
-                                            beginIndex,
-                                            endIndex));
-        return;
+    const void *results = factory(context);
+    if (staged->publish(index, results, vectorSize, count, deleter)) {
+        // Pairs with the fence in ResultObserver: either the observer sees
+        // our results, or we see the observer and deliver them ourselves.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (d->observers.loadRelaxed() == 0)
+            return ResultStaging::Accepted;
+        QMutexLocker locker(&d->m_mutex);
+        d->internal_collectStagedResults();
+        return ResultStaging::Accepted;
     }
-    d->sendCallOut(QFutureCallOutEvent(QFutureCallOutEvent::ResultsReady, beginIndex, endIndex));
+
+    QMutexLocker locker(&d->m_mutex);
+    d->internal_collectStagedResults();
+    return d->internal_addResults(index, results, vectorSize, count, deleter)
+            ? ResultStaging::Accepted : ResultStaging::Rejected;
 }
 
 void QFutureInterfaceBase::setRunnable(QRunnable *runnable)
@@ -550,10 +619,25 @@ QThreadPool *QFutureInterfaceBase::threadPool() const
 void QFutureInterfaceBase::setFilterMode(bool enable)
 {
     QMutexLocker locker(&d->m_mutex);
+    if (enable)
+        d->stagingEnabled.storeRelaxed(false);
     if (!hasException())
         resultStoreBase().setFilterMode(enable);
 }
 
+/*!
+    \internal
+    Enables or disables staging of results reported with an index, according
+    to \a enable; see stageResults(). Staging is off by default, and cannot
+    be combined with filter mode.
+*/
+void QFutureInterfaceBase::setResultStagingEnabled(bool enable)
+{
+    QMutexLocker locker(&d->m_mutex);
+    d->internal_collectStagedResults();
+    d->stagingEnabled.storeRelaxed(enable && (hasException() || !resultStoreBase().filterMode()));
+}
+
 /*!
     \internal
     Sets the progress range's minimum and maximum values to \a minimum and
@@ -637,12 +721,14 @@ QtPrivate::ExceptionStore &QFutureInterfaceBase::exceptionStore()
 QtPrivate::ResultStoreBase &QFutureInterfaceBase::resultStoreBase()
 {
     Q_ASSERT(!d->hasException);
+    d->internal_collectStagedResults();
     return d->data.m_results;
 }
 
 const QtPrivate::ResultStoreBase &QFutureInterfaceBase::resultStoreBase() const
 {
     Q_ASSERT(!d->hasException);
+    d->internal_collectStagedResults();
     return d->data.m_results;
 }
 
@@ -692,6 +778,15 @@ QFutureInterfaceBasePrivate::QFutureInterfaceBasePrivate(QFutureInterfaceBase::S
 
 QFutureInterfaceBasePrivate::~QFutureInterfaceBasePrivate()
 {
+    if (StagedResults *staged = stagedResults.loadRelaxed()) {
+        // results staged after the last QFutureInterface<T> cleared the store
+        for (StagedResults::Entry &entry : staged->entries) {
+            if (entry.state.loadRelaxed() == StagedResults::Published)
+                staged->deleter.load(std::memory_order_relaxed)(entry.results, entry.vectorSize);
+        }
+        delete staged;
+    }
+
     if (hasException)
         data.m_exceptionStore.~ExceptionStore();
     else
@@ -713,9 +808,12 @@ bool QFutureInterfaceBasePrivate::internal_waitForNextResult()
     if (hasException)
         return false;
 
+    internal_collectStagedResults();
     if (data.m_results.hasNextResult())
         return true;
 
+    const ResultObserver observer(this);
+    internal_collectStagedResults();
     while ((state.loadRelaxed() & QFutureInterfaceBase::Running)
            && data.m_results.hasNextResult() == false)
         waitCondition.wait(&m_mutex);
@@ -724,6 +822,105 @@ bool QFutureInterfaceBasePrivate::internal_waitForNextResult()
             && data.m_results.hasNextResult();
 }
 
+bool QFutureInterfaceBasePrivate::StagedResults::publish(int index, const void *results,
+                                                         int vectorSize, int count,
+                                                         ResultDeleter deleter) noexcept
+{
+    Entry &entry = entries[index % EntryCount];
+    if (entry.state.loadRelaxed() != Empty || !entry.state.testAndSetAcquire(Empty, Writing))
+        return false;
+    if (!this->deleter.load(std::memory_order_relaxed))
+        this->deleter.store(deleter, std::memory_order_relaxed);
+    entry.index = index;
+    entry.vectorSize = vectorSize;
+    entry.count = count;
+    entry.results = results;
+    entry.state.storeRelease(Published);
+    pending.ref();
+    return true;
+}
+
+// Moves the staged results into the result store, in index order. The mutex
+// must be locked, or the future no longer be shared with other threads.
+void QFutureInterfaceBasePrivate::internal_collectStagedResults()
+{
+    StagedResults *staged = stagedResults.loadAcquire();
+    if (!staged || staged->pending.loadAcquire() == 0)
+        return;
+
+    struct Staged
+    {
+        int index;
+        int vectorSize;
+        int count;
+        const void *results;
+    };
+    QVarLengthArray<Staged, 64> collected;
+    for (StagedResults::Entry &entry : staged->entries) {
+        if (entry.state.loadAcquire() != StagedResults::Published)
+            continue;
+        collected.append({ entry.index, entry.vectorSize, entry.count, entry.results });
+        entry.state.storeRelease(StagedResults::Empty);
+        staged->pending.deref();
+    }
+
+    std::sort(collected.begin(), collected.end(), [](const Staged &lhs, const Staged &rhs) {
+        return lhs.index < rhs.index;
+    });
+    const ResultDeleter deleter = staged->deleter.load(std::memory_order_relaxed);
+    for (const Staged &s : collected)
+        internal_addResults(s.index, s.results, s.vectorSize, s.count, deleter);
+}
+
+bool QFutureInterfaceBasePrivate::internal_addResults(int index, const void *results,
+                                                      int vectorSize, int count,
+                                                      ResultDeleter deleter)
+{
+    if (hasException
+            || (state.loadRelaxed() & (QFutureInterfaceBase::Canceled | QFutureInterfaceBase::Finished))) {
+        deleter(results, vectorSize);
+        return false;
+    }
+
+    QtPrivate::ResultStoreBase &store = data.m_results;
+    const QtPrivate::ResultIteratorBase existing = store.resultAt(index);
+    if (existing != store.end() && existing.isValid()) {
+        deleter(results, vectorSize);
+        return false;
+    }
+
+    const int insertIndex = vectorSize ? store.addResults(index, results, vectorSize, count)
+                                       : store.addResult(index, results);
+    internal_reportResultsReady(insertIndex, insertIndex + count);
+    return true;
+}
+
+void QFutureInterfaceBasePrivate::internal_reportResultsReady(int beginIndex, int endIndex)
+{
+    if (beginIndex == endIndex || (state.loadRelaxed() & (QFutureInterfaceBase::Canceled | QFutureInterfaceBase::Finished)))
+        return;
+
+    waitCondition.wakeAll();
+
+    if (!m_progress) {
+        if (internal_updateProgressValue(m_progressValue + endIndex - beginIndex) == false) {
+            sendCallOut(QFutureCallOutEvent(QFutureCallOutEvent::ResultsReady,
+                                            beginIndex,
+                                            endIndex));
+            return;
+        }
+
+        sendCallOuts(QFutureCallOutEvent(QFutureCallOutEvent::Progress,
+                                         m_progressValue,
+                                         QString()),
+                     QFutureCallOutEvent(QFutureCallOutEvent::ResultsReady,
+                                         beginIndex,
+                                         endIndex));
+        return;
+    }
+    sendCallOut(QFutureCallOutEvent(QFutureCallOutEvent::ResultsReady, beginIndex, endIndex));
+}
+
 bool QFutureInterfaceBasePrivate::internal_updateProgressValue(int progress)
 {
     if (m_progressValue >= progress)
@@ -805,6 +1002,11 @@ void QFutureInterfaceBasePrivate::connectOutputInterface(QFutureCallOutInterface
 {
     QMutexLocker locker(&m_mutex);
 
+    // from now on, results are reported right away; see ResultObserver
+    observers.ref();
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    internal_collectStagedResults();
+
     const auto currentState = state.loadRelaxed();
     if (currentState & QFutureInterfaceBase::Started) {
         iface->postCallOutEvent(QFutureCallOutEvent(QFutureCallOutEvent::Started));
@@ -858,6 +1060,7 @@ void QFutureInterfaceBasePrivate::disconnectOutputInterface(QFutureCallOutInterf
     if (index == -1)
         return;
     outputConnections.removeAt(index);
+    observers.deref();
 
     iface->callOutInterfaceDisconnected();
 }
@@ -43,6 +43,9 @@ class FailureHandler;
 void Q_CORE_EXPORT watchContinuationImpl(const QObject *context,
                                          QtPrivate::QSlotObjectBase *slotObj,
                                          QFutureInterfaceBase &fi);
+
+template<typename T>
+class FutureAwaiter;
 }
 
 class Q_CORE_EXPORT QFutureInterfaceBase
@@ -87,6 +90,7 @@ public:
     void setThreadPool(QThreadPool *pool);
     QThreadPool *threadPool() const;
     void setFilterMode(bool enable);
+    void setResultStagingEnabled(bool enable);
     void setProgressRange(int minimum, int maximum);
     int progressMinimum() const;
     int progressMaximum() const;
@@ -159,6 +163,14 @@ protected:
     bool derefT() const noexcept;
     void reset();
     void rethrowPossibleException();
+
+    // create and delete the results passed to stageResults(): a T if
+    // vectorSize is 0, else a QList<T>
+    using ResultFactory = const void *(*)(void *context);
+    using ResultDeleter = void (*)(const void *results, int vectorSize);
+    enum class ResultStaging { Accepted, Rejected, Unavailable };
+    ResultStaging stageResults(int index, ResultFactory factory, void *context, int vectorSize,
+                               int count, ResultDeleter deleter);
 public:
 
 #ifndef QFUTURE_TEST
@@ -187,6 +199,9 @@ private:
     template<class T>
     friend class QPromise;
 
+    template<typename T>
+    friend class QtPrivate::FutureAwaiter;
+
 protected:
     void setContinuation(std::function<void(const QFutureInterfaceBase &)> func);
     void setContinuation(std::function<void(const QFutureInterfaceBase &)> func,
@@ -235,8 +250,12 @@ public:
 
     ~QFutureInterface()
     {
-        if (!derefT() && !hasException())
+        if (!derefT() && !hasException()) {
+            // other QFutureInterfaceBase objects may still move staged
+            // results into the store
+            QMutexLocker<QMutex> locker(&mutex());
             resultStoreBase().template clear<T>();
+        }
     }
 
     static QFutureInterface canceledResult()
@@ -286,11 +305,38 @@ public:
         QFutureInterfaceBase::reportException(e);
     }
 #endif
+
+private:
+    static void deleteResults(const void *results, int vectorSize)
+    {
+        if (vectorSize)
+            delete static_cast<const QList<T> *>(results);
+        else
+            delete static_cast<const T *>(results);
+    }
+
+    // Only calls create() once the results can be staged.
+    template <typename Create>
+    ResultStaging stageNewResults(int index, int vectorSize, int count, Create create)
+    {
+        const ResultFactory factory = [](void *context) -> const void * {
+            return (*static_cast<Create *>(context))();
+        };
+        return stageResults(index, factory, &create, vectorSize, count, &deleteResults);
+    }
 };
 
 template <typename T>
 inline bool QFutureInterface<T>::reportResult(const T *result, int index)
 {
+    if (result && index >= 0) {
+        const ResultStaging staging = stageNewResults(index, 0, 1, [result] {
+            return new T(*result);
+        });
+        if (staging != ResultStaging::Unavailable)
+            return staging == ResultStaging::Accepted;
+    }
+
     QMutexLocker<QMutex> locker{&mutex()};
     if (this->queryState(Canceled) || this->queryState(Finished))
         return false;
@@ -314,6 +360,14 @@ template<typename T>
 template<typename...Args, std::enable_if_t<std::is_constructible_v<T, Args...>, bool>>
 bool QFutureInterface<T>::reportAndEmplaceResult(int index, Args&&...args)
 {
+    if (index >= 0) {
+        const ResultStaging staging = stageNewResults(index, 0, 1, [&] {
+            return new T(std::forward<Args>(args)...);
+        });
+        if (staging != ResultStaging::Unavailable)
+            return staging == ResultStaging::Accepted;
+    }
+
     QMutexLocker<QMutex> locker{&mutex()};
     if (queryState(Canceled) || queryState(Finished))
         return false;
@@ -350,6 +404,15 @@ inline bool QFutureInterface<T>::reportResult(const T &result, int index)
 template<typename T>
 inline bool QFutureInterface<T>::reportResults(const QList<T> &_results, int beginIndex, int count)
 {
+    if (!_results.isEmpty() && beginIndex >= 0) {
+        const int size = int(_results.size());
+        const ResultStaging staging = stageNewResults(beginIndex, size, size, [&_results] {
+            return new QList<T>(_results);
+        });
+        if (staging != ResultStaging::Unavailable)
+            return staging == ResultStaging::Accepted;
+    }
+
     QMutexLocker<QMutex> locker{&mutex()};
     if (this->queryState(Canceled) || this->queryState(Finished))
         return false;
@@ -155,6 +155,34 @@ public:
     };
     QScopedPointer<ProgressData> m_progress;
 
+    // Results reported with an index while nobody observes them are
+    // published here without locking m_mutex, and moved into the result
+    // store in batches; see QFutureInterfaceBase::stageResults().
+    using ResultDeleter = void (*)(const void *results, int vectorSize);
+    struct StagedResults
+    {
+        enum EntryState { Empty, Writing, Published };
+        struct Entry
+        {
+            QAtomicInt state;
+            int index;
+            int vectorSize;     // 0 for a single result
+            int count;
+            const void *results;
+        };
+        static constexpr int EntryCount = 512; // indexed by result index, modulo the size
+
+        bool publish(int index, const void *results, int vectorSize, int count,
+                     ResultDeleter deleter) noexcept;
+
+        Entry entries[EntryCount];
+        QAtomicInt pending;
+        std::atomic<ResultDeleter> deleter = nullptr;
+    };
+    QAtomicPointer<StagedResults> stagedResults;
+    QAtomicInt observers; // output connections and threads waiting for results
+    QAtomicInteger<bool> stagingEnabled = false;
+
     int m_expectedResultCount = 0;
     bool launchAsync = false;
     bool isValid = false;
@@ -171,6 +199,10 @@ public:
     int internal_resultCount() const;
     bool internal_isResultReadyAt(int index) const;
     bool internal_waitForNextResult();
+    void internal_collectStagedResults();
+    bool internal_addResults(int index, const void *results, int vectorSize, int count,
+                             ResultDeleter deleter);
+    void internal_reportResultsReady(int beginIndex, int endIndex);
     bool internal_updateProgressValue(int progress);
     bool internal_updateProgress(int progress, const QString &progressText = QString());
     void internal_setThrottled(bool enable);
@@ -9,9 +9,14 @@
 #include <qdebug.h>
 #include "qatomic.h"
 #include "qfutex_p.h"
+#include "qhash.h"
 #include "qthread.h"
 #include "qmutex_p.h"
 
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
 #ifndef QT_ALWAYS_USE_FUTEX
 #include "private/qfreelist_p.h"
 #endif
@@ -634,17 +639,265 @@ void QRecursiveMutex::unlock() noexcept
  * waiting in the past. We then set the mutex to 0x0 and perform a FUTEX_WAKE.
  */
 
+/*
+ * CONTENDED ACQUISITION:
+ *
+ * Most critical sections are short, so a thread that finds the mutex locked
+ * often only has to wait for a fraction of what the FUTEX_WAIT and FUTEX_WAKE
+ * pair costs. Before sleeping, lockInternal() therefore spins, checking
+ * whether the mutex got unlocked. We cannot tell whether the owner is running,
+ * as the mutex does not record its owner, so we use the waiters bit instead:
+ * once a thread sleeps on the mutex, newcomers stop spinning and queue up
+ * behind it, instead of repeatedly overtaking it.
+ *
+ * How long we spin adapts to the critical sections of the mutex: we keep an
+ * exponential average of how many spins it took to get it, in a small table
+ * indexed by the address of the mutex. When spinning did not succeed, we
+ * convert the time we waited into spins; waits longer than the maximum count
+ * as zero, so that mutexes with long critical sections stop spinning.
+ */
+
+namespace {
+using namespace std::chrono;
+
+enum {
+    DefaultMaximumSpinCount = 256,
+    MinimumSpinCount = 16,
+    SpinEstimateCount = 64
+};
+
+Q_CONSTINIT QBasicAtomicInt maximumSpins = Q_BASIC_ATOMIC_INITIALIZER(-1);
+Q_CONSTINIT QBasicAtomicInteger<bool> statisticsEnabled = Q_BASIC_ATOMIC_INITIALIZER(false);
+QBasicAtomicInt spinEstimates[SpinEstimateCount];
+
+struct ContentionTable
+{
+    // not a QMutex, we record from inside QBasicMutex::lockInternal()
+    std::mutex mutex;
+    QHash<const QBasicMutex *, QMutexContention::Statistics> statistics;
+};
+Q_GLOBAL_STATIC(ContentionTable, contentionTable)
+
+inline QMutexPrivate *dummyLockedValue()
+{
+    return reinterpret_cast<QMutexPrivate *>(quintptr(1));
+}
+
+// One contended acquisition of a futex-based mutex: spins for the mutex, and
+// when done, updates its spin estimate and contention statistics.
+class ContendedAcquisition
+{
+    Q_DISABLE_COPY_MOVE(ContendedAcquisition)
+public:
+    explicit ContendedAcquisition(const QBasicMutex *mutex) noexcept
+        : mutex(mutex),
+          estimate(spinEstimates[((quintptr(mutex) >> 3) ^ (quintptr(mutex) >> 9)) % SpinEstimateCount]),
+          maximum(QMutexContention::maximumSpinCount()),
+          recording(QMutexContention::isStatisticsEnabled())
+    {
+        if (maximum > 0 || recording)
+            start = steady_clock::now();
+    }
+    ~ContendedAcquisition()
+    {
+        if (maximum > 0 || recording)
+            finish();
+    }
+
+    // Returns true if it acquired the mutex whose state is \a d_ptr
+    bool spin(QBasicAtomicPointer<QMutexPrivate> &d_ptr) noexcept
+    {
+        const int limit = qMin(2 * estimate.loadRelaxed() + MinimumSpinCount, maximum);
+        for (spins = 0; spins < limit; ++spins) {
+            QMutexPrivate *d = d_ptr.loadRelaxed();
+            if (!d && d_ptr.testAndSetAcquire(nullptr, dummyLockedValue()))
+                return true;
+            if (d == dummyFutexValue())
+                break;  // others sleep already, don't overtake them
+            qYieldCpu();
+        }
+        return false;
+    }
+
+    // Called after each futex wait
+    void recordSleep() noexcept { slept = true; }
+
+private:
+    void finish() noexcept;
+
+    const QBasicMutex *mutex;
+    QBasicAtomicInt &estimate;
+    steady_clock::time_point start;
+    int maximum;
+    int spins = 0;
+    bool recording;
+    bool slept = false;
+};
+
+// The time 1024 iterations of the spin loop take, measured once, so that
+// ContendedAcquisition does not need to read the clock when it stops spinning.
+qint64 nsecsPer1024Spins() noexcept
+{
+    static const qint64 nsecs = [] {
+        QBasicAtomicPointer<QMutexPrivate> d_ptr = Q_BASIC_ATOMIC_INITIALIZER(nullptr);
+        const auto start = steady_clock::now();
+        for (int i = 0; i < 1024; ++i) {
+            (void)d_ptr.loadRelaxed();
+            qYieldCpu();
+        }
+        return qMax(qint64(1), qint64(nanoseconds(steady_clock::now() - start).count()));
+    }();
+    return nsecs;
+}
+
+void ContendedAcquisition::finish() noexcept
+{
+    const qint64 waited = nanoseconds(steady_clock::now() - start).count();
+    if (maximum > 0 && spins > 0) {
+        int observed = spins;
+        if (slept) {
+            // how many spins would have been enough?
+            const qint64 needed = waited * 1024 / nsecsPer1024Spins();
+            observed = needed > maximum ? 0 : int(needed);
+        }
+        const int current = estimate.loadRelaxed();
+        estimate.storeRelaxed(current + (observed - current) / 8);
+    }
+
+    if (!recording || contentionTable.isDestroyed())
+        return;
+    const quint64 nsecs = quint64(waited);
+    ContentionTable *table = contentionTable();
+    std::lock_guard locker(table->mutex);
+    QMutexContention::Statistics &s = table->statistics[mutex];
+    ++s.waits;
+    if (slept)
+        ++s.sleeps;
+    s.totalWaitNSecs += nsecs;
+    s.maxWaitNSecs = std::max(s.maxWaitNSecs, nsecs);
+}
+} // unnamed namespace
+
+/*!
+    \internal
+    \class QMutexContention
+    \inmodule QtCore
+
+    Controls how QBasicMutex, and thus QMutex and QRecursiveMutex, waits for
+    a locked mutex, and records how often and for how long threads wait.
+    Both only apply where the mutex is implemented with futexes, such as on
+    Linux, Windows, and \macos.
+
+    A thread that finds the mutex locked spins for at most
+    maximumSpinCount() iterations before going to sleep, fewer if the
+    critical sections of the mutex turned out to be short or too long for
+    spinning to pay off. Setting the maximum to zero disables spinning, so
+    that threads are served strictly in the order the operating system wakes
+    them up. By default, the maximum is 256 on multi-core machines and zero
+    otherwise.
+
+    With setStatisticsEnabled(), every contended acquisition is counted for
+    its mutex, identified by its address. The statistics of a mutex that
+    was destroyed remain until resetStatistics(), and are merged with those
+    of a mutex later created at the same address.
+*/
+
+int QMutexContention::maximumSpinCount() noexcept
+{
+    int count = maximumSpins.loadRelaxed();
+    if (Q_UNLIKELY(count < 0)) {
+        count = QThread::idealThreadCount() > 1 ? DefaultMaximumSpinCount : 0;
+        maximumSpins.storeRelaxed(count);
+    }
+    return count;
+}
+
+void QMutexContention::setMaximumSpinCount(int count) noexcept
+{
+    maximumSpins.storeRelaxed(qMax(count, 0));
+}
+
+bool QMutexContention::isStatisticsEnabled() noexcept
+{
+    return statisticsEnabled.loadRelaxed();
+}
+
+void QMutexContention::setStatisticsEnabled(bool enable) noexcept
+{
+    statisticsEnabled.storeRelaxed(enable);
+}
+
+/*!
+    \internal
+    Returns the statistics recorded for \a mutex.
+*/
+QMutexContention::Statistics QMutexContention::statistics(const QBasicMutex *mutex)
+{
+    if (contentionTable.isDestroyed())
+        return {};
+    ContentionTable *table = contentionTable();
+    std::lock_guard locker(table->mutex);
+    return table->statistics.value(mutex);
+}
+
+/*!
+    \internal
+    Returns up to \a count mutexes with their statistics, in descending
+    order of the total time threads waited for them.
+*/
+QList<std::pair<const QBasicMutex *, QMutexContention::Statistics>>
+QMutexContention::mostContended(qsizetype count)
+{
+    QList<std::pair<const QBasicMutex *, Statistics>> result;
+    if (contentionTable.isDestroyed())
+        return result;
+    ContentionTable *table = contentionTable();
+    {
+        std::lock_guard locker(table->mutex);
+        result.reserve(table->statistics.size());
+        for (auto it = table->statistics.cbegin(); it != table->statistics.cend(); ++it)
+            result.emplaceBack(it.key(), it.value());
+    }
+
+    auto longer = [](const auto &lhs, const auto &rhs) {
+        return lhs.second.totalWaitNSecs > rhs.second.totalWaitNSecs;
+    };
+    const qsizetype n = std::min(count, result.size());
+    std::partial_sort(result.begin(), result.begin() + n, result.end(), longer);
+    result.resize(n);
+    return result;
+}
+
+void QMutexContention::resetStatistics()
+{
+    if (contentionTable.isDestroyed())
+        return;
+    ContentionTable *table = contentionTable();
+    std::lock_guard locker(table->mutex);
+    table->statistics.clear();
+}
+
+bool QMutexContention::hasSleepers(const QBasicMutex *mutex) noexcept
+{
+    return futexAvailable() && QMutexPrivate::hasFutexWaiters(mutex);
+}
+
 /*!
     \internal helper for lock()
  */
 void QBasicMutex::lockInternal() QT_MUTEX_LOCK_NOEXCEPT
 {
     if (futexAvailable()) {
+        ContendedAcquisition acquisition(this);
+        if (acquisition.spin(d_ptr))
+            return;
+
         // note we must set to dummyFutexValue because there could be other threads
         // also waiting
         while (d_ptr.fetchAndStoreAcquire(dummyFutexValue()) != nullptr) {
             // successfully set the waiting bit, now sleep
             futexWait(d_ptr, dummyFutexValue());
+            acquisition.recordSleep();
 
             // we got woken up, so try to acquire the mutex
         }
@@ -681,6 +934,10 @@ bool QBasicMutex::lockInternal(QDeadlineTimer deadlineTimer) QT_MUTEX_LOCK_NOEXC
             return true;
         }
 
+        ContendedAcquisition acquisition(this);
+        if (acquisition.spin(d_ptr))
+            return true;
+
         // The mutex is already locked, set a bit indicating we're waiting.
         // Note we must set to dummyFutexValue because there could be other threads
         // also waiting.
@@ -688,7 +945,9 @@ bool QBasicMutex::lockInternal(QDeadlineTimer deadlineTimer) QT_MUTEX_LOCK_NOEXC
             return true;
 
         for (;;) {
-            if (!futexWait(d_ptr, dummyFutexValue(), deadlineTimer))
+            const bool woken = futexWait(d_ptr, dummyFutexValue(), deadlineTimer);
+            acquisition.recordSleep();
+            if (!woken)
                 return false;
 
             // We got woken up, so must try to acquire the mutex. We must set
@@ -806,6 +1065,11 @@ bool QBasicMutex::lockInternal(QDeadlineTimer deadlineTimer) QT_MUTEX_LOCK_NOEXC
 #endif
 }
 
+bool QMutexPrivate::hasFutexWaiters(const QBasicMutex *mutex) noexcept
+{
+    return mutex->d_ptr.loadAcquire() == dummyFutexValue();
+}
+
 /*!
     \internal
 */
@@ -22,6 +22,9 @@
 #include <QtCore/qmutex.h>
 #include <QtCore/qatomic.h>
 #include <QtCore/qdeadlinetimer.h>
+#include <QtCore/qlist.h>
+
+#include <utility>
 
 #include "qplatformdefs.h" // _POSIX_VERSION
 
@@ -72,6 +75,8 @@ public:
     void release();
     static QMutexPrivate *allocate();
 
+    static bool hasFutexWaiters(const QBasicMutex *mutex) noexcept;
+
     QAtomicInt waiters; // Number of threads waiting on this mutex. (may be offset by -BigNumber)
     QAtomicInt possiblyUnlocked; /* Boolean indicating that a timed wait timed out.
                                     When it is true, a reference is held.
@@ -89,6 +94,32 @@ public:
 #endif
 };
 
+// Tuning and profiling of contended QBasicMutex acquisitions; only the
+// futex-based implementation spins and collects statistics.
+class Q_CORE_EXPORT QMutexContention
+{
+public:
+    struct Statistics
+    {
+        quint64 waits = 0;          // acquisitions that found the mutex locked
+        quint64 sleeps = 0;         // ... and had to sleep rather than spin
+        quint64 totalWaitNSecs = 0;
+        quint64 maxWaitNSecs = 0;
+    };
+
+    static int maximumSpinCount() noexcept;
+    static void setMaximumSpinCount(int count) noexcept;
+
+    static bool isStatisticsEnabled() noexcept;
+    static void setStatisticsEnabled(bool enable) noexcept;
+    static Statistics statistics(const QBasicMutex *mutex);
+    static QList<std::pair<const QBasicMutex *, Statistics>> mostContended(qsizetype count = 10);
+    static void resetStatistics();
+
+    // whether threads sleep on mutex, or are about to; for tests
+    static bool hasSleepers(const QBasicMutex *mutex) noexcept;
+};
+
 QT_END_NAMESPACE
 
 #endif // QMUTEX_P_H
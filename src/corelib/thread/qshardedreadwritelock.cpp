@@ -0,0 +1,180 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qshardedreadwritelock_p.h"
+
+#include "qmath.h"
+#include "qthread.h"
+#include <private/qfutex_p.h>
+
+QT_BEGIN_NAMESPACE
+
+using namespace QtFutex;
+
+/*!
+    \internal
+    \class QShardedReadWriteLock
+    \inmodule QtCore
+
+    A read-write lock for data that is read far more often than it is
+    written, such as caches and registries shared by many threads.
+
+    QReadWriteLock keeps its readers in a single atomic word, so every
+    lockForRead() and unlock() writes the same cache line, and read-mostly
+    code stops scaling with the number of cores. QShardedReadWriteLock
+    counts its readers in one of several counters instead, each on a cache
+    line of its own; a thread always uses the same counter. Readers only
+    touch shared state when a writer is present. The price is paid by the
+    writers, which have to look at every counter, and in memory: the lock
+    has one counter per core, rounded up to a power of two, but at most 64.
+
+    Blocked threads wait on the futex primitives of the platform; where
+    there are none, they yield their time slice instead.
+
+    Like QReadWriteLock, the lock prefers writers: once a writer waits, new
+    readers wait as well. It is not recursive. unlock() releases either kind
+    of lock; for std::shared_lock and std::unique_lock, the lock also
+    provides the functions of the SharedMutex requirements.
+*/
+
+namespace {
+enum { MaxShards = 64 };
+
+Q_CONSTINIT QBasicAtomicInt nextThreadShard = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+// Blocks while \a word has the given \a value, or until \a timeout expires
+void waitWhileEqual(QAtomicInt &word, int value, QDeadlineTimer timeout)
+{
+    if (futexAvailable()) {
+        if (timeout.isForever())
+            futexWait(word, value);
+        else
+            futexWait(word, value, timeout);
+    } else {
+        QThread::yieldCurrentThread();
+    }
+}
+} // unnamed namespace
+
+int QShardedReadWriteLock::currentThreadShard() noexcept
+{
+    static thread_local const int shard = nextThreadShard.fetchAndAddRelaxed(1);
+    return shard;
+}
+
+QShardedReadWriteLock::QShardedReadWriteLock()
+{
+    const quint32 cores = quint32(qMax(QThread::idealThreadCount(), 1));
+    const int count = int(qMin(qNextPowerOfTwo(cores - 1), quint32(MaxShards)));
+    shards.reset(new Shard[count]);
+    shardMask = count - 1;
+}
+
+QShardedReadWriteLock::~QShardedReadWriteLock()
+{
+#ifndef QT_NO_DEBUG
+    Q_ASSERT_X(writer.loadRelaxed() == NoWriter, "QShardedReadWriteLock",
+               "destroying a lock that is locked for writing");
+    for (int i = 0; i <= shardMask; ++i) {
+        Q_ASSERT_X(shards[i].readers.loadRelaxed() == 0, "QShardedReadWriteLock",
+                   "destroying a lock that is locked for reading");
+    }
+#endif
+}
+
+bool QShardedReadWriteLock::contendedLockForRead(Shard &shard, QDeadlineTimer timeout)
+{
+    while (true) {
+        // a writer holds the lock or waits for it: step back until it is done
+        unlockRead(shard);
+        if (!waitForWriter(timeout))
+            return false;
+        shard.readers.fetchAndAddRelaxed(1);
+        if (!writerPresent())
+            return true;
+    }
+}
+
+bool QShardedReadWriteLock::waitForWriter(QDeadlineTimer timeout)
+{
+    int state = writer.loadAcquire();
+    while (state != NoWriter) {
+        if (timeout.hasExpired())
+            return false;
+        if (state == WriterLocked
+                && !writer.testAndSetRelaxed(WriterLocked, WriterLockedWithWaiters, state)) {
+            continue;
+        }
+        waitWhileEqual(writer, WriterLockedWithWaiters, timeout);
+        state = writer.loadAcquire();
+    }
+    return true;
+}
+
+bool QShardedReadWriteLock::tryLockForWrite(QDeadlineTimer timeout)
+{
+    int state = NoWriter;
+    while (!writer.testAndSetAcquire(NoWriter, WriterLocked, state)) {
+        // another writer: once we waited, we can no longer tell whether
+        // others wait too, so announce waiters when we get the lock
+        while (state != NoWriter) {
+            if (timeout.hasExpired())
+                return false;
+            if (state == WriterLocked
+                    && !writer.testAndSetRelaxed(WriterLocked, WriterLockedWithWaiters, state)) {
+                continue;
+            }
+            waitWhileEqual(writer, WriterLockedWithWaiters, timeout);
+            state = writer.loadRelaxed();
+        }
+        if (writer.testAndSetAcquire(NoWriter, WriterLockedWithWaiters, state))
+            break;
+    }
+    writerThread.storeRelaxed(QThread::currentThreadId());
+
+    // Pairs with the fence in writerPresent(): from now on, readers step
+    // back, so wait for those that got in before us.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (int i = 0; i <= shardMask; ++i) {
+        Shard &shard = shards[i];
+        int readers = shard.readers.loadAcquire();
+        while (readers != 0) {
+            if (timeout.hasExpired()) {
+                unlockWrite();
+                return false;
+            }
+            waitWhileEqual(shard.readers, readers, timeout);
+            readers = shard.readers.loadAcquire();
+        }
+    }
+    return true;
+}
+
+void QShardedReadWriteLock::unlock()
+{
+    if (writerThread.loadRelaxed() == QThread::currentThreadId())
+        unlockWrite();
+    else
+        unlockRead(currentShard());
+}
+
+void QShardedReadWriteLock::unlockRead(Shard &shard)
+{
+    const int previous = shard.readers.fetchAndSubRelease(1);
+    Q_ASSERT_X(previous > 0, "QShardedReadWriteLock::unlock()", "Cannot unlock an unlocked lock");
+    if (previous != 1)
+        return;
+    // pairs with the fence in tryLockForWrite(), like writerPresent()
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (writer.loadRelaxed() != NoWriter && futexAvailable())
+        futexWakeAll(shard.readers);
+}
+
+void QShardedReadWriteLock::unlockWrite()
+{
+    writerThread.storeRelaxed(nullptr);
+    if (writer.fetchAndStoreRelease(NoWriter) == WriterLockedWithWaiters && futexAvailable())
+        futexWakeAll(writer);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,95 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QSHARDEDREADWRITELOCK_P_H
+#define QSHARDEDREADWRITELOCK_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qatomic.h>
+#include <QtCore/qdeadlinetimer.h>
+
+#include <atomic>
+#include <memory>
+
+QT_REQUIRE_CONFIG(thread);
+
+QT_BEGIN_NAMESPACE
+
+class Q_CORE_EXPORT QShardedReadWriteLock
+{
+    Q_DISABLE_COPY_MOVE(QShardedReadWriteLock)
+public:
+    QShardedReadWriteLock();
+    ~QShardedReadWriteLock();
+
+    void lockForRead() { tryLockForRead(QDeadlineTimer(QDeadlineTimer::Forever)); }
+    bool tryLockForRead(QDeadlineTimer timeout = {})
+    {
+        Shard &shard = currentShard();
+        shard.readers.fetchAndAddRelaxed(1);
+        if (Q_LIKELY(!writerPresent()))
+            return true;
+        return contendedLockForRead(shard, timeout);
+    }
+
+    void lockForWrite() { tryLockForWrite(QDeadlineTimer(QDeadlineTimer::Forever)); }
+    bool tryLockForWrite(QDeadlineTimer timeout = {});
+
+    void unlock();
+
+    // for std::shared_lock and std::unique_lock
+    void lock_shared() { lockForRead(); }
+    bool try_lock_shared() { return tryLockForRead(); }
+    void unlock_shared() { unlockRead(currentShard()); }
+    void lock() { lockForWrite(); }
+    bool try_lock() { return tryLockForWrite(); }
+
+    int shardCount() const noexcept { return shardMask + 1; }
+
+private:
+    struct alignas(64) Shard
+    {
+        QAtomicInt readers;
+    };
+
+    enum WriterState {
+        NoWriter = 0,
+        WriterLocked = 1,
+        WriterLockedWithWaiters = 2,
+    };
+
+    Shard &currentShard() const noexcept { return shards[currentThreadShard() & shardMask]; }
+    bool writerPresent() const noexcept
+    {
+        // Pairs with the fence in tryLockForWrite(): either the reader sees
+        // the writer, or the writer sees the reader's count.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return writer.loadAcquire() != NoWriter;
+    }
+    bool contendedLockForRead(Shard &shard, QDeadlineTimer timeout);
+    void unlockRead(Shard &shard);
+    void unlockWrite();
+    bool waitForWriter(QDeadlineTimer timeout);
+
+    static int currentThreadShard() noexcept;
+
+    std::unique_ptr<Shard[]> shards;
+    int shardMask;
+    alignas(64) QAtomicInt writer;
+    QAtomicPointer<void> writerThread;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSHARDEDREADWRITELOCK_P_H
@@ -8,6 +8,7 @@
 #include "qreadwritelock.h"
 #include "qabstracteventdispatcher.h"
 #include "qbindingstorage.h"
+#include "qyieldcpu.h"
 
 #include <qeventloop.h>
 
@@ -40,6 +41,96 @@ void QPostEventList::addEvent(const QPostEvent &ev)
     }
 }
 
+/*
+    Pushes \a node onto the inbox. Returns \c false without pushing if the
+    inbox is closed, in which case the caller must post the event with the
+    mutex locked instead.
+*/
+bool QPostEventList::pushToInbox(InboxNode *node) noexcept
+{
+    InboxNode *head = inbox.loadRelaxed();
+    do {
+        if (head == closedInbox())
+            return false;
+        node->next = head;
+    } while (!inbox.testAndSetRelease(head, node, head));
+    return true;
+}
+
+/*
+    Moves the events posted to the inbox into the list, in the order they were
+    posted. Must be called with the mutex locked. A closed inbox stays closed.
+*/
+void QPostEventList::takeInbox()
+{
+    InboxNode *node = inbox.loadAcquire();
+    do {
+        if (!node || node == closedInbox())
+            return;
+    } while (!inbox.testAndSetAcquire(node, nullptr, node));
+    addInboxEvents(node);
+}
+
+/*
+    Like takeInbox(), but detaches the inbox by leaving it closed, so that all
+    further events are posted with the mutex locked until reopenInbox(). Must
+    be called with the mutex locked.
+
+    QObject::moveToThread() closes the inbox of the thread an object leaves, as
+    producers that looked up the object's thread before it changed could
+    otherwise push events for it to this list afterwards.
+*/
+void QPostEventList::closeInbox()
+{
+    InboxNode *node = inbox.fetchAndStoreAcquire(closedInbox());
+    if (node != closedInbox())
+        addInboxEvents(node);
+}
+
+void QPostEventList::addInboxEvents(InboxNode *node)
+{
+    // the stack holds the most recently posted event first
+    InboxNode *first = nullptr;
+    while (node) {
+        InboxNode *next = node->next;
+        node->next = first;
+        first = node;
+        node = next;
+    }
+
+    while (first) {
+        InboxNode *next = first->next;
+        addEvent(first->event);
+        delete first;
+        first = next;
+    }
+}
+
+/*
+    Makes producers that register with the list from now on count in the
+    other half of inboxPosters, and returns the index of the half that counts
+    the ones that registered before. Must be called with the mutex locked.
+*/
+int QPostEventList::startInboxEpoch() noexcept
+{
+    return inboxEpoch.fetchAndXorRelease(1);
+}
+
+/*
+    Waits for the producers registered in \a previousEpoch to leave and
+    reopens the inbox. Those producers find the inbox closed or the object's
+    new thread, and producers that register later are not waited for, so the
+    wait is bounded. Call it without the mutex locked: producers that find the
+    inbox closed post their events with it locked.
+*/
+void QPostEventList::reopenInbox(int previousEpoch) noexcept
+{
+    // pairs with the fence in QCoreApplicationPrivate::enterThreadPostEventInbox()
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (inboxPosters[previousEpoch].loadAcquire())
+        qYieldCpu();
+    inbox.testAndSetRelease(closedInbox(), nullptr);
+}
 
 /*
   QThreadData
@@ -82,6 +173,7 @@ QThreadData::~QThreadData()
     thread.storeRelease(nullptr);
     delete t;
 
+    postEventList.takeInbox();
     for (int i = 0; i < postEventList.size(); ++i) {
         const QPostEvent &pe = postEventList.at(i);
         if (pe.event) {
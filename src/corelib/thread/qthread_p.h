@@ -72,11 +72,44 @@ public:
 
     QMutex mutex;
 
+    // Events posted without locking the mutex, see QCoreApplication::postEvent().
+    // Producers push onto this lock-free stack, and whoever holds the mutex moves
+    // it into the sorted list with takeInbox() before inspecting the list.
+    struct InboxNode
+    {
+        QPostEvent event;
+        InboxNode *next;
+
+        static void *operator new(size_t size) { return QEventPool::allocate(size); }
+        static void operator delete(void *ptr, size_t size) noexcept { QEventPool::release(ptr, size); }
+    };
+    QAtomicPointer<InboxNode> inbox;
+    // number of producers that picked this list and have not pushed yet, counted
+    // separately for the current and the previous inbox epoch
+    QAtomicInt inboxPosters[2];
+    QAtomicInt inboxEpoch;
+
     inline QPostEventList() : QList<QPostEvent>(), recursion(0), startOffset(0), insertionOffset(0) { }
 
     void addEvent(const QPostEvent &ev);
 
+    bool pushToInbox(InboxNode *node) noexcept;
+    void takeInbox();
+    void closeInbox();
+    int startInboxEpoch() noexcept;
+    void reopenInbox(int previousEpoch) noexcept;
+    bool hasInboxEvents() const noexcept
+    {
+        InboxNode *head = inbox.loadAcquire();
+        return head && head != closedInbox();
+    }
+
+    // stored in inbox while it is closed
+    static InboxNode *closedInbox() noexcept { return reinterpret_cast<InboxNode *>(quintptr(1)); }
+
 private:
+    void addInboxEvents(InboxNode *node);
+
     //hides because they do not keep that list sorted. addEvent must be used
     using QList<QPostEvent>::append;
     using QList<QPostEvent>::insert;
@@ -317,7 +350,7 @@ public:
     bool canWaitLocked()
     {
         QMutexLocker locker(&postEventList.mutex);
-        return canWait;
+        return canWait && !postEventList.hasInboxEvents();
     }
 
 private:
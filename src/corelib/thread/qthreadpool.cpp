@@ -5,11 +5,17 @@
 #include "qthreadpool_p.h"
 #include "qdeadlinetimer.h"
 #include "qcoreapplication.h"
+#include "qfile.h"
 
 #include <QtCore/qpointer.h>
 
 #include <algorithm>
 #include <memory>
+#include <numeric>
+
+#if defined(Q_OS_LINUX)
+#include <sched.h>
+#endif
 
 QT_BEGIN_NAMESPACE
 
@@ -25,12 +31,28 @@ public:
     QThreadPoolThread(QThreadPoolPrivate *manager);
     void run() override;
     void registerThreadInactive();
+    QRunnable *takeLocalTask();
+    void applyCpuAffinity();
 
     QWaitCondition runnableReady;
     QThreadPoolPrivate *manager;
     QRunnable *runnable;
+
+    // the NUMA node this thread belongs to, and the CPUs it is pinned to
+    // when it starts, or when it wakes up with cpusChanged set; no pinning
+    // if empty
+    int numaNode = 0;
+    QList<int> cpus;
+    bool cpusChanged = false;
+
+    // work-stealing mode: runnables started from this thread. The thread
+    // itself takes from the back, the other threads steal from the front.
+    QMutex localMutex;
+    QList<QRunnable *> localTasks;
 };
 
+Q_CONSTINIT static thread_local QThreadPoolThread *currentPoolThread = nullptr;
+
 /*
     QThreadPool private class.
 */
@@ -50,34 +72,41 @@ QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
 */
 void QThreadPoolThread::run()
 {
+    currentPoolThread = this;
     QMutexLocker locker(&manager->mutex);
+    applyCpuAffinity();
     for(;;) {
         QRunnable *r = runnable;
         runnable = nullptr;
 
         do {
             if (r) {
-                // If autoDelete() is false, r might already be deleted after run(), so check status now.
-                const bool del = r->autoDelete();
-
-                // run the task
                 locker.unlock();
+                do {
+                    // If autoDelete() is false, r might already be deleted after run(), so check status now.
+                    const bool del = r->autoDelete();
+
+                    // run the task
 #ifndef QT_NO_EXCEPTIONS
-                try {
+                    try {
 #endif
-                    r->run();
+                        r->run();
 #ifndef QT_NO_EXCEPTIONS
-                } catch (...) {
-                    qWarning("Qt Concurrent has caught an exception thrown from a worker thread.\n"
-                             "This is not supported, exceptions thrown in worker threads must be\n"
-                             "caught before control returns to Qt Concurrent.");
-                    registerThreadInactive();
-                    throw;
-                }
+                    } catch (...) {
+                        qWarning("Qt Concurrent has caught an exception thrown from a worker thread.\n"
+                                 "This is not supported, exceptions thrown in worker threads must be\n"
+                                 "caught before control returns to Qt Concurrent.");
+                        registerThreadInactive();
+                        throw;
+                    }
 #endif
 
-                if (del)
-                    delete r;
+                    if (del)
+                        delete r;
+
+                    // keep going with the runnables started from this thread
+                    // without taking the pool's mutex
+                } while ((r = takeLocalTask()));
                 locker.relock();
             }
 
@@ -86,17 +115,11 @@ void QThreadPoolThread::run()
                 break;
 
             // all work is done, time to wait for more
-            if (manager->queue.isEmpty())
-                break;
+            r = manager->takeTask(this);
+        } while (r);
 
-            QueuePage *page = manager->queue.constFirst();
-            r = page->pop();
-
-            if (page->isFinished()) {
-                manager->queue.removeFirst();
-                delete page;
-            }
-        } while (true);
+        // leave the runnables started from this thread to the others
+        manager->flushLocalTasks(this);
 
         // this thread is about to be deleted, do not wait or expire
         if (!manager->allThreads.contains(this)) {
@@ -108,15 +131,17 @@ void QThreadPoolThread::run()
         if (manager->tooManyThreadsActive()) {
             manager->expiredThreads.enqueue(this);
             registerThreadInactive();
+            manager->updateSpareCapacity();
             return;
         }
         manager->waitingThreads.enqueue(this);
         registerThreadInactive();
+        manager->updateSpareCapacity();
         // wait for work, exiting after the expiry timeout is reached
         runnableReady.wait(locker.mutex(), QDeadlineTimer(manager->expiryTimeout));
         // this thread is about to be deleted, do not work or expire
         if (!manager->allThreads.contains(this)) {
-            Q_ASSERT(manager->queue.isEmpty());
+            Q_ASSERT(!manager->hasQueuedTasks());
             return;
         }
         if (manager->waitingThreads.removeOne(this)) {
@@ -124,6 +149,8 @@ void QThreadPoolThread::run()
             return;
         }
         ++manager->activeThreads;
+        if (std::exchange(cpusChanged, false))
+            applyCpuAffinity();
     }
 }
 
@@ -133,12 +160,211 @@ void QThreadPoolThread::registerThreadInactive()
         manager->noActiveThreads.wakeAll();
 }
 
+/*
+    \internal
+
+    Returns the runnable most recently started from this thread, or \nullptr
+    if there is none or a queued runnable with a higher priority is waiting.
+    Called without holding the pool's mutex.
+*/
+QRunnable *QThreadPoolThread::takeLocalTask()
+{
+    if (manager->prioritizedTasks.loadRelaxed() > 0)
+        return nullptr;
+    QMutexLocker locker(&localMutex);
+    return localTasks.isEmpty() ? nullptr : localTasks.takeLast();
+}
+
+/*
+    \internal
+
+    Restricts the current thread, which is this one, to the CPUs it was
+    assigned by the pool.
+*/
+void QThreadPoolThread::applyCpuAffinity()
+{
+    if (cpus.isEmpty())
+        return;
+#if defined(Q_OS_LINUX)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : std::as_const(cpus)) {
+        if (cpu < CPU_SETSIZE)
+            CPU_SET(cpu, &set);
+    }
+    if (sched_setaffinity(0, sizeof(set), &set) != 0)
+        qErrnoWarning("QThreadPool: Failed to set the CPU affinity of a thread");
+#endif
+}
+
 
 /*
     \internal
 */
 QThreadPoolPrivate:: QThreadPoolPrivate()
-{ }
+{
+    setNumaNodes(systemNumaNodes());
+}
+
+#if defined(Q_OS_LINUX)
+// Parses a list of CPUs or nodes in the format of sysfs, like "0-3,8,10-11".
+static QList<int> parseSysfsList(const QByteArray &list)
+{
+    QList<int> result;
+    for (QByteArrayView range : list.trimmed().split(',')) {
+        const qsizetype dash = range.indexOf('-');
+        bool ok = false;
+        const int first = range.first(dash < 0 ? range.size() : dash).toInt(&ok);
+        if (!ok)
+            return {};
+        const int last = dash < 0 ? first : range.sliced(dash + 1).toInt(&ok);
+        if (!ok || last < first)
+            return {};
+        for (int i = first; i <= last; ++i)
+            result.append(i);
+    }
+    return result;
+}
+
+static QList<int> readSysfsList(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return {};
+    return parseSysfsList(file.readAll());
+}
+#endif
+
+/*!
+    \internal
+
+    Returns the CPUs of each NUMA node that the process may run on. Nodes
+    without such CPUs are left out. Returns a single node with all CPUs if
+    the topology is not known.
+*/
+QList<QList<int>> QThreadPoolPrivate::systemNumaNodes()
+{
+    static const QList<QList<int>> nodes = [] {
+        QList<QList<int>> nodes;
+#if defined(Q_OS_LINUX)
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        const bool hasMask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+        const auto isAllowed = [&](int cpu) {
+            return !hasMask || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed));
+        };
+
+        const QString nodeDir = u"/sys/devices/system/node/"_s;
+        for (int node : readSysfsList(nodeDir + "online"_L1)) {
+            QList<int> cpus = readSysfsList(nodeDir + u"node%1/cpulist"_s.arg(node));
+            cpus.removeIf([&](int cpu) { return !isAllowed(cpu); });
+            if (!cpus.isEmpty())
+                nodes.append(std::move(cpus));
+        }
+
+        if (nodes.isEmpty() && hasMask) {
+            QList<int> cpus;
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &allowed))
+                    cpus.append(cpu);
+            }
+            if (!cpus.isEmpty())
+                nodes.append(std::move(cpus));
+        }
+#endif
+        if (nodes.isEmpty()) {
+            QList<int> cpus(QThread::idealThreadCount());
+            std::iota(cpus.begin(), cpus.end(), 0);
+            nodes.append(std::move(cpus));
+        }
+        return nodes;
+    }();
+    return nodes;
+}
+
+/*!
+    \internal
+
+    Returns the NUMA node of the current thread if it is a thread of a pool,
+    or -1.
+*/
+int QThreadPoolPrivate::currentThreadNumaNode()
+{
+    return currentPoolThread ? currentPoolThread->numaNode : -1;
+}
+
+/*!
+    \internal
+
+    Sets the CPUs of each NUMA node. Must not be called while runnables are
+    queued for a node.
+*/
+void QThreadPoolPrivate::setNumaNodes(const QList<QList<int>> &nodes)
+{
+    Q_ASSERT(!nodes.isEmpty());
+    Q_ASSERT(std::all_of(nodeQueues.cbegin(), nodeQueues.cend(),
+                         [](const QList<QueuePage *> &pages) { return pages.isEmpty(); }));
+    numaNodes = nodes;
+    nodeQueues.resize(nodes.size());
+    for (QThreadPoolThread *thread : std::as_const(allThreads))
+        thread->numaNode = qMin(thread->numaNode, int(nodes.size()) - 1);
+}
+
+/*!
+    \internal
+
+    Makes \a thread belong to NUMA \a node, or to the node with the fewest
+    threads per CPU if \a node is -1, and picks the CPUs the thread gets
+    pinned to according to the thread affinity of the pool.
+*/
+void QThreadPoolPrivate::assignNumaNode(QThreadPoolThread *thread, int node)
+{
+    if (node < 0) {
+        QList<int> threadsPerNode(numaNodes.size());
+        for (QThreadPoolThread *other : std::as_const(allThreads)) {
+            if (other != thread)
+                ++threadsPerNode[other->numaNode];
+        }
+        node = 0;
+        for (int i = 1; i < numaNodes.size(); ++i) {
+            if (qint64(threadsPerNode[i]) * numaNodes[node].size()
+                    < qint64(threadsPerNode[node]) * numaNodes[i].size()) {
+                node = i;
+            }
+        }
+    }
+    thread->numaNode = node;
+
+    const QList<int> &nodeCpus = numaNodes.at(node);
+    switch (threadAffinity) {
+    case QThreadPool::NoAffinity:
+        // a thread inherits the affinity of the thread starting it, which may
+        // be a pinned one
+        thread->cpus.clear();
+        if (threadsWerePinned) {
+            for (const QList<int> &cpus : std::as_const(numaNodes))
+                thread->cpus += cpus;
+        }
+        break;
+    case QThreadPool::NumaNodeAffinity:
+        thread->cpus = nodeCpus;
+        break;
+    case QThreadPool::CpuAffinity: {
+        // the CPU of the node with the fewest threads pinned to it
+        QList<int> threadsPerCpu(nodeCpus.size());
+        for (QThreadPoolThread *other : std::as_const(allThreads)) {
+            if (other != thread && other->numaNode == node && other->cpus.size() == 1) {
+                const qsizetype index = nodeCpus.indexOf(other->cpus.constFirst());
+                if (index >= 0)
+                    ++threadsPerCpu[index];
+            }
+        }
+        const auto least = std::min_element(threadsPerCpu.cbegin(), threadsPerCpu.cend());
+        thread->cpus = { nodeCpus.at(std::distance(threadsPerCpu.cbegin(), least)) };
+        break;
+    }
+    }
+}
 
 bool QThreadPoolPrivate::tryStart(QRunnable *task)
 {
@@ -162,23 +388,62 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
 
     if (!expiredThreads.isEmpty()) {
         // restart an expired thread
-        QThreadPoolThread *thread = expiredThreads.dequeue();
-        Q_ASSERT(thread->runnable == nullptr);
+        restartThread(expiredThreads.dequeue(), task);
+        return true;
+    }
 
-        ++activeThreads;
+    // start a new thread
+    startThread(task);
+    return true;
+}
 
-        thread->runnable = task;
+/*!
+    \internal
 
-        // Ensure that the thread has actually finished, otherwise the following
-        // start() has no effect.
-        thread->wait();
-        Q_ASSERT(thread->isFinished());
-        thread->start(threadPriority);
+    Like tryStart(), but prefers the threads of NUMA \a node. A thread of
+    another node only gets \a task if no thread of \a node is waiting, and
+    it moves to \a node for it; no thread is started while others wait.
+*/
+bool QThreadPoolPrivate::tryStartOnNumaNode(QRunnable *task, int node, int priority)
+{
+    Q_ASSERT(task != nullptr);
+    if (allThreads.isEmpty()) {
+        startThread(task, node);
         return true;
     }
 
-    // start a new thread
-    startThread(task);
+    if (areAllThreadsActive())
+        return false;
+
+    const auto waiting = std::find_if(waitingThreads.begin(), waitingThreads.end(),
+                                      [node](QThreadPoolThread *thread) {
+                                          return thread->numaNode == node;
+                                      });
+    if (waiting != waitingThreads.end()) {
+        enqueueTask(task, priority, node);
+        QThreadPoolThread *thread = *waiting;
+        waitingThreads.erase(waiting);
+        thread->runnableReady.wakeOne();
+        return true;
+    }
+
+    if (!expiredThreads.isEmpty()) {
+        restartThread(expiredThreads.dequeue(), task, node);
+        return true;
+    }
+
+    if (!waitingThreads.isEmpty()) {
+        // all waiting threads belong to other nodes: move one of them, as
+        // starting another thread would exceed maxThreadCount
+        enqueueTask(task, priority, node);
+        QThreadPoolThread *thread = waitingThreads.takeFirst();
+        assignNumaNode(thread, node);
+        thread->cpusChanged = true;
+        thread->runnableReady.wakeOne();
+        return true;
+    }
+
+    startThread(task, node);
     return true;
 }
 
@@ -187,17 +452,20 @@ inline bool comparePriority(int priority, const QueuePage *p)
     return p->priority() < priority;
 }
 
-void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
+void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority, int node)
 {
     Q_ASSERT(runnable != nullptr);
-    for (QueuePage *page : std::as_const(queue)) {
+    QList<QueuePage *> &pages = node < 0 ? queue : nodeQueues[node];
+    if (priority > 0)
+        prioritizedTasks.ref();
+    for (QueuePage *page : std::as_const(pages)) {
         if (page->priority() == priority && !page->isFull()) {
             page->push(runnable);
             return;
         }
     }
-    auto it = std::upper_bound(queue.constBegin(), queue.constEnd(), priority, comparePriority);
-    queue.insert(std::distance(queue.constBegin(), it), new QueuePage(runnable, priority));
+    auto it = std::upper_bound(pages.constBegin(), pages.constEnd(), priority, comparePriority);
+    pages.insert(std::distance(pages.constBegin(), it), new QueuePage(runnable, priority));
 }
 
 int QThreadPoolPrivate::activeThreadCount() const
@@ -216,13 +484,224 @@ void QThreadPoolPrivate::tryToStartMoreThreads()
         if (!tryStart(page->first()))
             break;
 
-        page->pop();
+        popQueuedTask();
+    }
+    for (int node = 0; node < nodeQueues.size(); ++node) {
+        while (!nodeQueues[node].isEmpty()) {
+            QueuePage *page = nodeQueues[node].constFirst();
+            if (!tryStartOnNumaNode(page->first(), node, page->priority()))
+                break;
 
-        if (page->isFinished()) {
-            queue.removeFirst();
-            delete page;
+            popQueuedTask(nodeQueues[node]);
+        }
+    }
+    // and the runnables in the local queues to idle threads
+    if (workStealing.loadRelaxed()) {
+        while (wakeThreadForStealing()) {
         }
+    } else {
+        updateSpareCapacity();
+    }
+}
+
+/*!
+    \internal
+
+    Returns \c true if runnables are queued, for any NUMA node or none.
+*/
+bool QThreadPoolPrivate::hasQueuedTasks() const
+{
+    return !queue.isEmpty()
+            || std::any_of(nodeQueues.cbegin(), nodeQueues.cend(),
+                           [](const QList<QueuePage *> &pages) { return !pages.isEmpty(); });
+}
+
+/*!
+    \internal
+
+    Removes the first runnable from \a pages, the shared queue or the one of
+    a NUMA node, and returns it, or returns \nullptr if it is empty.
+*/
+QRunnable *QThreadPoolPrivate::popQueuedTask(QList<QueuePage *> &pages)
+{
+    if (pages.isEmpty())
+        return nullptr;
+
+    QueuePage *page = pages.constFirst();
+    if (page->priority() > 0)
+        prioritizedTasks.deref();
+    QRunnable *runnable = page->pop();
+
+    if (page->isFinished()) {
+        pages.removeFirst();
+        delete page;
     }
+    return runnable;
+}
+
+/*!
+    \internal
+
+    Removes the first runnable started for another NUMA node than the one
+    of \a self, and returns it, or \nullptr if there is none. The node with
+    the highest priority runnable goes first.
+*/
+QRunnable *QThreadPoolPrivate::takeOtherNumaNodeTask(QThreadPoolThread *self)
+{
+    QList<QueuePage *> *best = nullptr;
+    for (int node = 0; node < nodeQueues.size(); ++node) {
+        QList<QueuePage *> &pages = nodeQueues[node];
+        if (node == self->numaNode || pages.isEmpty())
+            continue;
+        if (!best || pages.constFirst()->priority() > best->constFirst()->priority())
+            best = &pages;
+    }
+    return best ? popQueuedTask(*best) : nullptr;
+}
+
+/*!
+    \internal
+
+    Adds \a task to the local queue of the current thread if it is one of
+    this pool's threads, and returns \c true. Otherwise returns \c false.
+    Called without holding the mutex.
+*/
+bool QThreadPoolPrivate::pushLocalTask(QRunnable *task)
+{
+    QThreadPoolThread *self = currentPoolThread;
+    if (!self || self->manager != this)
+        return false;
+
+    {
+        QMutexLocker locker(&self->localMutex);
+        self->localTasks.append(task);
+    }
+
+    // Pairs with the fence in takeTask(): either a thread going idle finds
+    // the task, or we see the capacity it announced and wake it up. When
+    // there is no spare capacity, this thread runs the task at the latest
+    // after its current one.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (spareCapacity.loadRelaxed()) {
+        QMutexLocker locker(&mutex);
+        wakeThreadForStealing();
+    }
+    return true;
+}
+
+/*!
+    \internal
+
+    Returns the next runnable for \a self to run, or \nullptr if there is
+    none. The runnables started for the NUMA node of \a self come first,
+    unless the shared queue has one with a higher priority. Then queued
+    runnables with a priority above 0, the runnables started from \a self,
+    the rest of the queue, the runnables started for the other nodes, and
+    finally the runnables started from the other threads, which are stolen
+    from the front of their local queues.
+*/
+QRunnable *QThreadPoolPrivate::takeTask(QThreadPoolThread *self)
+{
+    QList<QueuePage *> &nodeQueue = nodeQueues[self->numaNode];
+    if (!nodeQueue.isEmpty()
+            && (queue.isEmpty() || nodeQueue.constFirst()->priority() >= queue.constFirst()->priority())) {
+        return popQueuedTask(nodeQueue);
+    }
+
+    const bool stealing = workStealing.loadRelaxed();
+    if (!queue.isEmpty() && (!stealing || queue.constFirst()->priority() > 0))
+        return popQueuedTask();
+
+    {
+        QMutexLocker locker(&self->localMutex);
+        if (!self->localTasks.isEmpty())
+            return self->localTasks.takeLast();
+    }
+
+    if (QRunnable *runnable = popQueuedTask())
+        return runnable;
+    if (QRunnable *runnable = takeOtherNumaNodeTask(self))
+        return runnable;
+    if (!stealing)
+        return nullptr;
+
+    if (QRunnable *runnable = stealLocalTask(self))
+        return runnable;
+
+    // This thread is about to go idle: announce that before looking once
+    // more, see pushLocalTask().
+    spareCapacity.storeRelaxed(true);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return stealLocalTask(self);
+}
+
+/*!
+    \internal
+
+    Removes the oldest runnable from the local queue of one of the threads
+    other than \a self, which may be \nullptr, and returns it, or returns
+    \nullptr if those queues are empty.
+*/
+QRunnable *QThreadPoolPrivate::stealLocalTask(QThreadPoolThread *self)
+{
+    for (QThreadPoolThread *thread : std::as_const(allThreads)) {
+        if (thread == self)
+            continue;
+        QMutexLocker locker(&thread->localMutex);
+        if (!thread->localTasks.isEmpty())
+            return thread->localTasks.takeFirst();
+    }
+    return nullptr;
+}
+
+/*!
+    \internal
+
+    Moves the runnables started from \a thread to the queue, and starts
+    them on other threads if the pool has capacity for them.
+*/
+void QThreadPoolPrivate::flushLocalTasks(QThreadPoolThread *thread)
+{
+    {
+        QMutexLocker locker(&thread->localMutex);
+        if (thread->localTasks.isEmpty())
+            return;
+        for (QRunnable *runnable : std::as_const(thread->localTasks))
+            enqueueTask(runnable);
+        thread->localTasks.clear();
+    }
+    tryToStartMoreThreads();
+}
+
+/*!
+    \internal
+
+    Steals a runnable from the local queues and hands it to an idle thread,
+    unless all threads are active already. Returns \c true if it did.
+
+    The thread counts as active as soon as it got the runnable, before the
+    spare capacity gets updated, so a burst of local runnables wakes no
+    more threads than there are runnables.
+*/
+bool QThreadPoolPrivate::wakeThreadForStealing()
+{
+    QRunnable *runnable = areAllThreadsActive() ? nullptr : stealLocalTask(nullptr);
+    if (!runnable) {
+        updateSpareCapacity();
+        return false;
+    }
+
+    if (!waitingThreads.isEmpty()) {
+        // queued, so that waitForDone() sees it until the thread wakes up
+        enqueueTask(runnable);
+        waitingThreads.takeFirst()->runnableReady.wakeOne();
+    } else if (!expiredThreads.isEmpty()) {
+        restartThread(expiredThreads.dequeue(), runnable);
+    } else {
+        startThread(runnable);
+    }
+    updateSpareCapacity();
+    return true;
 }
 
 bool QThreadPoolPrivate::areAllThreadsActive() const
@@ -240,7 +719,7 @@ bool QThreadPoolPrivate::tooManyThreadsActive() const
 /*!
     \internal
 */
-void QThreadPoolPrivate::startThread(QRunnable *runnable)
+void QThreadPoolPrivate::startThread(QRunnable *runnable, int node)
 {
     Q_ASSERT(runnable != nullptr);
     auto thread = std::make_unique<QThreadPoolThread>(this);
@@ -250,11 +729,35 @@ void QThreadPoolPrivate::startThread(QRunnable *runnable)
     Q_ASSERT(!allThreads.contains(thread.get())); // if this assert hits, we have an ABA problem (deleted threads don't get removed here)
     allThreads.insert(thread.get());
     ++activeThreads;
+    assignNumaNode(thread.get(), node);
 
     thread->runnable = runnable;
     thread.release()->start(threadPriority);
 }
 
+/*!
+    \internal
+
+    Restarts the expired \a thread to run \a runnable, on NUMA \a node, or
+    on the node it belonged to if \a node is -1.
+*/
+void QThreadPoolPrivate::restartThread(QThreadPoolThread *thread, QRunnable *runnable, int node)
+{
+    Q_ASSERT(runnable != nullptr);
+    Q_ASSERT(thread->runnable == nullptr);
+
+    ++activeThreads;
+    assignNumaNode(thread, node < 0 ? thread->numaNode : node);
+
+    thread->runnable = runnable;
+
+    // Ensure that the thread has actually finished, otherwise the following
+    // start() has no effect.
+    thread->wait();
+    Q_ASSERT(thread->isFinished());
+    thread->start(threadPriority);
+}
+
 /*!
     \internal
 
@@ -290,10 +793,10 @@ void QThreadPoolPrivate::reset()
 bool QThreadPoolPrivate::waitForDone(const QDeadlineTimer &timer)
 {
     QMutexLocker locker(&mutex);
-    while (!(queue.isEmpty() && activeThreads == 0) && !timer.hasExpired())
+    while (!(!hasQueuedTasks() && activeThreads == 0) && !timer.hasExpired())
         noActiveThreads.wait(&mutex, timer);
 
-    if (!queue.isEmpty() || activeThreads)
+    if (hasQueuedTasks() || activeThreads)
         return false;
 
     reset();
@@ -306,17 +809,34 @@ bool QThreadPoolPrivate::waitForDone(const QDeadlineTimer &timer)
 void QThreadPoolPrivate::clear()
 {
     QMutexLocker locker(&mutex);
-    while (!queue.isEmpty()) {
-        auto *page = queue.takeLast();
-        while (!page->isFinished()) {
-            QRunnable *r = page->pop();
-            if (r && r->autoDelete()) {
-                locker.unlock();
-                delete r;
-                locker.relock();
+    const auto clearPages = [&](QList<QueuePage *> &pages) {
+        while (!pages.isEmpty()) {
+            auto *page = pages.takeLast();
+            while (!page->isFinished()) {
+                QRunnable *r = page->pop();
+                if (r && r->autoDelete()) {
+                    locker.unlock();
+                    delete r;
+                    locker.relock();
+                }
             }
+            delete page;
         }
-        delete page;
+    };
+    clearPages(queue);
+    for (QList<QueuePage *> &pages : nodeQueues)
+        clearPages(pages);
+    prioritizedTasks.storeRelaxed(0);
+
+    QList<QRunnable *> localTasks;
+    for (QThreadPoolThread *thread : std::as_const(allThreads)) {
+        QMutexLocker localLocker(&thread->localMutex);
+        localTasks += std::exchange(thread->localTasks, {});
+    }
+    locker.unlock();
+    for (QRunnable *r : std::as_const(localTasks)) {
+        if (r->autoDelete())
+            delete r;
     }
 }
 
@@ -345,14 +865,31 @@ bool QThreadPool::tryTake(QRunnable *runnable)
         return false;
 
     QMutexLocker locker(&d->mutex);
-    for (QueuePage *page : std::as_const(d->queue)) {
-        if (page->tryTake(runnable)) {
-            if (page->isFinished()) {
-                d->queue.removeOne(page);
-                delete page;
+    const auto takeFrom = [&](QList<QueuePage *> &pages) {
+        for (QueuePage *page : std::as_const(pages)) {
+            if (page->tryTake(runnable)) {
+                if (page->priority() > 0)
+                    d->prioritizedTasks.deref();
+                if (page->isFinished()) {
+                    pages.removeOne(page);
+                    delete page;
+                }
+                return true;
             }
-            return true;
         }
+        return false;
+    };
+    if (takeFrom(d->queue))
+        return true;
+    for (QList<QueuePage *> &pages : d->nodeQueues) {
+        if (takeFrom(pages))
+            return true;
+    }
+
+    for (QThreadPoolThread *thread : std::as_const(d->allThreads)) {
+        QMutexLocker localLocker(&thread->localMutex);
+        if (thread->localTasks.removeOne(runnable))
+            return true;
     }
 
     return false;
@@ -425,6 +962,11 @@ void QThreadPoolPrivate::stealAndRunRunnable(QRunnable *runnable)
     implementing time-consuming operations that are not visible to the
     QThreadPool.
 
+    On machines with several NUMA nodes, startOnNumaNode() runs a runnable
+    on a thread of a given node, and the threadAffinity property binds the
+    threads to the CPUs of their node, so that memory-bound work stays
+    close to its data.
+
     Note that QThreadPool is a low-level class for managing threads, see
     the Qt Concurrent module for higher level alternatives.
 
@@ -453,7 +995,7 @@ QThreadPool::~QThreadPool()
 {
     Q_D(QThreadPool);
     waitForDone();
-    Q_ASSERT(d->queue.isEmpty());
+    Q_ASSERT(!d->hasQueuedTasks());
     Q_ASSERT(d->allThreads.isEmpty());
 }
 
@@ -507,6 +1049,9 @@ void QThreadPool::start(QRunnable *runnable, int priority)
         return;
 
     Q_D(QThreadPool);
+    if (priority == 0 && d->workStealing.loadRelaxed() && d->pushLocalTask(runnable))
+        return;
+
     QMutexLocker locker(&d->mutex);
 
     if (!d->tryStart(runnable))
@@ -730,6 +1275,154 @@ QThread::Priority QThreadPool::threadPriority() const
     return d->threadPriority;
 }
 
+/*! \property QThreadPool::workStealingEnabled
+    \brief whether runnables started from the pool's own threads are
+    scheduled by work stealing.
+
+    When this property is \c true, a runnable started with the default
+    priority from within one of the pool's threads, for instance by a
+    QtConcurrent::run() call in a running task, is not added to the shared
+    run queue. It goes to a queue local to that thread instead, which the
+    thread works through, most recent runnable first, without locking the
+    rest of the pool. Idle threads steal the oldest runnables from the other
+    threads' local queues. This reduces contention for workloads that spawn
+    many small tasks.
+
+    Runnables queued with a priority above 0 are still run before the local
+    ones. Among runnables of the same priority, no order is guaranteed.
+
+    The default value is \c false.
+
+    \since 6.9
+    \sa start()
+*/
+
+void QThreadPool::setWorkStealingEnabled(bool enabled)
+{
+    Q_D(QThreadPool);
+    QMutexLocker locker(&d->mutex);
+    d->workStealing.storeRelaxed(enabled);
+}
+
+bool QThreadPool::isWorkStealingEnabled() const
+{
+    Q_D(const QThreadPool);
+    return d->workStealing.loadRelaxed();
+}
+
+/*!
+    \enum QThreadPool::ThreadAffinity
+    \since 6.9
+
+    This enum describes to which CPUs the threads of the pool are bound.
+
+    \value NoAffinity The operating system schedules the threads on any CPU.
+    \value NumaNodeAffinity Each thread is bound to the CPUs of its NUMA node.
+    \value CpuAffinity Each thread is bound to a single CPU of its NUMA node.
+           The threads of a node are spread over its CPUs.
+
+    \sa threadAffinity
+*/
+
+/*! \property QThreadPool::threadAffinity
+    \brief the CPUs the worker threads are bound to.
+
+    Every thread of the pool belongs to a NUMA node: either the node that
+    a runnable started with startOnNumaNode() is meant for, or the node
+    with the fewest threads per CPU. This property decides whether the
+    threads are also bound to the CPUs of their node, or to a single one,
+    which keeps the caches and the memory they use local.
+
+    The value of the property is only used when the thread pool starts
+    threads. Changing it has no effect for already running threads.
+
+    Binding threads to CPUs is only supported on Linux. On other platforms,
+    the threads are not bound and the whole system counts as one node.
+
+    The default value is QThreadPool::NoAffinity.
+
+    \since 6.9
+    \sa numaNodeCount(), startOnNumaNode()
+*/
+
+void QThreadPool::setThreadAffinity(ThreadAffinity affinity)
+{
+    Q_D(QThreadPool);
+    QMutexLocker locker(&d->mutex);
+    d->threadAffinity = affinity;
+    if (affinity != NoAffinity)
+        d->threadsWerePinned = true;
+}
+
+QThreadPool::ThreadAffinity QThreadPool::threadAffinity() const
+{
+    Q_D(const QThreadPool);
+    QMutexLocker locker(&d->mutex);
+    return d->threadAffinity;
+}
+
+/*!
+    \since 6.9
+
+    Returns the number of NUMA nodes with CPUs that the process may run on.
+    The nodes are numbered from 0 to numaNodeCount() - 1, in the order of
+    the system's numbering. Returns 1 if the system has a single node, or
+    if the topology is not known.
+
+    \sa startOnNumaNode(), threadAffinity
+*/
+int QThreadPool::numaNodeCount() const
+{
+    Q_D(const QThreadPool);
+    QMutexLocker locker(&d->mutex);
+    return int(d->numaNodes.size());
+}
+
+/*!
+    \since 6.9
+
+    Runs \a runnable on a thread of NUMA \a node, so that it shares the
+    caches and the local memory of the other runnables started for that
+    node. If all threads are active, \a runnable is added to a run queue of
+    the node, which the threads of \a node take from before the shared run
+    queue. The \a priority argument orders both queues. A thread of another
+    node only runs \a runnable when it has nothing else left to do.
+
+    If \a node is not between 0 and numaNodeCount() - 1, this function is
+    the same as start().
+
+    Runnables started on a node are not subject to work stealing. Ownership
+    of \a runnable is handled as by start().
+
+    \sa numaNodeCount(), threadAffinity, start()
+*/
+void QThreadPool::startOnNumaNode(QRunnable *runnable, int node, int priority)
+{
+    if (!runnable)
+        return;
+
+    Q_D(QThreadPool);
+    QMutexLocker locker(&d->mutex);
+    if (node < 0 || node >= d->numaNodes.size()) {
+        locker.unlock();
+        return start(runnable, priority);
+    }
+
+    if (!d->tryStartOnNumaNode(runnable, node, priority))
+        d->enqueueTask(runnable, priority, node);
+}
+
+/*!
+    \fn template<typename Callable, QRunnable::if_callable<Callable>> void QThreadPool::startOnNumaNode(Callable &&callableToRun, int node, int priority)
+    \overload
+    \since 6.9
+
+    Runs \a callableToRun on a thread of NUMA \a node, with \a priority.
+
+    \note This function participates in overload resolution only if \c Callable
+    is a function or function object which can be called with zero arguments.
+*/
+
 /*!
     Releases a thread previously reserved by a call to reserveThread().
 
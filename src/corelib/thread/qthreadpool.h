@@ -27,9 +27,18 @@ class Q_CORE_EXPORT QThreadPool : public QObject
     Q_PROPERTY(int activeThreadCount READ activeThreadCount)
     Q_PROPERTY(uint stackSize READ stackSize WRITE setStackSize)
     Q_PROPERTY(QThread::Priority threadPriority READ threadPriority WRITE setThreadPriority)
+    Q_PROPERTY(bool workStealingEnabled READ isWorkStealingEnabled WRITE setWorkStealingEnabled)
+    Q_PROPERTY(ThreadAffinity threadAffinity READ threadAffinity WRITE setThreadAffinity)
     friend class QFutureInterfaceBase;
 
 public:
+    enum ThreadAffinity {
+        NoAffinity,
+        NumaNodeAffinity,
+        CpuAffinity,
+    };
+    Q_ENUM(ThreadAffinity)
+
     QThreadPool(QObject *parent = nullptr);
     ~QThreadPool();
 
@@ -55,6 +64,10 @@ public:
     template <typename Callable, QRunnable::if_callable<Callable> = true>
     void startOnReservedThread(Callable &&functionToRun);
 
+    void startOnNumaNode(QRunnable *runnable, int node, int priority = 0);
+    template <typename Callable, QRunnable::if_callable<Callable> = true>
+    void startOnNumaNode(Callable &&functionToRun, int node, int priority = 0);
+
     int expiryTimeout() const;
     void setExpiryTimeout(int expiryTimeout);
 
@@ -69,6 +82,14 @@ public:
     void setThreadPriority(QThread::Priority priority);
     QThread::Priority threadPriority() const;
 
+    void setWorkStealingEnabled(bool enabled);
+    bool isWorkStealingEnabled() const;
+
+    void setThreadAffinity(ThreadAffinity affinity);
+    ThreadAffinity threadAffinity() const;
+
+    int numaNodeCount() const;
+
     void reserveThread();
     void releaseThread();
 
@@ -105,6 +126,12 @@ void QThreadPool::startOnReservedThread(Callable &&functionToRun)
     startOnReservedThread(QRunnable::create(std::forward<Callable>(functionToRun)));
 }
 
+template <typename Callable, QRunnable::if_callable<Callable>>
+void QThreadPool::startOnNumaNode(Callable &&functionToRun, int node, int priority)
+{
+    startOnNumaNode(QRunnable::create(std::forward<Callable>(functionToRun)), node, priority);
+}
+
 #if QT_CORE_INLINE_IMPL_SINCE(6, 8)
 bool QThreadPool::waitForDone(int msecs)
 {
@@ -117,7 +117,8 @@ public:
     QThreadPoolPrivate();
 
     bool tryStart(QRunnable *task);
-    void enqueueTask(QRunnable *task, int priority = 0);
+    bool tryStartOnNumaNode(QRunnable *task, int node, int priority);
+    void enqueueTask(QRunnable *task, int priority = 0, int node = -1);
     int activeThreadCount() const;
 
     void tryToStartMoreThreads();
@@ -126,14 +127,30 @@ public:
 
     int maxThreadCount() const
     { return qMax(requestedMaxThreadCount, 1); }    // documentation says we start at least one
-    void startThread(QRunnable *runnable = nullptr);
+    void startThread(QRunnable *runnable = nullptr, int node = -1);
+    void restartThread(QThreadPoolThread *thread, QRunnable *runnable, int node = -1);
+    void assignNumaNode(QThreadPoolThread *thread, int node);
+    void setNumaNodes(const QList<QList<int>> &nodes);
+    bool hasQueuedTasks() const;
     void reset();
     bool waitForDone(const QDeadlineTimer &timer);
     void clear();
     void stealAndRunRunnable(QRunnable *runnable);
     void deletePageIfFinished(QueuePage *page);
 
+    QRunnable *popQueuedTask() { return popQueuedTask(queue); }
+    QRunnable *popQueuedTask(QList<QueuePage *> &pages);
+    QRunnable *takeOtherNumaNodeTask(QThreadPoolThread *self);
+    bool pushLocalTask(QRunnable *task);
+    QRunnable *takeTask(QThreadPoolThread *self);
+    QRunnable *stealLocalTask(QThreadPoolThread *self);
+    void flushLocalTasks(QThreadPoolThread *thread);
+    bool wakeThreadForStealing();
+    void updateSpareCapacity() { spareCapacity.storeRelaxed(!areAllThreadsActive()); }
+
     static QThreadPool *qtGuiInstance();
+    static QList<QList<int>> systemNumaNodes();
+    static int currentThreadNumaNode();
 
     mutable QMutex mutex;
     QSet<QThreadPoolThread *> allThreads;
@@ -149,6 +166,23 @@ public:
     int activeThreads = 0;
     uint stackSize = 0;
     QThread::Priority threadPriority = QThread::InheritPriority;
+
+    // Work-stealing mode: runnables started from a worker thread with the
+    // default priority go to that thread's local queue. These are read without
+    // holding the mutex: prioritizedTasks counts queued runnables with a
+    // priority above 0, which must not be overtaken by local ones, and
+    // spareCapacity tells whether another thread could pick up a local one.
+    QAtomicInteger<bool> workStealing = false;
+    QAtomicInteger<bool> spareCapacity = true;
+    QAtomicInt prioritizedTasks;
+
+    // NUMA awareness: the CPUs of each node, and the runnables started for
+    // a node, which the threads of that node take before the shared queue.
+    // Every thread belongs to a node, see assignNumaNode().
+    QList<QList<int>> numaNodes;
+    QList<QList<QueuePage *>> nodeQueues;
+    QThreadPool::ThreadAffinity threadAffinity = QThreadPool::NoAffinity;
+    bool threadsWerePinned = false;
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,206 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QCONCURRENTHASH_H
+#define QCONCURRENTHASH_H
+
+#include <QtCore/qhash.h>
+#include <QtCore/qreadwritelock.h>
+#include <QtCore/qthread.h>
+
+#include <memory>
+#include <optional>
+
+QT_BEGIN_NAMESPACE
+
+template <typename Key, typename T>
+class QConcurrentHash
+{
+    using Node = QHashPrivate::Node<Key, T>;
+    using Data = QHashPrivate::Data<Node>;
+
+    // Each shard is a hash table of its own, on its own cache line, so that
+    // threads working on different shards do not contend.
+    struct alignas(64) Shard
+    {
+        mutable QReadWriteLock lock;
+        Data d;
+    };
+
+    // The number of bits of the mixed hash that select the shard.
+    static constexpr int MaxShardBits = 8;
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using size_type = qsizetype;
+
+    QConcurrentHash() : QConcurrentHash(0) {}
+    explicit QConcurrentHash(qsizetype shardCount)
+        : seed(QHashSeed::globalSeed())
+    {
+        if (shardCount <= 0)
+            shardCount = 4 * QThread::idealThreadCount();
+        shardCount = qBound(qsizetype(1), shardCount, qsizetype(1) << MaxShardBits);
+        shardMask = size_t(qNextPowerOfTwo(quint32(shardCount - 1))) - 1;
+        shards.reset(new Shard[shardMask + 1]);
+        for (size_t i = 0; i <= shardMask; ++i)
+            shards[i].d.seed = seed;
+    }
+    ~QConcurrentHash() = default;
+    Q_DISABLE_COPY_MOVE(QConcurrentHash)
+
+    qsizetype shardCount() const noexcept { return qsizetype(shardMask + 1); }
+
+    qsizetype size() const
+    {
+        qsizetype result = 0;
+        for (size_t i = 0; i <= shardMask; ++i) {
+            QReadLocker locker(&shards[i].lock);
+            result += qsizetype(shards[i].d.size);
+        }
+        return result;
+    }
+    bool isEmpty() const { return size() == 0; }
+
+    bool contains(const Key &key) const
+    {
+        const Shard &shard = shardForKey(key);
+        QReadLocker locker(&shard.lock);
+        return findNode(shard, key) != nullptr;
+    }
+
+    T value(const Key &key, const T &defaultValue = T()) const
+    {
+        const Shard &shard = shardForKey(key);
+        QReadLocker locker(&shard.lock);
+        if (const Node *n = findNode(shard, key))
+            return n->value;
+        return defaultValue;
+    }
+
+    void insert(const Key &key, const T &value)
+    {
+        Shard &shard = shardForKey(key);
+        QWriteLocker locker(&shard.lock);
+        auto result = shard.d.findOrInsert(key);
+        if (!result.initialized)
+            Node::createInPlace(result.it.node(), Key(key), value);
+        else
+            result.it.node()->emplaceValue(value);
+    }
+
+    bool tryInsert(const Key &key, const T &value)
+    {
+        Shard &shard = shardForKey(key);
+        QWriteLocker locker(&shard.lock);
+        auto result = shard.d.findOrInsert(key);
+        if (result.initialized)
+            return false;
+        Node::createInPlace(result.it.node(), Key(key), value);
+        return true;
+    }
+
+    template <typename Factory>
+    T valueOrInsert(const Key &key, Factory &&factory)
+    {
+        Shard &shard = shardForKey(key);
+        {
+            QReadLocker locker(&shard.lock);
+            if (const Node *n = findNode(shard, key))
+                return n->value;
+        }
+        QWriteLocker locker(&shard.lock);
+        if (const Node *n = findNode(shard, key))
+            return n->value;
+        // create the value before the node, in case the factory throws
+        T value = std::forward<Factory>(factory)();
+        auto result = shard.d.findOrInsert(key);
+        Node::createInPlace(result.it.node(), Key(key), value);
+        return value;
+    }
+
+    template <typename Function>
+    bool update(const Key &key, Function &&function)
+    {
+        Shard &shard = shardForKey(key);
+        QWriteLocker locker(&shard.lock);
+        Node *n = findNode(shard, key);
+        if (!n)
+            return false;
+        std::forward<Function>(function)(n->value);
+        return true;
+    }
+
+    bool remove(const Key &key) { return take(key).has_value(); }
+
+    std::optional<T> take(const Key &key)
+    {
+        Shard &shard = shardForKey(key);
+        QWriteLocker locker(&shard.lock);
+        if (shard.d.size == 0)
+            return std::nullopt;
+        auto bucket = shard.d.findBucket(key);
+        if (bucket.isUnused())
+            return std::nullopt;
+        std::optional<T> result(std::move(bucket.node()->value));
+        shard.d.erase(bucket);
+        return result;
+    }
+
+    void clear()
+    {
+        for (size_t i = 0; i <= shardMask; ++i) {
+            QWriteLocker locker(&shards[i].lock);
+            shards[i].d.clear();
+        }
+    }
+
+    template <typename Function>
+    void forEach(Function function) const
+    {
+        for (size_t i = 0; i <= shardMask; ++i) {
+            QReadLocker locker(&shards[i].lock);
+            if (shards[i].d.size == 0)
+                continue;
+            for (auto it = shards[i].d.begin(); it != shards[i].d.end(); ++it) {
+                const Node *n = it.node();
+                function(n->key, n->value);
+            }
+        }
+    }
+
+    QHash<Key, T> toHash() const
+    {
+        QHash<Key, T> result;
+        forEach([&result](const Key &key, const T &value) { result.insert(key, value); });
+        return result;
+    }
+
+private:
+    // The table of a shard picks its buckets from the low bits of the same
+    // hash, so the shard comes from a mix of all of them.
+    Shard &shardForKey(const Key &key) const noexcept
+    {
+        constexpr int Digits = std::numeric_limits<size_t>::digits;
+        const size_t hash = QHashPrivate::calculateHash(key, seed);
+        const size_t mixed = hash * size_t(Q_UINT64_C(0x9e3779b97f4a7c15));
+        return shards[(mixed >> (Digits - MaxShardBits)) & shardMask];
+    }
+
+    static Node *findNode(const Shard &shard, const Key &key) noexcept
+    {
+        if (shard.d.size == 0)
+            return nullptr;
+        auto bucket = shard.d.findBucket(key);
+        return bucket.isUnused() ? nullptr : bucket.node();
+    }
+
+    std::unique_ptr<Shard[]> shards;
+    size_t shardMask = 0;
+    size_t seed = 0;
+};
+
+QT_END_NAMESPACE
+
+#endif // QCONCURRENTHASH_H
@@ -0,0 +1,246 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <qtconcurrentalgorithms.h>
+#include <qexception.h>
+
+#include <QList>
+#include <QRandomGenerator>
+#include <QTest>
+
+#include <algorithm>
+#include <numeric>
+
+using namespace QtConcurrent;
+
+class tst_QtConcurrentAlgorithms : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void forEach_data();
+    void forEach();
+    void transform();
+    void sort_data();
+    void sort();
+    void sortWithComparator();
+    void stableSort();
+    void inclusiveScan_data();
+    void inclusiveScan();
+    void inclusiveScanInPlace();
+    void inclusiveScanIsOrdered();
+#ifndef QT_NO_EXCEPTIONS
+    void exceptions();
+#endif
+
+private:
+    QThreadPool pool;
+};
+
+void tst_QtConcurrentAlgorithms::init()
+{
+    pool.setMaxThreadCount(4);
+}
+
+static void addSizes()
+{
+    QTest::addColumn<int>("size");
+    for (int size : { 0, 1, 17, 4095, 8192, 8193, 100000, 250007 })
+        QTest::addRow("%d", size) << size;
+}
+
+static QList<int> randomList(int size, int bound = std::numeric_limits<int>::max())
+{
+    QList<int> list(size);
+    for (int &value : list)
+        value = QRandomGenerator::global()->bounded(bound);
+    return list;
+}
+
+void tst_QtConcurrentAlgorithms::forEach_data()
+{
+    addSizes();
+}
+
+void tst_QtConcurrentAlgorithms::forEach()
+{
+    QFETCH(int, size);
+
+    QList<QAtomicInt> calls(size);
+    blockingForEach(&pool, 0, size, [&](qsizetype i) { calls[i].ref(); });
+    for (int i = 0; i < size; ++i)
+        QCOMPARE(calls.at(i).loadRelaxed(), 1);
+
+    // with an offset, on the global pool
+    const qsizetype offset = qsizetype(1) << 20;
+    QList<qsizetype> indexes(size, -1);
+    blockingForEach(offset, offset + size, [&](qsizetype i) { indexes[i - offset] = i; });
+    for (int i = 0; i < size; ++i)
+        QCOMPARE(indexes.at(i), offset + i);
+
+    // empty and reversed ranges do nothing
+    blockingForEach(&pool, size, size, [](qsizetype) { QFAIL("called for an empty range"); });
+    blockingForEach(&pool, size, 0, [](qsizetype) { QFAIL("called for a reversed range"); });
+}
+
+void tst_QtConcurrentAlgorithms::transform()
+{
+    const QList<int> input = randomList(50000, 1000);
+    QList<QString> output(input.size() + 1, QStringLiteral("untouched"));
+
+    blockingTransform(&pool, input.cbegin(), input.cend(), QSpan(output),
+                      [](int x) { return QString::number(x); });
+    for (int i = 0; i < input.size(); ++i)
+        QCOMPARE(output.at(i), QString::number(input.at(i)));
+    QCOMPARE(output.last(), QStringLiteral("untouched"));
+
+    QList<double> doubled(input.size());
+    blockingTransform(input.cbegin(), input.cend(), QSpan(doubled),
+                      [](int x) { return x * 2.0; });
+    for (int i = 0; i < input.size(); ++i)
+        QCOMPARE(doubled.at(i), input.at(i) * 2.0);
+}
+
+void tst_QtConcurrentAlgorithms::sort_data()
+{
+    addSizes();
+}
+
+void tst_QtConcurrentAlgorithms::sort()
+{
+    QFETCH(int, size);
+
+    QList<int> list = randomList(size);
+    QList<int> expected = list;
+    std::sort(expected.begin(), expected.end());
+
+    blockingSort(&pool, list.begin(), list.end());
+    QCOMPARE(list, expected);
+
+    // already sorted
+    blockingSort(list.begin(), list.end());
+    QCOMPARE(list, expected);
+
+    // many duplicates
+    list = randomList(size, 4);
+    expected = list;
+    std::sort(expected.begin(), expected.end());
+    blockingSort(&pool, list.begin(), list.end());
+    QCOMPARE(list, expected);
+}
+
+void tst_QtConcurrentAlgorithms::sortWithComparator()
+{
+    QList<QString> list;
+    for (int value : randomList(30000))
+        list.append(QString::number(value));
+    QList<QString> expected = list;
+    std::sort(expected.begin(), expected.end(), std::greater<>());
+
+    blockingSort(&pool, list.begin(), list.end(), std::greater<>());
+    QCOMPARE(list, expected);
+
+    // plain arrays
+    std::vector<int> vector(20000);
+    std::iota(vector.rbegin(), vector.rend(), 0);
+    blockingSort(vector.data(), vector.data() + vector.size(),
+                 [](int lhs, int rhs) { return lhs < rhs; });
+    QVERIFY(std::is_sorted(vector.cbegin(), vector.cend()));
+}
+
+void tst_QtConcurrentAlgorithms::stableSort()
+{
+    struct Item
+    {
+        int key;
+        int position;
+    };
+    QList<Item> items;
+    const QList<int> keys = randomList(100000, 100);
+    for (int i = 0; i < keys.size(); ++i)
+        items.append({ keys.at(i), i });
+
+    const auto byKey = [](const Item &lhs, const Item &rhs) { return lhs.key < rhs.key; };
+    blockingStableSort(&pool, items.begin(), items.end(), byKey);
+    for (int i = 1; i < items.size(); ++i) {
+        const Item &previous = items.at(i - 1);
+        const Item &item = items.at(i);
+        QVERIFY(previous.key <= item.key);
+        if (previous.key == item.key)
+            QVERIFY(previous.position < item.position);
+    }
+}
+
+void tst_QtConcurrentAlgorithms::inclusiveScan_data()
+{
+    addSizes();
+}
+
+void tst_QtConcurrentAlgorithms::inclusiveScan()
+{
+    QFETCH(int, size);
+
+    const QList<int> input = randomList(size, 1000);
+    QList<qint64> expected(size);
+    std::inclusive_scan(input.cbegin(), input.cend(), expected.begin(), std::plus<qint64>());
+
+    QList<qint64> output(size);
+    const auto end = blockingInclusiveScan(&pool, input.cbegin(), input.cend(), output.begin(),
+                                           std::plus<qint64>());
+    QCOMPARE(end, output.end());
+    QCOMPARE(output, expected);
+}
+
+void tst_QtConcurrentAlgorithms::inclusiveScanInPlace()
+{
+    QList<int> list = randomList(100000, 1000);
+    QList<int> expected(list.size());
+    std::inclusive_scan(list.cbegin(), list.cend(), expected.begin());
+
+    blockingInclusiveScan(list.cbegin(), list.cend(), list.begin());
+    QCOMPARE(list, expected);
+}
+
+void tst_QtConcurrentAlgorithms::inclusiveScanIsOrdered()
+{
+    // composing affine maps is associative, but not commutative
+    using Affine = std::pair<quint32, quint32>;
+    const auto compose = [](const Affine &f, const Affine &g) {
+        return Affine(f.first * g.first, f.second * g.first + g.second);
+    };
+
+    QList<Affine> input;
+    for (int i = 0; i < 100000; ++i) {
+        input.append(Affine(QRandomGenerator::global()->generate() | 1,
+                            QRandomGenerator::global()->generate()));
+    }
+    QList<Affine> expected(input.size());
+    std::inclusive_scan(input.cbegin(), input.cend(), expected.begin(), compose);
+
+    QList<Affine> output(input.size());
+    blockingInclusiveScan(&pool, input.cbegin(), input.cend(), output.begin(), compose);
+    QCOMPARE(output, expected);
+}
+
+#ifndef QT_NO_EXCEPTIONS
+void tst_QtConcurrentAlgorithms::exceptions()
+{
+    QVERIFY_THROWS_EXCEPTION(QException, blockingForEach(&pool, 0, 100000, [](qsizetype i) {
+        if (i == 5000)
+            throw QException();
+    }));
+
+    QList<int> list = randomList(100000);
+    list[50000] = -1;
+    QVERIFY_THROWS_EXCEPTION(QException,
+                             blockingSort(&pool, list.begin(), list.end(), [](int lhs, int rhs) {
+        if (lhs < 0 || rhs < 0)
+            throw QException();
+        return lhs < rhs;
+    }));
+}
+#endif
+
+QTEST_MAIN(tst_QtConcurrentAlgorithms)
+#include "tst_qtconcurrentalgorithms.moc"
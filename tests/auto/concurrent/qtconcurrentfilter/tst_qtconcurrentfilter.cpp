@@ -28,6 +28,7 @@ private slots:
     void filteredReducedInitialValueWithMoveOnlyCallables();
     void filteredReducedDifferentTypeInitialValue();
     void filteredReduceOptionConvertableToResultType();
+    void filteredReducedParallel();
     void resultAt();
     void incrementalResults();
     void noDetach();
@@ -1394,6 +1395,28 @@ bool filterfn(int i)
     return (i % 2);
 }
 
+void tst_QtConcurrentFilter::filteredReducedParallel()
+{
+    QList<int> intList;
+    int evenSum = 0;
+    for (int i = 0; i < 10000; ++i) {
+        intList.append(i);
+        if (i % 2 == 0)
+            evenSum += i;
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(4);
+
+    QCOMPARE(QtConcurrent::blockingFilteredReduced(intList, keepEvenIntegers, intSumReduce,
+                                                   QtConcurrent::ParallelReduce), evenSum);
+    QCOMPARE(QtConcurrent::filteredReduced(&pool, intList.cbegin(), intList.cend(),
+                                           keepEvenIntegers, intSumReduce,
+                                           QtConcurrent::ParallelReduce).result(), evenSum);
+    QCOMPARE(QtConcurrent::blockingFilteredReduced(&pool, intList, keepEvenIntegers, intSumReduce,
+                                                   10, QtConcurrent::ParallelReduce), evenSum + 10);
+}
+
 void tst_QtConcurrentFilter::resultAt()
 {
     QList<int> ints;
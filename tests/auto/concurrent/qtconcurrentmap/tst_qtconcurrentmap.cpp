@@ -10,6 +10,8 @@
 #include <QSet>
 #include <QRandomGenerator>
 
+#include <numeric>
+
 #include "../testhelper_functions.h"
 
 class tst_QtConcurrentMap : public QObject
@@ -31,6 +33,7 @@ private slots:
     void mappedReducedInitialValueWithMoveOnlyCallable();
     void mappedReducedDifferentTypeInitialValue();
     void mappedReduceOptionConvertableToResultType();
+    void mappedReducedParallel();
     void assignResult();
     void functionOverloads();
     void noExceptFunctionOverloads();
@@ -1673,6 +1676,100 @@ void tst_QtConcurrentMap::mappedReduceOptionConvertableToResultType()
                                                       multiplyBy2, intSumReduce, ro), sum);
 }
 
+// Counts the reductions into partial results, which only ParallelReduce does
+struct CountingSumReduce
+{
+    QAtomicInt *calls;
+    QSet<const qint64 *> *results;
+    QMutex *mutex;
+
+    void operator()(qint64 &sum, const qint64 &x) const
+    {
+        calls->ref();
+        {
+            QMutexLocker locker(mutex);
+            results->insert(&sum);
+        }
+        sum += x;
+    }
+};
+
+void tst_QtConcurrentMap::mappedReducedParallel()
+{
+    QList<int> intList;
+    for (int i = 0; i < 10000; ++i)
+        intList.append(i);
+    const qint64 sum = std::accumulate(intList.cbegin(), intList.cend(), qint64(0)) * 2;
+    const auto doubled = [](int x) { return qint64(x) * 2; };
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(4);
+    QAtomicInt calls;
+    QSet<const qint64 *> results;
+    QMutex mutex;
+    const CountingSumReduce reduce{ &calls, &results, &mutex };
+
+    // the final result gets the partial results only
+    qint64 result = QtConcurrent::blockingMappedReduced<qint64>(intList, doubled, reduce,
+                                                                ParallelReduce);
+    QCOMPARE(result, sum);
+    QCOMPARE_GE(results.size(), 2);
+    QCOMPARE_LT(calls.loadRelaxed(), 2 * intList.size());
+
+    calls.storeRelaxed(0);
+    results.clear();
+    QCOMPARE(QtConcurrent::mappedReduced<qint64>(&pool, intList, doubled, reduce,
+                                                 ParallelReduce).result(), sum);
+    QCOMPARE_GE(results.size(), 2);
+
+    // the initial value is reduced with the partial results only once
+    QCOMPARE(QtConcurrent::blockingMappedReduced<qint64>(&pool, intList.cbegin(), intList.cend(),
+                                                         doubled, reduce, qint64(1000),
+                                                         ParallelReduce), sum + 1000);
+
+    // OrderedReduce wins
+    calls.storeRelaxed(0);
+    results.clear();
+    QCOMPARE(QtConcurrent::blockingMappedReduced<qint64>(&pool, intList, doubled, reduce,
+                                                         ParallelReduce | OrderedReduce), sum);
+    QCOMPARE(calls.loadRelaxed(), intList.size());
+    QCOMPARE(results.size(), 1);
+
+    // results of another type fall back to UnorderedReduce
+    const QList<int> appended = QtConcurrent::blockingMappedReduced<QList<int>>(
+            &pool, intList, multiplyBy2, [](QList<int> &list, int x) { list.append(x); },
+            ParallelReduce);
+    QCOMPARE(appended.size(), intList.size());
+    QCOMPARE(std::accumulate(appended.cbegin(), appended.cend(), qint64(0)), sum);
+
+    // reducing into containers works as well
+    QList<int> sorted = QtConcurrent::blockingMappedReduced<QList<int>>(
+            &pool, intList, [](int x) { return QList<int>{ x }; },
+            [](QList<int> &list, const QList<int> &other) { list += other; }, ParallelReduce);
+    std::sort(sorted.begin(), sorted.end());
+    QCOMPARE(sorted, intList);
+
+    // and with an empty sequence
+    QCOMPARE(QtConcurrent::blockingMappedReduced<qint64>(QList<int>(), doubled, reduce,
+                                                         ParallelReduce), qint64(0));
+
+    // reductions whose identity is not a default-constructed value
+    const auto identity = [](int x) { return x; };
+    QCOMPARE(QtConcurrent::blockingMappedReduced<int>(
+                     &pool, QList<int>{ 1, 2, 3 }, identity,
+                     [](int &product, int x) { product *= x; }, 1, ParallelReduce), 6);
+    const QList<int> twos = QtConcurrent::blockingMapped(
+            intList, [](int x) { return x % 500 == 0 ? 2 : 1; });
+    QCOMPARE(QtConcurrent::blockingMappedReduced<qint64>(
+                     &pool, twos, [](int x) { return qint64(x); },
+                     [](qint64 &product, qint64 x) { product *= x; }, qint64(1), ParallelReduce),
+             qint64(1) << 20);
+    QCOMPARE(QtConcurrent::blockingMappedReduced<int>(
+                     &pool, intList, [](int x) { return x + 1000; },
+                     [](int &minimum, int x) { minimum = qMin(minimum, x); },
+                     std::numeric_limits<int>::max(), ParallelReduce), 1000);
+}
+
 int sleeper(int val)
 {
     QTest::qSleep(100);
@@ -0,0 +1,334 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <qtconcurrentpipeline.h>
+#include <qexception.h>
+
+#include <QList>
+#include <QRandomGenerator>
+#include <QSemaphore>
+#include <QTest>
+#include <QThread>
+
+using namespace QtConcurrent;
+using namespace std::chrono_literals;
+
+class tst_QtConcurrentPipeline : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void serialKeepsOrder();
+    void parallelStage();
+    void filtering();
+    void changingTypes();
+    void emptySource();
+    void capacity();
+    void singleThread();
+    void priority();
+    void cancel();
+#ifndef QT_NO_EXCEPTIONS
+    void exceptionInStage();
+    void exceptionBeforeSerialStage();
+    void exceptionInSource();
+#endif
+
+private:
+    QThreadPool pool;
+};
+
+void tst_QtConcurrentPipeline::init()
+{
+    pool.setMaxThreadCount(4);
+}
+
+static auto counter(int count)
+{
+    return [i = 0, count]() mutable -> std::optional<int> {
+        if (i == count)
+            return std::nullopt;
+        return i++;
+    };
+}
+
+static void sleepRandomly()
+{
+    QThread::sleep(std::chrono::microseconds(QRandomGenerator::global()->bounded(200)));
+}
+
+void tst_QtConcurrentPipeline::serialKeepsOrder()
+{
+    QList<int> results;
+    QFuture<void> future = pipeline(counter(1000))
+            .onThreadPool(pool)
+            .parallel([](int i) {
+                sleepRandomly();
+                return i * 2;
+            })
+            .serial([&](int i) { results.append(i); })
+            .run();
+    future.waitForFinished();
+
+    QVERIFY(future.isFinished());
+    QVERIFY(!future.isCanceled());
+    QCOMPARE(results.size(), 1000);
+    for (int i = 0; i < results.size(); ++i)
+        QCOMPARE(results.at(i), i * 2);
+}
+
+void tst_QtConcurrentPipeline::parallelStage()
+{
+    QAtomicInt running;
+    QAtomicInt maxRunning;
+    QAtomicInt sum;
+    pipeline(counter(200))
+            .onThreadPool(pool)
+            .parallel([&](int i) {
+                const int now = running.fetchAndAddOrdered(1) + 1;
+                int max = maxRunning.loadRelaxed();
+                while (now > max && !maxRunning.testAndSetOrdered(max, now, max)) { }
+                QThread::sleep(std::chrono::microseconds(500));
+                running.deref();
+                sum.fetchAndAddRelaxed(i);
+            })
+            .run()
+            .waitForFinished();
+
+    QCOMPARE(sum.loadRelaxed(), 199 * 200 / 2);
+    QCOMPARE(running.loadRelaxed(), 0);
+    QCOMPARE_LE(maxRunning.loadRelaxed(), pool.maxThreadCount());
+}
+
+void tst_QtConcurrentPipeline::filtering()
+{
+    QList<int> results;
+    pipeline(counter(1000))
+            .onThreadPool(pool)
+            .parallel([](int i) -> std::optional<int> {
+                if (i % 3)
+                    return std::nullopt;
+                return i;
+            })
+            .serial([](int i) -> std::optional<int> {
+                if (i % 2)
+                    return std::nullopt;
+                return i;
+            })
+            .serial([&](int i) { results.append(i); })
+            .run()
+            .waitForFinished();
+
+    QList<int> expected;
+    for (int i = 0; i < 1000; i += 6)
+        expected.append(i);
+    QCOMPARE(results, expected);
+}
+
+void tst_QtConcurrentPipeline::changingTypes()
+{
+    QStringList results;
+    pipeline(counter(100))
+            .onThreadPool(pool)
+            .parallel([](int i) { return QString::number(i); })
+            .parallel([](const QString &s) { return s + QLatin1Char('!'); })
+            .serial([](QString s) { return s.toUtf8(); })
+            .serial([&](const QByteArray &bytes) { results.append(QString::fromUtf8(bytes)); })
+            .run()
+            .waitForFinished();
+
+    QCOMPARE(results.size(), 100);
+    QCOMPARE(results.first(), QStringLiteral("0!"));
+    QCOMPARE(results.last(), QStringLiteral("99!"));
+
+    // move-only items
+    int sum = 0;
+    pipeline(counter(100))
+            .onThreadPool(pool)
+            .parallel([](int i) { return std::make_unique<int>(i); })
+            .serial([&](std::unique_ptr<int> p) { sum += *p; })
+            .run()
+            .waitForFinished();
+    QCOMPARE(sum, 99 * 100 / 2);
+}
+
+void tst_QtConcurrentPipeline::emptySource()
+{
+    bool called = false;
+    QFuture<void> future = pipeline([]() -> std::optional<int> { return std::nullopt; })
+            .onThreadPool(pool)
+            .serial([&](int) { called = true; })
+            .run();
+    future.waitForFinished();
+    QVERIFY(future.isFinished());
+    QVERIFY(!called);
+}
+
+void tst_QtConcurrentPipeline::capacity()
+{
+    // a slow stage does not let the source run ahead by more than the capacity
+    const int capacity = 5;
+    QAtomicInt inFlight;
+    QAtomicInt maxInFlight;
+    int next = 0;
+    int consumed = 0;
+    pipeline([&]() -> std::optional<int> {
+                if (next == 200)
+                    return std::nullopt;
+                const int now = inFlight.fetchAndAddOrdered(1) + 1;
+                int max = maxInFlight.loadRelaxed();
+                while (now > max && !maxInFlight.testAndSetOrdered(max, now, max)) { }
+                return next++;
+            })
+            .onThreadPool(pool)
+            .withCapacity(capacity)
+            .parallel([](int i) { return i; })
+            .serial([&](int) {
+                QThread::sleep(std::chrono::microseconds(200));
+                ++consumed;
+                inFlight.deref();
+            })
+            .run()
+            .waitForFinished();
+
+    QCOMPARE(consumed, 200);
+    QCOMPARE(inFlight.loadRelaxed(), 0);
+    QCOMPARE_LE(maxInFlight.loadRelaxed(), capacity);
+    QCOMPARE_GT(maxInFlight.loadRelaxed(), 1);
+}
+
+void tst_QtConcurrentPipeline::singleThread()
+{
+    // every stage shares the only thread, and none waits for another
+    QThreadPool singlePool;
+    singlePool.setMaxThreadCount(1);
+
+    QList<int> results;
+    pipeline(counter(500))
+            .onThreadPool(singlePool)
+            .withCapacity(3)
+            .parallel([](int i) { return i + 1; })
+            .serial([](int i) -> std::optional<int> {
+                if (i % 2)
+                    return std::nullopt;
+                return i;
+            })
+            .parallel([](int i) { return i * 10; })
+            .serial([&](int i) { results.append(i); })
+            .run()
+            .waitForFinished();
+
+    QCOMPARE(results.size(), 250);
+    for (int i = 0; i < results.size(); ++i)
+        QCOMPARE(results.at(i), (2 * i + 2) * 10);
+}
+
+void tst_QtConcurrentPipeline::priority()
+{
+    QList<int> results;
+    pipeline(counter(10))
+            .onThreadPool(pool)
+            .withPriority(10)
+            .serial([&](int i) { results.append(i); })
+            .run()
+            .waitForFinished();
+    QCOMPARE(results, QList<int>({ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }));
+}
+
+void tst_QtConcurrentPipeline::cancel()
+{
+    QSemaphore started;
+    QSemaphore proceed;
+    QAtomicInt produced;
+    QAtomicInt consumed;
+
+    QFuture<void> future = pipeline([&]() -> std::optional<int> {
+                // an endless source
+                return produced.fetchAndAddRelaxed(1);
+            })
+            .onThreadPool(pool)
+            .withCapacity(8)
+            .parallel([&](int i) {
+                if (i == 0) {
+                    started.release();
+                    proceed.acquire();
+                }
+                return i;
+            })
+            .serial([&](int) { consumed.ref(); })
+            .run();
+
+    started.acquire();
+    future.cancel();
+    proceed.release();
+    future.waitForFinished();
+
+    QVERIFY(future.isCanceled());
+    QVERIFY(future.isFinished());
+    // item 0 held up the serial stage, and nothing was produced past the capacity
+    QCOMPARE(consumed.loadRelaxed(), 0);
+    QCOMPARE_LE(produced.loadRelaxed(), 8 + 1);
+}
+
+#ifndef QT_NO_EXCEPTIONS
+void tst_QtConcurrentPipeline::exceptionInStage()
+{
+    QAtomicInt consumed;
+    QFuture<void> future = pipeline(counter(100000))
+            .onThreadPool(pool)
+            .parallel([](int i) {
+                if (i == 100)
+                    throw QException();
+                return i;
+            })
+            .serial([&](int) { consumed.ref(); })
+            .run();
+
+    QVERIFY_THROWS_EXCEPTION(QException, future.waitForFinished());
+    QVERIFY(future.isCanceled());
+    QCOMPARE_LE(consumed.loadRelaxed(), 100);
+}
+
+void tst_QtConcurrentPipeline::exceptionBeforeSerialStage()
+{
+    // the item that throws is the last one to leave the parallel stage, so
+    // the serial stage waits for it while the items after it are pending
+    QAtomicInt consumed;
+    QFuture<void> future = pipeline(counter(50))
+            .onThreadPool(pool)
+            .parallel([](int i) {
+                if (i == 3) {
+                    QThread::sleep(200ms);
+                    throw QException();
+                }
+                return i;
+            })
+            .serial([&](int) { consumed.ref(); })
+            .run();
+
+    QVERIFY_THROWS_EXCEPTION(QException, future.waitForFinished());
+    QVERIFY(future.isFinished());
+    QVERIFY(future.isCanceled());
+    QCOMPARE_LE(consumed.loadRelaxed(), 3);
+}
+
+void tst_QtConcurrentPipeline::exceptionInSource()
+{
+    int calls = 0;
+    QList<int> results;
+    QFuture<void> future = pipeline([&]() -> std::optional<int> {
+                if (calls == 10)
+                    throw QUnhandledException();
+                return calls++;
+            })
+            .onThreadPool(pool)
+            .serial([&](int i) { results.append(i); })
+            .run();
+
+    QVERIFY_THROWS_EXCEPTION(QUnhandledException, future.waitForFinished());
+    QCOMPARE_LE(results.size(), 10);
+}
+#endif
+
+QTEST_MAIN(tst_QtConcurrentPipeline)
+#include "tst_qtconcurrentpipeline.moc"
@@ -0,0 +1,320 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <qtconcurrenttaskgraph.h>
+#include <qexception.h>
+
+#include <QList>
+#include <QMutex>
+#include <QSemaphore>
+#include <QTest>
+#include <QThread>
+
+using namespace QtConcurrent;
+using namespace std::chrono_literals;
+
+class tst_QtConcurrentTaskGraph : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void empty();
+    void diamond();
+    void dependencyOrder();
+    void chainStaysOnThread();
+    void priorities();
+    void timing();
+    void cancel();
+#ifndef QT_NO_EXCEPTIONS
+    void exception();
+#endif
+    void cycle();
+    void runTwice();
+    void destroyWhileRunning();
+    void moveOnlyTask();
+
+private:
+    QThreadPool pool;
+};
+
+void tst_QtConcurrentTaskGraph::init()
+{
+    pool.setMaxThreadCount(4);
+}
+
+void tst_QtConcurrentTaskGraph::empty()
+{
+    QTaskGraph graph;
+    QCOMPARE(graph.size(), 0);
+    QFuture<void> future = graph.onThreadPool(pool).run();
+    QVERIFY(future.isFinished());
+    QVERIFY(!future.isCanceled());
+    QVERIFY(!graph.isRunning());
+}
+
+void tst_QtConcurrentTaskGraph::diamond()
+{
+    QMutex mutex;
+    QStringList order;
+    const auto record = [&](const char *name) {
+        return [&, name] {
+            QMutexLocker locker(&mutex);
+            order.append(QLatin1StringView(name));
+        };
+    };
+
+    QTaskGraph graph;
+    const auto a = graph.addTask(record("a"));
+    const auto b = graph.addTask(record("b"));
+    const auto c = graph.addTask(record("c"));
+    const auto d = graph.addTask(record("d"));
+    graph.addDependency(b, a);
+    graph.addDependency(c, a);
+    graph.addDependency(d, b);
+    graph.addDependency(d, c);
+    QCOMPARE(graph.size(), 4);
+
+    QFuture<void> future = graph.onThreadPool(pool).run();
+    future.waitForFinished();
+    QVERIFY(!future.isCanceled());
+    QVERIFY(!graph.isRunning());
+
+    QCOMPARE(order.size(), 4);
+    QCOMPARE(order.first(), QStringLiteral("a"));
+    QCOMPARE(order.last(), QStringLiteral("d"));
+}
+
+void tst_QtConcurrentTaskGraph::dependencyOrder()
+{
+    // layers of tasks where every task depends on a few of the layer before
+    constexpr int layers = 20;
+    constexpr int width = 30;
+    QList<QAtomicInt> done(layers * width);
+    QAtomicInt violations;
+
+    QTaskGraph graph;
+    for (int layer = 0; layer < layers; ++layer) {
+        for (int i = 0; i < width; ++i) {
+            const int index = layer * width + i;
+            graph.addTask([&, layer, i, index] {
+                if (layer > 0) {
+                    for (int k : { i, (i + 7) % width, (i + 13) % width }) {
+                        if (!done[(layer - 1) * width + k].loadAcquire())
+                            violations.ref();
+                    }
+                }
+                done[index].storeRelease(1);
+            });
+        }
+    }
+    for (int layer = 1; layer < layers; ++layer) {
+        for (int i = 0; i < width; ++i) {
+            for (int k : { i, (i + 7) % width, (i + 13) % width })
+                graph.addDependency(layer * width + i, (layer - 1) * width + k);
+        }
+    }
+
+    graph.onThreadPool(pool).run().waitForFinished();
+    QCOMPARE(violations.loadRelaxed(), 0);
+    for (const QAtomicInt &flag : done)
+        QCOMPARE(flag.loadRelaxed(), 1);
+}
+
+void tst_QtConcurrentTaskGraph::chainStaysOnThread()
+{
+    QList<QThread *> threads(10);
+    QTaskGraph graph;
+    for (int i = 0; i < threads.size(); ++i) {
+        graph.addTask([&threads, i] { threads[i] = QThread::currentThread(); });
+        if (i > 0)
+            graph.addDependency(i, i - 1);
+    }
+    graph.onThreadPool(pool).run().waitForFinished();
+
+    // each task goes on with the next one instead of starting it on the pool
+    for (QThread *thread : threads)
+        QCOMPARE(thread, threads.first());
+}
+
+void tst_QtConcurrentTaskGraph::priorities()
+{
+    QThreadPool singlePool;
+    singlePool.setMaxThreadCount(1);
+
+    // keep the only thread busy until all roots are queued
+    QSemaphore blocked;
+    QSemaphore proceed;
+    singlePool.start([&] {
+        blocked.release();
+        proceed.acquire();
+    });
+    blocked.acquire();
+
+    QList<int> order;
+    QTaskGraph graph;
+    for (int priority : { 1, 5, 3, 4, 2 })
+        graph.addTask([&order, priority] { order.append(priority); }, priority);
+    QFuture<void> future = graph.onThreadPool(singlePool).run();
+    QVERIFY(graph.isRunning());
+    proceed.release();
+    future.waitForFinished();
+
+    QCOMPARE(order, QList<int>({ 5, 4, 3, 2, 1 }));
+}
+
+void tst_QtConcurrentTaskGraph::timing()
+{
+    QTaskGraph graph;
+    const auto first = graph.addTask([] { QThread::sleep(2ms); });
+    const auto second = graph.addTask([] { QThread::sleep(2ms); });
+    graph.addDependency(second, first);
+
+    QCOMPARE(graph.timing(first).executed, false);
+    graph.onThreadPool(pool).run().waitForFinished();
+
+    const QTaskGraph::NodeTiming firstTiming = graph.timing(first);
+    const QTaskGraph::NodeTiming secondTiming = graph.timing(second);
+    QVERIFY(firstTiming.executed);
+    QVERIFY(secondTiming.executed);
+    QCOMPARE_GE(firstTiming.duration(), 2ms);
+    QCOMPARE_GE(secondTiming.duration(), 2ms);
+    QCOMPARE_GE(firstTiming.started, 0ns);
+    QCOMPARE_LE(firstTiming.finished, secondTiming.started);
+
+    // tasks added after the run have no timing yet
+    const auto third = graph.addTask([] { });
+    QCOMPARE(graph.timing(third).executed, false);
+}
+
+void tst_QtConcurrentTaskGraph::cancel()
+{
+    QSemaphore started;
+    QSemaphore proceed;
+    QAtomicInt calls;
+
+    QTaskGraph graph;
+    const auto first = graph.addTask([&] {
+        calls.ref();
+        started.release();
+        proceed.acquire();
+    });
+    QTaskGraph::Node previous = first;
+    for (int i = 0; i < 10; ++i) {
+        const auto node = graph.addTask([&] { calls.ref(); });
+        graph.addDependency(node, previous);
+        previous = node;
+    }
+
+    QFuture<void> future = graph.onThreadPool(pool).run();
+    started.acquire();
+    future.cancel();
+    proceed.release();
+    future.waitForFinished();
+
+    QVERIFY(future.isCanceled());
+    QVERIFY(!graph.isRunning());
+    QCOMPARE(calls.loadRelaxed(), 1);
+    QVERIFY(graph.timing(first).executed);
+    QVERIFY(!graph.timing(previous).executed);
+}
+
+#ifndef QT_NO_EXCEPTIONS
+void tst_QtConcurrentTaskGraph::exception()
+{
+    bool after = false;
+    QTaskGraph graph;
+    const auto thrower = graph.addTask([] { throw QException(); });
+    const auto next = graph.addTask([&] { after = true; });
+    graph.addDependency(next, thrower);
+
+    QFuture<void> future = graph.onThreadPool(pool).run();
+    QVERIFY_THROWS_EXCEPTION(QException, future.waitForFinished());
+    QVERIFY(future.isCanceled());
+    QVERIFY(!after);
+}
+#endif
+
+void tst_QtConcurrentTaskGraph::cycle()
+{
+    bool called = false;
+    QTaskGraph graph;
+    const auto root = graph.addTask([&] { called = true; });
+    const auto a = graph.addTask([&] { called = true; });
+    const auto b = graph.addTask([&] { called = true; });
+    graph.addDependency(a, root);
+    graph.addDependency(b, a);
+    graph.addDependency(a, b);
+
+    QTest::ignoreMessage(QtWarningMsg,
+                         "QTaskGraph::run: The dependencies of the graph form a cycle");
+    QFuture<void> future = graph.onThreadPool(pool).run();
+    QVERIFY(future.isFinished());
+    QVERIFY(future.isCanceled());
+    QVERIFY(!called);
+}
+
+void tst_QtConcurrentTaskGraph::runTwice()
+{
+    QSemaphore started;
+    QSemaphore proceed;
+    QAtomicInt calls;
+
+    QTaskGraph graph;
+    graph.addTask([&] {
+        if (calls.fetchAndAddRelaxed(1) == 0) {
+            started.release();
+            proceed.acquire();
+        }
+    });
+
+    QFuture<void> first = graph.onThreadPool(pool).run();
+    started.acquire();
+    QVERIFY(graph.isRunning());
+    QTest::ignoreMessage(QtWarningMsg, "QTaskGraph::run: The graph is already running");
+    QVERIFY(graph.run().isCanceled());
+    proceed.release();
+    first.waitForFinished();
+
+    // a task added after a run is part of the next one
+    graph.addTask([&] { calls.ref(); });
+    QFuture<void> second = graph.run();
+    second.waitForFinished();
+    QVERIFY(!second.isCanceled());
+    QCOMPARE(calls.loadRelaxed(), 3);
+}
+
+void tst_QtConcurrentTaskGraph::destroyWhileRunning()
+{
+    QSemaphore proceed;
+    QAtomicInt calls;
+    QFuture<void> future;
+    {
+        QTaskGraph graph;
+        const auto first = graph.addTask([&] {
+            proceed.acquire();
+            calls.ref();
+        });
+        const auto second = graph.addTask([&] { calls.ref(); });
+        graph.addDependency(second, first);
+        future = graph.onThreadPool(pool).run();
+    }
+    proceed.release();
+    future.waitForFinished();
+    QCOMPARE(calls.loadRelaxed(), 2);
+}
+
+void tst_QtConcurrentTaskGraph::moveOnlyTask()
+{
+    int value = 0;
+    auto pointer = std::make_unique<int>(42);
+    QTaskGraph graph;
+    graph.addTask([&value, pointer = std::move(pointer)] { value = *pointer; });
+
+    QTaskGraph moved(std::move(graph));
+    moved.onThreadPool(pool).run().waitForFinished();
+    QCOMPARE(value, 42);
+}
+
+QTEST_MAIN(tst_QtConcurrentTaskGraph)
+#include "tst_qtconcurrenttaskgraph.moc"
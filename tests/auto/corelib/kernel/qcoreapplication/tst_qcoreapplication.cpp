@@ -511,6 +511,88 @@ void tst_QCoreApplication::deliverInDefinedOrder()
     QObject::connect(&obj, SIGNAL(done()), &app, SLOT(quit()));
     app.exec();
 }
+
+class PostedOrderObject : public QObject
+{
+public:
+    QList<int> received;
+
+    bool event(QEvent *event) override
+    {
+        if (event->type() < QEvent::User)
+            return QObject::event(event);
+        received.append(event->type() - QEvent::User);
+        return true;
+    }
+};
+
+void tst_QCoreApplication::deliverInPostedOrderFromThread()
+{
+    int argc = 1;
+    char *argv[] = { const_cast<char*>(QTest::currentAppName()) };
+    TestApplication app(argc, argv);
+
+    // queued calls and other events take different paths into the list of
+    // posted events, but must still be delivered in the order they were posted
+    constexpr int Count = 1000;
+    PostedOrderObject obj;
+    std::unique_ptr<QThread> thread(QThread::create([&obj] {
+        for (int i = 0; i < Count; ++i) {
+            if (i % 3 == 0) {
+                QCoreApplication::postEvent(&obj, new QEvent(QEvent::Type(QEvent::User + i)));
+            } else {
+                QMetaObject::invokeMethod(&obj, [&obj, i] { obj.received.append(i); },
+                                          Qt::QueuedConnection);
+            }
+        }
+    }));
+    thread->start();
+    QVERIFY(thread->wait());
+
+    QCoreApplication::sendPostedEvents();
+    QCOMPARE(obj.received.size(), Count);
+    for (int i = 0; i < Count; ++i)
+        QCOMPARE(obj.received.at(i), i);
+}
+
+void tst_QCoreApplication::postWhileMovingToThread()
+{
+    int argc = 1;
+    char *argv[] = { const_cast<char*>(QTest::currentAppName()) };
+    TestApplication app(argc, argv);
+
+    // queued calls posted while the receiver changes threads must all arrive,
+    // in the thread the receiver lives in when they are delivered
+    constexpr int Count = 2000;
+    QObject obj;
+    std::atomic<int> delivered = 0;
+    std::atomic<int> deliveredInWrongThread = 0;
+    std::unique_ptr<QThread> poster(QThread::create([&] {
+        for (int i = 0; i < Count; ++i) {
+            QMetaObject::invokeMethod(&obj, [&] {
+                if (QThread::currentThread() != obj.thread())
+                    ++deliveredInWrongThread;
+                ++delivered;
+            }, Qt::QueuedConnection);
+        }
+    }));
+    QThread worker;
+    worker.start();
+    poster->start();
+    while (!poster->isFinished()) {
+        obj.moveToThread(&worker);
+        QMetaObject::invokeMethod(&obj, [&obj, &app] { obj.moveToThread(app.thread()); },
+                                  Qt::BlockingQueuedConnection);
+        QCoreApplication::sendPostedEvents();
+    }
+    QVERIFY(poster->wait());
+    worker.quit();
+    QVERIFY(worker.wait());
+
+    QCoreApplication::sendPostedEvents();
+    QCOMPARE(delivered.load(), Count);
+    QCOMPARE(deliveredInWrongThread.load(), 0);
+}
 #endif // QT_CONFIG(thread)
 
 void tst_QCoreApplication::applicationPid()
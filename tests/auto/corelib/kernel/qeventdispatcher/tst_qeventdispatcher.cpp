@@ -9,8 +9,12 @@
 #include <QTest>
 #include <QAbstractEventDispatcher>
 #include <QTimer>
+#include <QScopeGuard>
+#include <QThread>
 #include <QThreadPool>
 
+#include <QtCore/private/qeventdispatcherstatistics_p.h>
+
 #ifdef DISABLE_GLIB
 static bool glibDisabled = []() {
     qputenv("QT_NO_GLIB", "1");
@@ -83,6 +87,7 @@ private slots:
     // these two tests need to run before postedEventsPingPong
     void postEventFromThread();
     void postEventFromEventHandler();
+    void statistics();
     // these tests don't leave the event dispatcher in a reliable state
     void postedEventsPingPong();
     void eventLoopExit();
@@ -464,6 +469,71 @@ void tst_QEventDispatcher::postEventFromEventHandler()
 }
 
 
+class SlowReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    bool event(QEvent *event) override
+    {
+        if (event->type() == QEvent::User) {
+            QThread::sleep(1ms);
+            return true;
+        }
+        return QObject::event(event);
+    }
+};
+
+void tst_QEventDispatcher::statistics()
+{
+    QEventDispatcherStatistics *statistics =
+            QEventDispatcherStatistics::forDispatcher(eventDispatcher);
+    QVERIFY(statistics);
+    const auto resetStatistics = qScopeGuard([statistics] {
+        QEventDispatcherStatistics::setEnabled(false);
+        statistics->reset();
+    });
+    statistics->reset();
+
+    // nothing is recorded unless enabled
+    QCoreApplication::postEvent(this, new QEvent(QEvent::User));
+    eventDispatcher->processEvents(QEventLoop::AllEvents);
+    QCOMPARE(statistics->snapshot().delivery.count, 0u);
+
+    QEventDispatcherStatistics::setEnabled(true);
+    SlowReceiver slow;
+    for (int i = 0; i < 3; ++i)
+        QCoreApplication::postEvent(&slow, new QEvent(QEvent::User));
+    for (int i = 0; i < 5; ++i)
+        QCoreApplication::postEvent(this, new QEvent(QEvent::User));
+    eventDispatcher->processEvents(QEventLoop::AllEvents);
+
+    const QEventDispatcherStatistics::Snapshot snapshot = statistics->snapshot();
+    QCOMPARE(snapshot.delivery.count, 8u);
+    QCOMPARE_GE(snapshot.delivery.max, quint64(std::chrono::nanoseconds(1ms).count()));
+    QCOMPARE_GE(snapshot.queueDepth.max, 8u);
+
+    // the receivers are sorted by the time they took
+    QCOMPARE_GE(snapshot.slowestReceivers.size(), 2);
+    QCOMPARE(snapshot.slowestReceivers.at(0).metaObject, &SlowReceiver::staticMetaObject);
+    QCOMPARE(snapshot.slowestReceivers.at(0).count, 3u);
+    QCOMPARE_GE(snapshot.slowestReceivers.at(0).totalNSecs,
+                quint64(std::chrono::nanoseconds(3ms).count()));
+    QCOMPARE_GE(snapshot.slowestReceivers.at(1).totalNSecs,
+                snapshot.slowestReceivers.at(1).maxNSecs);
+    QCOMPARE(statistics->snapshot(1).slowestReceivers.size(), 1);
+
+    const QEventDispatcherStatistics::Histogram &delivery = snapshot.delivery;
+    QCOMPARE_LE(delivery.percentile(0.5), delivery.percentile(1.0));
+    QCOMPARE(delivery.percentile(1.0), delivery.max);
+
+    if (eventDispatcher->inherits("QEventDispatcherUNIX")
+            || eventDispatcher->inherits("QEventDispatcherGlib")) {
+        QCOMPARE_GE(snapshot.phases[QEventDispatcherStatistics::PostedEvents].count, 1u);
+        QCOMPARE_GE(snapshot.phases[QEventDispatcherStatistics::PostedEvents].max,
+                    quint64(std::chrono::nanoseconds(3ms).count()));
+    }
+}
+
 void tst_QEventDispatcher::postedEventsPingPong()
 {
     QEventLoop mainLoop;
@@ -0,0 +1,132 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QTest>
+#include <QThread>
+
+#include <QtCore/private/qeventpool_p.h>
+#include <QtCore/private/qobject_p.h>
+
+#include <memory>
+#include <vector>
+
+class tst_QEventPool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void recycle_data();
+    void recycle();
+    void oversized();
+    void alignment();
+    void releaseInOtherThread();
+    void metaCallEvent();
+};
+
+void tst_QEventPool::recycle_data()
+{
+    QTest::addColumn<size_t>("size");
+
+    QTest::newRow("1") << size_t(1);
+    QTest::newRow("64") << size_t(64);
+    QTest::newRow("65") << size_t(65);
+    QTest::newRow("192") << size_t(192);
+}
+
+void tst_QEventPool::recycle()
+{
+#ifdef QT_ASAN_ENABLED
+    QSKIP("The pool is disabled with AddressSanitizer");
+#endif
+    QFETCH(size_t, size);
+
+    void *first = QEventPool::allocate(size);
+    QVERIFY(first);
+    memset(first, 0xa5, size);
+    QEventPool::release(first, size);
+
+    // the most recently released slot comes back from the thread's cache
+    const QEventPool::Statistics before = QEventPool::statistics();
+    void *second = QEventPool::allocate(size);
+    QCOMPARE(second, first);
+    QEventPool::release(second, size);
+    const QEventPool::Statistics after = QEventPool::statistics();
+    QCOMPARE(after.hits, before.hits + 1);
+    QCOMPARE(after.misses, before.misses);
+    QCOMPARE(after.unpooled, before.unpooled);
+}
+
+void tst_QEventPool::oversized()
+{
+    const QEventPool::Statistics before = QEventPool::statistics();
+    void *ptr = QEventPool::allocate(4096);
+    QVERIFY(ptr);
+    memset(ptr, 0xa5, 4096);
+    QEventPool::release(ptr, 4096);
+#ifndef QT_ASAN_ENABLED
+    QCOMPARE(QEventPool::statistics().unpooled, before.unpooled + 1);
+#endif
+}
+
+void tst_QEventPool::alignment()
+{
+    for (size_t size : { 8, 24, 64, 100, 192 }) {
+        for (int i = 0; i < 100; ++i) {
+            void *ptr = QEventPool::allocate(size);
+            QCOMPARE(quintptr(ptr) % __STDCPP_DEFAULT_NEW_ALIGNMENT__, quintptr(0));
+            QEventPool::release(ptr, size);
+        }
+    }
+}
+
+void tst_QEventPool::releaseInOtherThread()
+{
+    // more than fit into a thread's cache, so that the rest goes back to the
+    // shared free list
+    constexpr int Count = 1000;
+    constexpr size_t Size = 48;
+    std::vector<void *> pointers;
+    for (int i = 0; i < Count; ++i) {
+        pointers.push_back(QEventPool::allocate(Size));
+        memset(pointers.back(), i & 0xff, Size);
+    }
+
+    std::unique_ptr<QThread> thread(QThread::create([&pointers] {
+        for (void *ptr : pointers)
+            QEventPool::release(ptr, Size);
+    }));
+    thread->start();
+    QVERIFY(thread->wait());
+
+    // all slots are free again and can be reused by this thread
+    std::vector<void *> again;
+    for (int i = 0; i < Count; ++i)
+        again.push_back(QEventPool::allocate(Size));
+    for (void *ptr : again)
+        QEventPool::release(ptr, Size);
+}
+
+void tst_QEventPool::metaCallEvent()
+{
+#ifdef QT_ASAN_ENABLED
+    QSKIP("The pool is disabled with AddressSanitizer");
+#endif
+    // queued calls allocate their events from the pool
+    QObject receiver;
+    int calls = 0;
+    QMetaObject::invokeMethod(&receiver, [&calls] { ++calls; }, Qt::QueuedConnection);
+    QCoreApplication::sendPostedEvents(&receiver, QEvent::MetaCall);
+    QCOMPARE(calls, 1);
+
+    const QEventPool::Statistics before = QEventPool::statistics();
+    for (int i = 0; i < 10; ++i)
+        QMetaObject::invokeMethod(&receiver, [&calls] { ++calls; }, Qt::QueuedConnection);
+    QCoreApplication::sendPostedEvents(&receiver, QEvent::MetaCall);
+    QCOMPARE(calls, 11);
+    const QEventPool::Statistics after = QEventPool::statistics();
+    QVERIFY(after.hits + after.misses >= before.hits + before.misses + 10);
+}
+
+QTEST_MAIN(tst_QEventPool)
+
+#include "tst_qeventpool.moc"
@@ -151,6 +151,8 @@ private slots:
     void functorReferencesConnection();
     void disconnectDisconnects();
     void singleShotConnection();
+    void batchedConnection();
+    void modifyConnectionsDuringEmission();
     void objectNameBinding();
     void emitToDestroyedClass();
     void declarativeData();
@@ -8545,6 +8547,140 @@ void tst_QObject::singleShotConnection()
     }
 }
 
+void tst_QObject::batchedConnection()
+{
+    const auto batched = static_cast<Qt::ConnectionType>(Qt::QueuedConnection
+                                                         | Qt::BatchedConnection);
+    {
+        SenderObject sender;
+        QObject receiver;
+        EventSpy spy;
+        receiver.installEventFilter(&spy);
+
+        QList<int> numbers;
+        QStringList strings;
+        QVERIFY(connect(&sender, &SenderObject::signal7, &receiver,
+                        [&](int i, const QString &s) { numbers << i; strings << s; }, batched));
+
+        // all emissions are delivered in order through a single event
+        for (int i = 0; i < 1000; ++i)
+            emit sender.signal7(i, QString::number(i));
+        QVERIFY(numbers.isEmpty());
+        QCoreApplication::sendPostedEvents(&receiver, QEvent::MetaCall);
+        QCOMPARE(numbers.size(), 1000);
+        for (int i = 0; i < 1000; ++i) {
+            QCOMPARE(numbers.at(i), i);
+            QCOMPARE(strings.at(i), QString::number(i));
+        }
+        QCOMPARE(spy.eventList().size(), 1);
+
+        // emissions after the delivery start a new event
+        emit sender.signal7(1000, QString());
+        emit sender.signal7(1001, QString());
+        QCoreApplication::sendPostedEvents(&receiver, QEvent::MetaCall);
+        QCOMPARE(numbers.size(), 1002);
+        QCOMPARE(numbers.last(), 1001);
+        QCOMPARE(spy.eventList().size(), 2);
+
+        // a discarded event does not swallow later emissions
+        emit sender.signal7(-1, QString());
+        QCoreApplication::removePostedEvents(&receiver, QEvent::MetaCall);
+        emit sender.signal7(1002, QString());
+        QCoreApplication::sendPostedEvents(&receiver, QEvent::MetaCall);
+        QCOMPARE(numbers.size(), 1003);
+        QCOMPARE(numbers.last(), 1002);
+    }
+
+    {
+        // string-based connection, no arguments
+        SenderObject sender;
+        SenderObject receiver;
+        QVERIFY(connect(&sender, SIGNAL(signal1()), &receiver, SLOT(aPublicSlot()), batched));
+        for (int i = 0; i < 10; ++i)
+            sender.emitSignal1();
+        QCOMPARE(receiver.aPublicSlotCalled, 0);
+        QCoreApplication::sendPostedEvents(&receiver, QEvent::MetaCall);
+        QCOMPARE(receiver.aPublicSlotCalled, 10);
+    }
+
+    {
+        // a pending event survives the connection
+        SenderObject sender;
+        SenderObject receiver;
+        auto c = connect(&sender, &SenderObject::signal1, &receiver, &SenderObject::aPublicSlot,
+                         batched);
+        sender.emitSignal1();
+        sender.emitSignal1();
+        QVERIFY(disconnect(c));
+        sender.emitSignal1();
+        QCoreApplication::sendPostedEvents(&receiver, QEvent::MetaCall);
+        QCOMPARE(receiver.aPublicSlotCalled, 2);
+    }
+
+    {
+        // from another thread
+        SenderObject sender;
+        QObject receiver;
+        QList<int> numbers;
+        connect(&sender, &SenderObject::signal7, &receiver,
+                [&](int i) { numbers << i; }, Qt::BatchedConnection);
+        std::unique_ptr<QThread> thread(QThread::create([&] {
+            for (int i = 0; i < 1000; ++i)
+                emit sender.signal7(i, QString());
+        }));
+        thread->start();
+        QVERIFY(thread->wait());
+        QTRY_COMPARE(numbers.size(), 1000);
+        for (int i = 0; i < 1000; ++i)
+            QCOMPARE(numbers.at(i), i);
+    }
+
+    {
+        // copying the arguments locks the signalSlotLock of other objects
+        CheckInstanceCount checker;
+        QCustomTypeChecker sender;
+        QCustomTypeChecker receiver;
+        QList<int> values;
+        QVERIFY(connect(&sender, &QCustomTypeChecker::signal1, &receiver,
+                        [&](CustomType ct) { values << ct.value(); }, batched));
+        sender.doEmit(CustomType(1));
+        sender.doEmit(CustomType(2));
+        QCoreApplication::sendPostedEvents(&receiver, QEvent::MetaCall);
+        QCOMPARE(values, QList<int>({ 1, 2 }));
+    }
+}
+
+void tst_QObject::modifyConnectionsDuringEmission()
+{
+    SenderObject sender;
+    QList<int> calls;
+    QList<QMetaObject::Connection> connections;
+    for (int i = 0; i < 10; ++i) {
+        connections << connect(&sender, &SenderObject::signal1, &sender, [&, i] {
+            calls << i;
+            if (i == 2) {
+                // removed connections are skipped, added ones wait for the next emission
+                disconnect(connections.at(5));
+                disconnect(connections.at(0));
+                connections << connect(&sender, &SenderObject::signal1, &sender,
+                                       [&] { calls << 10; });
+            } else if (i == 7) {
+                // a nested emission sees the current connections
+                disconnect(connections.at(7));
+                sender.emitSignal1();
+            }
+        });
+    }
+
+    sender.emitSignal1();
+    QCOMPARE(calls, QList<int>({ 0, 1, 2, 3, 4, 6, 7, 1, 2, 3, 4, 6, 8, 9, 10, 8, 9 }));
+
+    // i == 2 keeps connecting, i == 7 is gone
+    calls.clear();
+    sender.emitSignal1();
+    QCOMPARE(calls, QList<int>({ 1, 2, 3, 4, 6, 8, 9, 10, 10 }));
+}
+
 void tst_QObject::objectNameBinding()
 {
     QObject obj;
@@ -24,6 +24,14 @@
 #  undef min
 #endif // Q_CC_MSVC
 
+#ifdef USE_EPOLL
+static bool epollEnabled = []() {
+    qputenv("QT_NO_GLIB", "1");
+    qputenv("QT_EVENT_DISPATCHER_EPOLL", "1");
+    return true;
+}();
+#endif
+
 using namespace std::chrono_literals;
 
 class tst_QSocketNotifier : public QObject
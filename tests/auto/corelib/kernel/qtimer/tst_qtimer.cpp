@@ -39,6 +39,13 @@ static bool glibDisabled = []() {
 }();
 #endif
 
+#ifdef USE_TIMER_WHEEL
+static bool timerWheelEnabled = []() {
+    qputenv("QT_EVENT_DISPATCHER_TIMER_WHEEL", "1");
+    return true;
+}();
+#endif
+
 using namespace std::chrono_literals;
 
 class tst_QTimer : public QObject
@@ -0,0 +1,385 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QCborView>
+
+#include <QCborArray>
+#include <QCborMap>
+#include <QCborValue>
+#include <QTemporaryFile>
+#include <QTest>
+#include <QThread>
+
+#include <limits>
+#include <memory>
+
+using namespace Qt::StringLiterals;
+
+class tst_QCborView : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void invalid();
+    void matchesValue_data();
+    void matchesValue();
+    void encodings_data();
+    void encodings();
+    void lookup();
+    void malformed_data();
+    void malformed();
+    void truncatedContainer();
+    void nestingLimit();
+    void mappedFile();
+    void threads();
+};
+
+// Compares everything the view can tell about the value with the value.
+static void compare(const QCborView &view, const QCborValue &value)
+{
+    QCOMPARE(view.type(), value.type());
+    switch (value.type()) {
+    case QCborValue::Integer:
+        QCOMPARE(view.toInteger(), value.toInteger());
+        QCOMPARE(view.toDouble(), value.toDouble());
+        break;
+    case QCborValue::Double:
+        QCOMPARE(view.toDouble(), value.toDouble());
+        if (qAbs(value.toDouble()) < 1e18)
+            QCOMPARE(view.toInteger(), value.toInteger());
+        break;
+    case QCborValue::ByteArray:
+        QCOMPARE(view.toByteArray(), value.toByteArray());
+        break;
+    case QCborValue::String:
+        QCOMPARE(view.toString(), value.toString());
+        break;
+    case QCborValue::Array: {
+        const QCborArray array = value.toArray();
+        QCOMPARE(view.size(), array.size());
+        for (qsizetype i = 0; i < array.size(); ++i) {
+            compare(view.at(i), array.at(i));
+            if (QTest::currentTestFailed())
+                return;
+        }
+        QVERIFY(view.at(array.size()).isInvalid());
+        break;
+    }
+    case QCborValue::Map: {
+        const QCborMap map = value.toMap();
+        QCOMPARE(view.size(), map.size());
+        qsizetype i = 0;
+        for (auto it = map.cbegin(); it != map.cend(); ++it, ++i) {
+            compare(view.keyAt(i), it.key());
+            if (QTest::currentTestFailed())
+                return;
+            compare(view.valueAt(i), it.value());
+            if (QTest::currentTestFailed())
+                return;
+        }
+        QVERIFY(view.keyAt(map.size()).isInvalid());
+        QVERIFY(view.valueAt(map.size()).isInvalid());
+        break;
+    }
+    case QCborValue::Tag:
+        QCOMPARE(view.tag(), value.tag());
+        compare(view.taggedValue(), value.taggedValue());
+        break;
+    default:
+        QCOMPARE(view.toSimpleType(), value.toSimpleType());
+        break;
+    }
+    QCOMPARE(view.toBool(), value.toBool());
+}
+
+void tst_QCborView::invalid()
+{
+    const QCborView view;
+    QVERIFY(view.isInvalid());
+    QCOMPARE(view.offset(), -1);
+    QCOMPARE(view.size(), 0);
+    QVERIFY(view.at(0).isInvalid());
+    QVERIFY(view["key"].isInvalid());
+    QCOMPARE(view.toInteger(42), 42);
+    QVERIFY(view.toStringView().isNull());
+    QCOMPARE(view.toString(u"default"_s), u"default"_s);
+    QVERIFY(view.toCborValue().isInvalid());
+
+    QVERIFY(QCborView::fromCbor({}).isInvalid());
+}
+
+void tst_QCborView::matchesValue_data()
+{
+    QTest::addColumn<QCborValue>("value");
+
+    QTest::newRow("zero") << QCborValue(0);
+    QTest::newRow("23") << QCborValue(23);
+    QTest::newRow("24") << QCborValue(24);
+    QTest::newRow("256") << QCborValue(256);
+    QTest::newRow("65536") << QCborValue(65536);
+    QTest::newRow("int64-max") << QCborValue(std::numeric_limits<qint64>::max());
+    QTest::newRow("minus-one") << QCborValue(-1);
+    QTest::newRow("minus-25") << QCborValue(-25);
+    QTest::newRow("int64-min") << QCborValue(std::numeric_limits<qint64>::min());
+    QTest::newRow("double") << QCborValue(1.25);
+    QTest::newRow("negative-double") << QCborValue(-1e300);
+    QTest::newRow("false") << QCborValue(false);
+    QTest::newRow("true") << QCborValue(true);
+    QTest::newRow("null") << QCborValue(nullptr);
+    QTest::newRow("undefined") << QCborValue();
+    QTest::newRow("simple-type") << QCborValue(QCborSimpleType(32));
+    QTest::newRow("empty-string") << QCborValue(u""_s);
+    QTest::newRow("string") << QCborValue(u"hello"_s);
+    QTest::newRow("non-ascii-string") << QCborValue(u"né € \U0001F600"_s);
+    QTest::newRow("long-string") << QCborValue(QString(1000, u'x'));
+    QTest::newRow("byte-array") << QCborValue(QByteArray("\0\1\2\xff", 4));
+    QTest::newRow("tag") << QCborValue(QCborTag(1234), u"tagged"_s);
+    QTest::newRow("empty-array") << QCborValue(QCborArray());
+    QTest::newRow("empty-map") << QCborValue(QCborMap());
+    QTest::newRow("array") << QCborValue(QCborArray{ 1, u"two"_s, 3.5, true, nullptr });
+    QTest::newRow("map") << QCborValue(QCborMap{ { u"a"_s, 1 }, { 2, u"b"_s },
+                                                 { QByteArray("c"), QCborArray{ 3 } } });
+    QTest::newRow("nested")
+            << QCborValue(QCborArray{ QCborMap{ { u"list"_s, QCborArray{ 1, QCborArray{ 2, 3 } } },
+                                                { u"map"_s, QCborMap{ { u"x"_s, QCborMap() } } } },
+                                      QCborArray{ QCborArray{ QCborArray() } },
+                                      QCborValue(QCborTag(99), QCborArray{ 4 }) });
+
+    QCborArray large;
+    for (int i = 0; i < 1000; ++i)
+        large.append(QCborMap{ { u"id"_s, i }, { u"name"_s, u"item %1"_s.arg(i) } });
+    QTest::newRow("large") << QCborValue(large);
+}
+
+void tst_QCborView::matchesValue()
+{
+    QFETCH(QCborValue, value);
+
+    const QByteArray cbor = value.toCbor();
+    const QCborView view = QCborView::fromCbor(cbor);
+    QCOMPARE(view.offset(), 0);
+    compare(view, value);
+    if (QTest::currentTestFailed())
+        return;
+    QCOMPARE(view.toCborValue(), value);
+
+    // once more, now that the containers are indexed
+    compare(view, value);
+}
+
+void tst_QCborView::encodings_data()
+{
+    QTest::addColumn<QByteArray>("cbor");
+
+    QTest::newRow("one-byte-argument") << "\x18\x18"_ba;
+    QTest::newRow("eight-byte-argument") << "\x1b\0\0\0\0\0\0\0\x01"_ba;
+    QTest::newRow("uint64-max") << "\x1b\xff\xff\xff\xff\xff\xff\xff\xff"_ba;
+    QTest::newRow("negative-out-of-range") << "\x3b\x80\0\0\0\0\0\0\0"_ba;
+    QTest::newRow("float16") << "\xf9\x3e\x00"_ba;
+    QTest::newRow("float") << "\xfa\x3f\xc0\x00\x00"_ba;
+    QTest::newRow("simple-type-in-next-byte") << "\xf8\xff"_ba;
+    QTest::newRow("indefinite-array") << "\x9f\x01\x9f\xff\x82\x02\x03\xff"_ba;
+    QTest::newRow("indefinite-map") << "\xbf\x61\x61\x01\x02\xbf\xff\xff"_ba;
+    QTest::newRow("chunked-string") << "\x7f\x62\x61\x62\x60\x61\x63\xff"_ba;
+    QTest::newRow("chunked-byte-array") << "\x5f\x41\x01\x41\x02\xff"_ba;
+    QTest::newRow("chunked-in-array") << "\x82\x7f\x61\x61\xff\x05"_ba;
+    QTest::newRow("nested-tags") << "\xd8\x63\xd8\x64\x01"_ba;
+}
+
+void tst_QCborView::encodings()
+{
+    QFETCH(QByteArray, cbor);
+
+    const QCborValue value = QCborValue::fromCbor(cbor);
+    const QCborView view = QCborView::fromCbor(cbor);
+    compare(view, value);
+    if (QTest::currentTestFailed())
+        return;
+    QCOMPARE(view.toCborValue(), value);
+
+    // strings split into chunks must be copied to be joined
+    if (QByteArrayView(cbor).startsWith("\x7f"))
+        QVERIFY(view.toStringView().isNull());
+    if (QByteArrayView(cbor).startsWith("\x5f"))
+        QVERIFY(view.toByteArrayView().isNull());
+}
+
+void tst_QCborView::lookup()
+{
+    const QCborMap map{
+        { u"a"_s, 1 },
+        { 2, u"two"_s },
+        { u"é"_s, 3 },
+        { QByteArray("bytes"), 4 },
+        { u"list"_s, QCborArray{ 10, 20, 30 } },
+    };
+    const QByteArray cbor = QCborValue(map).toCbor();
+    const QCborView view = QCborView::fromCbor(cbor);
+
+    QCOMPARE(view.value(u"a").toInteger(), 1);
+    QCOMPARE(view["a"].toInteger(), 1);
+    QCOMPARE(view[u"a"_s].toInteger(), 1);
+    QCOMPARE(view[2].toStringView(), QUtf8StringView("two"));
+    QCOMPARE(view.value(2).toString(), u"two"_s);
+    QCOMPARE(view[u"é"].toInteger(), 3);
+    QCOMPARE(view["é"].toInteger(), 3);
+    QCOMPARE(view[QLatin1StringView("\xe9")].toInteger(), 3);
+    QCOMPARE(view["list"][1].toInteger(), 20);
+    QCOMPARE(view["list"].at(2).toInteger(), 30);
+
+    QVERIFY(view["missing"].isInvalid());
+    QVERIFY(view["bytes"].isInvalid());         // the key is not a string
+    QVERIFY(view[3].isInvalid());
+    QVERIFY(view.at(0).isInvalid());            // not an array
+    QVERIFY(view["list"][3].isInvalid());
+    QVERIFY(view["list"][-1].isInvalid());
+    QVERIFY(view["list"]["a"].isInvalid());     // not a map
+    QVERIFY(view["a"][0].isInvalid());
+
+    // the string views point into the data
+    const QUtf8StringView key = view.keyAt(0).toStringView();
+    QVERIFY(key.data() >= cbor.constData());
+    QVERIFY(key.data() < cbor.constData() + cbor.size());
+    QCOMPARE(key, QUtf8StringView("a"));
+
+    // with duplicate keys, the first one wins, as in QCborMap
+    const QCborView duplicates = QCborView::fromCbor("\xa2\x61\x61\x01\x61\x61\x02");
+    QCOMPARE(duplicates.size(), 2);
+    QCOMPARE(duplicates["a"].toInteger(), 1);
+}
+
+void tst_QCborView::malformed_data()
+{
+    QTest::addColumn<QByteArray>("cbor");
+    QTest::addColumn<QCborValue::Type>("type");
+
+    QTest::newRow("reserved") << "\x1c"_ba << QCborValue::Invalid;
+    QTest::newRow("indefinite-integer") << "\x1f"_ba << QCborValue::Invalid;
+    QTest::newRow("indefinite-tag") << "\xdf\x01"_ba << QCborValue::Invalid;
+    QTest::newRow("break") << "\xff"_ba << QCborValue::Invalid;
+    QTest::newRow("truncated-argument") << "\x19\x01"_ba << QCborValue::Invalid;
+    QTest::newRow("truncated-string") << "\x65\x61\x62"_ba << QCborValue::String;
+    QTest::newRow("truncated-byte-array") << "\x45\x61\x62"_ba << QCborValue::ByteArray;
+    QTest::newRow("unterminated-chunks") << "\x7f\x61\x61"_ba << QCborValue::String;
+    QTest::newRow("mixed-chunks") << "\x7f\x41\x61\xff"_ba << QCborValue::String;
+    QTest::newRow("huge-array") << "\x9b\xff\xff\xff\xff\xff\xff\xff\xff\x01"_ba << QCborValue::Array;
+    QTest::newRow("huge-string") << "\x7b\xff\xff\xff\xff\xff\xff\xff\xff\x61"_ba << QCborValue::String;
+    QTest::newRow("unterminated-array") << "\x9f\x01\x02"_ba << QCborValue::Array;
+    QTest::newRow("truncated-tag") << "\xc1"_ba << QCborValue::Tag;
+}
+
+void tst_QCborView::malformed()
+{
+    QFETCH(QByteArray, cbor);
+    QFETCH(QCborValue::Type, type);
+
+    const QCborView view = QCborView::fromCbor(cbor);
+    QCOMPARE(view.type(), type);
+    QVERIFY(view.toStringView().isNull());
+    QVERIFY(view.toByteArrayView().isNull());
+    QCOMPARE(view.toString(u"default"_s), u"default"_s);
+    QCOMPARE(view.toByteArray("default"), "default");
+    QVERIFY(view.toCborValue().isInvalid());
+    if (type == QCborValue::Tag)
+        QVERIFY(view.taggedValue().isInvalid());
+}
+
+void tst_QCborView::truncatedContainer()
+{
+    const QCborArray array{ 1, u"hello"_s, QCborArray{ 2, 3 } };
+    const QByteArray cbor = QCborValue(array).toCbor();
+
+    // the elements that precede malformed data are available
+    for (qsizetype size = cbor.size() - 1; size > 0; --size) {
+        const QCborView view = QCborView::fromCbor(QByteArrayView(cbor).first(size));
+        QVERIFY(view.isArray());
+        QVERIFY(view.size() < array.size());
+        for (qsizetype i = 0; i < view.size(); ++i)
+            QCOMPARE(view.at(i).toCborValue(), array.at(i));
+        QVERIFY(view.at(view.size()).isInvalid());
+        QVERIFY(view.toCborValue().isInvalid());
+    }
+
+    // the same goes for the members of maps, which need both a key and a value
+    const QByteArray map = "\xa2\x61\x61\x01\x61\x62"_ba;
+    const QCborView view = QCborView::fromCbor(map);
+    QCOMPARE(view.size(), 1);
+    QCOMPARE(view["a"].toInteger(), 1);
+    QVERIFY(view.keyAt(1).isInvalid());
+}
+
+void tst_QCborView::nestingLimit()
+{
+    const auto nested = [](int depth) {
+        return QByteArray(depth, '\x81') + '\0';
+    };
+
+    QByteArray cbor = nested(1000);
+    QCborView view = QCborView::fromCbor(cbor);
+    for (int i = 0; i < 1000; ++i) {
+        QCOMPARE(view.size(), 1);
+        view = view.at(0);
+    }
+    QVERIFY(view.isInteger());
+
+    // deeper nesting is not followed, instead of exhausting the stack
+    cbor = nested(100000);
+    view = QCborView::fromCbor(cbor);
+    QVERIFY(view.isArray());
+    QCOMPARE(view.size(), 0);
+}
+
+void tst_QCborView::mappedFile()
+{
+    QCborMap map;
+    for (int i = 0; i < 100; ++i)
+        map.insert(u"key %1"_s.arg(i), QCborArray{ i, u"value %1"_s.arg(i) });
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    const QByteArray cbor = QCborValue(map).toCbor();
+    QCOMPARE(file.write(cbor), cbor.size());
+    QVERIFY(file.flush());
+
+    uchar *data = file.map(0, file.size());
+    QVERIFY(data);
+    {
+        const QCborView view = QCborView::fromCbor(QByteArrayView(data, file.size()));
+        compare(view, map);
+        QCOMPARE(view["key 42"][1].toStringView(), QUtf8StringView("value 42"));
+        QCOMPARE(view["key 42"][1].toStringView().data(),
+                 reinterpret_cast<const char *>(data) + view["key 42"][1].offset() + 1);
+    }
+    QVERIFY(file.unmap(data));
+}
+
+void tst_QCborView::threads()
+{
+    QCborArray array;
+    for (int i = 0; i < 200; ++i)
+        array.append(QCborMap{ { u"id"_s, i }, { u"children"_s, QCborArray{ i, i + 1, i + 2 } } });
+    const QByteArray cbor = QCborValue(array).toCbor();
+
+    // the views share the index of the containers, which the threads build
+    // at the same time
+    const QCborView view = QCborView::fromCbor(cbor);
+    std::unique_ptr<QThread> threads[4];
+    qint64 sums[4] = {};
+    for (int t = 0; t < 4; ++t) {
+        threads[t].reset(QThread::create([&view, sum = &sums[t]] {
+            for (qsizetype i = 0; i < view.size(); ++i) {
+                const QCborView children = view[i]["children"];
+                for (qsizetype j = 0; j < children.size(); ++j)
+                    *sum += children[j].toInteger();
+            }
+        }));
+        threads[t]->start();
+    }
+    for (const auto &thread : threads)
+        QVERIFY(thread->wait());
+    for (qint64 sum : sums)
+        QCOMPARE(sum, 3 * (199 * 200 / 2) + 3 * 200);
+}
+
+QTEST_APPLESS_MAIN(tst_QCborView)
+#include "tst_qcborview.moc"
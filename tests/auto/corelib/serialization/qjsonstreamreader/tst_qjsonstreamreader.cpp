@@ -0,0 +1,461 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QJsonStreamReader>
+
+#include <QBuffer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTest>
+
+using namespace Qt::StringLiterals;
+
+class tst_QJsonStreamReader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void tokens_data();
+    void tokens();
+    void tokensIncremental_data() { tokens_data(); }
+    void tokensIncremental();
+    void errors_data();
+    void errors();
+    void errorOffset();
+    void topLevelNumber();
+    void sequentialDevice();
+    void longStrings();
+    void readValue_data();
+    void readValue();
+    void readValueNested();
+    void readValueIncomplete();
+    void skipCurrentValue();
+    void skipCurrentValueIncremental();
+    void jsonLines();
+};
+
+// Describes the current token, so that a stream compares as a list of
+// strings.
+static QString describe(const QJsonStreamReader &reader)
+{
+    switch (reader.tokenType()) {
+    case QJsonStreamReader::StartArray:
+        return u"["_s;
+    case QJsonStreamReader::EndArray:
+        return u"]"_s;
+    case QJsonStreamReader::StartObject:
+        return u"{"_s;
+    case QJsonStreamReader::EndObject:
+        return u"}"_s;
+    case QJsonStreamReader::Name:
+        return reader.text().toString() + u':';
+    case QJsonStreamReader::String:
+        return u'"' + reader.text().toString() + u'"';
+    case QJsonStreamReader::Integer:
+        return QString::number(reader.toInteger());
+    case QJsonStreamReader::Double:
+        return u"d:"_s + QString::number(reader.toDouble());
+    case QJsonStreamReader::Bool:
+        return reader.toBool() ? u"true"_s : u"false"_s;
+    case QJsonStreamReader::Null:
+        return u"null"_s;
+    case QJsonStreamReader::NoToken:
+    case QJsonStreamReader::Invalid:
+        break;
+    }
+    return QString();
+}
+
+static void readAvailable(QJsonStreamReader &reader, QStringList &tokens)
+{
+    while (true) {
+        const QJsonStreamReader::TokenType type = reader.readNext();
+        if (type == QJsonStreamReader::NoToken || type == QJsonStreamReader::Invalid)
+            return;
+        tokens.append(describe(reader));
+    }
+}
+
+void tst_QJsonStreamReader::tokens_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QStringList>("expected");
+
+    QTest::newRow("empty") << QByteArray() << QStringList();
+    QTest::newRow("whitespace") << " \t\r\n"_ba << QStringList();
+    QTest::newRow("empty-object") << "{}"_ba << QStringList{ u"{"_s, u"}"_s };
+    QTest::newRow("empty-array") << "[ ]"_ba << QStringList{ u"["_s, u"]"_s };
+    QTest::newRow("object")
+            << R"({"a": 1, "b": [true, false, null], "c": {"d": "e"}})"_ba
+            << QStringList{ u"{"_s, u"a:"_s, u"1"_s, u"b:"_s, u"["_s, u"true"_s, u"false"_s,
+                            u"null"_s, u"]"_s, u"c:"_s, u"{"_s, u"d:"_s, u"\"e\""_s, u"}"_s,
+                            u"}"_s };
+    QTest::newRow("numbers")
+            << "[0, -1, 1.5, 1e3, 9223372036854775807, 1e300, -0.25]"_ba
+            << QStringList{ u"["_s, u"0"_s, u"-1"_s, u"d:1.5"_s, u"1000"_s,
+                            u"9223372036854775807"_s, u"d:1e+300"_s, u"d:-0.25"_s, u"]"_s };
+    QTest::newRow("strings")
+            << "[\"\", \"plain\", \"tab\\tquote\\\"\", \"\\u00e9\\ud83d\\ude00\", \"\xc3\xbc\"]"_ba
+            << QStringList{ u"["_s, u"\"\""_s, u"\"plain\""_s, u"\"tab\tquote\"\""_s,
+                            u"\"é\U0001F600\""_s, u"\"ü\""_s, u"]"_s };
+    QTest::newRow("whitespace-everywhere")
+            << " \t\r\n[ 1 ,\n 2 ]\n{ \"a\" : \"b\" }\n"_ba
+            << QStringList{ u"["_s, u"1"_s, u"2"_s, u"]"_s, u"{"_s, u"a:"_s, u"\"b\""_s, u"}"_s };
+    QTest::newRow("bom") << "\xef\xbb\xbf[1]"_ba << QStringList{ u"["_s, u"1"_s, u"]"_s };
+    QTest::newRow("top-level-values")
+            << "{\"a\":1}\n{\"a\":2}\n\"x\" true null\n"_ba
+            << QStringList{ u"{"_s, u"a:"_s, u"1"_s, u"}"_s, u"{"_s, u"a:"_s, u"2"_s, u"}"_s,
+                            u"\"x\""_s, u"true"_s, u"null"_s };
+}
+
+void tst_QJsonStreamReader::tokens()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QStringList, expected);
+
+    QStringList tokens;
+    QJsonStreamReader reader(json);
+    readAvailable(reader, tokens);
+    QCOMPARE(tokens, expected);
+    QVERIFY(!reader.hasError());
+    QVERIFY(reader.atEnd());
+    QCOMPARE(reader.depth(), 0);
+
+    QBuffer buffer(&json);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    tokens.clear();
+    reader.setDevice(&buffer);
+    readAvailable(reader, tokens);
+    QCOMPARE(tokens, expected);
+    QCOMPARE(reader.error(), QJsonParseError::NoError);
+    QVERIFY(reader.atEnd());
+    QCOMPARE(reader.offset(), json.size());
+}
+
+void tst_QJsonStreamReader::tokensIncremental()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QStringList, expected);
+
+    // feed a byte at a time, so that every token is split
+    QJsonStreamReader reader;
+    QStringList tokens;
+    for (char c : std::as_const(json)) {
+        reader.addData(QByteArrayView(&c, 1));
+        QVERIFY(!reader.atEnd());
+        readAvailable(reader, tokens);
+        QVERIFY(reader.atEnd());
+        QVERIFY(!reader.hasError());
+    }
+    QCOMPARE(tokens, expected);
+}
+
+void tst_QJsonStreamReader::errors_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QJsonParseError::ParseError>("error");
+
+    QTest::newRow("missing-name-separator") << R"({"a" 1})"_ba << QJsonParseError::MissingNameSeparator;
+    QTest::newRow("missing-value-separator") << "[1 2]"_ba << QJsonParseError::MissingValueSeparator;
+    QTest::newRow("missing-member-separator") << R"({"a":1 "b":2})"_ba << QJsonParseError::UnterminatedObject;
+    QTest::newRow("name-not-string") << "{1:2}"_ba << QJsonParseError::UnterminatedObject;
+    QTest::newRow("unterminated-object") << R"({"a":1)"_ba << QJsonParseError::UnterminatedObject;
+    QTest::newRow("unterminated-after-name") << R"({"a")"_ba << QJsonParseError::UnterminatedObject;
+    QTest::newRow("unterminated-array") << "[1,"_ba << QJsonParseError::UnterminatedArray;
+    QTest::newRow("unterminated-string") << R"(["abc)"_ba << QJsonParseError::UnterminatedString;
+    QTest::newRow("truncated-literal") << "tru"_ba << QJsonParseError::IllegalValue;
+    QTest::newRow("wrong-literal") << "[nul]"_ba << QJsonParseError::IllegalValue;
+    QTest::newRow("trailing-comma-array") << "[1,]"_ba << QJsonParseError::MissingObject;
+    QTest::newRow("trailing-comma-object") << R"({"a":1,})"_ba << QJsonParseError::MissingObject;
+    QTest::newRow("leading-comma") << "[,1]"_ba << QJsonParseError::IllegalValue;
+    QTest::newRow("stray-end") << "]"_ba << QJsonParseError::MissingObject;
+    QTest::newRow("garbage") << "[x]"_ba << QJsonParseError::IllegalValue;
+    QTest::newRow("illegal-number") << "[-]"_ba << QJsonParseError::IllegalNumber;
+    QTest::newRow("illegal-escape") << R"(["\u12x4"])"_ba << QJsonParseError::IllegalEscapeSequence;
+    QTest::newRow("truncated-escape") << R"("\u12)"_ba << QJsonParseError::IllegalEscapeSequence;
+    QTest::newRow("illegal-utf8") << "[\"\xff\"]"_ba << QJsonParseError::IllegalUTF8String;
+    QTest::newRow("truncated-utf8") << "[\"\xc3\"]"_ba << QJsonParseError::IllegalUTF8String;
+    QTest::newRow("deep-nesting") << QByteArray(1025, '[') << QJsonParseError::DeepNesting;
+}
+
+void tst_QJsonStreamReader::errors()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QJsonParseError::ParseError, error);
+
+    QBuffer buffer(&json);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader reader(&buffer);
+    QStringList tokens;
+    readAvailable(reader, tokens);
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), error);
+    QVERIFY(reader.hasError());
+    QVERIFY(reader.atEnd());
+    QVERIFY(!reader.errorString().isEmpty());
+
+    // errors are final
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), error);
+}
+
+void tst_QJsonStreamReader::errorOffset()
+{
+    QJsonStreamReader reader(R"({"a" 1})"_ba);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.offset(), 1);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.offset(), 4);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.offset(), 5);
+    QJsonParseError error;
+    error.error = QJsonParseError::MissingNameSeparator;
+    QCOMPARE(reader.errorString(), error.errorString());
+}
+
+void tst_QJsonStreamReader::topLevelNumber()
+{
+    // without a device, more digits could follow
+    QJsonStreamReader reader("42"_ba);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+    QVERIFY(reader.atEnd());
+    reader.addData("7 ");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Integer);
+    QCOMPARE(reader.toInteger(), 427);
+    QCOMPARE(reader.toDouble(), 427.);
+
+    // the end of a file ends the number
+    QByteArray json = "-2.5"_ba;
+    QBuffer buffer(&json);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    reader.setDevice(&buffer);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Double);
+    QCOMPARE(reader.toDouble(), -2.5);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+    QVERIFY(!reader.hasError());
+}
+
+// A sequential device that returns the data it was given so far, like a
+// socket.
+class SequentialDevice : public QIODevice
+{
+public:
+    SequentialDevice() { open(ReadOnly); }
+    void receive(const QByteArray &data) { received += data; }
+
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override
+    { return received.size() + QIODevice::bytesAvailable(); }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override
+    {
+        const qint64 n = qMin<qint64>(maxSize, received.size());
+        memcpy(data, received.constData(), n);
+        received.remove(0, n);
+        return n;
+    }
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+    QByteArray received;
+};
+
+void tst_QJsonStreamReader::sequentialDevice()
+{
+    SequentialDevice device;
+    QJsonStreamReader reader(&device);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+    QVERIFY(reader.atEnd());
+
+    device.receive(R"({"name": "va)"_ba);
+    QVERIFY(!reader.atEnd());
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.text(), u"name");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+    QVERIFY(reader.atEnd());
+
+    // a sequential device cannot tell the data is incomplete
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+    QVERIFY(!reader.hasError());
+
+    device.receive(R"(lue"})"_ba);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QCOMPARE(reader.text(), u"value");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+}
+
+void tst_QJsonStreamReader::longStrings()
+{
+    // strings longer than what the reader reads at a time, with escape
+    // sequences and multi-byte characters at every position relative to
+    // the chunks
+    const QString unit = u"abcé€\U0001F600\n\"\\"_s;
+    QString expected;
+    while (expected.size() < 70000)
+        expected += unit;
+
+    QJsonArray array;
+    for (int i = 0; i < 3; ++i)
+        array.append(expected.mid(i));
+    QByteArray json = QJsonDocument(array).toJson(QJsonDocument::Compact);
+
+    QBuffer buffer(&json);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader reader(&buffer);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    for (int i = 0; i < 3; ++i) {
+        QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+        QCOMPARE(reader.text(), QStringView(expected).mid(i));
+    }
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+    QVERIFY(!reader.hasError());
+}
+
+void tst_QJsonStreamReader::readValue_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QTest::newRow("empty-object") << "{}"_ba;
+    QTest::newRow("empty-array") << "[]"_ba;
+    QTest::newRow("object")
+            << R"({"id": 1, "name": "né", "tags": ["a", "b"], "nested": {"x": 1.5, "y": null}})"_ba;
+    QTest::newRow("duplicate-keys") << R"({"b": 1, "a": 2, "b": 3})"_ba;
+    QTest::newRow("array") << R"([1, "two", [3, [4]], {"five": false}, -6e-1])"_ba;
+}
+
+void tst_QJsonStreamReader::readValue()
+{
+    QFETCH(QByteArray, json);
+
+    const QJsonDocument document = QJsonDocument::fromJson(json);
+    QVERIFY(!document.isNull());
+    const QJsonValue expected = document.isArray() ? QJsonValue(document.array())
+                                                   : QJsonValue(document.object());
+
+    QJsonStreamReader reader(json + '\n');
+    QVERIFY(reader.readNext() == QJsonStreamReader::StartArray
+            || reader.tokenType() == QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readValue(), expected);
+    QCOMPARE(reader.tokenType(), document.isArray() ? QJsonStreamReader::EndArray
+                                                    : QJsonStreamReader::EndObject);
+    QCOMPARE(reader.depth(), 0);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+    QVERIFY(!reader.hasError());
+}
+
+void tst_QJsonStreamReader::readValueNested()
+{
+    QJsonStreamReader reader(R"({"a": [1, 2], "b": {"c": true}, "d": "text", "e": 7})"_ba);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.readValue(), QJsonValue(QJsonArray{ 1, 2 }));
+    QCOMPARE(reader.depth(), 1);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.text(), u"b");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readValue(), QJsonValue(QJsonObject{ { u"c"_s, true } }));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QCOMPARE(reader.readValue(), QJsonValue(u"text"_s));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.readValue(), QJsonValue(QJsonValue::Undefined));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Integer);
+    QCOMPARE(reader.readValue(), QJsonValue(7));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndObject);
+}
+
+void tst_QJsonStreamReader::readValueIncomplete()
+{
+    QJsonStreamReader reader;
+    reader.addData(R"({"a": [1, 2)");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readValue(), QJsonValue(QJsonValue::Undefined));
+    QVERIFY(!reader.hasError());
+    QVERIFY(reader.atEnd());
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.depth(), 1);
+
+    reader.addData(R"(, 3], "b": "c"})");
+    QCOMPARE(reader.readValue(),
+             QJsonValue(QJsonObject{ { u"a"_s, QJsonArray{ 1, 2, 3 } }, { u"b"_s, u"c"_s } }));
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.depth(), 0);
+}
+
+void tst_QJsonStreamReader::skipCurrentValue()
+{
+    QJsonStreamReader reader(R"({"skip": {"x": [1, {"y": 2}]}, "keep": 3, "scalar": "s"})"_ba);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QVERIFY(reader.skipCurrentValue());
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+
+    reader.clear();
+    reader.addData(R"({"skip": {"x": [1, {"y": 2}]}, "keep": 3, "scalar": "s"})");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QVERIFY(!reader.skipCurrentValue());
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QVERIFY(reader.skipCurrentValue());
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.depth(), 1);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.text(), u"keep");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Integer);
+    QVERIFY(reader.skipCurrentValue());
+    QCOMPARE(reader.toInteger(), 3);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QCOMPARE(reader.text(), u"s");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndObject);
+}
+
+void tst_QJsonStreamReader::skipCurrentValueIncremental()
+{
+    QJsonStreamReader reader;
+    reader.addData(R"([{"a": [1, 2, )");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QVERIFY(!reader.skipCurrentValue());
+    QVERIFY(reader.atEnd());
+    QVERIFY(!reader.hasError());
+
+    reader.addData(R"(3], "b": {"c": "d"}}, "after"])");
+    QVERIFY(reader.skipCurrentValue());
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.depth(), 1);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::String);
+    QCOMPARE(reader.text(), u"after");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndArray);
+}
+
+void tst_QJsonStreamReader::jsonLines()
+{
+    QByteArray json;
+    for (int i = 0; i < 2000; ++i)
+        json += R"({"id": )" + QByteArray::number(i) + R"(, "payload": ")" + QByteArray(i % 50, 'p') + "\"}\n";
+
+    QBuffer buffer(&json);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader reader(&buffer);
+    int count = 0;
+    while (reader.readNext() == QJsonStreamReader::StartObject) {
+        const QJsonObject object = reader.readValue().toObject();
+        QCOMPARE(object.value("id").toInteger(), count);
+        QCOMPARE(object.value("payload").toString().size(), count % 50);
+        ++count;
+    }
+    QCOMPARE(count, 2000);
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::NoToken);
+    QVERIFY(!reader.hasError());
+    QVERIFY(reader.atEnd());
+}
+
+QTEST_APPLESS_MAIN(tst_QJsonStreamReader)
+#include "tst_qjsonstreamreader.moc"
@@ -0,0 +1,332 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QJsonStreamWriter>
+
+#include <QBuffer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonStreamReader>
+#include <QTest>
+
+#include <limits>
+
+using namespace Qt::StringLiterals;
+
+class tst_QJsonStreamWriter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void matchesDocument_data();
+    void matchesDocument();
+    void appendJsonValue_data() { matchesDocument_data(); }
+    void appendJsonValue();
+    void strings_data();
+    void strings();
+    void numbers();
+    void topLevelValues();
+    void flushToDevice();
+    void misuse();
+    void roundTrip();
+};
+
+// Writes value token by token.
+static void write(QJsonStreamWriter &writer, const QJsonValue &value)
+{
+    switch (value.type()) {
+    case QJsonValue::Array:
+        writer.startArray();
+        for (const QJsonValue &element : value.toArray())
+            write(writer, element);
+        QVERIFY(writer.endArray());
+        break;
+    case QJsonValue::Object: {
+        writer.startObject();
+        const QJsonObject object = value.toObject();
+        for (auto it = object.begin(); it != object.end(); ++it) {
+            writer.append(it.key());
+            write(writer, it.value());
+        }
+        QVERIFY(writer.endObject());
+        break;
+    }
+    case QJsonValue::String:
+        writer.append(value.toString());
+        break;
+    case QJsonValue::Double:
+        if (value.toInteger(-1) == value.toInteger(0))
+            writer.append(value.toInteger());
+        else
+            writer.append(value.toDouble());
+        break;
+    case QJsonValue::Bool:
+        writer.append(value.toBool());
+        break;
+    case QJsonValue::Null:
+    case QJsonValue::Undefined:
+        writer.append(nullptr);
+        break;
+    }
+}
+
+void tst_QJsonStreamWriter::matchesDocument_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QJsonDocument::JsonFormat>("format");
+
+    const QByteArray documents[] = {
+        "{}"_ba,
+        "[]"_ba,
+        R"({"a": [], "b": {}, "c": [{}], "d": [[]]})"_ba,
+        R"([1, -2, 3.25, 1e300, true, false, null, "text"])"_ba,
+        R"({"id": 1, "name": "né \"quoted\"\n", "tags": ["x", "y"],
+            "nested": {"deeper": {"deepest": [1, [2, [3]]]}}})"_ba,
+    };
+    for (const QByteArray &json : documents) {
+        QTest::addRow("compact:%s", json.left(20).constData()) << json << QJsonDocument::Compact;
+        QTest::addRow("indented:%s", json.left(20).constData()) << json << QJsonDocument::Indented;
+    }
+}
+
+// The same text as toJson(), with a newline after the value.
+static QByteArray expectedText(const QJsonDocument &document, QJsonDocument::JsonFormat format)
+{
+    QByteArray expected = document.toJson(format);
+    if (format == QJsonDocument::Compact)
+        expected += '\n';
+    return expected;
+}
+
+void tst_QJsonStreamWriter::matchesDocument()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QJsonDocument::JsonFormat, format);
+
+    const QJsonDocument document = QJsonDocument::fromJson(json);
+    QVERIFY(!document.isNull());
+    const QJsonValue value = document.isArray() ? QJsonValue(document.array())
+                                                : QJsonValue(document.object());
+
+    QByteArray output;
+    {
+        QJsonStreamWriter writer(&output);
+        QCOMPARE(writer.format(), QJsonDocument::Indented);
+        writer.setFormat(format);
+        QCOMPARE(writer.format(), format);
+        write(writer, value);
+    }
+    QCOMPARE(output, expectedText(document, format));
+}
+
+void tst_QJsonStreamWriter::appendJsonValue()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QJsonDocument::JsonFormat, format);
+
+    const QJsonDocument document = QJsonDocument::fromJson(json);
+    const QJsonValue value = document.isArray() ? QJsonValue(document.array())
+                                                : QJsonValue(document.object());
+
+    // at the top level
+    QByteArray output;
+    QJsonStreamWriter writer(&output);
+    writer.setFormat(format);
+    writer.append(value);
+    QCOMPARE(output, expectedText(document, format));
+
+    // nested in a streamed array and object, with the same indentation
+    output.clear();
+    writer.startArray();
+    writer.startObject();
+    writer.append("key");
+    writer.append(value);
+    writer.endObject();
+    writer.endArray();
+
+    QByteArray expected;
+    QJsonStreamWriter tokenWriter(&expected);
+    tokenWriter.setFormat(format);
+    write(tokenWriter, QJsonArray{ QJsonObject{ { u"key"_s, value } } });
+    QCOMPARE(output, expected);
+}
+
+void tst_QJsonStreamWriter::strings_data()
+{
+    QTest::addColumn<QString>("string");
+
+    QTest::newRow("empty") << QString();
+    QTest::newRow("ascii") << u"plain ASCII text"_s;
+    QTest::newRow("escapes") << u"quote\" backslash\\ newline\n tab\t nul"_s + QChar(0) + u'\x1f';
+    QTest::newRow("latin1") << u"café ü"_s;
+    QTest::newRow("non-latin1") << u"€ \U0001F600"_s;
+    QTest::newRow("delete") << u"\x7f"_s;
+}
+
+void tst_QJsonStreamWriter::strings()
+{
+    QFETCH(QString, string);
+
+    const QByteArray expected = QJsonDocument(QJsonArray{ string }).toJson(QJsonDocument::Compact) + '\n';
+
+    // the result does not depend on the encoding of the string
+    QByteArray output;
+    QJsonStreamWriter writer(&output);
+    writer.setFormat(QJsonDocument::Compact);
+    writer.startArray();
+    writer.append(QStringView(string));
+    writer.endArray();
+    QCOMPARE(output, expected);
+
+    output.clear();
+    const QByteArray utf8 = string.toUtf8();
+    writer.startArray();
+    writer.append(QUtf8StringView(utf8));
+    writer.endArray();
+    QCOMPARE(output, expected);
+
+    // object member names too
+    output.clear();
+    writer.startObject();
+    writer.append(QUtf8StringView(utf8));
+    writer.append(string);
+    writer.endObject();
+    QCOMPARE(output, QJsonDocument(QJsonObject{ { string, string } }).toJson(QJsonDocument::Compact) + '\n');
+
+    const bool isLatin1 = std::all_of(string.cbegin(), string.cend(),
+                                      [](QChar c) { return c.unicode() < 0x100; });
+    if (isLatin1) {
+        output.clear();
+        const QByteArray latin1 = string.toLatin1();
+        writer.startArray();
+        writer.append(QLatin1StringView(latin1));
+        writer.endArray();
+        QCOMPARE(output, expected);
+    }
+}
+
+void tst_QJsonStreamWriter::numbers()
+{
+    QByteArray output;
+    QJsonStreamWriter writer(&output);
+    writer.setFormat(QJsonDocument::Compact);
+    writer.startArray();
+    writer.append(0);
+    writer.append(-1);
+    writer.append(std::numeric_limits<qint64>::max());
+    writer.append(1.0);
+    writer.append(-0.1);
+    writer.append(1e300);
+    writer.append(qInf());
+    writer.append(qQNaN());
+    writer.endArray();
+    QCOMPARE(output, "[0,-1,9223372036854775807,1,-0.1,1e+300,null,null]\n"_ba);
+}
+
+void tst_QJsonStreamWriter::topLevelValues()
+{
+    QByteArray output;
+    QJsonStreamWriter writer(&output);
+    writer.setFormat(QJsonDocument::Compact);
+    for (int i = 0; i < 3; ++i) {
+        writer.startObject();
+        writer.append("id");
+        writer.append(i);
+        writer.endObject();
+    }
+    writer.append("text");
+    writer.append(true);
+    writer.appendNull();
+    QCOMPARE(output, "{\"id\":0}\n{\"id\":1}\n{\"id\":2}\n\"text\"\ntrue\nnull\n"_ba);
+}
+
+void tst_QJsonStreamWriter::flushToDevice()
+{
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    {
+        QJsonStreamWriter writer(&buffer);
+        QCOMPARE(writer.device(), &buffer);
+        writer.setFormat(QJsonDocument::Compact);
+
+        // small values are buffered until the top-level value ends
+        writer.startArray();
+        writer.append("first");
+        QCOMPARE(buffer.size(), 0);
+
+        // large ones are passed on as they are written
+        const QString text(1000, u'x');
+        for (int i = 0; i < 100; ++i)
+            writer.append(text);
+        QVERIFY(buffer.size() > 0);
+        QVERIFY(buffer.size() < 100 * 1000);
+
+        writer.endArray();
+        QCOMPARE(buffer.size(), 100 * 1003 + 10);
+
+        writer.append(42);
+        QCOMPARE(buffer.data().right(3), "42\n"_ba);
+
+        writer.startArray();
+        writer.append(1);
+        writer.flush();
+        QVERIFY(buffer.data().endsWith("[1"));
+        writer.append(2);
+    }
+    // the destructor flushes
+    QVERIFY(buffer.data().endsWith("[1,2"));
+}
+
+void tst_QJsonStreamWriter::misuse()
+{
+    QByteArray output;
+    QJsonStreamWriter writer(&output);
+    writer.setFormat(QJsonDocument::Compact);
+    QVERIFY(!writer.endArray());
+    QVERIFY(!writer.endObject());
+
+    writer.startObject();
+    QTest::ignoreMessage(QtWarningMsg,
+                         "QJsonStreamWriter: the name of an object member must be a string");
+    writer.append(1);
+    QVERIFY(!writer.endArray());
+    writer.append("name");
+    QVERIFY(!writer.endObject());     // the value is missing
+    writer.append(QJsonValue(u"value"_s));
+    QVERIFY(writer.endObject());
+    QCOMPARE(output, "{\"name\":\"value\"}\n"_ba);
+}
+
+void tst_QJsonStreamWriter::roundTrip()
+{
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::ReadWrite));
+    {
+        QJsonStreamWriter writer(&buffer);
+        writer.setFormat(QJsonDocument::Compact);
+        for (int i = 0; i < 1000; ++i) {
+            writer.startObject();
+            writer.append("id");
+            writer.append(i);
+            writer.append("name");
+            writer.append(u"né %1"_s.arg(i));
+            writer.endObject();
+        }
+    }
+
+    QVERIFY(buffer.seek(0));
+    QJsonStreamReader reader(&buffer);
+    int count = 0;
+    while (reader.readNext() == QJsonStreamReader::StartObject) {
+        const QJsonObject object = reader.readValue().toObject();
+        QCOMPARE(object.value("id").toInteger(), count);
+        QCOMPARE(object.value("name").toString(), u"né %1"_s.arg(count));
+        ++count;
+    }
+    QCOMPARE(count, 1000);
+    QVERIFY(!reader.hasError());
+}
+
+QTEST_APPLESS_MAIN(tst_QJsonStreamWriter)
+#include "tst_qjsonstreamwriter.moc"
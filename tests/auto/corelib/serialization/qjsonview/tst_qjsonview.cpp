@@ -0,0 +1,373 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QJsonView>
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryFile>
+#include <QTest>
+#include <QThread>
+
+#include <memory>
+
+using namespace Qt::StringLiterals;
+
+class tst_QJsonView : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void undefined();
+    void matchesDocument_data();
+    void matchesDocument();
+    void strings_data();
+    void strings();
+    void numbers_data();
+    void numbers();
+    void lookup();
+    void malformed_data();
+    void malformed();
+    void nestingLimit();
+    void mappedFile();
+    void threads();
+};
+
+// Compares everything the view can tell about the value with the value.
+static void compare(const QJsonView &view, const QJsonValue &value)
+{
+    QCOMPARE(view.type(), value.type());
+    switch (value.type()) {
+    case QJsonValue::Bool:
+        QCOMPARE(view.toBool(), value.toBool());
+        break;
+    case QJsonValue::Double:
+        QCOMPARE(view.toDouble(), value.toDouble());
+        QCOMPARE(view.toInteger(-1), value.toInteger(-1));
+        QCOMPARE(view.toInt(-1), value.toInt(-1));
+        break;
+    case QJsonValue::String:
+        QCOMPARE(view.toString(), value.toString());
+        break;
+    case QJsonValue::Array: {
+        const QJsonArray array = value.toArray();
+        QCOMPARE(view.size(), array.size());
+        for (qsizetype i = 0; i < array.size(); ++i) {
+            compare(view.at(i), array.at(i));
+            if (QTest::currentTestFailed())
+                return;
+        }
+        QVERIFY(view.at(array.size()).isUndefined());
+        break;
+    }
+    case QJsonValue::Object: {
+        // the members of a QJsonObject are sorted, those of the view are not
+        const QJsonObject object = value.toObject();
+        QCOMPARE(view.size(), object.size());
+        for (auto it = object.begin(); it != object.end(); ++it) {
+            compare(view.value(it.key()), it.value());
+            if (QTest::currentTestFailed())
+                return;
+        }
+        for (qsizetype i = 0; i < view.size(); ++i)
+            QVERIFY(object.contains(view.keyAt(i).toString()));
+        QVERIFY(view.keyAt(object.size()).isUndefined());
+        break;
+    }
+    case QJsonValue::Null:
+    case QJsonValue::Undefined:
+        break;
+    }
+}
+
+// Parses any value, including the ones QJsonDocument does not accept at
+// the top level.
+static QJsonValue parse(const QByteArray &json)
+{
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson("[" + json + "]", &error);
+    if (error.error != QJsonParseError::NoError)
+        return QJsonValue::Undefined;
+    return document.array().at(0);
+}
+
+void tst_QJsonView::undefined()
+{
+    const QJsonView view;
+    QVERIFY(view.isUndefined());
+    QCOMPARE(view.offset(), -1);
+    QCOMPARE(view.size(), 0);
+    QVERIFY(view.at(0).isUndefined());
+    QVERIFY(view["key"].isUndefined());
+    QCOMPARE(view.toInteger(42), 42);
+    QVERIFY(view.toStringView().isNull());
+    QCOMPARE(view.toString(u"default"_s), u"default"_s);
+    QCOMPARE(view.toJsonValue(), QJsonValue::Undefined);
+
+    QVERIFY(QJsonView::fromJson({}).isUndefined());
+    QVERIFY(QJsonView::fromJson(" \n\t ").isUndefined());
+    QVERIFY(QJsonView::fromJson("\xef\xbb\xbf").isUndefined());
+}
+
+void tst_QJsonView::matchesDocument_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QTest::newRow("empty-array") << "[]"_ba;
+    QTest::newRow("empty-object") << "{}"_ba;
+    QTest::newRow("spaced-empty") << "[ { } , [ ] ]"_ba;
+    QTest::newRow("scalars") << R"([1, -2, 3.25, 1e300, true, false, null, "text"])"_ba;
+    QTest::newRow("object") << R"({"b": 1, "a": [2, {"c": "d"}], "e": {}})"_ba;
+    QTest::newRow("indented") << QJsonDocument::fromJson(
+            R"({"id": 1, "tags": ["x", "y"], "nested": {"deeper": {"deepest": [1, [2, [3]]]}}})")
+            .toJson(QJsonDocument::Indented);
+    QTest::newRow("escapes") << R"({"quote\"d": "back\\slash", "é": "😀\n"})"_ba;
+    QTest::newRow("non-ascii") << R"(["né", "€", "😀"])"_ba;
+    QTest::newRow("top-level-number") << "42"_ba;
+    QTest::newRow("top-level-string") << R"("top")"_ba;
+    QTest::newRow("top-level-literal") << "false"_ba;
+    QTest::newRow("bom") << "\xef\xbb\xbf [1]"_ba;
+
+    QByteArray large = "[";
+    for (int i = 0; i < 1000; ++i)
+        large += R"({"id": %1, "name": "item %1"},)"_ba.replace("%1", QByteArray::number(i));
+    large.back() = ']';
+    QTest::newRow("large") << large;
+}
+
+void tst_QJsonView::matchesDocument()
+{
+    QFETCH(QByteArray, json);
+
+    const QJsonValue value = parse(json.startsWith("\xef\xbb\xbf") ? json.mid(3) : json);
+    QVERIFY(!value.isUndefined());
+
+    const QJsonView view = QJsonView::fromJson(json);
+    compare(view, value);
+    if (QTest::currentTestFailed())
+        return;
+    QCOMPARE(view.toJsonValue(), value);
+
+    // once more, now that the containers are indexed
+    compare(view, value);
+}
+
+void tst_QJsonView::strings_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QString>("string");
+    QTest::addColumn<bool>("isView");
+
+    QTest::newRow("empty") << R"("")"_ba << u""_s << true;
+    QTest::newRow("ascii") << R"("plain")"_ba << u"plain"_s << true;
+    QTest::newRow("utf8") << R"("né €")"_ba << u"né €"_s << true;
+    QTest::newRow("escapes") << R"("a\"b\\c\/d\n\t")"_ba << u"a\"b\\c/d\n\t"_s << false;
+    QTest::newRow("unicode-escape") << R"("caf\u00e9")"_ba << u"café"_s << false;
+    QTest::newRow("surrogates") << R"("\ud83d\ude00!")"_ba << u"\U0001F600!"_s << false;
+    QTest::newRow("escape-first") << R"("\n")"_ba << u"\n"_s << false;
+}
+
+void tst_QJsonView::strings()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QString, string);
+    QFETCH(bool, isView);
+
+    const QJsonView view = QJsonView::fromJson(json);
+    QVERIFY(view.isString());
+    QCOMPARE(view.toString(), string);
+    QCOMPARE(view.toJsonValue(), QJsonValue(string));
+    QCOMPARE(!view.toStringView().isNull(), isView);
+    if (isView) {
+        QCOMPARE(view.toStringView(), QUtf8StringView(string.toUtf8()));
+        QCOMPARE(view.toStringView().data(), json.constData() + 1);
+    }
+}
+
+void tst_QJsonView::numbers_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QTest::newRow("zero") << "0"_ba;
+    QTest::newRow("negative") << "-1"_ba;
+    QTest::newRow("fraction") << "1.5"_ba;
+    QTest::newRow("integral-fraction") << "2.0"_ba;
+    QTest::newRow("exponent") << "1e3"_ba;
+    QTest::newRow("negative-exponent") << "-25E-1"_ba;
+    QTest::newRow("int-max") << "2147483647"_ba;
+    QTest::newRow("beyond-int") << "2147483648"_ba;
+    QTest::newRow("int64-max") << "9223372036854775807"_ba;
+    QTest::newRow("beyond-int64") << "9223372036854775808"_ba;
+    QTest::newRow("huge") << "1e300"_ba;
+}
+
+void tst_QJsonView::numbers()
+{
+    QFETCH(QByteArray, json);
+
+    const QJsonValue value = parse(json);
+    QVERIFY(value.isDouble());
+
+    // alone, and followed by something, which QJsonView does not look at
+    const QByteArray texts[] = { json, json + ",", json + " ]" };
+    for (const QByteArray &text : texts) {
+        const QJsonView view = QJsonView::fromJson(text);
+        compare(view, value);
+        if (QTest::currentTestFailed())
+            return;
+        QCOMPARE(view.toJsonValue(), value);
+    }
+}
+
+void tst_QJsonView::lookup()
+{
+    const QByteArray json = R"({"b": 1, "a": [10, 20, 30], "é": 3, "a\u0062": "escaped",
+                                "dup": 1, "dup": 2, "obj": {"x": {"y": true}}})"_ba;
+    const QJsonView view = QJsonView::fromJson(json);
+
+    QCOMPARE(view.size(), 7);
+    QCOMPARE(view.keyAt(0).toStringView(), QUtf8StringView("b"));
+    QCOMPARE(view.keyAt(3).toString(), u"ab"_s);
+    QCOMPARE(view.valueAt(0).toInt(), 1);
+
+    QCOMPARE(view.value(u"b").toInt(), 1);
+    QCOMPARE(view["b"].toInt(), 1);
+    QCOMPARE(view[u"b"_s].toInt(), 1);
+    QCOMPARE(view["a"][1].toInt(), 20);
+    QCOMPARE(view["a"].at(2).toInt(), 30);
+    QCOMPARE(view["é"].toInt(), 3);
+    QCOMPARE(view[u"é"].toInt(), 3);
+    QCOMPARE(view[QLatin1StringView("\xe9")].toInt(), 3);
+    QCOMPARE(view["ab"].toString(), u"escaped"_s);
+    QCOMPARE(view["dup"].toInt(), 2);            // the last one, as in QJsonObject
+    QVERIFY(view["obj"]["x"]["y"].toBool());
+
+    QVERIFY(view["missing"].isUndefined());
+    QVERIFY(view[0].isUndefined());             // not an array
+    QVERIFY(view["a"][3].isUndefined());
+    QVERIFY(view["a"][-1].isUndefined());
+    QVERIFY(view["a"]["b"].isUndefined());      // not an object
+    QVERIFY(view["b"][0].isUndefined());
+    QVERIFY(view.keyAt(-1).isUndefined());
+
+    QCOMPARE(view["a"].toJsonValue(), QJsonValue(QJsonArray{ 10, 20, 30 }));
+}
+
+void tst_QJsonView::malformed_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QJsonValue::Type>("type");
+    QTest::addColumn<qsizetype>("size");
+
+    QTest::newRow("garbage") << "garbage"_ba << QJsonValue::Undefined << qsizetype(0);
+    QTest::newRow("closing-bracket") << "]"_ba << QJsonValue::Undefined << qsizetype(0);
+    QTest::newRow("truncated-literal") << "tru"_ba << QJsonValue::Undefined << qsizetype(0);
+    QTest::newRow("minus") << "-"_ba << QJsonValue::Undefined << qsizetype(0);
+    QTest::newRow("unterminated-string") << R"("abc)"_ba << QJsonValue::String << qsizetype(0);
+    QTest::newRow("truncated-escape") << R"("a\)"_ba << QJsonValue::String << qsizetype(0);
+    QTest::newRow("unterminated-array") << "[1, 3"_ba << QJsonValue::Array << qsizetype(2);
+    QTest::newRow("missing-comma") << "[1 2]"_ba << QJsonValue::Array << qsizetype(1);
+    QTest::newRow("mismatched-bracket") << "[1, [2}, 3]"_ba << QJsonValue::Array << qsizetype(1);
+    QTest::newRow("bad-element") << "[1, x, 3]"_ba << QJsonValue::Array << qsizetype(1);
+    QTest::newRow("missing-value") << R"({"a": 1, "b"})"_ba << QJsonValue::Object << qsizetype(1);
+    QTest::newRow("non-string-key") << R"({"a": 1, 2: 3})"_ba << QJsonValue::Object << qsizetype(1);
+    QTest::newRow("unterminated-object") << R"({"a": 1)"_ba << QJsonValue::Object << qsizetype(1);
+}
+
+void tst_QJsonView::malformed()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QJsonValue::Type, type);
+    QFETCH(qsizetype, size);
+
+    // the elements that precede malformed text are available
+    const QJsonView view = QJsonView::fromJson(json);
+    QCOMPARE(view.type(), type);
+    QCOMPARE(view.size(), size);
+    for (qsizetype i = 0; i < size; ++i)
+        QCOMPARE(view.isArray() ? view.at(i).toInt() : view.valueAt(i).toInt(), 1 + 2 * i);
+    QVERIFY(view.at(size).isUndefined());
+    QVERIFY(view.valueAt(size).isUndefined());
+    QVERIFY(view.toStringView().isNull());
+    QCOMPARE(view.toString(u"default"_s), u"default"_s);
+    QCOMPARE(view.toJsonValue(), QJsonValue::Undefined);
+}
+
+void tst_QJsonView::nestingLimit()
+{
+    const auto nested = [](int depth) {
+        return QByteArray(depth, '[') + QByteArray(depth, ']');
+    };
+
+    QByteArray json = nested(1000);
+    QJsonView view = QJsonView::fromJson(json);
+    for (int i = 0; i < 999; ++i) {
+        QCOMPARE(view.size(), 1);
+        view = view.at(0);
+    }
+    QVERIFY(view.isArray());
+    QCOMPARE(view.size(), 0);
+
+    // deeper nesting is not followed, instead of exhausting the stack
+    json = nested(100000);
+    view = QJsonView::fromJson(json);
+    QVERIFY(view.isArray());
+    QCOMPARE(view.size(), 0);
+}
+
+void tst_QJsonView::mappedFile()
+{
+    QJsonObject object;
+    for (int i = 0; i < 100; ++i)
+        object.insert(u"key %1"_s.arg(i), QJsonArray{ i, u"value %1"_s.arg(i) });
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    const QByteArray json = QJsonDocument(object).toJson();
+    QCOMPARE(file.write(json), json.size());
+    QVERIFY(file.flush());
+
+    uchar *data = file.map(0, file.size());
+    QVERIFY(data);
+    {
+        const QJsonView view = QJsonView::fromJson(QByteArrayView(data, file.size()));
+        compare(view, object);
+        const QJsonView value = view["key 42"][1];
+        QCOMPARE(value.toStringView(), QUtf8StringView("value 42"));
+        QCOMPARE(value.toStringView().data(),
+                 reinterpret_cast<const char *>(data) + value.offset() + 1);
+    }
+    QVERIFY(file.unmap(data));
+}
+
+void tst_QJsonView::threads()
+{
+    QJsonArray array;
+    for (int i = 0; i < 200; ++i)
+        array.append(QJsonObject{ { u"id"_s, i }, { u"children"_s, QJsonArray{ i, i + 1, i + 2 } } });
+    const QByteArray json = QJsonDocument(array).toJson(QJsonDocument::Compact);
+
+    // the views share the index of the containers, which the threads build
+    // at the same time
+    const QJsonView view = QJsonView::fromJson(json);
+    std::unique_ptr<QThread> threads[4];
+    qint64 sums[4] = {};
+    for (int t = 0; t < 4; ++t) {
+        threads[t].reset(QThread::create([&view, sum = &sums[t]] {
+            for (qsizetype i = 0; i < view.size(); ++i) {
+                const QJsonView children = view[i]["children"];
+                for (qsizetype j = 0; j < children.size(); ++j)
+                    *sum += children[j].toInteger();
+            }
+        }));
+        threads[t]->start();
+    }
+    for (const auto &thread : threads)
+        QVERIFY(thread->wait());
+    for (qint64 sum : sums)
+        QCOMPARE(sum, 3 * (199 * 200 / 2) + 3 * 200);
+}
+
+QTEST_APPLESS_MAIN(tst_QJsonView)
+#include "tst_qjsonview.moc"
@@ -24,6 +24,8 @@ private slots:
     void overloads();
     void interface();
     void indexIn();
+    void everyPosition_data();
+    void everyPosition();
     void staticByteArrayMatcher();
     void haystacksWithMoreThan4GiBWork();
 };
@@ -152,6 +154,53 @@ void tst_QByteArrayMatcher::indexIn()
     QCOMPARE(matcher.indexIn(haystack, 34), -1);
 }
 
+void tst_QByteArrayMatcher::everyPosition_data()
+{
+    QTest::addColumn<QByteArray>("needle");
+
+    QTest::newRow("2") << QByteArray("ab");
+    QTest::newRow("3") << QByteArray("aba");
+    QTest::newRow("17") << QByteArray("abcdefghijklmnopq");
+    QTest::newRow("40") << QByteArray("the quick brown fox jumps over a lazy do");
+    QTest::newRow("binary") << QByteArray("\0\xff\0", 3);
+}
+
+// Places the needle at every position of haystacks of every length up to
+// a few vectors and compares with a plain search
+void tst_QByteArrayMatcher::everyPosition()
+{
+    QFETCH(QByteArray, needle);
+
+    const QByteArrayMatcher matcher(needle);
+    const auto expected = [&](QByteArrayView haystack, qsizetype from) -> qsizetype {
+        for (qsizetype i = from; i <= haystack.size() - needle.size(); ++i) {
+            if (haystack.sliced(i, needle.size()) == needle)
+                return i;
+        }
+        return -1;
+    };
+
+    for (qsizetype length = 0; length < 100; ++length) {
+        // a haystack with near misses: only the first and the last byte
+        // of the needle
+        QByteArray haystack(length, '.');
+        for (qsizetype i = 0; i + needle.size() <= length; i += needle.size() + 1) {
+            haystack[i] = needle.front();
+            haystack[i + needle.size() - 1] = needle.back();
+        }
+        for (qsizetype pos = 0; pos + needle.size() <= length; ++pos) {
+            QByteArray h = haystack;
+            h.replace(pos, needle.size(), needle);
+            for (qsizetype from : { qsizetype(0), pos, pos + 1 }) {
+                const qsizetype result = expected(h, from);
+                QCOMPARE(matcher.indexIn(h, from), result);
+                QCOMPARE(h.indexOf(needle, from), result);
+            }
+        }
+        QCOMPARE(matcher.indexIn(haystack), expected(haystack, 0));
+    }
+}
+
 void tst_QByteArrayMatcher::staticByteArrayMatcher()
 {
     {
@@ -0,0 +1,247 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtCore/qsmallstring.h>
+
+#include <QHash>
+#include <QTest>
+
+#include <private/qcomparisontesthelper_p.h>
+
+using namespace Qt::StringLiterals;
+
+static_assert(sizeof(QSmallString) == sizeof(QString));
+static_assert(sizeof(QSmallByteArray) == sizeof(QByteArray));
+static_assert(QSmallByteArray::inlineCapacity() >= 15);
+static_assert(QSmallString::inlineCapacity() >= 4);
+static_assert(std::is_nothrow_move_constructible_v<QSmallString>);
+static_assert(QTypeInfo<QSmallString>::isRelocatable);
+static_assert(std::is_convertible_v<QSmallString, QStringView>);
+static_assert(std::is_convertible_v<QSmallByteArray, QByteArrayView>);
+
+class tst_QSmallString : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void defaultConstructed();
+    void construct_data();
+    void construct();
+    void fromContainer();
+    void copyAndMove();
+    void append();
+    void appendSelf();
+    void assignAndClear();
+    void compare();
+    void hash();
+    void heterogeneousLookup();
+};
+
+void tst_QSmallString::defaultConstructed()
+{
+    QSmallString string;
+    QVERIFY(string.isInline());
+    QVERIFY(string.isEmpty());
+    QCOMPARE(string.size(), 0);
+    QVERIFY(string.data());
+    QCOMPARE(string.data()[0], u'\0');
+    QCOMPARE(string.toString(), QString(u""_s));
+
+    QSmallByteArray bytes;
+    QVERIFY(bytes.isInline());
+    QCOMPARE(bytes.size(), 0);
+    QCOMPARE(bytes.constData(), "");
+}
+
+void tst_QSmallString::construct_data()
+{
+    QTest::addColumn<qsizetype>("size");
+    QTest::addColumn<bool>("byteInline");
+    QTest::addColumn<bool>("stringInline");
+
+    const qsizetype byteCapacity = QSmallByteArray::inlineCapacity();
+    const qsizetype stringCapacity = QSmallString::inlineCapacity();
+    for (qsizetype size : { qsizetype(1), stringCapacity, stringCapacity + 1,
+                            byteCapacity, byteCapacity + 1, qsizetype(1000) }) {
+        QTest::addRow("%lld", qlonglong(size))
+                << size << (size <= byteCapacity) << (size <= stringCapacity);
+    }
+}
+
+void tst_QSmallString::construct()
+{
+    QFETCH(qsizetype, size);
+    QFETCH(bool, byteInline);
+    QFETCH(bool, stringInline);
+
+    QByteArray source;
+    for (qsizetype i = 0; i < size; ++i)
+        source.append(char('a' + i % 26));
+
+    const QSmallByteArray bytes(QByteArrayView{source});
+    QCOMPARE(bytes.isInline(), byteInline);
+    QCOMPARE(bytes.size(), size);
+    QCOMPARE(bytes.view(), source);
+    QCOMPARE(bytes.toByteArray(), source);
+    QCOMPARE(bytes.constData()[size], '\0');
+    QCOMPARE(bytes.at(size - 1), source.back());
+
+    const QString text = QString::fromLatin1(source);
+    const QSmallString string(QStringView{text});
+    QCOMPARE(string.isInline(), stringInline);
+    QCOMPARE(string.size(), size);
+    QCOMPARE(string.view(), text);
+    QCOMPARE(string.toString(), text);
+    QCOMPARE(string.data()[size], u'\0');
+    QCOMPARE(QStringView(string.end() - 1, 1), text.right(1));
+}
+
+void tst_QSmallString::fromContainer()
+{
+    // a long container is shared rather than copied
+    const QString longText = u"a string too long for the inline buffer"_s.repeated(2);
+    const QSmallString string(longText);
+    QVERIFY(!string.isInline());
+    QVERIFY(QStringView(string).data() == longText.constData());
+    QVERIFY(string.toString().constData() == longText.constData());
+
+    // and moved from, if possible
+    QByteArray longBytes = QByteArray(100, 'x');
+    const char *data = longBytes.constData();
+    const QSmallByteArray bytes(std::move(longBytes));
+    QVERIFY(!bytes.isInline());
+    QVERIFY(bytes.constData() == data);
+
+    const QSmallString shortString(u"key"_s);
+    QVERIFY(shortString.isInline());
+    QCOMPARE(shortString, u"key");
+}
+
+void tst_QSmallString::copyAndMove()
+{
+    const QString longText(100, u'y');
+    for (const QString &text : { u"abc"_s, longText }) {
+        QSmallString original(text);
+        QSmallString copy = original;
+        QCOMPARE(copy, text);
+        QCOMPARE(copy.isInline(), original.isInline());
+
+        QSmallString moved = std::move(original);
+        QCOMPARE(moved, text);
+        QVERIFY(original.isEmpty()); // NOLINT(bugprone-use-after-move)
+
+        QSmallString assigned(u"other"_s);
+        assigned = copy;
+        QCOMPARE(assigned, text);
+        assigned = std::move(moved);
+        QCOMPARE(assigned, text);
+
+        QSmallString swapped;
+        swapped.swap(assigned);
+        QCOMPARE(swapped, text);
+        QVERIFY(assigned.isEmpty());
+    }
+}
+
+void tst_QSmallString::append()
+{
+    QSmallByteArray bytes;
+    QByteArray expected;
+    for (int i = 0; i < 40; ++i) {
+        const QByteArray part = QByteArray::number(i);
+        bytes += part;
+        expected += part;
+        QCOMPARE(bytes, expected);
+        QCOMPARE(bytes.isInline(), expected.size() <= QSmallByteArray::inlineCapacity());
+        QCOMPARE(bytes.constData()[bytes.size()], '\0');
+    }
+
+    QSmallString string(u"ab"_s);
+    string.append(u"cd").append(u"");
+    QVERIFY(string.isInline());
+    QCOMPARE(string, u"abcd");
+    string.append(QString(50, u'e'));
+    QVERIFY(!string.isInline());
+    QCOMPARE(string, u"abcd"_s + QString(50, u'e'));
+}
+
+void tst_QSmallString::appendSelf()
+{
+    QSmallString string(u"abc"_s);
+    string.append(string.view());
+    QCOMPARE(string, u"abcabc");
+    string.append(string.view().mid(1, 2));
+    QCOMPARE(string, u"abcabcbc");
+
+    // growing out of the inline buffer with a part of it
+    QSmallByteArray bytes(QByteArrayView("0123456789"));
+    bytes.append(bytes.view());
+    bytes.append(bytes.view());
+    QCOMPARE(bytes, "0123456789012345678901234567890123456789");
+    QVERIFY(!bytes.isInline());
+    bytes.append(bytes.view().first(10));
+    QCOMPARE(bytes.size(), 50);
+}
+
+void tst_QSmallString::assignAndClear()
+{
+    QSmallString string(QString(30, u'z'));
+    string.assign(u"short");
+    QVERIFY(string.isInline());
+    QCOMPARE(string, u"short");
+    string.assign(string.view().sliced(1));
+    QCOMPARE(string, u"hort");
+
+    string.assign(QString(30, u'z'));
+    QVERIFY(!string.isInline());
+    string.clear();
+    QVERIFY(string.isInline());
+    QVERIFY(string.isEmpty());
+}
+
+void tst_QSmallString::compare()
+{
+    const QSmallString abc(u"abc"_s);
+    const QSmallString abd(u"abd"_s);
+    QT_TEST_ALL_COMPARISON_OPS(abc, abd, Qt::strong_ordering::less);
+    QT_TEST_ALL_COMPARISON_OPS(abc, QSmallString(u"abc"_s), Qt::strong_ordering::equal);
+    QT_TEST_ALL_COMPARISON_OPS(abc, u"abc"_s, Qt::strong_ordering::equal);
+    QT_TEST_ALL_COMPARISON_OPS(abd, QStringView(u"abc"), Qt::strong_ordering::greater);
+    QT_TEST_ALL_COMPARISON_OPS(abc, u"abcd", Qt::strong_ordering::less);
+
+    const QSmallByteArray bytes(QByteArrayView("key"));
+    QT_TEST_ALL_COMPARISON_OPS(bytes, "key", Qt::strong_ordering::equal);
+    QT_TEST_ALL_COMPARISON_OPS(bytes, "kez"_ba, Qt::strong_ordering::less);
+    QT_TEST_ALL_COMPARISON_OPS(bytes, QByteArrayView("ke"), Qt::strong_ordering::greater);
+
+    // inline and heap representations compare by content
+    const QString longText(40, u'q');
+    QSmallString heap(longText);
+    QSmallString grown(u"qq"_s);
+    grown.append(QString(38, u'q'));
+    QT_TEST_ALL_COMPARISON_OPS(heap, grown, Qt::strong_ordering::equal);
+}
+
+void tst_QSmallString::hash()
+{
+    const QString text = u"hash me"_s;
+    QCOMPARE(qHash(QSmallString(text), 42), qHash(text, 42));
+    const QByteArray longBytes(64, 'h');
+    QCOMPARE(qHash(QSmallByteArray(longBytes), 7), qHash(longBytes, 7));
+}
+
+void tst_QSmallString::heterogeneousLookup()
+{
+    QHash<QSmallString, int> hash;
+    hash.insert(QSmallString(u"content-type"_s), 1);
+    hash.insert(QSmallString(u"content-length"_s), 2);
+    QCOMPARE(hash.value(QSmallString(u"content-type"_s)), 1);
+#ifdef __cpp_concepts
+    // no key needs to be constructed for the lookup
+    QCOMPARE(hash.value(QStringView(u"content-length")), 2);
+    QVERIFY(!hash.contains(QStringView(u"accept")));
+#endif
+}
+
+QTEST_APPLESS_MAIN(tst_QSmallString)
+#include "tst_qsmallstring.moc"
@@ -4,6 +4,8 @@
 #include <QTest>
 #include <qstringmatcher.h>
 
+using namespace Qt::StringLiterals;
+
 class tst_QStringMatcher : public QObject
 {
     Q_OBJECT
@@ -15,6 +17,10 @@ private slots:
     void indexIn();
     void setCaseSensitivity_data();
     void setCaseSensitivity();
+    void caseFolding_data();
+    void caseFolding();
+    void everyPosition_data();
+    void everyPosition();
     void assignOperator();
 };
 
@@ -135,6 +141,88 @@ void tst_QStringMatcher::setCaseSensitivity()
     QCOMPARE(matcher.indexIn(QStringView(haystack), from), indexIn);
 }
 
+void tst_QStringMatcher::caseFolding_data()
+{
+    QTest::addColumn<QString>("needle");
+    QTest::addColumn<QString>("haystack");
+    QTest::addColumn<int>("indexIn");
+
+    // long enough that the search looks at whole vectors
+    const QString padding(40, u'x');
+    // KELVIN SIGN and LATIN SMALL LETTER LONG S fold to 'k' and 's'
+    QTest::newRow("kelvin-first") << u"kilo"_s << padding + u"\u212Aılo \u212AILO"_s << 45;
+    QTest::newRow("kelvin-last") << u"ok"_s << padding + u"O\u212A"_s << 40;
+    QTest::newRow("long-s-first") << u"SAM"_s << padding + u"\u017Fam"_s << 40;
+    QTest::newRow("long-s-last") << u"gas"_s << padding + u"GA\u017F"_s << 40;
+    QTest::newRow("non-ascii") << u"ÉTÉ"_s << padding + u"un été"_s << 43;
+    QTest::newRow("non-ascii-first") << u"Über"_s << padding + u"über"_s << 40;
+    QTest::newRow("non-ascii-last") << u"café"_s << padding + u"CAFÉ"_s << 40;
+    QTest::newRow("not-a-letter") << u"[a]"_s << padding + u"{A} [A]"_s << 44;
+}
+
+void tst_QStringMatcher::caseFolding()
+{
+    QFETCH(QString, needle);
+    QFETCH(QString, haystack);
+    QFETCH(int, indexIn);
+
+    QStringMatcher matcher(needle, Qt::CaseInsensitive);
+    QCOMPARE(matcher.indexIn(haystack), indexIn);
+    QCOMPARE(haystack.indexOf(needle, 0, Qt::CaseInsensitive), indexIn);
+}
+
+void tst_QStringMatcher::everyPosition_data()
+{
+    QTest::addColumn<QString>("needle");
+    QTest::addColumn<Qt::CaseSensitivity>("cs");
+
+    for (Qt::CaseSensitivity cs : { Qt::CaseSensitive, Qt::CaseInsensitive }) {
+        const char *suffix = cs == Qt::CaseSensitive ? "cs" : "ci";
+        QTest::addRow("2-%s", suffix) << u"ab"_s << cs;
+        QTest::addRow("3-%s", suffix) << u"aBa"_s << cs;
+        QTest::addRow("17-%s", suffix) << u"abcdefghijklmnopQ"_s << cs;
+        QTest::addRow("40-%s", suffix) << u"The quick brown fox jumps over a lazy do"_s << cs;
+    }
+}
+
+// Places the needle at every position of haystacks of every length up to
+// a few vectors and compares with a plain search
+void tst_QStringMatcher::everyPosition()
+{
+    QFETCH(QString, needle);
+    QFETCH(Qt::CaseSensitivity, cs);
+
+    const QStringMatcher matcher(needle, cs);
+    const QString other = cs == Qt::CaseSensitive ? needle : needle.toUpper();
+    const auto expected = [&](QStringView haystack, qsizetype from) -> qsizetype {
+        for (qsizetype i = from; i <= haystack.size() - needle.size(); ++i) {
+            if (haystack.sliced(i, needle.size()).compare(needle, cs) == 0)
+                return i;
+        }
+        return -1;
+    };
+
+    for (qsizetype length = 0; length < 100; ++length) {
+        // a haystack with near misses: only the first and the last
+        // character of the needle
+        QString haystack(length, u'.');
+        for (qsizetype i = 0; i + needle.size() <= length; i += needle.size() + 1) {
+            haystack[i] = needle.front();
+            haystack[i + needle.size() - 1] = needle.back();
+        }
+        for (qsizetype pos = 0; pos + needle.size() <= length; ++pos) {
+            QString h = haystack;
+            h.replace(pos, other.size(), other);
+            for (qsizetype from : { qsizetype(0), pos, pos + 1 }) {
+                const qsizetype result = expected(h, from);
+                QCOMPARE(matcher.indexIn(h, from), result);
+                QCOMPARE(h.indexOf(needle, from, cs), result);
+            }
+        }
+        QCOMPARE(matcher.indexIn(haystack), expected(haystack, 0));
+    }
+}
+
 void tst_QStringMatcher::assignOperator()
 {
     QString needle("d");
@@ -0,0 +1,483 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtCore/qcoroutine.h>
+
+#include <QElapsedTimer>
+#include <QException>
+#include <QPromise>
+#include <QTest>
+#include <QThread>
+
+using namespace std::chrono_literals;
+
+class Emitter : public QObject
+{
+    Q_OBJECT
+signals:
+    void noArguments();
+    void oneArgument(const QString &text);
+    void twoArguments(int number, const QString &text);
+};
+
+class tst_QCoroutine : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void task();
+    void awaitTask();
+    void taskException();
+    void detachedTask();
+    void awaitFinishedFuture();
+    void awaitFutureFromThread();
+    void awaitFutureWithContext();
+    void awaitFutureException();
+    void awaitCanceledFuture();
+    void awaitFutureContextDestroyed();
+    void awaitSignal();
+    void awaitSignalWithArguments();
+    void awaitSignalSenderDestroyed();
+    void readyRead();
+    void delay();
+    void resumeOn();
+};
+
+#if defined(__cpp_lib_coroutine)
+
+// A sequential device whose data is fed by the test.
+class Pipe : public QIODevice
+{
+public:
+    Pipe() { open(QIODevice::ReadOnly); }
+
+    void feed(const QByteArray &data)
+    {
+        buffer += data;
+        emit readyRead();
+    }
+
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override { return buffer.size() + QIODevice::bytesAvailable(); }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override
+    {
+        const qint64 size = qMin(maxSize, qint64(buffer.size()));
+        memcpy(data, buffer.constData(), size);
+        buffer.remove(0, size);
+        return size;
+    }
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+    QByteArray buffer;
+};
+
+void tst_QCoroutine::initTestCase()
+{
+}
+
+static QCoroTask<int> immediate(int value)
+{
+    co_return value;
+}
+
+void tst_QCoroutine::task()
+{
+    QCoroTask<int> task = immediate(42);
+    // the coroutine runs right away, up to its first suspension
+    QVERIFY(task.isFinished());
+
+    QCoroTask<int> moved = std::move(task);
+    QVERIFY(!task.isFinished());
+    QVERIFY(moved.isFinished());
+}
+
+void tst_QCoroutine::awaitTask()
+{
+    Emitter emitter;
+    int result = 0;
+
+    auto inner = [&]() -> QCoroTask<int> {
+        co_await QtCoro::signal(&emitter, &Emitter::noArguments);
+        co_return 2;
+    };
+    auto outer = [&]() -> QCoroTask<> {
+        const int first = co_await immediate(1);
+        const int second = co_await inner();
+        result = first + second;
+    };
+
+    QCoroTask<> task = outer();
+    QVERIFY(!task.isFinished());
+    QCOMPARE(result, 0);
+    emit emitter.noArguments();
+    QVERIFY(task.isFinished());
+    QCOMPARE(result, 3);
+}
+
+void tst_QCoroutine::taskException()
+{
+#ifdef QT_NO_EXCEPTIONS
+    QSKIP("This test requires exception support");
+#else
+    bool caught = false;
+    auto thrower = []() -> QCoroTask<int> {
+        throw QException();
+        co_return 0;
+    };
+    auto catcher = [&]() -> QCoroTask<> {
+        try {
+            co_await thrower();
+        } catch (const QException &) {
+            caught = true;
+        }
+    };
+    QCoroTask<> task = catcher();
+    QVERIFY(task.isFinished());
+    QVERIFY(caught);
+#endif
+}
+
+// Not a capturing lambda: the frame outlives the task, and with it the closure
+static QCoroTask<> waitForNoArguments(Emitter *emitter, bool *finished)
+{
+    co_await QtCoro::signal(emitter, &Emitter::noArguments);
+    *finished = true;
+}
+
+void tst_QCoroutine::detachedTask()
+{
+    // a task that is destroyed before the coroutine finishes does not stop it
+    Emitter emitter;
+    bool finished = false;
+    {
+        QCoroTask<> task = waitForNoArguments(&emitter, &finished);
+        QVERIFY(!task.isFinished());
+    }
+    QVERIFY(!finished);
+    emit emitter.noArguments();
+    QVERIFY(finished);
+}
+
+void tst_QCoroutine::awaitFinishedFuture()
+{
+    QCoroTask<int> task = [&]() -> QCoroTask<int> {
+        co_return co_await QtFuture::makeReadyValueFuture(7);
+    }();
+    QVERIFY(task.isFinished());
+
+    int value = 0;
+    auto awaiter = [&]() -> QCoroTask<> { value = co_await std::move(task); };
+    QCoroTask<> second = awaiter();
+    QVERIFY(second.isFinished());
+    QCOMPARE(value, 7);
+}
+
+void tst_QCoroutine::awaitFutureFromThread()
+{
+    QPromise<QString> promise;
+    QFuture<QString> future = promise.future();
+    QString result;
+    QThread *resumedIn = nullptr;
+
+    auto coroutine = [&]() -> QCoroTask<> {
+        result = co_await future;
+        resumedIn = QThread::currentThread();
+    };
+    QCoroTask<> task = coroutine();
+    QVERIFY(!task.isFinished());
+
+    // without a context, the coroutine resumes in the thread finishing the future
+    std::unique_ptr<QThread> thread(QThread::create([&promise] {
+        promise.start();
+        promise.addResult(QStringLiteral("done"));
+        promise.finish();
+    }));
+    thread->start();
+    QVERIFY(thread->wait());
+
+    QVERIFY(task.isFinished());
+    QCOMPARE(result, QStringLiteral("done"));
+    QCOMPARE(resumedIn, thread.get());
+}
+
+void tst_QCoroutine::awaitFutureWithContext()
+{
+    QPromise<int> promise;
+    QFuture<int> future = promise.future();
+    int result = 0;
+    QThread *resumedIn = nullptr;
+
+    auto coroutine = [&]() -> QCoroTask<> {
+        result = co_await QtCoro::await(future, this);
+        resumedIn = QThread::currentThread();
+    };
+    QCoroTask<> task = coroutine();
+
+    std::unique_ptr<QThread> thread(QThread::create([&promise] {
+        promise.start();
+        promise.addResult(5);
+        promise.finish();
+    }));
+    thread->start();
+    QVERIFY(thread->wait());
+
+    // the coroutine resumes in the thread of the context, from its event loop
+    QVERIFY(!task.isFinished());
+    QTRY_VERIFY(task.isFinished());
+    QCOMPARE(result, 5);
+    QCOMPARE(resumedIn, QThread::currentThread());
+}
+
+void tst_QCoroutine::awaitFutureException()
+{
+#ifdef QT_NO_EXCEPTIONS
+    QSKIP("This test requires exception support");
+#else
+    QPromise<void> promise;
+    QFuture<void> future = promise.future();
+    bool caught = false;
+
+    auto coroutine = [&]() -> QCoroTask<> {
+        try {
+            co_await future;
+        } catch (const QException &) {
+            caught = true;
+        }
+    };
+    QCoroTask<> task = coroutine();
+    QVERIFY(!task.isFinished());
+
+    promise.start();
+    promise.setException(QException());
+    promise.finish();
+    QVERIFY(task.isFinished());
+    QVERIFY(caught);
+#endif
+}
+
+void tst_QCoroutine::awaitCanceledFuture()
+{
+#ifdef QT_NO_EXCEPTIONS
+    QSKIP("This test requires exception support");
+#else
+    QPromise<int> promise;
+    QFuture<int> future = promise.future();
+    bool caught = false;
+
+    auto coroutine = [&]() -> QCoroTask<> {
+        try {
+            co_await future;
+        } catch (const QUnhandledException &) {
+            caught = true;
+        }
+    };
+    QCoroTask<> task = coroutine();
+    QVERIFY(!task.isFinished());
+
+    promise.start();
+    future.cancel();
+    promise.finish();
+    QVERIFY(task.isFinished());
+    QVERIFY(caught);
+#endif
+}
+
+void tst_QCoroutine::awaitFutureContextDestroyed()
+{
+#ifdef QT_NO_EXCEPTIONS
+    QSKIP("This test requires exception support");
+#else
+    QPromise<int> promise;
+    QFuture<int> future = promise.future();
+    auto context = std::make_unique<QObject>();
+    bool caught = false;
+
+    auto coroutine = [&]() -> QCoroTask<> {
+        try {
+            co_await QtCoro::await(future, context.get());
+        } catch (const QUnhandledException &) {
+            caught = true;
+        }
+    };
+    QCoroTask<> task = coroutine();
+    QVERIFY(!task.isFinished());
+
+    // the coroutine resumes from the destructor of the context
+    context.reset();
+    QVERIFY(task.isFinished());
+    QVERIFY(caught);
+
+    promise.start();
+    promise.addResult(1);
+    promise.finish();
+#endif
+}
+
+void tst_QCoroutine::awaitSignal()
+{
+    Emitter emitter;
+    int resumed = 0;
+    auto coroutine = [&]() -> QCoroTask<> {
+        for (int i = 0; i < 3; ++i) {
+            co_await QtCoro::signal(&emitter, &Emitter::noArguments);
+            ++resumed;
+        }
+    };
+    QCoroTask<> task = coroutine();
+
+    for (int i = 1; i <= 3; ++i) {
+        QVERIFY(!task.isFinished());
+        emit emitter.noArguments();
+        QCOMPARE(resumed, i);
+    }
+    QVERIFY(task.isFinished());
+    // the connection is gone
+    emit emitter.noArguments();
+    QCOMPARE(resumed, 3);
+}
+
+void tst_QCoroutine::awaitSignalWithArguments()
+{
+    Emitter emitter;
+    QString text;
+    int number = 0;
+    auto coroutine = [&]() -> QCoroTask<> {
+        text = co_await QtCoro::signal(&emitter, &Emitter::oneArgument);
+        std::tie(number, text) = co_await QtCoro::signal(&emitter, &Emitter::twoArguments);
+    };
+    QCoroTask<> task = coroutine();
+
+    emit emitter.oneArgument(QStringLiteral("one"));
+    QCOMPARE(text, QStringLiteral("one"));
+    emit emitter.twoArguments(2, QStringLiteral("two"));
+    QCOMPARE(number, 2);
+    QCOMPARE(text, QStringLiteral("two"));
+    QVERIFY(task.isFinished());
+}
+
+void tst_QCoroutine::awaitSignalSenderDestroyed()
+{
+#ifdef QT_NO_EXCEPTIONS
+    QSKIP("This test requires exception support");
+#else
+    for (const bool withContext : { false, true }) {
+        auto emitter = std::make_unique<Emitter>();
+        bool caught = false;
+        auto coroutine = [&]() -> QCoroTask<> {
+            try {
+                co_await QtCoro::signal(emitter.get(), &Emitter::noArguments,
+                                        withContext ? this : nullptr);
+            } catch (const QUnhandledException &) {
+                caught = true;
+            }
+        };
+        QCoroTask<> task = coroutine();
+        QVERIFY(!task.isFinished());
+
+        emitter.reset();
+        QVERIFY(task.isFinished());
+        QVERIFY(caught);
+    }
+#endif
+}
+
+void tst_QCoroutine::readyRead()
+{
+    Pipe pipe;
+    QByteArrayList chunks;
+    auto coroutine = [&]() -> QCoroTask<> {
+        while (chunks.size() < 3) {
+            if (co_await QtCoro::readyRead(&pipe) > 0)
+                chunks.append(pipe.readAll());
+        }
+    };
+    QCoroTask<> task = coroutine();
+
+    pipe.feed("a");
+    pipe.feed("bc");
+    QVERIFY(!task.isFinished());
+    pipe.feed("def");
+    QVERIFY(task.isFinished());
+    const QByteArrayList expected = { "a", "bc", "def" };
+    QCOMPARE(chunks, expected);
+
+    // data that is already there does not suspend
+    pipe.feed("ready");
+    QByteArray data;
+    task = [&]() -> QCoroTask<> { data = pipe.read(co_await QtCoro::readyRead(&pipe)); }();
+    QVERIFY(task.isFinished());
+    QCOMPARE(data, "ready");
+}
+
+void tst_QCoroutine::delay()
+{
+    QElapsedTimer timer;
+    timer.start();
+    auto coroutine = [&]() -> QCoroTask<> { co_await QtCoro::delay(20ms); };
+    QCoroTask<> task = coroutine();
+    QVERIFY(!task.isFinished());
+    QTRY_VERIFY(task.isFinished());
+    QCOMPARE_GE(timer.durationElapsed(), 20ms);
+}
+
+void tst_QCoroutine::resumeOn()
+{
+    QThread thread;
+    QObject worker;
+    worker.moveToThread(&thread);
+    thread.start();
+
+    QThread *first = nullptr;
+    QThread *second = nullptr;
+    QThread *third = nullptr;
+    auto coroutine = [&]() -> QCoroTask<> {
+        co_await QtCoro::resumeOn(this); // already there
+        first = QThread::currentThread();
+        co_await QtCoro::resumeOn(&worker);
+        second = QThread::currentThread();
+        co_await QtCoro::resumeOn(this);
+        third = QThread::currentThread();
+    };
+    QCoroTask<> task = coroutine();
+    QCOMPARE(first, QThread::currentThread());
+    QTRY_VERIFY(task.isFinished());
+    QCOMPARE(second, &thread);
+    QCOMPARE(third, QThread::currentThread());
+
+    thread.quit();
+    QVERIFY(thread.wait());
+}
+
+#else // __cpp_lib_coroutine
+
+// moc does not see the feature macros, so the slots exist in any case
+void tst_QCoroutine::initTestCase()
+{
+    QSKIP("This test requires C++20 coroutines");
+}
+
+void tst_QCoroutine::task() { }
+void tst_QCoroutine::awaitTask() { }
+void tst_QCoroutine::taskException() { }
+void tst_QCoroutine::detachedTask() { }
+void tst_QCoroutine::awaitFinishedFuture() { }
+void tst_QCoroutine::awaitFutureFromThread() { }
+void tst_QCoroutine::awaitFutureWithContext() { }
+void tst_QCoroutine::awaitFutureException() { }
+void tst_QCoroutine::awaitCanceledFuture() { }
+void tst_QCoroutine::awaitFutureContextDestroyed() { }
+void tst_QCoroutine::awaitSignal() { }
+void tst_QCoroutine::awaitSignalWithArguments() { }
+void tst_QCoroutine::awaitSignalSenderDestroyed() { }
+void tst_QCoroutine::readyRead() { }
+void tst_QCoroutine::delay() { }
+void tst_QCoroutine::resumeOn() { }
+
+#endif // __cpp_lib_coroutine
+
+QTEST_MAIN(tst_QCoroutine)
+#include "tst_qcoroutine.moc"
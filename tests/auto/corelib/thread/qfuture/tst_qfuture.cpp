@@ -29,6 +29,7 @@
 
 #include <forward_list>
 #include <list>
+#include <numeric>
 #include <vector>
 #include <memory>
 #include <set>
@@ -173,6 +174,7 @@ private slots:
     void statePropagation();
     void multipleResults();
     void indexedResults();
+    void indexedResultsFromThreads();
     void progress();
     void setProgressRange();
     void progressWithRange();
@@ -1190,6 +1192,56 @@ void tst_QFuture::indexedResults()
     }
 }
 
+void tst_QFuture::indexedResultsFromThreads()
+{
+    // results reported with an index bypass the mutex while nobody waits
+    // for them; make sure none are lost, duplicated, or reordered
+    enum { ThreadCount = 4, BlockSize = 10, BlocksPerThread = 500 };
+    const int total = ThreadCount * BlocksPerThread * BlockSize;
+
+    QFutureInterface<int> fi;
+    fi.setResultStagingEnabled(true);
+    fi.reportStarted();
+    QFuture<int> f = fi.future();
+
+    std::vector<std::unique_ptr<QThread>> threads;
+    for (int t = 0; t < ThreadCount; ++t) {
+        threads.emplace_back(QThread::create([&fi, t] {
+            for (int block = t; block < ThreadCount * BlocksPerThread; block += ThreadCount) {
+                const int begin = block * BlockSize;
+                if (block % 2) {
+                    QList<int> values(BlockSize);
+                    std::iota(values.begin(), values.end(), begin);
+                    fi.reportResults(values, begin);
+                } else {
+                    for (int i = begin; i < begin + BlockSize; ++i)
+                        fi.reportResult(i, i);
+                }
+            }
+        }));
+    }
+    for (auto &thread : threads)
+        thread->start();
+
+    // waiting for a result while the others are reported
+    QCOMPARE(f.resultAt(total - 1), total - 1);
+    for (auto &thread : threads)
+        QVERIFY(thread->wait());
+
+    QCOMPARE(f.resultCount(), total);
+    fi.reportResult(42, 0); // already there, so it is dropped
+    QCOMPARE(f.resultAt(0), 0);
+    QCOMPARE(f.resultCount(), total);
+
+    fi.reportFinished();
+    QVERIFY(!fi.reportResult(42, total));
+
+    const QList<int> results = f.results();
+    QCOMPARE(results.size(), total);
+    for (int i = 0; i < total; ++i)
+        QCOMPARE(results.at(i), i);
+}
+
 void tst_QFuture::progress()
 {
     QFutureInterface<QChar> result;
@@ -9,11 +9,16 @@
 #include <qcoreapplication.h>
 #include <qelapsedtimer.h>
 #include <qmutex.h>
+#include <qscopeguard.h>
 #include <qthread.h>
 #include <qvarlengtharray.h>
 #include <qwaitcondition.h>
+#include <private/qfutex_p.h>
+#include <private/qmutex_p.h>
 #include <private/qvolatile_p.h>
 
+#include <memory>
+
 using namespace std::chrono_literals;
 
 class tst_QMutex : public QObject
@@ -42,6 +47,9 @@ private slots:
     void tryLockNegative_data();
     void tryLockNegative();
     void moreStress();
+    void spinCount_data();
+    void spinCount();
+    void contentionStatistics();
 };
 
 static const int iterations = 100;
@@ -1191,6 +1199,93 @@ void tst_QMutex::moreStress()
     QCOMPARE(MoreStressTestThread::errorCount.loadRelaxed(), 0);
 }
 
+void tst_QMutex::spinCount_data()
+{
+    QTest::addColumn<int>("maximumSpinCount");
+
+    QTest::newRow("no spinning") << 0;
+    QTest::newRow("default") << QMutexContention::maximumSpinCount();
+    QTest::newRow("long") << 100000;
+}
+
+void tst_QMutex::spinCount()
+{
+    QFETCH(int, maximumSpinCount);
+    const int previous = QMutexContention::maximumSpinCount();
+    auto restore = qScopeGuard([=] { QMutexContention::setMaximumSpinCount(previous); });
+    QMutexContention::setMaximumSpinCount(maximumSpinCount);
+    QCOMPARE(QMutexContention::maximumSpinCount(), maximumSpinCount);
+
+    enum { Iterations = 100000 };
+    QMutex mutex;
+    int counter = 0;
+    std::unique_ptr<QThread> threads[4];
+    for (auto &thread : threads) {
+        thread.reset(QThread::create([&] {
+            for (int i = 0; i < Iterations; ++i) {
+                QMutexLocker locker(&mutex);
+                ++counter;
+            }
+        }));
+        thread->start();
+    }
+    for (auto &thread : threads)
+        QVERIFY(thread->wait(one_minute));
+    QCOMPARE(counter, int(std::size(threads)) * Iterations);
+}
+
+void tst_QMutex::contentionStatistics()
+{
+    if (!QtFutex::futexAvailable())
+        QSKIP("Contention statistics require futexes");
+
+    QMutexContention::setStatisticsEnabled(true);
+    auto disable = qScopeGuard([] { QMutexContention::setStatisticsEnabled(false); });
+    QMutexContention::resetStatistics();
+
+    QMutex mutex;
+    QMutex other;
+    QCOMPARE(QMutexContention::statistics(&mutex).waits, quint64(0));
+
+    // uncontended locking is not recorded
+    mutex.lock();
+    mutex.unlock();
+    QCOMPARE(QMutexContention::statistics(&mutex).waits, quint64(0));
+
+    bool timedOut = false;
+    mutex.lock();
+    std::unique_ptr<QThread> thread(QThread::create([&] {
+        mutex.lock();
+        mutex.unlock();
+        timedOut = !other.tryLock(10ms);
+    }));
+    other.lock();
+    thread->start();
+    // unlock only once the thread sleeps on the mutex
+    QTRY_VERIFY(QMutexContention::hasSleepers(&mutex));
+    mutex.unlock();
+    QVERIFY(thread->wait(one_minute));
+    other.unlock();
+    QVERIFY(timedOut);
+
+    const QMutexContention::Statistics statistics = QMutexContention::statistics(&mutex);
+    QCOMPARE(statistics.waits, quint64(1));
+    QCOMPARE(statistics.sleeps, quint64(1));
+    QCOMPARE_GT(statistics.totalWaitNSecs, quint64(0));
+    QCOMPARE(statistics.maxWaitNSecs, statistics.totalWaitNSecs);
+
+    // a timed out attempt counts as a wait, too
+    QCOMPARE(QMutexContention::statistics(&other).waits, quint64(1));
+
+    const auto mostContended = QMutexContention::mostContended(1);
+    QCOMPARE(mostContended.size(), 1);
+    QCOMPARE(mostContended.first().first, &mutex);
+
+    QMutexContention::resetStatistics();
+    QCOMPARE(QMutexContention::statistics(&mutex).waits, quint64(0));
+    QVERIFY(QMutexContention::mostContended().isEmpty());
+}
+
 
 QTEST_MAIN(tst_QMutex)
 #include "tst_qmutex.moc"
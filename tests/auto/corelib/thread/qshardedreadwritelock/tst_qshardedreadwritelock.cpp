@@ -0,0 +1,189 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QTest>
+#include <QSemaphore>
+#include <QThread>
+
+#include <QtCore/private/qshardedreadwritelock_p.h>
+
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+class tst_QShardedReadWriteLock : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void shardCount();
+    void readersShareTheLock();
+    void writerExcludesEveryone();
+    void waitingWriterBlocksNewReaders();
+    void timedOutWriterReleasesTheLock();
+    void stdLockers();
+    void stress();
+};
+
+template <typename Function>
+static bool inOtherThread(Function function)
+{
+    bool result = false;
+    std::unique_ptr<QThread> thread(QThread::create([&] { result = function(); }));
+    thread->start();
+    thread->wait();
+    return result;
+}
+
+void tst_QShardedReadWriteLock::shardCount()
+{
+    QShardedReadWriteLock lock;
+    const int count = lock.shardCount();
+    QCOMPARE_GE(count, 1);
+    QCOMPARE_LE(count, 64);
+    QCOMPARE(count & (count - 1), 0);
+    if (QThread::idealThreadCount() <= 64)
+        QCOMPARE_GE(count, QThread::idealThreadCount());
+}
+
+void tst_QShardedReadWriteLock::readersShareTheLock()
+{
+    QShardedReadWriteLock lock;
+    lock.lockForRead();
+    QVERIFY(inOtherThread([&] {
+        if (!lock.tryLockForRead())
+            return false;
+        lock.unlock();
+        return true;
+    }));
+    QVERIFY(!inOtherThread([&] { return lock.tryLockForWrite(); }));
+    QVERIFY(!inOtherThread([&] { return lock.tryLockForWrite(QDeadlineTimer(10ms)); }));
+    lock.unlock();
+
+    QVERIFY(inOtherThread([&] {
+        if (!lock.tryLockForWrite())
+            return false;
+        lock.unlock();
+        return true;
+    }));
+}
+
+void tst_QShardedReadWriteLock::writerExcludesEveryone()
+{
+    QShardedReadWriteLock lock;
+    lock.lockForWrite();
+    QVERIFY(!inOtherThread([&] { return lock.tryLockForRead(); }));
+    QVERIFY(!inOtherThread([&] { return lock.tryLockForRead(QDeadlineTimer(10ms)); }));
+    QVERIFY(!inOtherThread([&] { return lock.tryLockForWrite(QDeadlineTimer(10ms)); }));
+    lock.unlock();
+
+    QVERIFY(lock.tryLockForRead());
+    lock.unlock();
+}
+
+void tst_QShardedReadWriteLock::waitingWriterBlocksNewReaders()
+{
+    QShardedReadWriteLock lock;
+    QSemaphore writerStarted;
+    QSemaphore writerLocked;
+    lock.lockForRead();
+
+    std::unique_ptr<QThread> writer(QThread::create([&] {
+        writerStarted.release();
+        lock.lockForWrite();
+        writerLocked.release();
+        lock.unlock();
+    }));
+    writer->start();
+    writerStarted.acquire();
+    QVERIFY(!writerLocked.tryAcquire(1, 50ms));
+
+    // the writer waits for us, so other readers have to wait for the writer
+    QTRY_VERIFY(!inOtherThread([&] {
+        if (!lock.tryLockForRead())
+            return false;
+        lock.unlock();
+        return true;
+    }));
+
+    lock.unlock();
+    QVERIFY(writerLocked.tryAcquire(1, 10s));
+    QVERIFY(writer->wait(10s));
+}
+
+void tst_QShardedReadWriteLock::timedOutWriterReleasesTheLock()
+{
+    QShardedReadWriteLock lock;
+    lock.lockForRead();
+    QVERIFY(!inOtherThread([&] { return lock.tryLockForWrite(QDeadlineTimer(20ms)); }));
+
+    // readers are admitted again
+    QVERIFY(inOtherThread([&] {
+        if (!lock.tryLockForRead())
+            return false;
+        lock.unlock();
+        return true;
+    }));
+    lock.unlock();
+}
+
+void tst_QShardedReadWriteLock::stdLockers()
+{
+    QShardedReadWriteLock lock;
+    {
+        std::shared_lock reader(lock);
+        QVERIFY(reader.owns_lock());
+        std::shared_lock otherReader(lock, std::try_to_lock);
+        QVERIFY(otherReader.owns_lock());
+    }
+    {
+        std::unique_lock writer(lock);
+        QVERIFY(writer.owns_lock());
+        QVERIFY(!inOtherThread([&] { return lock.try_lock_shared(); }));
+    }
+    std::unique_lock writer(lock, std::try_to_lock);
+    QVERIFY(writer.owns_lock());
+}
+
+void tst_QShardedReadWriteLock::stress()
+{
+    enum { Iterations = 20000, WriteInterval = 50 };
+    const int threadCount = qMax(4, QThread::idealThreadCount());
+
+    QShardedReadWriteLock lock;
+    int first = 0;
+    int second = 0;
+    QAtomicInt failures;
+    std::vector<std::unique_ptr<QThread>> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back(QThread::create([&] {
+            for (int i = 0; i < Iterations; ++i) {
+                if (i % WriteInterval == 0) {
+                    lock.lockForWrite();
+                    ++first;
+                    ++second;
+                    lock.unlock();
+                } else {
+                    lock.lockForRead();
+                    if (first != second)
+                        failures.ref();
+                    lock.unlock();
+                }
+            }
+        }));
+    }
+    for (auto &thread : threads)
+        thread->start();
+    for (auto &thread : threads)
+        QVERIFY(thread->wait(60s));
+
+    QCOMPARE(failures.loadRelaxed(), 0);
+    QCOMPARE(first, threadCount * (Iterations / WriteInterval));
+    QCOMPARE(second, first);
+}
+
+QTEST_MAIN(tst_QShardedReadWriteLock)
+#include "tst_qshardedreadwritelock.moc"
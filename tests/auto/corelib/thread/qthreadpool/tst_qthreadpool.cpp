@@ -11,9 +11,14 @@
 #include <qstring.h>
 #include <qmutex.h>
 
+#include <private/qthreadpool_p.h>
+
 #ifdef Q_OS_UNIX
 #include <unistd.h>
 #endif
+#ifdef Q_OS_LINUX
+#include <sched.h>
+#endif
 
 using namespace std::chrono_literals;
 
@@ -88,6 +93,15 @@ private slots:
     void waitForDoneAfterTake();
     void threadReuse();
     void nullFunctions();
+    void workStealing_data();
+    void workStealing();
+    void workStealingPriority();
+    void workStealingTryTake();
+    void numaNodes();
+    void numaNodeLocality();
+    void numaNodeMovesWaitingThread();
+    void threadAffinity_data();
+    void threadAffinity();
 
 private:
     QMutex m_functionTestMutex;
@@ -1488,5 +1502,243 @@ void tst_QThreadPool::nullFunctions()
     }
 }
 
+void tst_QThreadPool::workStealing_data()
+{
+    QTest::addColumn<int>("maxThreadCount");
+    QTest::newRow("1") << 1;
+    QTest::newRow("2") << 2;
+    QTest::newRow("8") << 8;
+}
+
+void tst_QThreadPool::workStealing()
+{
+    QFETCH(int, maxThreadCount);
+
+    TestThreadPool threadPool;
+    threadPool.setMaxThreadCount(maxThreadCount);
+    threadPool.setWorkStealingEnabled(true);
+    QVERIFY(threadPool.isWorkStealingEnabled());
+
+    // every task splits itself until depth 0, so all but the first one are
+    // started from the pool's threads
+    QAtomicInt leaves;
+    std::function<void(int)> split = [&](int depth) {
+        if (depth == 0) {
+            leaves.ref();
+            return;
+        }
+        threadPool.start([&split, depth] { split(depth - 1); });
+        threadPool.start([&split, depth] { split(depth - 1); });
+    };
+    constexpr int Depth = 12;
+    threadPool.start([&split] { split(Depth); });
+    QVERIFY(threadPool.waitForDone());
+    QCOMPARE(leaves.loadRelaxed(), 1 << Depth);
+
+    // the pool can be reused after turning it off again
+    threadPool.setWorkStealingEnabled(false);
+    leaves.storeRelaxed(0);
+    threadPool.start([&split] { split(4); });
+    QVERIFY(threadPool.waitForDone());
+    QCOMPARE(leaves.loadRelaxed(), 1 << 4);
+}
+
+void tst_QThreadPool::workStealingPriority()
+{
+    QSemaphore spawned;
+    QSemaphore go;
+    QAtomicPointer<QRunnable> firstStarted;
+
+    class Runner : public QRunnable
+    {
+    public:
+        QAtomicPointer<QRunnable> &ptr;
+        Runner(QAtomicPointer<QRunnable> &ptr) : ptr(ptr) {}
+        void run() override
+        {
+            ptr.testAndSetRelaxed(nullptr, this);
+        }
+    };
+
+    TestThreadPool threadPool;
+    threadPool.setMaxThreadCount(1);
+    threadPool.setWorkStealingEnabled(true);
+
+    // the runners started from the worker thread go to its local queue
+    threadPool.start([&] {
+        for (int i = 0; i < 3; ++i)
+            threadPool.start(new Runner(firstStarted));
+        spawned.release();
+        go.acquire();
+    });
+    QVERIFY(spawned.tryAcquire(1, 10s));
+
+    QRunnable *expected = new Runner(firstStarted);
+    threadPool.start(expected, 1);
+    go.release();
+    QVERIFY(threadPool.waitForDone());
+    QCOMPARE(firstStarted.loadRelaxed(), expected);
+}
+
+void tst_QThreadPool::workStealingTryTake()
+{
+    QSemaphore spawned;
+    QSemaphore go;
+    QAtomicInt runs;
+
+    TestThreadPool threadPool;
+    threadPool.setMaxThreadCount(1);
+    threadPool.setWorkStealingEnabled(true);
+
+    std::unique_ptr<QRunnable> local(QRunnable::create([&runs] { runs.ref(); }));
+    local->setAutoDelete(false);
+    threadPool.start([&] {
+        threadPool.start(local.get());
+        threadPool.start([&runs] { runs.ref(); });
+        spawned.release();
+        go.acquire();
+    });
+    QVERIFY(spawned.tryAcquire(1, 10s));
+
+    QVERIFY(threadPool.tryTake(local.get()));
+    QVERIFY(!threadPool.tryTake(local.get()));
+    go.release();
+    QVERIFY(threadPool.waitForDone());
+    QCOMPARE(runs.loadRelaxed(), 1);
+}
+
+void tst_QThreadPool::numaNodes()
+{
+    TestThreadPool threadPool;
+    QCOMPARE_GE(threadPool.numaNodeCount(), 1);
+
+    QAtomicInt runs;
+    for (int node = -1; node <= threadPool.numaNodeCount(); ++node)
+        threadPool.startOnNumaNode([&runs] { runs.ref(); }, node);
+    QVERIFY(threadPool.waitForDone());
+    QCOMPARE(runs.loadRelaxed(), threadPool.numaNodeCount() + 2);
+}
+
+void tst_QThreadPool::numaNodeLocality()
+{
+    TestThreadPool threadPool;
+    threadPool.setMaxThreadCount(2);
+    // pretend that the system has two nodes
+    auto d = static_cast<QThreadPoolPrivate *>(QObjectPrivate::get(&threadPool));
+    d->setNumaNodes({ { 0 }, { 0 } });
+    QCOMPARE(threadPool.numaNodeCount(), 2);
+
+    // the threads are spread over the nodes
+    QSemaphore started;
+    QSemaphore go[2];
+    QAtomicInt nodes[2] = { -1, -1 };
+    for (int i = 0; i < 2; ++i) {
+        threadPool.start([&, i] {
+            nodes[i].storeRelaxed(QThreadPoolPrivate::currentThreadNumaNode());
+            started.release();
+            go[i].acquire();
+        });
+    }
+    QVERIFY(started.tryAcquire(2, 10s));
+    QCOMPARE(nodes[0].loadRelaxed(), 0);
+    QCOMPARE(nodes[1].loadRelaxed(), 1);
+
+    // all threads are busy, so these are queued
+    QMutex mutex;
+    QList<int> order;
+    QList<int> ranOn;
+    for (int node : { 1, 0 }) {
+        for (int i = 0; i < 5; ++i) {
+            threadPool.startOnNumaNode([&, node] {
+                QMutexLocker locker(&mutex);
+                order.append(node);
+                ranOn.append(QThreadPoolPrivate::currentThreadNumaNode());
+            }, node);
+        }
+    }
+
+    // the thread of node 0 runs the runnables of its node first, then the
+    // others, since the thread of node 1 is still busy
+    go[0].release();
+    QTRY_COMPARE(order.size(), 10);
+    QCOMPARE(order, QList<int>({ 0, 0, 0, 0, 0, 1, 1, 1, 1, 1 }));
+    QCOMPARE(ranOn, QList<int>(10, 0));
+    go[1].release();
+    QVERIFY(threadPool.waitForDone());
+}
+
+void tst_QThreadPool::numaNodeMovesWaitingThread()
+{
+    TestThreadPool threadPool;
+    threadPool.setMaxThreadCount(1);
+    auto d = static_cast<QThreadPoolPrivate *>(QObjectPrivate::get(&threadPool));
+    d->setNumaNodes({ { 0 }, { 0 } });
+
+    QThread *threads[2] = {};
+    int nodes[2] = { -1, -1 };
+    for (int node : { 0, 1 }) {
+        threadPool.startOnNumaNode([&, node] {
+            threads[node] = QThread::currentThread();
+            nodes[node] = QThreadPoolPrivate::currentThreadNumaNode();
+        }, node);
+        // let the thread wait for more
+        QTRY_COMPARE(threadPool.activeThreadCount(), 0);
+    }
+    QVERIFY(threadPool.waitForDone());
+
+    // the waiting thread of node 0 moved to node 1, rather than another
+    // thread being started
+    QCOMPARE(threads[1], threads[0]);
+    QCOMPARE(nodes[0], 0);
+    QCOMPARE(nodes[1], 1);
+}
+
+void tst_QThreadPool::threadAffinity_data()
+{
+    QTest::addColumn<QThreadPool::ThreadAffinity>("affinity");
+    QTest::newRow("none") << QThreadPool::NoAffinity;
+    QTest::newRow("node") << QThreadPool::NumaNodeAffinity;
+    QTest::newRow("cpu") << QThreadPool::CpuAffinity;
+}
+
+void tst_QThreadPool::threadAffinity()
+{
+    QFETCH(QThreadPool::ThreadAffinity, affinity);
+
+    TestThreadPool threadPool;
+    QCOMPARE(threadPool.threadAffinity(), QThreadPool::NoAffinity);
+    threadPool.setThreadAffinity(affinity);
+    QCOMPARE(threadPool.threadAffinity(), affinity);
+
+#ifdef Q_OS_LINUX
+    const auto cpuCount = [] {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        return sched_getaffinity(0, sizeof(set), &set) == 0 ? CPU_COUNT(&set) : -1;
+    };
+    const int processCpus = cpuCount();
+    QAtomicInt threadCpus;
+    threadPool.startOnNumaNode([&] { threadCpus.storeRelaxed(cpuCount()); }, 0);
+    QVERIFY(threadPool.waitForDone());
+
+    switch (affinity) {
+    case QThreadPool::NoAffinity:
+        QCOMPARE(threadCpus.loadRelaxed(), processCpus);
+        break;
+    case QThreadPool::NumaNodeAffinity:
+        QCOMPARE_GE(threadCpus.loadRelaxed(), 1);
+        QCOMPARE_LE(threadCpus.loadRelaxed(), processCpus);
+        break;
+    case QThreadPool::CpuAffinity:
+        QCOMPARE(threadCpus.loadRelaxed(), 1);
+        break;
+    }
+    // the affinity of the test thread does not change
+    QCOMPARE(cpuCount(), processCpus);
+#else
+    QSKIP("Thread affinity is only supported on Linux");
+#endif
+}
+
 QTEST_MAIN(tst_QThreadPool);
 #include "tst_qthreadpool.moc"
@@ -0,0 +1,264 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtCore/qconcurrenthash.h>
+
+#include <QAtomicInt>
+#include <QList>
+#include <QTest>
+#include <QThread>
+
+#include <memory>
+
+using namespace Qt::StringLiterals;
+
+class tst_QConcurrentHash : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void shardCount_data();
+    void shardCount();
+    void insertAndLookup();
+    void tryInsert();
+    void valueOrInsert();
+    void update();
+    void removeAndTake();
+    void clear();
+    void forEach();
+    void manyItems();
+    void concurrentInsert();
+    void concurrentValueOrInsert();
+    void concurrentReadWriteErase();
+};
+
+void tst_QConcurrentHash::shardCount_data()
+{
+    QTest::addColumn<qsizetype>("requested");
+    QTest::addColumn<qsizetype>("expected");
+    QTest::newRow("1") << qsizetype(1) << qsizetype(1);
+    QTest::newRow("3") << qsizetype(3) << qsizetype(4);
+    QTest::newRow("64") << qsizetype(64) << qsizetype(64);
+    QTest::newRow("too-many") << qsizetype(100000) << qsizetype(256);
+}
+
+void tst_QConcurrentHash::shardCount()
+{
+    QFETCH(qsizetype, requested);
+    QFETCH(qsizetype, expected);
+    QConcurrentHash<int, int> hash(requested);
+    QCOMPARE(hash.shardCount(), expected);
+
+    QConcurrentHash<int, int> defaultHash;
+    QCOMPARE_GE(defaultHash.shardCount(), qMin(4 * QThread::idealThreadCount(), 256));
+    QCOMPARE(qPopulationCount(quint32(defaultHash.shardCount())), 1u);
+}
+
+void tst_QConcurrentHash::insertAndLookup()
+{
+    QConcurrentHash<QString, int> hash;
+    QVERIFY(hash.isEmpty());
+    QVERIFY(!hash.contains(u"one"_s));
+    QCOMPARE(hash.value(u"one"_s), 0);
+    QCOMPARE(hash.value(u"one"_s, -1), -1);
+
+    hash.insert(u"one"_s, 1);
+    hash.insert(u"two"_s, 2);
+    QCOMPARE(hash.size(), 2);
+    QVERIFY(hash.contains(u"one"_s));
+    QCOMPARE(hash.value(u"two"_s), 2);
+
+    // inserting an existing key replaces the value
+    hash.insert(u"one"_s, 10);
+    QCOMPARE(hash.size(), 2);
+    QCOMPARE(hash.value(u"one"_s), 10);
+}
+
+void tst_QConcurrentHash::tryInsert()
+{
+    QConcurrentHash<int, QString> hash;
+    QVERIFY(hash.tryInsert(1, u"a"_s));
+    QVERIFY(!hash.tryInsert(1, u"b"_s));
+    QCOMPARE(hash.value(1), u"a"_s);
+    QCOMPARE(hash.size(), 1);
+}
+
+void tst_QConcurrentHash::valueOrInsert()
+{
+    QConcurrentHash<int, int> hash;
+    int calls = 0;
+    const auto factory = [&calls] { return 100 + calls++; };
+    QCOMPARE(hash.valueOrInsert(1, factory), 100);
+    QCOMPARE(hash.valueOrInsert(1, factory), 100);
+    QCOMPARE(hash.valueOrInsert(2, factory), 101);
+    QCOMPARE(calls, 2);
+
+#ifndef QT_NO_EXCEPTIONS
+    // nothing is inserted if the factory throws
+    QVERIFY_THROWS_EXCEPTION(int, hash.valueOrInsert(3, []() -> int { throw 42; }));
+    QVERIFY(!hash.contains(3));
+    QCOMPARE(hash.size(), 2);
+#endif
+}
+
+void tst_QConcurrentHash::update()
+{
+    QConcurrentHash<int, QList<int>> hash;
+    QVERIFY(!hash.update(1, [](QList<int> &list) { list.append(1); }));
+    QVERIFY(!hash.contains(1));
+
+    hash.insert(1, {});
+    QVERIFY(hash.update(1, [](QList<int> &list) { list.append(1); }));
+    QVERIFY(hash.update(1, [](QList<int> &list) { list.append(2); }));
+    QCOMPARE(hash.value(1), QList<int>({ 1, 2 }));
+}
+
+void tst_QConcurrentHash::removeAndTake()
+{
+    QConcurrentHash<int, std::shared_ptr<int>> hash;
+    hash.insert(1, std::make_shared<int>(1));
+    hash.insert(2, std::make_shared<int>(2));
+
+    QVERIFY(hash.remove(1));
+    QVERIFY(!hash.remove(1));
+    QVERIFY(!hash.contains(1));
+
+    std::optional<std::shared_ptr<int>> taken = hash.take(2);
+    QVERIFY(taken);
+    QCOMPARE(**taken, 2);
+    QCOMPARE(taken->use_count(), 1);
+    QVERIFY(!hash.take(2));
+    QVERIFY(hash.isEmpty());
+}
+
+void tst_QConcurrentHash::clear()
+{
+    QConcurrentHash<int, int> hash(4);
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, i);
+    QCOMPARE(hash.size(), 100);
+    hash.clear();
+    QVERIFY(hash.isEmpty());
+    QVERIFY(!hash.contains(5));
+    QVERIFY(!hash.remove(5));
+
+    // the hash is usable after clear()
+    hash.insert(5, 50);
+    QCOMPARE(hash.value(5), 50);
+    QCOMPARE(hash.size(), 1);
+}
+
+void tst_QConcurrentHash::forEach()
+{
+    QConcurrentHash<int, int> hash;
+    QHash<int, int> expected;
+    for (int i = 0; i < 50; ++i) {
+        hash.insert(i, i * i);
+        expected.insert(i, i * i);
+    }
+
+    QHash<int, int> visited;
+    hash.forEach([&visited](const int &key, const int &value) { visited.insert(key, value); });
+    QCOMPARE(visited, expected);
+    QCOMPARE(hash.toHash(), expected);
+}
+
+void tst_QConcurrentHash::manyItems()
+{
+    // enough items for the tables of the shards to grow, and for removals
+    // to move items back
+    constexpr int Count = 20000;
+    QConcurrentHash<QString, int> hash(8);
+    for (int i = 0; i < Count; ++i)
+        hash.insert(QString::number(i), i);
+    QCOMPARE(hash.size(), Count);
+    for (int i = 0; i < Count; i += 2)
+        QVERIFY(hash.remove(QString::number(i)));
+    QCOMPARE(hash.size(), Count / 2);
+    for (int i = 0; i < Count; ++i)
+        QCOMPARE(hash.value(QString::number(i), -1), i % 2 ? i : -1);
+}
+
+template <typename Function>
+static void runInThreads(int count, Function function)
+{
+    std::vector<std::unique_ptr<QThread>> threads;
+    for (int i = 0; i < count; ++i)
+        threads.emplace_back(QThread::create(function, i));
+    for (auto &thread : threads)
+        thread->start();
+    for (auto &thread : threads)
+        QVERIFY(thread->wait());
+}
+
+void tst_QConcurrentHash::concurrentInsert()
+{
+    constexpr int Threads = 8;
+    constexpr int PerThread = 2000;
+    QConcurrentHash<int, int> hash;
+    runInThreads(Threads, [&hash](int thread) {
+        for (int i = 0; i < PerThread; ++i)
+            hash.insert(thread * PerThread + i, thread);
+    });
+
+    QCOMPARE(hash.size(), Threads * PerThread);
+    for (int i = 0; i < Threads * PerThread; ++i)
+        QCOMPARE(hash.value(i, -1), i / PerThread);
+}
+
+void tst_QConcurrentHash::concurrentValueOrInsert()
+{
+    constexpr int Threads = 8;
+    constexpr int Keys = 500;
+    QConcurrentHash<int, int> hash;
+    QAtomicInt created;
+    QList<QAtomicInt> mismatches(Threads);
+    runInThreads(Threads, [&](int thread) {
+        for (int key = 0; key < Keys; ++key) {
+            const int value = hash.valueOrInsert(key, [&created, key] {
+                created.ref();
+                return key * 3;
+            });
+            if (value != key * 3)
+                mismatches[thread].ref();
+        }
+    });
+
+    // every value was created once, whichever thread came first
+    QCOMPARE(created.loadRelaxed(), Keys);
+    for (const QAtomicInt &count : mismatches)
+        QCOMPARE(count.loadRelaxed(), 0);
+}
+
+void tst_QConcurrentHash::concurrentReadWriteErase()
+{
+    constexpr int Threads = 8;
+    constexpr int Rounds = 2000;
+    QConcurrentHash<QString, int> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(u"stable-%1"_s.arg(i), i);
+
+    QList<QAtomicInt> errors(Threads);
+    runInThreads(Threads, [&](int thread) {
+        for (int round = 0; round < Rounds; ++round) {
+            // keys of this thread come and go while the stable ones stay
+            const QString key = u"thread-%1-%2"_s.arg(thread).arg(round % 50);
+            hash.insert(key, round);
+            if (hash.value(key, -1) != round)
+                errors[thread].ref();
+            const int stable = round % 100;
+            if (hash.value(u"stable-%1"_s.arg(stable), -1) != stable)
+                errors[thread].ref();
+            if (round % 3 == 0 && !hash.remove(key))
+                errors[thread].ref();
+        }
+    });
+
+    for (const QAtomicInt &count : errors)
+        QCOMPARE(count.loadRelaxed(), 0);
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(hash.value(u"stable-%1"_s.arg(i), -1), i);
+}
+
+QTEST_MAIN(tst_QConcurrentHash)
+#include "tst_qconcurrenthash.moc"
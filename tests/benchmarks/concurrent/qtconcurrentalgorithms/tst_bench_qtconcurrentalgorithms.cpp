@@ -0,0 +1,165 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+// before the Qt headers: TBB, which runs the parallel algorithms of
+// libstdc++, has functions called emit
+#ifdef HAVE_STD_EXECUTION
+#include <execution>
+#endif
+
+#include <QRandomGenerator>
+#include <QTest>
+#include <QtConcurrent/qtconcurrentalgorithms.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+class tst_QtConcurrentAlgorithms : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Implementation {
+        Sequential,
+        StdParallel,
+        Concurrent,
+    };
+    Q_ENUM(Implementation)
+
+private slots:
+    void initTestCase();
+
+    void sort_data() { addImplementations(); }
+    void sort();
+    void stableSort_data() { addImplementations(); }
+    void stableSort();
+    void inclusiveScan_data() { addImplementations(); }
+    void inclusiveScan();
+    void transform_data() { addImplementations(); }
+    void transform();
+
+private:
+    void addImplementations();
+
+    QList<double> input;
+};
+
+void tst_QtConcurrentAlgorithms::initTestCase()
+{
+    input.resize(4'000'000);
+    for (double &value : input)
+        value = QRandomGenerator::global()->generateDouble();
+}
+
+void tst_QtConcurrentAlgorithms::addImplementations()
+{
+    QTest::addColumn<Implementation>("implementation");
+    QTest::newRow("sequential") << Sequential;
+#ifdef HAVE_STD_EXECUTION
+    QTest::newRow("std::execution::par") << StdParallel;
+#endif
+    QTest::newRow("QtConcurrent") << Concurrent;
+}
+
+void tst_QtConcurrentAlgorithms::sort()
+{
+    QFETCH(Implementation, implementation);
+
+    QList<double> list;
+    QBENCHMARK {
+        list = input;
+        list.detach();
+        switch (implementation) {
+        case Sequential:
+            std::sort(list.begin(), list.end());
+            break;
+        case StdParallel:
+#ifdef HAVE_STD_EXECUTION
+            std::sort(std::execution::par, list.begin(), list.end());
+#endif
+            break;
+        case Concurrent:
+            QtConcurrent::blockingSort(list.begin(), list.end());
+            break;
+        }
+    }
+    QVERIFY(std::is_sorted(list.cbegin(), list.cend()));
+}
+
+void tst_QtConcurrentAlgorithms::stableSort()
+{
+    QFETCH(Implementation, implementation);
+
+    QList<double> list;
+    QBENCHMARK {
+        list = input;
+        list.detach();
+        switch (implementation) {
+        case Sequential:
+            std::stable_sort(list.begin(), list.end());
+            break;
+        case StdParallel:
+#ifdef HAVE_STD_EXECUTION
+            std::stable_sort(std::execution::par, list.begin(), list.end());
+#endif
+            break;
+        case Concurrent:
+            QtConcurrent::blockingStableSort(list.begin(), list.end());
+            break;
+        }
+    }
+    QVERIFY(std::is_sorted(list.cbegin(), list.cend()));
+}
+
+void tst_QtConcurrentAlgorithms::inclusiveScan()
+{
+    QFETCH(Implementation, implementation);
+
+    QList<double> output(input.size());
+    QBENCHMARK {
+        switch (implementation) {
+        case Sequential:
+            std::inclusive_scan(input.cbegin(), input.cend(), output.begin());
+            break;
+        case StdParallel:
+#ifdef HAVE_STD_EXECUTION
+            std::inclusive_scan(std::execution::par, input.cbegin(), input.cend(), output.begin());
+#endif
+            break;
+        case Concurrent:
+            QtConcurrent::blockingInclusiveScan(input.cbegin(), input.cend(), output.begin());
+            break;
+        }
+    }
+    QCOMPARE_GT(output.last(), 0.0);
+}
+
+void tst_QtConcurrentAlgorithms::transform()
+{
+    QFETCH(Implementation, implementation);
+
+    const auto function = [](double x) { return std::sqrt(x) * std::log1p(x); };
+    QList<double> output(input.size());
+    QBENCHMARK {
+        switch (implementation) {
+        case Sequential:
+            std::transform(input.cbegin(), input.cend(), output.begin(), function);
+            break;
+        case StdParallel:
+#ifdef HAVE_STD_EXECUTION
+            std::transform(std::execution::par, input.cbegin(), input.cend(), output.begin(),
+                           function);
+#endif
+            break;
+        case Concurrent:
+            QtConcurrent::blockingTransform(input.cbegin(), input.cend(), QSpan(output), function);
+            break;
+        }
+    }
+    QCOMPARE(output.first(), function(input.first()));
+}
+
+QTEST_MAIN(tst_QtConcurrentAlgorithms)
+
+#include "tst_bench_qtconcurrentalgorithms.moc"
@@ -0,0 +1,59 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QTest>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <numeric>
+
+class tst_QtConcurrentMap : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void mappedReduced_data();
+    void mappedReduced();
+};
+
+void tst_QtConcurrentMap::mappedReduced_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<QtConcurrent::ReduceOptions>("options");
+
+    const QtConcurrent::ReduceOptions unordered = QtConcurrent::UnorderedReduce;
+    const QtConcurrent::ReduceOptions parallel = QtConcurrent::ParallelReduce;
+    for (int threadCount : { 1, 2, 4, 8, 16 }) {
+        QTest::addRow("unordered-%d", threadCount) << threadCount << unordered;
+        QTest::addRow("parallel-%d", threadCount) << threadCount << parallel;
+    }
+}
+
+void tst_QtConcurrentMap::mappedReduced()
+{
+    QFETCH(int, threadCount);
+    QFETCH(QtConcurrent::ReduceOptions, options);
+
+    QList<int> list(200000);
+    std::iota(list.begin(), list.end(), 0);
+    QThreadPool pool;
+    pool.setMaxThreadCount(threadCount);
+
+    // cheap to map, somewhat expensive to reduce
+    const auto map = [](int x) { return double(x); };
+    const auto reduce = [](double &sum, double x) {
+        for (int i = 0; i < 16; ++i)
+            x = x * 0.5 + 1.0;
+        sum += x;
+    };
+
+    double result = 0;
+    QBENCHMARK {
+        result = QtConcurrent::blockingMappedReduced<double>(&pool, list, map, reduce, options);
+    }
+    QVERIFY(result > 0);
+}
+
+QTEST_MAIN(tst_QtConcurrentMap)
+
+#include "tst_bench_qtconcurrentmap.moc"
@@ -0,0 +1,103 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QTest>
+#include <QtConcurrent/qtconcurrentrun.h>
+#include <QtConcurrent/qtconcurrenttaskgraph.h>
+
+class tst_QtConcurrentTaskGraph : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Implementation {
+        Continuations,
+        TaskGraph,
+    };
+    Q_ENUM(Implementation)
+
+private slots:
+    void chain_data() { addImplementations(); }
+    void chain();
+    void fanOutFanIn_data() { addImplementations(); }
+    void fanOutFanIn();
+
+private:
+    void addImplementations();
+
+    QAtomicInt counter;
+};
+
+static constexpr int TaskCount = 1000;
+
+void tst_QtConcurrentTaskGraph::addImplementations()
+{
+    QTest::addColumn<Implementation>("implementation");
+    QTest::newRow("QFuture::then") << Continuations;
+    QTest::newRow("QTaskGraph") << TaskGraph;
+}
+
+void tst_QtConcurrentTaskGraph::chain()
+{
+    QFETCH(Implementation, implementation);
+
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const auto work = [this] { counter.ref(); };
+    QBENCHMARK {
+        switch (implementation) {
+        case Continuations: {
+            QFuture<void> future = QtConcurrent::run(pool, work);
+            for (int i = 1; i < TaskCount; ++i)
+                future = future.then(pool, work);
+            future.waitForFinished();
+            break;
+        }
+        case TaskGraph: {
+            QtConcurrent::QTaskGraph graph;
+            graph.addTask(work);
+            for (int i = 1; i < TaskCount; ++i)
+                graph.addDependency(graph.addTask(work), i - 1);
+            graph.onThreadPool(*pool).run().waitForFinished();
+            break;
+        }
+        }
+    }
+}
+
+void tst_QtConcurrentTaskGraph::fanOutFanIn()
+{
+    QFETCH(Implementation, implementation);
+
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const auto work = [this] { counter.ref(); };
+    QBENCHMARK {
+        switch (implementation) {
+        case Continuations: {
+            QFuture<void> root = QtConcurrent::run(pool, work);
+            QList<QFuture<void>> branches;
+            for (int i = 0; i < TaskCount; ++i)
+                branches.append(root.then(pool, work));
+            QtFuture::whenAll(branches.begin(), branches.end())
+                    .then(pool, [&](const QList<QFuture<void>> &) { work(); })
+                    .waitForFinished();
+            break;
+        }
+        case TaskGraph: {
+            QtConcurrent::QTaskGraph graph;
+            const auto root = graph.addTask(work);
+            const auto sink = graph.addTask(work);
+            for (int i = 0; i < TaskCount; ++i) {
+                const auto branch = graph.addTask(work);
+                graph.addDependency(branch, root);
+                graph.addDependency(sink, branch);
+            }
+            graph.onThreadPool(*pool).run().waitForFinished();
+            break;
+        }
+        }
+    }
+}
+
+QTEST_MAIN(tst_QtConcurrentTaskGraph)
+
+#include "tst_bench_qtconcurrenttaskgraph.moc"
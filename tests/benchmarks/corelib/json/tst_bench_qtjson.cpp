@@ -1,10 +1,17 @@
 // Copyright (C) 2016 The Qt Company Ltd.
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
 
+#include <QBuffer>
 #include <QTest>
 #include <QVariantMap>
+#include <qjsonarray.h>
 #include <qjsondocument.h>
 #include <qjsonobject.h>
+#include <qjsonstreamreader.h>
+#include <qjsonstreamwriter.h>
+#include <qjsonview.h>
+
+using namespace Qt::StringLiterals;
 
 class BenchmarkQtJson: public QObject
 {
@@ -21,6 +28,18 @@ private Q_SLOTS:
     void parseNumbers();
     void parseJson();
     void parseJsonToVariant();
+    void parseGenerated_data();
+    void parseGenerated();
+    void streamReadGenerated_data() { parseGenerated_data(); }
+    void streamReadGenerated();
+    void toJsonGenerated_data() { parseGenerated_data(); }
+    void toJsonGenerated();
+    void streamWriteGenerated_data() { parseGenerated_data(); }
+    void streamWriteGenerated();
+    void viewLookupGenerated_data() { parseGenerated_data(); }
+    void viewLookupGenerated();
+    void viewWalkGenerated_data() { parseGenerated_data(); }
+    void viewWalkGenerated();
 
     void jsonObjectInsert();
     void variantMapInsert();
@@ -93,6 +112,142 @@ void BenchmarkQtJson::parseJsonToVariant()
     }
 }
 
+// Generates an array of event records, the kind of data found in log and
+// event streams: a few megabytes of it.
+static QByteArray generateEvents(bool indented, bool longText, bool escapes)
+{
+    QJsonArray events;
+    for (int i = 0; i < 20000; ++i) {
+        QString message = u"request %1 served"_s.arg(i);
+        if (longText)
+            message += u" after forwarding it to the upstream cluster and waiting for "
+                       "all of the replicas to acknowledge the write"_s.repeated(3);
+        if (escapes)
+            message += u"\n\t\"quoted\" path: C:\\data\\%1"_s.arg(i);
+        events.append(QJsonObject{
+                { "id"_L1, i },
+                { "timestamp"_L1, 1700000000.0 + i / 8.0 },
+                { "level"_L1, i % 10 ? "info"_L1 : "warning"_L1 },
+                { "host"_L1, u"node-%1.example.com"_s.arg(i % 16) },
+                { "message"_L1, message },
+                { "tags"_L1, QJsonArray{ "http"_L1, "frontend"_L1 } },
+                { "success"_L1, i % 7 != 0 },
+        });
+    }
+    return QJsonDocument(events).toJson(indented ? QJsonDocument::Indented
+                                                 : QJsonDocument::Compact);
+}
+
+void BenchmarkQtJson::parseGenerated_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QTest::newRow("compact") << generateEvents(false, false, false);
+    QTest::newRow("indented") << generateEvents(true, false, false);
+    QTest::newRow("long-strings") << generateEvents(false, true, false);
+    QTest::newRow("escapes") << generateEvents(false, false, true);
+}
+
+void BenchmarkQtJson::parseGenerated()
+{
+    QFETCH(QByteArray, json);
+
+    QBENCHMARK {
+        QJsonParseError error;
+        QJsonDocument doc = QJsonDocument::fromJson(json, &error);
+        QCOMPARE(error.error, QJsonParseError::NoError);
+    }
+}
+
+void BenchmarkQtJson::streamReadGenerated()
+{
+    QFETCH(QByteArray, json);
+
+    QBENCHMARK {
+        QBuffer buffer(&json);
+        buffer.open(QIODevice::ReadOnly);
+        QJsonStreamReader reader(&buffer);
+        qsizetype tokens = 0;
+        while (reader.readNext() != QJsonStreamReader::NoToken)
+            ++tokens;
+        QVERIFY(!reader.hasError());
+        QVERIFY(tokens > 0);
+    }
+}
+
+// Reads one value of the document, with a view that is created each time.
+void BenchmarkQtJson::viewLookupGenerated()
+{
+    QFETCH(QByteArray, json);
+
+    QBENCHMARK {
+        const QJsonView view = QJsonView::fromJson(json);
+        QCOMPARE(view[10000]["host"].toStringView(), QUtf8StringView("node-0.example.com"));
+    }
+}
+
+// Reads a member of each object of the document, like parseGenerated()
+// followed by the same loop over the QJsonDocument would.
+void BenchmarkQtJson::viewWalkGenerated()
+{
+    QFETCH(QByteArray, json);
+
+    QBENCHMARK {
+        const QJsonView view = QJsonView::fromJson(json);
+        qint64 sum = 0;
+        for (qsizetype i = 0; i < view.size(); ++i)
+            sum += view[i]["id"].toInteger();
+        QCOMPARE(sum, 19999 * 20000 / 2);
+    }
+}
+
+void BenchmarkQtJson::toJsonGenerated()
+{
+    QFETCH(QByteArray, json);
+    const QJsonDocument doc = QJsonDocument::fromJson(json);
+
+    QBENCHMARK {
+        const QByteArray output = doc.toJson(QJsonDocument::Compact);
+        QVERIFY(!output.isEmpty());
+    }
+}
+
+// Writes the same document as toJsonGenerated(), token by token.
+static void writeValue(QJsonStreamWriter &writer, const QJsonValue &value)
+{
+    if (value.isArray()) {
+        writer.startArray();
+        for (const QJsonValue &element : value.toArray())
+            writeValue(writer, element);
+        writer.endArray();
+    } else if (value.isObject()) {
+        writer.startObject();
+        const QJsonObject object = value.toObject();
+        for (auto it = object.begin(); it != object.end(); ++it) {
+            writer.append(it.key());
+            writeValue(writer, it.value());
+        }
+        writer.endObject();
+    } else {
+        writer.append(value);
+    }
+}
+
+void BenchmarkQtJson::streamWriteGenerated()
+{
+    QFETCH(QByteArray, json);
+    const QJsonArray array = QJsonDocument::fromJson(json).array();
+
+    QBENCHMARK {
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+        QJsonStreamWriter writer(&buffer);
+        writer.setFormat(QJsonDocument::Compact);
+        writeValue(writer, array);
+        QVERIFY(buffer.size() > 0);
+    }
+}
+
 void BenchmarkQtJson::jsonObjectInsert()
 {
     QJsonObject object;
@@ -5,6 +5,9 @@
 #include <qtest.h>
 #include <qtesteventloop.h>
 
+#include <memory>
+#include <vector>
+
 class PingPong : public QObject
 {
 public:
@@ -58,6 +61,37 @@ int EventTester::foo(int bar)
     return bar + 1;
 }
 
+class EventCounter : public QObject
+{
+public:
+    void expect(int count) { m_remaining = count; }
+    void hit()
+    {
+        if (--m_remaining == 0)
+            QTestEventLoop::instance().exitLoop();
+    }
+
+protected:
+    bool event(QEvent *e) override
+    {
+        if (e->type() != QEvent::User)
+            return QObject::event(e);
+        hit();
+        return true;
+    }
+
+private:
+    int m_remaining = 0;
+};
+
+class Emitter : public QObject
+{
+    Q_OBJECT
+
+signals:
+    void value(int);
+};
+
 class EventsBench : public QObject
 {
     Q_OBJECT
@@ -71,6 +105,10 @@ private slots:
     void sendEvent();
     void postEvent_data();
     void postEvent();
+    void postEventFromThreads_data();
+    void postEventFromThreads();
+    void queuedSignalFromThread_data();
+    void queuedSignalFromThread();
 };
 
 void EventsBench::initTestCase()
@@ -145,6 +183,88 @@ void EventsBench::postEvent()
     }
 }
 
+void EventsBench::postEventFromThreads_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<bool>("queuedCall");
+
+    for (int threadCount : { 1, 2, 4, 8, 16 }) {
+        QTest::addRow("queued call, %d threads", threadCount) << threadCount << true;
+        QTest::addRow("user event, %d threads", threadCount) << threadCount << false;
+    }
+}
+
+// Measures many threads posting to the same receiving thread, either queued
+// calls like cross-thread signal emissions or plain events.
+void EventsBench::postEventFromThreads()
+{
+    QFETCH(int, threadCount);
+    QFETCH(bool, queuedCall);
+
+    constexpr int EventsPerThread = 20000;
+    EventCounter counter;
+
+    QBENCHMARK {
+        counter.expect(threadCount * EventsPerThread);
+
+        std::vector<std::unique_ptr<QThread>> threads;
+        for (int i = 0; i < threadCount; ++i) {
+            threads.emplace_back(QThread::create([&counter, queuedCall] {
+                for (int j = 0; j < EventsPerThread; ++j) {
+                    if (queuedCall) {
+                        QMetaObject::invokeMethod(&counter, [&counter] { counter.hit(); },
+                                                  Qt::QueuedConnection);
+                    } else {
+                        QCoreApplication::postEvent(&counter, new QEvent(QEvent::User));
+                    }
+                }
+            }));
+            threads.back()->start();
+        }
+
+        QTestEventLoop::instance().enterLoop(60);
+        QVERIFY(!QTestEventLoop::instance().timeout());
+        for (const auto &thread : threads)
+            thread->wait();
+    }
+}
+
+void EventsBench::queuedSignalFromThread_data()
+{
+    QTest::addColumn<bool>("batched");
+
+    QTest::newRow("queued") << false;
+    QTest::newRow("batched") << true;
+}
+
+// Measures a high-rate signal emitted in a worker thread and received in
+// the main thread.
+void EventsBench::queuedSignalFromThread()
+{
+    QFETCH(bool, batched);
+
+    constexpr int Emissions = 100000;
+    Emitter emitter;
+    EventCounter counter;
+    const auto type = batched ? Qt::ConnectionType(Qt::QueuedConnection | Qt::BatchedConnection)
+                              : Qt::QueuedConnection;
+    connect(&emitter, &Emitter::value, &counter, [&counter](int) { counter.hit(); }, type);
+
+    QBENCHMARK {
+        counter.expect(Emissions);
+
+        std::unique_ptr<QThread> thread(QThread::create([&emitter] {
+            for (int i = 0; i < Emissions; ++i)
+                emit emitter.value(i);
+        }));
+        thread->start();
+
+        QTestEventLoop::instance().enterLoop(60);
+        QVERIFY(!QTestEventLoop::instance().timeout());
+        thread->wait();
+    }
+}
+
 QTEST_MAIN(EventsBench)
 
 #include "tst_bench_events.moc"
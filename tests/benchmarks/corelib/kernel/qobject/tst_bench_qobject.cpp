@@ -154,19 +154,29 @@ void tst_QObject::signal_slot_benchmark()
 void tst_QObject::signal_many_receivers_data()
 {
     QTest::addColumn<int>("receiverCount");
-    QTest::newRow("100 receivers") << 100;
-    QTest::newRow("1 000 receivers") << 1000;
-    QTest::newRow("10 000 receivers") << 10000;
+    QTest::addColumn<bool>("interleaved");
+    for (int count : {1, 10, 100, 1000, 10000}) {
+        QTest::addRow("%d receivers", count) << count << false;
+        // the connections of one signal are spread out over the heap
+        QTest::addRow("%d receivers, interleaved", count) << count << true;
+    }
 }
 
 void tst_QObject::signal_many_receivers()
 {
     QFETCH(int, receiverCount);
+    QFETCH(bool, interleaved);
     Object sender;
+    Object otherSender;
     std::vector<Object> receivers(receiverCount);
 
-    for (Object &receiver : receivers)
+    for (Object &receiver : receivers) {
         QObject::connect(&sender, &Object::signal0, &receiver, &Object::slot0);
+        if (interleaved) {
+            for (int i = 0; i < 4; ++i)
+                QObject::connect(&otherSender, &Object::signal0, &receiver, &Object::slot0);
+        }
+    }
 
     QBENCHMARK {
         sender.emitSignal0();
@@ -0,0 +1,151 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QSocketNotifier>
+#include <QTest>
+
+#include <memory>
+#include <vector>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+// Both variants bypass the Glib dispatcher so that they compare the two
+// QEventDispatcherUNIX backends: rebuilding the poll() array on every
+// iteration versus the persistent epoll(7) registration.
+static bool dispatcherSelected = []() {
+    qputenv("QT_NO_GLIB", "1");
+#ifdef USE_EPOLL
+    qputenv("QT_EVENT_DISPATCHER_EPOLL", "1");
+#endif
+    return true;
+}();
+
+class Pipe
+{
+public:
+    Pipe()
+    {
+        if (::pipe(fds) != 0)
+            fds[0] = fds[1] = -1;
+    }
+    ~Pipe()
+    {
+        if (fds[0] != -1)
+            ::close(fds[0]);
+        if (fds[1] != -1)
+            ::close(fds[1]);
+    }
+    Q_DISABLE_COPY_MOVE(Pipe)
+
+    bool isValid() const { return fds[0] != -1; }
+    int readEnd() const { return fds[0]; }
+    int writeEnd() const { return fds[1]; }
+
+private:
+    int fds[2];
+};
+
+class tst_QSocketNotifier : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void activateOne_data();
+    void activateOne();
+    void toggleEnabled_data();
+    void toggleEnabled();
+
+private:
+    rlim_t maxDescriptors = 0;
+};
+
+void tst_QSocketNotifier::initTestCase()
+{
+    // every notifier needs both ends of a pipe
+    rlimit limit;
+    QCOMPARE(getrlimit(RLIMIT_NOFILE, &limit), 0);
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    QCOMPARE(getrlimit(RLIMIT_NOFILE, &limit), 0);
+    maxDescriptors = limit.rlim_cur;
+}
+
+void tst_QSocketNotifier::activateOne_data()
+{
+    QTest::addColumn<int>("notifierCount");
+    QTest::newRow("1") << 1;
+    QTest::newRow("10") << 10;
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+}
+
+// Measures one wakeup with a single ready descriptor among notifierCount
+// enabled, idle ones.
+void tst_QSocketNotifier::activateOne()
+{
+    QFETCH(int, notifierCount);
+    if (rlim_t(2 * notifierCount + 64) > maxDescriptors)
+        QSKIP("Not enough file descriptors available");
+
+    std::vector<std::unique_ptr<Pipe>> pipes;
+    std::vector<std::unique_ptr<QSocketNotifier>> notifiers;
+    for (int i = 0; i < notifierCount; ++i) {
+        pipes.push_back(std::make_unique<Pipe>());
+        QVERIFY(pipes.back()->isValid());
+        notifiers.push_back(std::make_unique<QSocketNotifier>(pipes.back()->readEnd(),
+                                                              QSocketNotifier::Read));
+    }
+
+    const Pipe &ready = *pipes.back();
+    int activations = 0;
+    connect(notifiers.back().get(), &QSocketNotifier::activated, this, [&] {
+        char c;
+        QCOMPARE(::read(ready.readEnd(), &c, 1), 1);
+        ++activations;
+    });
+
+    const char c = 0;
+    QBENCHMARK {
+        QCOMPARE(::write(ready.writeEnd(), &c, 1), 1);
+        QCoreApplication::processEvents();
+    }
+    QVERIFY(activations > 0);
+}
+
+void tst_QSocketNotifier::toggleEnabled_data()
+{
+    activateOne_data();
+}
+
+// Measures disabling and re-enabling one notifier among notifierCount
+// enabled ones, as done by QAbstractSocket on every read.
+void tst_QSocketNotifier::toggleEnabled()
+{
+    QFETCH(int, notifierCount);
+    if (rlim_t(2 * notifierCount + 64) > maxDescriptors)
+        QSKIP("Not enough file descriptors available");
+
+    std::vector<std::unique_ptr<Pipe>> pipes;
+    std::vector<std::unique_ptr<QSocketNotifier>> notifiers;
+    for (int i = 0; i < notifierCount; ++i) {
+        pipes.push_back(std::make_unique<Pipe>());
+        QVERIFY(pipes.back()->isValid());
+        notifiers.push_back(std::make_unique<QSocketNotifier>(pipes.back()->readEnd(),
+                                                              QSocketNotifier::Read));
+    }
+
+    QSocketNotifier *notifier = notifiers.back().get();
+    QBENCHMARK {
+        notifier->setEnabled(false);
+        notifier->setEnabled(true);
+        QCoreApplication::processEvents();
+    }
+}
+
+QTEST_MAIN(tst_QSocketNotifier)
+
+#include "tst_bench_qsocketnotifier.moc"
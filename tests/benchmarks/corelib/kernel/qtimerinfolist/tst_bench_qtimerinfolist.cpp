@@ -0,0 +1,112 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QtCore/QObject>
+#include <QTest>
+
+#include <QtCore/private/qtimerinfo_unix_p.h>
+
+using namespace std::chrono_literals;
+
+using Backend = QTimerInfoList::Backend;
+
+class tst_QTimerInfoList : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void registerUnregister_data();
+    void registerUnregister();
+    void restart_data() { registerUnregister_data(); }
+    void restart();
+    void timerWait_data() { registerUnregister_data(); }
+    void timerWait();
+
+private:
+    static void fill(QTimerInfoList &list, int count, QObject *receiver);
+};
+
+void tst_QTimerInfoList::registerUnregister_data()
+{
+    QTest::addColumn<Backend>("backend");
+    QTest::addColumn<int>("timerCount");
+
+    for (int count : { 100, 1000, 10000, 100000 }) {
+        QTest::addRow("list-%d", count) << Backend::SortedList << count;
+        QTest::addRow("wheel-%d", count) << Backend::Wheel << count;
+    }
+}
+
+// Registers timerCount timers with idle-timeout-like intervals between
+// 10 and 60 seconds, so that none of them fires during the benchmark.
+void tst_QTimerInfoList::fill(QTimerInfoList &list, int count, QObject *receiver)
+{
+    for (int i = 0; i < count; ++i) {
+        const auto interval = 10s + std::chrono::milliseconds((i * 7919) % 50000);
+        list.registerTimer(Qt::TimerId(i + 1), interval, Qt::CoarseTimer, receiver);
+    }
+}
+
+// Cost of adding and removing one timer while timerCount others are active.
+void tst_QTimerInfoList::registerUnregister()
+{
+    QFETCH(Backend, backend);
+    QFETCH(int, timerCount);
+
+    QObject receiver;
+    QTimerInfoList list(backend);
+    fill(list, timerCount, &receiver);
+
+    const Qt::TimerId id = Qt::TimerId(timerCount + 1);
+    QBENCHMARK {
+        list.registerTimer(id, 30s, Qt::CoarseTimer, &receiver);
+        list.unregisterTimer(id);
+    }
+    QCOMPARE(list.size(), timerCount);
+    list.clearTimers();
+}
+
+// Cost of restarting an existing timer, as done on every activity for
+// per-connection idle timeouts.
+void tst_QTimerInfoList::restart()
+{
+    QFETCH(Backend, backend);
+    QFETCH(int, timerCount);
+
+    QObject receiver;
+    QTimerInfoList list(backend);
+    fill(list, timerCount, &receiver);
+
+    int i = 0;
+    QBENCHMARK {
+        const Qt::TimerId id = Qt::TimerId(i % timerCount + 1);
+        list.unregisterTimer(id);
+        list.registerTimer(id, 30s, Qt::CoarseTimer, &receiver);
+        ++i;
+    }
+    QCOMPARE(list.size(), timerCount);
+    list.clearTimers();
+}
+
+// Cost of one event loop iteration looking for the next timeout and
+// activating the expired timers.
+void tst_QTimerInfoList::timerWait()
+{
+    QFETCH(Backend, backend);
+    QFETCH(int, timerCount);
+
+    QObject receiver;
+    QTimerInfoList list(backend);
+    fill(list, timerCount, &receiver);
+
+    QBENCHMARK {
+        QVERIFY(list.timerWait());
+        list.activateTimers();
+    }
+    QCOMPARE(list.size(), timerCount);
+    list.clearTimers();
+}
+
+QTEST_MAIN(tst_QTimerInfoList)
+
+#include "tst_bench_qtimerinfolist.moc"
@@ -1,8 +1,10 @@
 // Copyright (C) 2023 The Qt Company Ltd.
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
 
+#include <QCborArray>
 #include <QCborMap>
 #include <QCborValue>
+#include <QCborView>
 
 #include <QTest>
 
@@ -51,6 +53,9 @@ private slots:
     void constructString() { doConstruct<QString>(); }
     void constructStringView() { doConstruct<QStringView>(); }
     void constructConstCharPtr() { doConstruct<char>(); }
+
+    void fromCborLookup();
+    void viewLookup();
 };
 
 template <typename Type>
@@ -90,6 +95,35 @@ void tst_QCborValue::doConstruct()
     }
 }
 
+static QByteArray generateRecords()
+{
+    QCborArray records;
+    for (int i = 0; i < 20000; ++i) {
+        records.append(QCborMap{ { QLatin1StringView("id"), i },
+                                 { QLatin1StringView("name"), QString::number(i) },
+                                 { QLatin1StringView("tags"), QCborArray{ "a", "b" } } });
+    }
+    return QCborValue(records).toCbor();
+}
+
+void tst_QCborValue::fromCborLookup()
+{
+    const QByteArray cbor = generateRecords();
+    QBENCHMARK {
+        const QCborValue value = QCborValue::fromCbor(cbor);
+        QCOMPARE(value[10000]["name"].toString(), QLatin1StringView("10000"));
+    }
+}
+
+void tst_QCborValue::viewLookup()
+{
+    const QByteArray cbor = generateRecords();
+    QBENCHMARK {
+        const QCborView view = QCborView::fromCbor(cbor);
+        QCOMPARE(view[10000]["name"].toStringView(), QUtf8StringView("10000"));
+    }
+}
+
 QTEST_MAIN(tst_QCborValue)
 
 #include "tst_bench_qcborvalue.moc"
@@ -0,0 +1,164 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QBuffer>
+#include <QXmlStreamReader>
+
+#include <QTest>
+
+using namespace Qt::StringLiterals;
+
+class tst_QXmlStreamReader : public QObject
+{
+    Q_OBJECT
+private:
+    void corpusData();
+
+private slots:
+    void initTestCase();
+    void readData_data() { corpusData(); }
+    void readData();
+    void readDevice_data() { corpusData(); }
+    void readDevice();
+
+private:
+    QByteArray textFeed;
+    QByteArray attributeFeed;
+    QByteArray indentedFeed;
+    QByteArray nonAsciiFeed;
+};
+
+// A news feed whose items are mostly long paragraphs of text
+static QByteArray generateTextFeed(int items)
+{
+    QByteArray xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<feed>"_ba;
+    for (int i = 0; i < items; ++i) {
+        xml += "<item id=\"" + QByteArray::number(i) + "\"><title>Item number "
+                + QByteArray::number(i) + "</title><body>";
+        for (int j = 0; j < 8; ++j) {
+            xml += "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+                   "tempor incididunt ut labore et dolore magna aliqua. ";
+        }
+        xml += "Fish &amp; chips.</body></item>";
+    }
+    xml += "</feed>\n";
+    return xml;
+}
+
+// Records that carry their data in long attribute values
+static QByteArray generateAttributeFeed(int items)
+{
+    QByteArray xml = "<?xml version=\"1.0\"?>\n<records>"_ba;
+    for (int i = 0; i < items; ++i) {
+        xml += "<record id=\"" + QByteArray::number(i)
+                + "\" name=\"A reasonably long name for record number " + QByteArray::number(i)
+                + "\" description='Quoted with apostrophes, holding a \"double quote\" and "
+                  "enough text to be worth scanning quickly' href=\"https://example.com/"
+                  "records/some/long/path/to/the/record/resource\"/>";
+    }
+    xml += "</records>\n";
+    return xml;
+}
+
+// A deeply indented document, as written by QXmlStreamWriter with
+// autoFormatting, with short text nodes
+static QByteArray generateIndentedFeed(int items)
+{
+    QByteArray xml = "<?xml version=\"1.0\"?>\n<catalog>\n"_ba;
+    for (int i = 0; i < items; ++i) {
+        xml += "    <section>\n"
+               "        <group>\n"
+               "            <entry>\n"
+               "                <key>entry" + QByteArray::number(i) + "</key>\n"
+               "                <value>some value</value>\n"
+               "            </entry>\n"
+               "        </group>\n"
+               "    </section>\n";
+    }
+    xml += "</catalog>\n";
+    return xml;
+}
+
+// Text that is mostly outside of US-ASCII
+static QByteArray generateNonAsciiFeed(int items)
+{
+    QByteArray xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<feed>"_ba;
+    for (int i = 0; i < items; ++i) {
+        xml += "<item lang=\"de\">";
+        for (int j = 0; j < 8; ++j)
+            xml += "Größere Übungen für Bäckereien, Flüsse und Straßen. ";
+        xml += "</item><item lang=\"ru\">";
+        for (int j = 0; j < 8; ++j)
+            xml += "Съешь же ещё этих мягких французских булок, да выпей чаю. ";
+        xml += "</item>";
+    }
+    xml += "</feed>\n";
+    return xml;
+}
+
+void tst_QXmlStreamReader::initTestCase()
+{
+    // each document is a few megabytes
+    textFeed = generateTextFeed(5000);
+    attributeFeed = generateAttributeFeed(20000);
+    indentedFeed = generateIndentedFeed(15000);
+    nonAsciiFeed = generateNonAsciiFeed(3000);
+}
+
+void tst_QXmlStreamReader::corpusData()
+{
+    QTest::addColumn<QByteArray>("xml");
+    QTest::newRow("text") << textFeed;
+    QTest::newRow("attributes") << attributeFeed;
+    QTest::newRow("indented") << indentedFeed;
+    QTest::newRow("non-ascii") << nonAsciiFeed;
+}
+
+static qsizetype readAll(QXmlStreamReader &reader)
+{
+    qsizetype characters = 0;
+    while (!reader.atEnd()) {
+        switch (reader.readNext()) {
+        case QXmlStreamReader::StartElement:
+            for (const QXmlStreamAttribute &attribute : reader.attributes())
+                characters += attribute.value().size();
+            break;
+        case QXmlStreamReader::Characters:
+            characters += reader.text().size();
+            break;
+        default:
+            break;
+        }
+    }
+    return characters;
+}
+
+void tst_QXmlStreamReader::readData()
+{
+    QFETCH(QByteArray, xml);
+
+    QBENCHMARK {
+        QXmlStreamReader reader(xml);
+        const qsizetype characters = readAll(reader);
+        QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+        QVERIFY(characters > 0);
+    }
+}
+
+void tst_QXmlStreamReader::readDevice()
+{
+    QFETCH(QByteArray, xml);
+
+    QBENCHMARK {
+        QBuffer buffer(&xml);
+        QVERIFY(buffer.open(QIODevice::ReadOnly));
+        QXmlStreamReader reader(&buffer);
+        const qsizetype characters = readAll(reader);
+        QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+        QVERIFY(characters > 0);
+    }
+}
+
+QTEST_MAIN(tst_QXmlStreamReader)
+
+#include "tst_bench_qxmlstreamreader.moc"
@@ -1,6 +1,7 @@
 // Copyright (C) 2021 The Qt Company Ltd.
 // Copyright (C) 2016 Intel Corporation.
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+#include <QByteArrayMatcher>
 #include <QDebug>
 #include <QIODevice>
 #include <QFile>
@@ -9,6 +10,8 @@
 #include <qtest.h>
 #include <limits>
 
+using namespace Qt::StringLiterals;
+
 class tst_QByteArray : public QObject
 {
     Q_OBJECT
@@ -34,6 +37,11 @@ private slots:
 
     void operator_assign_char();
     void operator_assign_char_data();
+
+    void indexOf_data();
+    void indexOf();
+    void byteArrayMatcher_data() { indexOf_data(); }
+    void byteArrayMatcher();
 };
 
 void tst_QByteArray::initTestCase()
@@ -327,6 +335,49 @@ void tst_QByteArray::latin1Uppercasing_bitcheck()
     }
 }
 
+void tst_QByteArray::indexOf_data()
+{
+    QTest::addColumn<QByteArray>("haystack");
+    QTest::addColumn<QByteArray>("needle");
+
+    // this file's source code, with the needles appended; they are
+    // upper-cased so that they don't occur in the source code itself
+    const QByteArray haystack = sourcecode + "\nzq: the needle sits in a sentence appended at "
+                                             "the very end of the haystack.\n"_ba.toUpper();
+    const auto addRow = [&](const char *needle) {
+        QTest::addRow("%d", int(qstrlen(needle))) << haystack << QByteArray(needle).toUpper();
+    };
+    addRow("zq");
+    addRow("needle");
+    addRow("sentence appended");
+    addRow("appended at the very end of the haystack");
+}
+
+void tst_QByteArray::indexOf()
+{
+    QFETCH(QByteArray, haystack);
+    QFETCH(QByteArray, needle);
+
+    qsizetype result = -1;
+    QBENCHMARK {
+        result = haystack.indexOf(needle);
+    }
+    QVERIFY(result > 0);
+}
+
+void tst_QByteArray::byteArrayMatcher()
+{
+    QFETCH(QByteArray, haystack);
+    QFETCH(QByteArray, needle);
+
+    const QByteArrayMatcher matcher(needle);
+    qsizetype result = -1;
+    QBENCHMARK {
+        result = matcher.indexIn(haystack);
+    }
+    QVERIFY(result > 0);
+}
+
 void tst_QByteArray::toPercentEncoding_data()
 {
     QTest::addColumn<QByteArray>("plaintext");
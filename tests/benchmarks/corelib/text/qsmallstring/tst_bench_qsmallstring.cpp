@@ -0,0 +1,164 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QSmallString>
+#include <QTest>
+
+#include <atomic>
+#include <vector>
+
+#if defined(__GLIBC__) && !defined(QT_ASAN_ENABLED)
+// Count the allocations of the whole process by interposing malloc() and
+// realloc(); QArrayData allocates with those.
+#  define COUNT_ALLOCATIONS
+static std::atomic<qint64> allocationCount;
+
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+
+extern "C" void *malloc(size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+    if (!ptr)
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+#endif
+
+enum Type { ByteArray, SmallByteArray, String, SmallString };
+
+class tst_QSmallString : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void construct_data();
+    void construct();
+    void constructAllocations_data() { construct_data(); }
+    void constructAllocations();
+};
+
+// Keys like the ones of HTTP headers and JSON objects, which are mostly
+// short.
+static QByteArrayList corpus(const QByteArray &name)
+{
+    static const char *const headers[] = {
+        "Host", "Accept", "Accept-Encoding", "Accept-Language", "Cache-Control",
+        "Connection", "Content-Length", "Content-Type", "Cookie", "Date", "ETag",
+        "If-Modified-Since", "Last-Modified", "Location", "Server", "User-Agent",
+        "Vary", "X-Request-Id", "Strict-Transport-Security", "Access-Control-Allow-Origin",
+    };
+    static const char *const keys[] = {
+        "id", "name", "type", "value", "time", "user", "tags", "x", "y", "width",
+        "height", "url", "created_at", "updated_at", "parent", "children", "count",
+        "enabled", "description", "session_identifier",
+    };
+
+    const auto &words = name == "http-headers" ? headers : keys;
+    QByteArrayList result;
+    for (int i = 0; i < 10000; ++i)
+        result.append(QByteArray(words[i % std::size(words)]));
+    return result;
+}
+
+void tst_QSmallString::construct_data()
+{
+    QTest::addColumn<Type>("type");
+    QTest::addColumn<QByteArray>("corpus");
+
+    for (const char *name : { "http-headers", "json-keys" }) {
+        QTest::addRow("QByteArray:%s", name) << ByteArray << QByteArray(name);
+        QTest::addRow("QSmallByteArray:%s", name) << SmallByteArray << QByteArray(name);
+        QTest::addRow("QString:%s", name) << String << QByteArray(name);
+        QTest::addRow("QSmallString:%s", name) << SmallString << QByteArray(name);
+    }
+}
+
+// Creates a string of type T for every entry of the corpus, as a parser
+// does for the keys it reads.
+template <typename T, typename View>
+static void constructAll(std::vector<T> &result, const std::vector<View> &views)
+{
+    result.clear();
+    for (View view : views) {
+        if constexpr (std::is_same_v<T, QByteArray>)
+            result.push_back(view.toByteArray());
+        else if constexpr (std::is_same_v<T, QString>)
+            result.push_back(view.toString());
+        else
+            result.emplace_back(view);
+    }
+}
+
+template <typename T, typename View>
+static void runConstruct(const QByteArrayList &words, bool countAllocations)
+{
+    QStringList utf16;
+    std::vector<View> views;
+    for (const QByteArray &word : words) {
+        if constexpr (std::is_same_v<View, QStringView>)
+            utf16.append(QString::fromLatin1(word));
+    }
+    for (qsizetype i = 0; i < words.size(); ++i) {
+        if constexpr (std::is_same_v<View, QStringView>)
+            views.push_back(utf16.at(i));
+        else
+            views.push_back(words.at(i));
+    }
+
+    std::vector<T> result;
+    result.reserve(views.size());
+    if (!countAllocations) {
+        QBENCHMARK {
+            constructAll(result, views);
+        }
+        return;
+    }
+#ifdef COUNT_ALLOCATIONS
+    const qint64 before = allocationCount.load(std::memory_order_relaxed);
+    constructAll(result, views);
+    const qint64 count = allocationCount.load(std::memory_order_relaxed) - before;
+    QTest::setBenchmarkResult(count, QTest::Events);
+#endif
+}
+
+static void run(Type type, const QByteArray &corpus, bool countAllocations)
+{
+    const QByteArrayList words = ::corpus(corpus);
+    switch (type) {
+    case ByteArray:
+        return runConstruct<QByteArray, QByteArrayView>(words, countAllocations);
+    case SmallByteArray:
+        return runConstruct<QSmallByteArray, QByteArrayView>(words, countAllocations);
+    case String:
+        return runConstruct<QString, QStringView>(words, countAllocations);
+    case SmallString:
+        return runConstruct<QSmallString, QStringView>(words, countAllocations);
+    }
+}
+
+void tst_QSmallString::construct()
+{
+    QFETCH(Type, type);
+    QFETCH(QByteArray, corpus);
+    run(type, corpus, false);
+}
+
+void tst_QSmallString::constructAllocations()
+{
+#ifndef COUNT_ALLOCATIONS
+    QSKIP("Counting allocations is only supported with glibc");
+#else
+    QFETCH(Type, type);
+    QFETCH(QByteArray, corpus);
+    run(type, corpus, true);
+#endif
+}
+
+QTEST_MAIN(tst_QSmallString)
+#include "tst_bench_qsmallstring.moc"
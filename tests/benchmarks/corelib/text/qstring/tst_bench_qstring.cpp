@@ -1,6 +1,7 @@
 // Copyright (C) 2016 The Qt Company Ltd.
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
 #include <QStringList>
+#include <QStringMatcher>
 #include <QByteArray>
 #include <QLatin1StringView>
 #include <QFile>
@@ -28,6 +29,11 @@ private slots:
     void toCaseFolded_data();
     void toCaseFolded();
 
+    void indexOf_data();
+    void indexOf();
+    void stringMatcher_data() { indexOf_data(); }
+    void stringMatcher();
+
     // Serializing:
     void number_qlonglong_data();
     void number_qlonglong() { number_impl<qlonglong>(); }
@@ -484,6 +490,58 @@ template <typename T> void tst_QString::operator_assign()
     }
 }
 
+void tst_QString::indexOf_data()
+{
+    QTest::addColumn<QString>("haystack");
+    QTest::addColumn<QString>("needle");
+    QTest::addColumn<Qt::CaseSensitivity>("cs");
+
+    // about 30k characters of text, with the needles near the end
+    QString haystack;
+    for (int i = 0; i < 250; ++i) {
+        haystack += u"Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+                    u"tempor incididunt ut labore et dolore magna aliqua. ";
+    }
+    haystack += u"Un été zq: the needle sits in a sentence appended at the very end of the haystack."_s;
+
+    const auto addRows = [&](const char *name, const QString &needle) {
+        QTest::addRow("%s-cs", name) << haystack << needle << Qt::CaseSensitive;
+        QTest::addRow("%s-ci", name) << haystack << needle.toUpper() << Qt::CaseInsensitive;
+    };
+    addRows("2", u"zq"_s);
+    addRows("6", u"needle"_s);
+    addRows("17", u"sentence appended"_s);
+    addRows("40", u"appended at the very end of the haystack"_s);
+    addRows("non-ascii", u"été zq"_s);
+}
+
+void tst_QString::indexOf()
+{
+    QFETCH(QString, haystack);
+    QFETCH(QString, needle);
+    QFETCH(Qt::CaseSensitivity, cs);
+
+    qsizetype result = -1;
+    QBENCHMARK {
+        result = haystack.indexOf(needle, 0, cs);
+    }
+    QVERIFY(result > 0);
+}
+
+void tst_QString::stringMatcher()
+{
+    QFETCH(QString, haystack);
+    QFETCH(QString, needle);
+    QFETCH(Qt::CaseSensitivity, cs);
+
+    const QStringMatcher matcher(needle, cs);
+    qsizetype result = -1;
+    QBENCHMARK {
+        result = matcher.indexIn(haystack);
+    }
+    QVERIFY(result > 0);
+}
+
 void tst_QString::operator_assign_data()
 {
     QTest::addColumn<QByteArray>("data");
@@ -5,8 +5,10 @@
 
 #include <qexception.h>
 #include <qfuture.h>
+#include <qfuturewatcher.h>
 #include <qpromise.h>
 #include <qsemaphore.h>
+#include <qthread.h>
 
 class tst_QFuture : public QObject
 {
@@ -23,6 +25,8 @@ private slots:
     void reportResult();
     void reportResults();
     void reportResultsManualProgress();
+    void reportIndexedResultsFromThreads_data();
+    void reportIndexedResultsFromThreads();
 #ifndef QT_NO_EXCEPTIONS
     void reportException();
 #endif
@@ -127,6 +131,60 @@ void tst_QFuture::reportResultsManualProgress()
     }
 }
 
+void tst_QFuture::reportIndexedResultsFromThreads_data()
+{
+    QTest::addColumn<int>("blockSize");
+    QTest::addColumn<bool>("staging");
+    QTest::addColumn<bool>("watched");
+
+    for (int blockSize : { 1, 10, 100 }) {
+        QTest::addRow("block %d", blockSize) << blockSize << false << false;
+        QTest::addRow("block %d, staged", blockSize) << blockSize << true << false;
+        QTest::addRow("block %d, staged, watched", blockSize) << blockSize << true << true;
+    }
+}
+
+void tst_QFuture::reportIndexedResultsFromThreads()
+{
+    // like QtConcurrent::mapped(): each thread reports blocks of results
+    QFETCH(int, blockSize);
+    QFETCH(bool, staging);
+    QFETCH(bool, watched);
+    const int threadCount = qMax(2, QThread::idealThreadCount());
+    const int blockCount = 100000 / blockSize;
+
+    QBENCHMARK {
+        QFutureInterface<int> fi;
+        fi.setResultStagingEnabled(staging);
+        fi.reportStarted();
+        QFutureWatcher<int> watcher;
+        if (watched)
+            watcher.setFuture(fi.future());
+
+        QList<QThread *> threads(threadCount);
+        for (int t = 0; t < threadCount; ++t) {
+            threads[t] = QThread::create([&, t] {
+                for (int block = t; block < blockCount; block += threadCount) {
+                    const int begin = block * blockSize;
+                    if (blockSize == 1) {
+                        fi.reportResult(begin, begin);
+                    } else {
+                        QList<int> values(blockSize);
+                        std::iota(values.begin(), values.end(), begin);
+                        fi.reportResults(values, begin);
+                    }
+                }
+            });
+            threads[t]->start();
+        }
+        for (QThread *thread : threads)
+            thread->wait();
+        qDeleteAll(threads);
+        fi.reportFinished();
+        QCOMPARE(fi.resultCount(), blockCount * blockSize);
+    }
+}
+
 #ifndef QT_NO_EXCEPTIONS
 void tst_QFuture::reportException()
 {
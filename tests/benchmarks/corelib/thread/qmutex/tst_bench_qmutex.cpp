@@ -3,6 +3,7 @@
 
 #include <QtCore/QtCore>
 #include <QTest>
+#include <QtCore/private/qmutex_p.h>
 #include <QtCore/private/qvolatile_p.h>
 
 #include <math.h>
@@ -107,6 +108,9 @@ private slots:
     void contendedNative();
     void contendedQMutex();
     void contendedQMutexLocker();
+
+    void shortCriticalSections_data();
+    void shortCriticalSections();
 };
 
 QSemaphore tst_QMutex::semaphore1;
@@ -428,6 +432,48 @@ void tst_QMutex::contendedQMutexLocker()
     qDeleteAll(threads);
 }
 
+void tst_QMutex::shortCriticalSections_data()
+{
+    QTest::addColumn<int>("maximumSpinCount");
+    QTest::addColumn<int>("work");
+
+    const int defaultSpinCount = QMutexContention::maximumSpinCount();
+    for (int work : { 0, 10, 100, 1000 }) {
+        QTest::addRow("no spinning, work %d", work) << 0 << work;
+        QTest::addRow("adaptive spinning, work %d", work) << defaultSpinCount << work;
+    }
+}
+
+void tst_QMutex::shortCriticalSections()
+{
+    QFETCH(int, maximumSpinCount);
+    QFETCH(int, work);
+    const int previous = QMutexContention::maximumSpinCount();
+    QMutexContention::setMaximumSpinCount(maximumSpinCount);
+
+    const int iterations = 10000;
+    QMutex mutex;
+    volatile int counter = 0;
+    QBENCHMARK {
+        QList<QThread *> threads(threadCount);
+        for (QThread *&thread : threads) {
+            thread = QThread::create([&] {
+                for (int i = 0; i < iterations; ++i) {
+                    QMutexLocker locker(&mutex);
+                    for (int j = 0; j <= work; ++j)
+                        QtPrivate::volatilePreIncrement(counter);
+                }
+            });
+            thread->start();
+        }
+        for (QThread *thread : threads)
+            thread->wait();
+        qDeleteAll(threads);
+    }
+
+    QMutexContention::setMaximumSpinCount(previous);
+}
+
 QTEST_MAIN(tst_QMutex)
 
 #include "tst_bench_qmutex.moc"
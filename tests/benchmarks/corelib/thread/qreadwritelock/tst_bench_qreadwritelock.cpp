@@ -3,6 +3,7 @@
 
 #include <QtCore/QtCore>
 #include <QTest>
+#include <QtCore/private/qshardedreadwritelock_p.h>
 #include <mutex>
 #if __has_include(<shared_mutex>)
 #include <shared_mutex>
@@ -82,6 +83,8 @@ private slots:
     void readOnly();
     void writeOnly_data();
     void writeOnly();
+    void readMostly_data();
+    void readMostly();
     // void readWrite();
 };
 
@@ -123,6 +126,12 @@ void tst_QReadWriteLock::uncontended_data()
         << FunctionPtrHolder(testUncontended<QReadWriteLock, QReadLocker>);
     QTest::newRow("QReadWriteLock, write")
         << FunctionPtrHolder(testUncontended<QReadWriteLock, QWriteLocker>);
+    QTest::newRow("QShardedReadWriteLock, read") << FunctionPtrHolder(
+        testUncontended<QShardedReadWriteLock,
+                        LockerWrapper<std::shared_lock<QShardedReadWriteLock>>>);
+    QTest::newRow("QShardedReadWriteLock, write") << FunctionPtrHolder(
+        testUncontended<QShardedReadWriteLock,
+                        LockerWrapper<std::unique_lock<QShardedReadWriteLock>>>);
 #define ROW(n) \
     QTest::addRow("QReadWriteLock, %s, recursive: %d", "read", n) \
         << FunctionPtrHolder(testUncontended<QRecursiveReadWriteLock, QRecursiveReadLocker<n>>); \
@@ -199,6 +208,9 @@ void tst_QReadWriteLock::readOnly_data()
     QTest::newRow("nothing") << FunctionPtrHolder(testReadOnly<int, FakeLock>);
     QTest::newRow("QMutex") << FunctionPtrHolder(testReadOnly<QMutex, QMutexLocker<QMutex>>);
     QTest::newRow("QReadWriteLock") << FunctionPtrHolder(testReadOnly<QReadWriteLock, QReadLocker>);
+    QTest::newRow("QShardedReadWriteLock") << FunctionPtrHolder(
+        testReadOnly<QShardedReadWriteLock,
+                     LockerWrapper<std::shared_lock<QShardedReadWriteLock>>>);
 #define ROW(n) \
     QTest::addRow("QReadWriteLock, recursive: %d", n) \
         << FunctionPtrHolder(testReadOnly<QRecursiveReadWriteLock, QRecursiveReadLocker<n>>)
@@ -267,6 +279,9 @@ void tst_QReadWriteLock::writeOnly_data()
     // QTest::newRow("nothing") << FunctionPtrHolder(testWriteOnly<int, FakeLock>);
     QTest::newRow("QMutex") << FunctionPtrHolder(testWriteOnly<QMutex, QMutexLocker<QMutex>>);
     QTest::newRow("QReadWriteLock") << FunctionPtrHolder(testWriteOnly<QReadWriteLock, QWriteLocker>);
+    QTest::newRow("QShardedReadWriteLock") << FunctionPtrHolder(
+        testWriteOnly<QShardedReadWriteLock,
+                      LockerWrapper<std::unique_lock<QShardedReadWriteLock>>>);
 #define ROW(n) \
     QTest::addRow("QReadWriteLock, recursive: %d", n) \
         << FunctionPtrHolder(testWriteOnly<QRecursiveReadWriteLock, QRecursiveWriteLocker<n>>)
@@ -294,5 +309,72 @@ void tst_QReadWriteLock::writeOnly()
     holder.value();
 }
 
+// one write per WriteInterval reads, as in a cache
+enum { WriteInterval = 1000 };
+
+template <typename Mutex, typename ReadLocker, typename WriteLocker>
+void testReadMostly()
+{
+    struct Thread : QThread
+    {
+        Mutex *lock;
+        void run() override
+        {
+            for (int i = 0; i < Iterations; ++i) {
+                QString s = QString::number(i); // Do something outside the lock
+                if (i % WriteInterval == 0) {
+                    WriteLocker locker(lock);
+                    global_hash.insert(s, s);
+                } else {
+                    ReadLocker locker(lock);
+                    global_hash.contains(s);
+                }
+            }
+        }
+    };
+    Mutex lock;
+    std::vector<std::unique_ptr<Thread>> threads;
+    for (int i = 0; i < threadCount; ++i) {
+        auto t = std::make_unique<Thread>();
+        t->lock = &lock;
+        threads.push_back(std::move(t));
+    }
+    QBENCHMARK {
+        for (auto &t : threads) {
+            t->start();
+        }
+        for (auto &t : threads) {
+            t->wait();
+        }
+    }
+    global_hash.clear();
+}
+
+void tst_QReadWriteLock::readMostly_data()
+{
+    QTest::addColumn<FunctionPtrHolder>("holder");
+
+    QTest::newRow("QMutex") << FunctionPtrHolder(
+        testReadMostly<QMutex, QMutexLocker<QMutex>, QMutexLocker<QMutex>>);
+    QTest::newRow("QReadWriteLock") << FunctionPtrHolder(
+        testReadMostly<QReadWriteLock, QReadLocker, QWriteLocker>);
+    QTest::newRow("QShardedReadWriteLock") << FunctionPtrHolder(
+        testReadMostly<QShardedReadWriteLock,
+                       LockerWrapper<std::shared_lock<QShardedReadWriteLock>>,
+                       LockerWrapper<std::unique_lock<QShardedReadWriteLock>>>);
+#ifdef __cpp_lib_shared_mutex
+    QTest::newRow("std::shared_mutex") << FunctionPtrHolder(
+        testReadMostly<std::shared_mutex,
+                       LockerWrapper<std::shared_lock<std::shared_mutex>>,
+                       LockerWrapper<std::unique_lock<std::shared_mutex>>>);
+#endif
+}
+
+void tst_QReadWriteLock::readMostly()
+{
+    QFETCH(FunctionPtrHolder, holder);
+    holder.value();
+}
+
 QTEST_MAIN(tst_QReadWriteLock)
 #include "tst_bench_qreadwritelock.moc"
@@ -15,6 +15,8 @@ public:
 private slots:
     void startRunnables();
     void activeThreadCount();
+    void fineGrainedTasks_data();
+    void fineGrainedTasks();
 };
 
 tst_QThreadPool::tst_QThreadPool()
@@ -50,6 +52,45 @@ void tst_QThreadPool::activeThreadCount()
     }
 }
 
+void tst_QThreadPool::fineGrainedTasks_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<bool>("workStealing");
+
+    for (int threadCount : {1, 2, 4, 8, 16, 32, 64}) {
+        QTest::addRow("%d-queue", threadCount) << threadCount << false;
+        QTest::addRow("%d-stealing", threadCount) << threadCount << true;
+    }
+}
+
+void tst_QThreadPool::fineGrainedTasks()
+{
+    QFETCH(int, threadCount);
+    QFETCH(bool, workStealing);
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(threadCount);
+    threadPool.setWorkStealingEnabled(workStealing);
+
+    // a binary tree of tiny tasks, each starting its children from a worker
+    constexpr int Depth = 14;
+    QSemaphore leaves;
+    std::function<void(int)> split = [&](int depth) {
+        if (depth == 0) {
+            leaves.release();
+            return;
+        }
+        threadPool.start([&split, depth] { split(depth - 1); });
+        threadPool.start([&split, depth] { split(depth - 1); });
+    };
+
+    QBENCHMARK {
+        threadPool.start([&split] { split(Depth); });
+        leaves.acquire(1 << Depth);
+    }
+    threadPool.waitForDone();
+}
+
 QTEST_MAIN(tst_QThreadPool)
 
 #include "tst_bench_qthreadpool.moc"
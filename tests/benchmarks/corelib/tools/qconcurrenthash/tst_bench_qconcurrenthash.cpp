@@ -0,0 +1,124 @@
+// Copyright (C) 2024 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QAtomicInt>
+#include <QConcurrentHash>
+#include <QHash>
+#include <QReadWriteLock>
+#include <QTest>
+#include <QThread>
+
+#include <memory>
+#include <vector>
+
+// The reference: a QHash guarded by a single lock, as code sharing a hash
+// between threads does without QConcurrentHash.
+class LockedHash
+{
+public:
+    int value(int key) const
+    {
+        QReadLocker locker(&lock);
+        return hash.value(key);
+    }
+    void insert(int key, int value)
+    {
+        QWriteLocker locker(&lock);
+        hash.insert(key, value);
+    }
+
+private:
+    mutable QReadWriteLock lock;
+    QHash<int, int> hash;
+};
+
+class tst_QConcurrentHash : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void readMostly_data();
+    void readMostly();
+};
+
+enum Implementation { Locked, Concurrent };
+
+static constexpr int KeyCount = 10000;
+static constexpr int OperationsPerThread = 100000;
+// keeps the lookups from being optimized out
+static QAtomicInt sink;
+
+void tst_QConcurrentHash::initTestCase()
+{
+    QHashSeed::setDeterministicGlobalSeed();
+}
+
+void tst_QConcurrentHash::readMostly_data()
+{
+    QTest::addColumn<Implementation>("implementation");
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<int>("writePercentage");
+
+    for (int threads : { 1, 2, 4, 8, 16, 32, 64 }) {
+        for (int writes : { 1, 10 }) {
+            QTest::addRow("QHash+QReadWriteLock:%d-threads:%d%%-writes", threads, writes)
+                    << Locked << threads << writes;
+            QTest::addRow("QConcurrentHash:%d-threads:%d%%-writes", threads, writes)
+                    << Concurrent << threads << writes;
+        }
+    }
+}
+
+template <typename Hash>
+static void runWorkload(Hash &hash, int threadCount, int writePercentage)
+{
+    // every thread does the same number of operations, so the time per
+    // operation goes down as far as the threads scale
+    std::vector<std::unique_ptr<QThread>> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back(QThread::create([&hash, t, writePercentage] {
+            quint32 state = 2654435761u * quint32(t + 1);
+            int sum = 0;
+            for (int i = 0; i < OperationsPerThread; ++i) {
+                state = state * 1664525u + 1013904223u;
+                const int key = int((state >> 8) % KeyCount);
+                if (int(state % 100) < writePercentage)
+                    hash.insert(key, i);
+                else
+                    sum += hash.value(key);
+            }
+            sink.fetchAndAddRelaxed(sum);
+        }));
+    }
+    for (auto &thread : threads)
+        thread->start();
+    for (auto &thread : threads)
+        thread->wait();
+}
+
+void tst_QConcurrentHash::readMostly()
+{
+    QFETCH(Implementation, implementation);
+    QFETCH(int, threadCount);
+    QFETCH(int, writePercentage);
+
+    if (implementation == Locked) {
+        LockedHash hash;
+        for (int i = 0; i < KeyCount; ++i)
+            hash.insert(i, i);
+        QBENCHMARK {
+            runWorkload(hash, threadCount, writePercentage);
+        }
+    } else {
+        QConcurrentHash<int, int> hash;
+        for (int i = 0; i < KeyCount; ++i)
+            hash.insert(i, i);
+        QBENCHMARK {
+            runWorkload(hash, threadCount, writePercentage);
+        }
+    }
+}
+
+QTEST_MAIN(tst_QConcurrentHash)
+#include "tst_bench_qconcurrenthash.moc"
@@ -13,6 +13,8 @@
 #include <QUuid>
 #include <QTest>
 
+using namespace Qt::StringLiterals;
+
 static constexpr quint64 RandomSeed32 = 1045982819;
 static constexpr quint64 RandomSeed64 = QtPrivate::QHashCombine{}(RandomSeed32, RandomSeed32);
 
@@ -49,8 +51,14 @@ private slots:
     void hashing_nonzero_qlatin1string_data() { data(); }
     void hashing_nonzero_qlatin1string() { hashing_nonzero_template<OwningLatin1String>(); }
 
+    void lookup_hits_data() { lookupData(); }
+    void lookup_hits();
+    void lookup_misses_data() { lookupData(); }
+    void lookup_misses();
+
 private:
     void data();
+    void lookupData();
     template <typename String> void qhash_template();
     template <typename String, size_t Seed = 0> void hashing_template();
     template <typename String> void hashing_nonzero_template()
@@ -176,6 +184,55 @@ template <typename String, size_t Seed> void tst_QHash::hashing_template()
     }
 }
 
+void tst_QHash::lookupData()
+{
+    QTest::addColumn<QStringList>("items");
+    QTest::addColumn<QStringList>("missing");
+
+    // keys sharing long prefixes, as in large string-keyed tables, so that
+    // comparing keys is expensive
+    const auto keys = [](int count, int offset) {
+        QStringList list;
+        list.reserve(count);
+        for (int i = 0; i < count; ++i)
+            list.append(u"org.qt-project.settings.group/key-%1"_s.arg(offset + i));
+        return list;
+    };
+    for (int count : { 1000, 100000, 1000000 })
+        QTest::addRow("%d", count) << keys(count, 0) << keys(count, count);
+}
+
+void tst_QHash::lookup_hits()
+{
+    QFETCH(QStringList, items);
+    QHash<QString, int> hash;
+    for (int i = 0; i < items.size(); ++i)
+        hash.insert(items.at(i), i);
+
+    qsizetype found = 0;
+    QBENCHMARK {
+        for (const QString &item : std::as_const(items))
+            found += hash.contains(item);
+    }
+    QVERIFY(found > 0);
+}
+
+void tst_QHash::lookup_misses()
+{
+    QFETCH(QStringList, items);
+    QFETCH(QStringList, missing);
+    QHash<QString, int> hash;
+    for (int i = 0; i < items.size(); ++i)
+        hash.insert(items.at(i), i);
+
+    qsizetype found = 0;
+    QBENCHMARK {
+        for (const QString &item : std::as_const(missing))
+            found += hash.contains(item);
+    }
+    QCOMPARE(found, 0);
+}
+
 QTEST_MAIN(tst_QHash)
 
 #include "tst_bench_qhash.moc"